@@ -31,16 +31,31 @@
 #include "gecoEvent.h"
 #include "gecoObj.h"
 #include "gecoProcess.h"
+#include "gecoScript.h"
+#include "gecoExpr.h"
+#include "gecoSignal.h"
 #include "gecoTrigger.h"
 #include "gecoUProc.h"
 #include "gecoGraph.h"
+#include "gecoBinFile.h"
+#include "gecoAsyncWriter.h"
+#include "gecoRecordArena.h"
+#include "gecoBinRecord.h"
+#include "gecoTextRecord.h"
+#include "gecoBlockCodec.h"
+#include "gecoTimeQuery.h"
+#include "gecoPyramid.h"
 #include "gecoFileStream.h"
 #include "gecoMemStream.h"
+#include "gecoRingRecorder.h"
+#include "gecoReplay.h"
 #include "gecoIOModule.h"
 #include "gecoIO.h"
 #include "gecoIOSocket.h"
 #include "gecoIOTcp.h"
 #include "gecoClock.h"
+#include "gecoRTLoop.h"
+#include "gecoTimerWheel.h"
 #include "gecoApp.h"
 #include "gecoPkgHandle.h"
 #include "gecoGenerator.h"
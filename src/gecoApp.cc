@@ -19,6 +19,16 @@
 // 12.10.2015 Creation                         R. Wuthrich
 // 21.11.2020 Added DOxygen documentation      R. Wuthrich
 // 17.11.2024 Fix tcl.h and tk.h imports       R. Wuthrich
+// 17.10.2026 Added real-time thread           agent
+// 17.10.2026 Added ps -stats and -resetStats  agent
+// 17.10.2026 Added multi-rate scheduling      agent
+// 17.10.2026 Commands posted to event queue   agent
+// 17.10.2026 Indexed process registry         agent
+// 17.10.2026 Added native variables           agent
+// 17.10.2026 Added signal bus                 agent
+// 17.10.2026 Added binfile command            agent
+// 17.10.2026 Added ringrecorder and ringfile  agent
+// 17.10.2026 Added replay                     agent
 //
 // ---------------------------------------------------------------
 
@@ -27,10 +37,14 @@
 #include <tcl.h>
 #include <cstring>
 #include <iostream>
+#include <time.h>
 #include <tclreadline.h>
 #include "gecoApp.h"
 #include "gecoEvent.h"
+#include "gecoSignal.h"
 #include "gecoProcess.h"
+#include "gecoRTLoop.h"
+#include "gecoTimerWheel.h"
 #include "gecoTcpServer.h"
 #include "gecoIOModule.h"
 #include "gecoPkgHandle.h"
@@ -38,7 +52,10 @@
 #include "gecoUProc.h"
 #include "gecoGraph.h"
 #include "gecoFileStream.h"
+#include "gecoBinFile.h"
 #include "gecoMemStream.h"
+#include "gecoRingRecorder.h"
+#include "gecoReplay.h"
 #include "gecoIO.h"
 #include "gecoIOSocket.h"
 #include "gecoIOTcp.h"
@@ -119,15 +136,15 @@ int geco_StartCmd(ClientData clientData, Tcl_Interp *interp,
       return TCL_ERROR;
     }
 
-  // loops over all processes in order to reset them in Waiting status
-  gecoProcess* p=app->getFirstGecoProcess();
-  while (p!=NULL)
+  if (!app->getEvent()->postCmdEvent(CmdStart, NULL))
     {
-      p->setStatus(Waiting);
-      p=p->getNextGecoProcess();
+      Tcl_AppendResult(interp, "event queue is full; command rejected", NULL);
+      return TCL_ERROR;
     }
 
-  app->getEvent()->setCmdEvent(CmdStart,NULL);
+  // loops over all processes in order to reset them in Waiting status
+  for (int k=0; k<app->getNbrGecoProcesses(); k++)
+    app->getGecoProcess(k)->setStatus(Waiting);
   app->getEvent()->setEventLoopStatus(1);
 
   Tcl_Eval(interp, "cons \"+---------------------------------+\"");
@@ -155,7 +172,11 @@ int geco_StopCmd(ClientData clientData, Tcl_Interp *interp,
     }
 
   app->getEvent()->setEventLoopStatus(0);
-  app->getEvent()->setCmdEvent(CmdStop, NULL);
+  if (!app->getEvent()->postCmdEvent(CmdStop, NULL))
+    {
+      Tcl_AppendResult(interp, "event queue is full; command rejected", NULL);
+      return TCL_ERROR;
+    }
   return TCL_OK;
 }
 
@@ -175,7 +196,11 @@ int geco_HoldCmd(ClientData clientData, Tcl_Interp *interp,
       return TCL_ERROR;
     }
 
-  app->getEvent()->setCmdEvent(CmdHold, NULL);
+  if (!app->getEvent()->postCmdEvent(CmdHold, NULL))
+    {
+      Tcl_AppendResult(interp, "event queue is full; command rejected", NULL);
+      return TCL_ERROR;
+    }
   return TCL_OK;
 }
 
@@ -195,7 +220,11 @@ int geco_ResumeCmd(ClientData clientData, Tcl_Interp *interp,
       return TCL_ERROR;
     }
 
-  app->getEvent()->setCmdEvent(CmdResume, NULL);
+  if (!app->getEvent()->postCmdEvent(CmdResume, NULL))
+    {
+      Tcl_AppendResult(interp, "event queue is full; command rejected", NULL);
+      return TCL_ERROR;
+    }
   return TCL_OK;
 }
 
@@ -208,7 +237,7 @@ int geco_PsCmd(ClientData clientData, Tcl_Interp *interp,
 	       int objc,Tcl_Obj *const objv[])
 {
   gecoApp*     app=(gecoApp *)clientData;
-  gecoProcess* p=app->getFirstGecoProcess();
+  gecoProcess* p;
 
   char str[100];
   char user_name[15];
@@ -219,8 +248,9 @@ int geco_PsCmd(ClientData clientData, Tcl_Interp *interp,
 		       "OWNER     PID  PROCESS NAME         ",
                        "CMD          STATUS      COMMENT\n",
 		       NULL);
-      while (p!=NULL)
+      for (int k=0; k<app->getNbrGecoProcesses(); k++)
 	{
+	  p=app->getGecoProcess(k);
 	  sprintf(str,"::geco::%s", p->getProcessOwner());
 	  if (Tcl_GetVar(interp, str, 0)!=NULL)
 	    strncpy(user_name, Tcl_GetVar(interp, str, 0), 9);
@@ -241,13 +271,12 @@ int geco_PsCmd(ClientData clientData, Tcl_Interp *interp,
 	  else
 	    sprintf(str,"%-15s...\n", user_name);
 	  Tcl_AppendResult(interp, str, NULL);
-	  p=p->getNextGecoProcess();
 	}
       return TCL_OK;
     }
 
   int index;
-  static CONST char* cmds[] = {"-list", "-cmd", "-move", NULL};
+  static CONST char* cmds[] = {"-list", "-cmd", "-move", "-stats", "-resetStats", NULL};
   if (Tcl_GetIndexFromObj(interp, objv[1], cmds, "subcommand", '0', &index)!=TCL_OK)
     return TCL_ERROR;
 
@@ -260,12 +289,10 @@ int geco_PsCmd(ClientData clientData, Tcl_Interp *interp,
 	  Tcl_WrongNumArgs(interp, 2, objv, "");
 	  return TCL_ERROR;
 	}
-      if (p!=NULL) p=p->getNextGecoProcess();
-      while (p!=NULL)
+      for (int k=1; k<app->getNbrGecoProcesses(); k++)
 	{
-	  sprintf(str,"%s ",p->getTclCmd());
+	  sprintf(str,"%s ",app->getGecoProcess(k)->getTclCmd());
 	  Tcl_AppendResult(interp, str, NULL);
-	  p=p->getNextGecoProcess();
 	}
       break;
 
@@ -299,6 +326,47 @@ int geco_PsCmd(ClientData clientData, Tcl_Interp *interp,
 	}
       break;
 
+    case 3: //-stats
+      if (objc>2)
+	{
+	  Tcl_WrongNumArgs(interp, 2, objv, "");
+	  return TCL_ERROR;
+	}
+      Tcl_AppendResult(interp,
+		       "PID  CMD          CALLS      TOTAL(ms)  MEAN(us)   ",
+		       "MIN(us)    MAX(us)    P50(us)    P99(us)    P999(us)\n",
+		       NULL);
+      for (int k=0; k<app->getNbrGecoProcesses(); k++)
+	{
+	  p=app->getGecoProcess(k);
+	  long n=p->getNExec();
+	  snprintf(str, 100, "%-3s  %-12s %-10ld %-10.3f %-10.2f %-10.2f %-10.2f ",
+		  p->getID(),
+		  p->getTclCmd(),
+		  n,
+		  p->getExecSum()/1000.0,
+		  (n>0) ? p->getExecSum()/n : 0.0,
+		  (n>0) ? p->getExecMin() : 0.0,
+		  p->getExecMax());
+	  Tcl_AppendResult(interp, str, NULL);
+	  snprintf(str, 100, "%-10.2f %-10.2f %-10.2f\n",
+		  p->execPercentile(0.5),
+		  p->execPercentile(0.99),
+		  p->execPercentile(0.999));
+	  Tcl_AppendResult(interp, str, NULL);
+	}
+      break;
+
+    case 4: //-resetStats
+      if (objc>2)
+	{
+	  Tcl_WrongNumArgs(interp, 2, objv, "");
+	  return TCL_ERROR;
+	}
+      for (int k=0; k<app->getNbrGecoProcesses(); k++)
+	app->getGecoProcess(k)->resetExecStat();
+      break;
+
     }
 
   return TCL_OK;
@@ -393,6 +461,7 @@ int geco_TerminateCmd(ClientData clientData, Tcl_Interp *interp,
     }
 
   gecoProcess* p=app->findGecoProcess(Tcl_GetString(objv[1]));
+  if (p==NULL) p=app->findGecoProcessByCmd(Tcl_GetString(objv[1]));
   if (p==NULL)
     {
       Tcl_AppendResult(interp, "invalid process ID", NULL);
@@ -403,8 +472,18 @@ int geco_TerminateCmd(ClientData clientData, Tcl_Interp *interp,
       Tcl_AppendResult(interp, "process not active; can't be terminated", NULL);
       return TCL_ERROR;
     }
-  p->terminate(app->getEvent());
-  //app->getEvent()->setCmdEvent(CmdProcessTerminated, NULL);
+  // terminates the process and posts the resulting event command
+  // to the event queue, leaving the current event untouched
+  gecoEvent* ev = app->getEvent();
+  long rejected = ev->getQueue()->getRejected();
+  ev->deferCmdEvents(true);
+  p->terminate(ev);
+  ev->deferCmdEvents(false);
+  if (ev->getQueue()->getRejected()!=rejected)
+    {
+      Tcl_AppendResult(interp, "event queue is full; command rejected", NULL);
+      return TCL_ERROR;
+    }
   return TCL_OK;
 }
 
@@ -425,6 +504,7 @@ int geco_RemoveCmd(ClientData clientData, Tcl_Interp *interp,
     }
 
   gecoProcess* p=app->findGecoProcess(Tcl_GetString(objv[1]));
+  if (p==NULL) p=app->findGecoProcessByCmd(Tcl_GetString(objv[1]));
 
   if (p==NULL)
     {
@@ -450,6 +530,22 @@ int geco_RemoveCmd(ClientData clientData, Tcl_Interp *interp,
 }
 
 
+/**
+ * @brief Runs gecoProcess::handleEvent and records its execution time
+ * @param app a pointer to the instance of gecoApp
+ * @param p gecoProcess to run
+ */
+
+static void geco_runProcess(gecoApp* app, gecoProcess* p)
+{
+  struct timespec t1, t2;
+  clock_gettime(CLOCK_MONOTONIC, &t1);
+  p->handleEvent(app->getEvent());
+  clock_gettime(CLOCK_MONOTONIC, &t2);
+  p->addExecReco((t2.tv_sec-t1.tv_sec)*1e6 + (t2.tv_nsec-t1.tv_nsec)/1e3);
+}
+
+
 /**
  * @brief Dispatches the geCo events
  * @param clientData a pointer to the instance of gecoApp
@@ -459,23 +555,74 @@ int geco_RemoveCmd(ClientData clientData, Tcl_Interp *interp,
  *
  * The Tcl_TimerProc register itself again continuously with the function
  * Tcl_CreateTimerHandler() from the Tcl C API.
- * The time interval used for registration is the tick value
- * of the gecoClock, which must be the first gecoProcess in the 
- * geco process loop.
+ * The time interval used for registration is computed by the gecoClock,
+ * which must be the first gecoProcess in the geco process loop. With the
+ * relative scheduler it is the tick value of the gecoClock. With the 
+ * absolute scheduler the Tcl_TimerProc wakes up shortly before the next
+ * deadline and gecoClock::waitDeadline waits for the exact deadline.
+ *
+ * At the start of each run, the next event command posted to the
+ * gecoEventQueue is loaded into the gecoEvent (gecoEvent::nextCmdEvent).
+ * A posted CmdProcessTerminated is dispatched from the gecoProcess following
+ * the terminated one, like a CmdProcessTerminated set within the loop.
+ *
+ * Only the gecoProcess due on the current tick, as given by the gecoTimerWheel,
+ * are visited. As soon as the gecoEvent carries a command, all (remaining)
+ * gecoProcess of the geco process loop are visited.
+ *
+ * The time spent in gecoProcess::handleEvent is recorded for each 
+ * gecoProcess with gecoProcess::addExecReco ('ps -stats').
+ *
+ * After each run, the status of the gecoProcess is forwarded to the
+ * real-time thread with gecoRTLoop::sync.
 */
 
 void geco_eventLoop(ClientData clientData)
 {
   gecoApp* app = (gecoApp *)clientData;
-  gecoProcess* p = app->getFirstGecoProcess();
-  while (p!=NULL)
+  gecoClock* clk = (gecoClock *)app->getFirstGecoProcess();
+  if (clk->scheduler==Scheduler_absolute) clk->waitDeadline();
+
+  gecoEvent* ev = app->event;
+  ev->nextCmdEvent();
+  vector<gecoProcess*>& due = app->dueProcesses;
+  app->wheel->advance(due);
+
+  // a posted CmdProcessTerminated is dispatched from the gecoProcess
+  // following its generator, the due ones before it run without it
+  int next = app->gecoProcs.size();
+  int          cmd = ev->cmd();
+  gecoProcess* gen = ev->eventGenerator();
+  if (cmd!=NoCmd)
     {
-      p->handleEvent(app->event);
-      p = p->getNextGecoProcess();
+      next = 0;
+      if ((cmd==CmdProcessTerminated)&&(gen!=NULL)&&(gen->getLoopIndex()>=0))
+	{
+	  next = gen->getLoopIndex()+1;
+	  ev->reset();
+	}
     }
+
+  for (unsigned int k=0; (k<due.size())&&(due[k]->getLoopIndex()<next); k++)
+    {
+      geco_runProcess(app, due[k]);
+      if (ev->cmd()!=NoCmd)
+	{
+	  // a command was set within the loop: the held one is posted again
+	  if (cmd!=NoCmd) ev->postCmdEvent(cmd, gen);
+	  cmd = NoCmd;
+	  next = due[k]->getLoopIndex()+1;
+	  break;
+	}
+    }
+  if (cmd!=NoCmd) ev->loadCmdEvent(cmd, gen);
+
+  for (int k=next; k<(int)app->gecoProcs.size(); k++)
+    geco_runProcess(app, app->gecoProcs[k]);
   app->event->reset();
-  gecoClock* clk = (gecoClock *)app->getFirstGecoProcess();
-  Tcl_CreateTimerHandler(clk->tick, geco_eventLoop, clientData);
+  app->signalBus->flush();
+  app->rtLoop->sync();
+  Tcl_CreateTimerHandler(clk->nextTimerDelay(), geco_eventLoop, clientData);
 }
 
 
@@ -494,15 +641,15 @@ void geco_exitHandler(ClientData clientData)
 {
   gecoApp* app=(gecoApp *)clientData;
 
+  // stops the real-time thread before deleting the gecoProcesses
+  delete app->getRTLoop();
+
   // loops over all gecopPocesses in order to delete them
-  gecoProcess* p1=app->getFirstGecoProcess();
-  gecoProcess* p2;
-  while (p1!=NULL)
-    {
-      p2=p1->getNextGecoProcess();
-      delete p1;
-      p1=p2;
-    }
+  for (int k=0; k<app->getNbrGecoProcesses(); k++)
+    delete app->getGecoProcess(k);
+  app->gecoProcs.clear();
+  Tcl_DeleteHashTable(&app->gecoProcByID);
+  Tcl_DeleteHashTable(&app->gecoProcByCmd);
 
   // loops over all gecoIOModules in order to delete them
   gecoIOModule* m1=app->getFirstGecoIOModule();
@@ -535,7 +682,10 @@ void geco_exitHandler(ClientData clientData)
       s1=s2;
     }
 
+  delete app->getSignalBus();
   delete app->getEvent();
+  delete app->getTimerWheel();
+  Tcl_DeleteHashTable(&app->nativeVars);
 
   cout <<"bye\n";
 }
@@ -575,12 +725,20 @@ gecoApp::gecoApp(int argc, char **argv)
   registerNewCmd();
   registerGlobalVars();
 
+  Tcl_InitHashTable(&nativeVars, TCL_STRING_KEYS);
+  nativeVarsEpoch    = 0;
   event              = new gecoEvent(this);
+  signalBus          = new gecoSignalBus(this);
+  Tcl_InitHashTable(&gecoProcByID, TCL_STRING_KEYS);
+  Tcl_InitHashTable(&gecoProcByCmd, TCL_STRING_KEYS);
   gecoClock* clk     = new gecoClock(this);;
-  firstGecoProcess   = clk;
+  registerGecoProcess(clk);
   firstGecoIOModule  = NULL;
   firstGecoPkgHandle = NULL;
   firstGecoTcpServer = NULL;
+  rtLoop             = new gecoRTLoop(this);
+  wheel              = new gecoTimerWheel(this);
+  wheel->rebuild();
 
   Tcl_EvalFile(interp, "//usr//local//share//geco//gecolib.tcl");
   Tcl_EvalFile(interp, "//usr//local//etc//geco//geco.gecorc.tcl");
@@ -672,6 +830,18 @@ void gecoApp::registerNewCmd()
   Tcl_CreateObjCommand(interp, "memstream", geco_MemStreamCmd, 
                        (ClientData) this, (Tcl_CmdDeleteProc *) NULL);
 
+  Tcl_CreateObjCommand(interp, "binfile", geco_BinFileCmd, 
+                       (ClientData) this, (Tcl_CmdDeleteProc *) NULL);
+
+  Tcl_CreateObjCommand(interp, "ringrecorder", geco_RingRecorderCmd, 
+                       (ClientData) this, (Tcl_CmdDeleteProc *) NULL);
+
+  Tcl_CreateObjCommand(interp, "ringfile", geco_RingFileCmd, 
+                       (ClientData) this, (Tcl_CmdDeleteProc *) NULL);
+
+  Tcl_CreateObjCommand(interp, "replay", geco_ReplayCmd, 
+                       (ClientData) this, (Tcl_CmdDeleteProc *) NULL);
+
   Tcl_CreateObjCommand(interp, "triangle", geco_TriangleCmd, 
                        (ClientData) this, (Tcl_CmdDeleteProc *) NULL);
 
@@ -709,6 +879,33 @@ void gecoApp::registerGlobalVars()
 }
 
 
+/**
+ * @brief Appends a gecoProcess to the registry of the geco process loop
+ * @param proc gecoProcess to be appended
+*/
+
+void gecoApp::registerGecoProcess(gecoProcess* proc)
+{
+  int isNew;
+  proc->setLoopIndex(gecoProcs.size());
+  gecoProcs.push_back(proc);
+  Tcl_SetHashValue(Tcl_CreateHashEntry(&gecoProcByID, proc->getID(), &isNew), proc);
+  Tcl_SetHashValue(Tcl_CreateHashEntry(&gecoProcByCmd, proc->getTclCmd(), &isNew), proc);
+}
+
+
+/**
+ * @brief Updates the loop index of the gecoProcess from position from on
+ * @param from first position in the geco process loop to update
+*/
+
+void gecoApp::reindexGecoProcesses(int from)
+{
+  for (int k=from; k<(int)gecoProcs.size(); k++)
+    gecoProcs[k]->setLoopIndex(k);
+}
+
+
 /**
  * @brief Adds a new gecoProcess to the process list
  * @param proc gecoProcess to be added
@@ -716,13 +913,9 @@ void gecoApp::registerGlobalVars()
 
 void gecoApp::addGecoProcess(gecoProcess* proc)
 {
-  gecoProcess* p=firstGecoProcess;
-
-  while (p->getNextGecoProcess()!=NULL)
-    p=p->getNextGecoProcess();
-      
-  p->setNextGecoProcess(proc);
-  proc->setNextGecoProcess(NULL);
+  registerGecoProcess(proc);
+  rtLoop->publish();
+  wheel->rebuild();
   Tcl_Eval(interp, "event generate . <<ProcessCreated>>");
 }
 
@@ -740,23 +933,21 @@ int gecoApp::moveGecoProcess(const char* PID1, const char* PID2)
   gecoProcess* p2=findGecoProcess(PID2);
 
   // check validity of PIDs
-  if ((p1==NULL)||(p2==NULL)) return -1;
+  if ((p1==NULL)||(p2==NULL)||(p1==p2)) return -1;
   if (strcmp(p1->getProcessOwner(),"system")==0) return -1;
 
   // check if order is already correct
-  if (p2->getNextGecoProcess()==p1) return 0;
+  int i1=p1->getLoopIndex();
+  if (p2->getLoopIndex()+1==i1) return 0;
 
-  // finds process before PID1
-  gecoProcess* p=firstGecoProcess;
-  while (p->getNextGecoProcess()!=NULL)
-    {
-      if (p->getNextGecoProcess()==p1) break;
-      p=p->getNextGecoProcess();
-    }
+  gecoProcs.erase(gecoProcs.begin()+i1);
+  int i2=p2->getLoopIndex();
+  if (i2>i1) i2--;
+  gecoProcs.insert(gecoProcs.begin()+i2+1, p1);
+  reindexGecoProcesses((i1<i2) ? i1 : i2);
 
-  p ->setNextGecoProcess(p1->getNextGecoProcess());
-  p1->setNextGecoProcess(p2->getNextGecoProcess());
-  p2->setNextGecoProcess(p1);
+  rtLoop->publish();
+  wheel->rebuild();
   Tcl_Eval(interp, "event generate . <<ProcessMoved>>");
   return 0;
 }
@@ -765,18 +956,22 @@ int gecoApp::moveGecoProcess(const char* PID1, const char* PID2)
 /**
  * @brief Removes a gecoProcess from the geco process loop 
  * @param proc gecoProcess to be removed
- * The process will be removed from the geco process loop, but not be deleted
+ * The process will be removed from the geco process loop and deleted
 */
 
 void gecoApp::removeGecoProcess(gecoProcess* proc)
 {
-  gecoProcess* p=firstGecoProcess;
-  while (p->getNextGecoProcess()!=NULL)
-    {
-      if (p->getNextGecoProcess()==proc) break;
-      p=p->getNextGecoProcess();
-    }
-  p->setNextGecoProcess(proc->getNextGecoProcess());
+  int k=proc->getLoopIndex();
+  if ((k<0)||(getGecoProcess(k)!=proc)) return;
+
+  gecoProcs.erase(gecoProcs.begin()+k);
+  reindexGecoProcesses(k);
+  proc->setLoopIndex(-1);
+  Tcl_DeleteHashEntry(Tcl_FindHashEntry(&gecoProcByID, proc->getID()));
+  Tcl_DeleteHashEntry(Tcl_FindHashEntry(&gecoProcByCmd, proc->getTclCmd()));
+
+  rtLoop->publish();
+  wheel->rebuild();
   delete proc;
   Tcl_Eval(interp, "event generate . <<ProcessDeleted>>");
 }
@@ -790,13 +985,68 @@ void gecoApp::removeGecoProcess(gecoProcess* proc)
 
 gecoProcess* gecoApp::findGecoProcess(const char* PID)
 {
-  gecoProcess* p=firstGecoProcess;
-  while (p!=NULL)
-    {
-      if (strcmp(p->getID(),PID)==0) break;
-      p=p->getNextGecoProcess();
-    }
-  return p;
+  Tcl_HashEntry* entry=Tcl_FindHashEntry(&gecoProcByID, PID);
+  if (entry==NULL) return NULL;
+  return (gecoProcess *)Tcl_GetHashValue(entry);
+}
+
+
+/**
+ * @brief Finds and returns the gecoProcess in the geco process loop with Tcl command cmd
+ * @param cmd Tcl command associated to the gecoProcess
+ * \return returns a pointer to the gecoProcess or NULL if the process was not found
+*/
+
+gecoProcess* gecoApp::findGecoProcessByCmd(const char* cmd)
+{
+  Tcl_HashEntry* entry=Tcl_FindHashEntry(&gecoProcByCmd, cmd);
+  if (entry==NULL) return NULL;
+  return (gecoProcess *)Tcl_GetHashValue(entry);
+}
+
+
+/**
+ * @brief Registers a native variable
+ * @param name name of the Tcl variable linked to ptr
+ * @param ptr storage of the variable
+ *
+ * A gecoExpr reads a native variable directly from ptr. The caller
+ * remains responsible for linking ptr to the Tcl variable (Tcl_LinkVar).
+*/
+
+void gecoApp::linkNativeVar(const char* name, double* ptr)
+{
+  int isNew;
+  Tcl_SetHashValue(Tcl_CreateHashEntry(&nativeVars, name, &isNew), ptr);
+  nativeVarsEpoch++;
+}
+
+
+/**
+ * @brief Unregisters a native variable
+ * @param name name of the Tcl variable
+*/
+
+void gecoApp::unlinkNativeVar(const char* name)
+{
+  Tcl_HashEntry* entry=Tcl_FindHashEntry(&nativeVars, name);
+  if (entry==NULL) return;
+  Tcl_DeleteHashEntry(entry);
+  nativeVarsEpoch++;
+}
+
+
+/**
+ * @brief Finds a native variable
+ * @param name name of the Tcl variable
+ * \return the storage of the variable or NULL if it is not a native variable
+*/
+
+double* gecoApp::findNativeVar(const char* name)
+{
+  Tcl_HashEntry* entry=Tcl_FindHashEntry(&nativeVars, name);
+  if (entry==NULL) return NULL;
+  return (double *)Tcl_GetHashValue(entry);
 }
 
 
@@ -20,6 +20,14 @@
 // ---------------------------------------------------------------
 // 12.10.2015 Creation                         R. Wuthrich
 // 21.11.2020 Added DOxygen documentation      R. Wuthrich
+// 17.10.2026 Added real-time thread           agent
+// 17.10.2026 Added multi-rate scheduling      agent
+// 17.10.2026 Indexed process registry         agent
+// 17.10.2026 Added native variables           agent
+// 17.10.2026 Added signal bus                 agent
+// 17.10.2026 Documented binfile command       agent
+// 17.10.2026 Documented ringrecorder          agent
+// 17.10.2026 Documented replay                agent
 // ---------------------------------------------------------------
 
 #ifndef gecoApp_SEEN_
@@ -27,6 +35,7 @@
 
 #include <tcl8.6/tcl.h>
 #include <tcl8.6/tk.h>
+#include <vector>
 #include "gecoEvent.h"
 
 using namespace std;
@@ -41,6 +50,9 @@ class gecoProcess;            // forward definition
 class gecoIOModule;           // forward definition
 class gecoPkgHandle;          // forward definition
 class gecoTcpServer;          // forward definition
+class gecoRTLoop;             // forward definition
+class gecoTimerWheel;         // forward definition
+class gecoSignalBus;          // forward definition
 
 
 /**
@@ -71,8 +83,10 @@ class gecoTcpServer;          // forward definition
  * hold                | holds the event loop
  * resume              | resumes the event loop
  * ps                  | displays, in a table form, the process loop 
- * terminate processID | terminated the geco process processID
- * remove processID    | removes the geco process processID from the process loop
+ * ps -stats           | displays the execution time statistics of each process
+ * ps -resetStats      | resets the execution time statistics of each process
+ * terminate processID | terminated the geco process processID (ID or Tcl command)
+ * remove processID    | removes the geco process processID from the process loop (ID or Tcl command)
  * lsiomod             | lists loaded geco IO-modules
  * lstcpserver         | lists running TCP servers
  * loadGecoPkg         | loads a new geco package into the Tcl interpreter
@@ -116,6 +130,11 @@ class gecoTcpServer;          // forward definition
  * if the function geco_CreateGecoProcessCmd(gecoProcess* proc, int objc, Tcl_Obj *const objv[]) of 
  * the geco library is used to create a new Tcl command associated to a gecoProcess.
  *
+ * The geco process loop is stored as a contiguous registry: a vector of gecoProcess in loop order 
+ * (gecoApp::getGecoProcess) and two Tcl hash tables giving the gecoProcess from its ID 
+ * (gecoApp::findGecoProcess) or its Tcl command (gecoApp::findGecoProcessByCmd). Each gecoProcess 
+ * knows its position in the loop (gecoProcess::getLoopIndex).
+ *
  * A gecoProcess can be moved to a new position in the gecoProcess loop with the gecoApp::moveGecoProcess method.
  * The Tcl command 'ps -move', defined by gecoApp, implements this in form of a Tcl command.
  *
@@ -124,6 +143,33 @@ class gecoTcpServer;          // forward definition
  *
  * The geco process loop can be displayed in a table format with the Tcl command 'ps' defined by gecoApp.
  *
+ * Multi-rate scheduling
+ * ---------------------
+ * A gecoProcess can be run only every N-th clock tick with its '-tickDivider' subcommand. 
+ * The gecoApp keeps a gecoTimerWheel which geco_eventLoop() uses to visit only the gecoProcess 
+ * due on the current tick. Whenever the gecoEvent carries a command (e.g. 'start' or a terminated
+ * process) all gecoProcess are visited, so that their life cycle is not delayed by their tick divider.
+ *
+ * Real-time thread
+ * ----------------
+ * The gecoApp creates during its construction a gecoRTLoop. The Tcl command 'rtloop' allows to 
+ * manipulate it. When started, it runs the gecoProcess in '-realtime' mode on a dedicated thread 
+ * (see gecoRTLoop). The gecoApp publishes any change of the geco process loop to the gecoRTLoop.
+ *
+ * Native variables
+ * ----------------
+ * C++ variables linked to a Tcl variable (e.g. the time $t of the gecoEvent) can in addition
+ * be registered as native variables with gecoApp::linkNativeVar. A gecoExpr reads a native 
+ * variable directly from its storage instead of going through the Tcl interpreter. A native
+ * variable must be unregistered with gecoApp::unlinkNativeVar before its storage is freed.
+ *
+ * Signal bus
+ * ----------
+ * The gecoApp creates during its construction a gecoSignalBus. The Tcl command 'signals' allows
+ * to manipulate it. It holds typed numeric signals (double, int or bool) addressable by name, 
+ * which gecoProcess and gecoIOModule read and write directly. Each signal is mirrored to the Tcl
+ * variable of the same name, whose write traces are fired once per pass of the geco process loop.
+ *
  * Geco processes
  * --------------
  *
@@ -138,12 +184,18 @@ class gecoTcpServer;          // forward definition
  * gecoGraph      | graph
  * gecoFileStream | filestream
  * gecoMemStream  | memstream
+ * gecoRingRecorder | ringrecorder
+ * gecoReplay     | replay
  * gecoTriangle   | triangle
  * gecoSawtooth   | sawtooth
  * gecoStep       | step
  * gecoPulse      | pulse
  * gecoEnd        | end
  *
+ * The binary data files written by gecoFileStream are read with the Tcl command 'binfile' (see gecoBinFile).
+ * The ring files written by gecoRingRecorder are recovered with the Tcl command 'ringfile'.
+ * The files written by gecoFileStream and gecoMemStream are played back by gecoReplay.
+ *
  * Geco IO-modules
  * ---------------
  * The gecoApp keeps trace of loaded gecoIOModule in an internal list. A new gecoIOModule must be registered 
@@ -209,16 +261,26 @@ protected:
 
   Tcl_Interp*     interp;                /*!< Tcl interpreter run by gecoApp */
 
-  gecoProcess*    firstGecoProcess;      /*!< Start of the geco process loop */
+  vector<gecoProcess*> gecoProcs;        /*!< geco process loop in loop order */
+  Tcl_HashTable   gecoProcByID;          /*!< gecoProcess of the geco process loop by ID */
+  Tcl_HashTable   gecoProcByCmd;         /*!< gecoProcess of the geco process loop by Tcl command */
   gecoIOModule*   firstGecoIOModule;     /*!< Start of the internal list of loaded gecoIOModule */
   gecoPkgHandle*  firstGecoPkgHandle;    /*!< Start of the internal list of loaded gecoPkgHandle */
   gecoTcpServer*  firstGecoTcpServer;    /*!< Start of the internal list of running gecoTcpServer */
   gecoEvent*      event;                 /*!< gecoEvent of the geco event loop */
+  gecoRTLoop*     rtLoop;                /*!< real-time thread of the geco process loop */
+  gecoSignalBus*  signalBus;             /*!< typed numeric signals of the gecoApp */
+  gecoTimerWheel* wheel;                 /*!< multi-rate scheduler of the geco process loop */
+  vector<gecoProcess*> dueProcesses;     /*!< gecoProcess due on the current tick */
+  Tcl_HashTable   nativeVars;            /*!< storage of the native variables by name */
+  unsigned long   nativeVarsEpoch;       /*!< incremented at each change of the native variables */
 
   char*           commentStr;            /*!< Needed for internal purposes */
 
   void registerNewCmd();
   void registerGlobalVars();
+  void registerGecoProcess(gecoProcess* proc);
+  void reindexGecoProcesses(int from);
 
 
 public:
@@ -226,11 +288,15 @@ public:
   gecoApp(int argc, char **argv);
   ~gecoApp();
 
-  gecoProcess*   getFirstGecoProcess() {return firstGecoProcess;}  /*!< Returns first gecoProcess from the geco event loop */
+  gecoProcess*   getFirstGecoProcess() {return getGecoProcess(0);}  /*!< Returns first gecoProcess from the geco event loop */
+  gecoProcess*   getGecoProcess(int index) 
+                   {return ((index>=0)&&(index<(int)gecoProcs.size())) ? gecoProcs[index] : NULL;} /*!< Returns the gecoProcess at position index in the geco process loop */
+  int            getNbrGecoProcesses() {return gecoProcs.size();}  /*!< Returns the number of gecoProcess in the geco process loop */
   void           addGecoProcess(gecoProcess* proc);  
   int            moveGecoProcess(const char* PID1, const char* PID2);
   void           removeGecoProcess(gecoProcess* proc);
   gecoProcess*   findGecoProcess(const char* PID);
+  gecoProcess*   findGecoProcessByCmd(const char* cmd);
 
   gecoIOModule*  getFirstGecoIOModule() {return firstGecoIOModule;} /*!< Returns first gecoIOModule loaded in the gecoApp */
   void           addGecoIOModule(gecoIOModule* mod);  
@@ -247,8 +313,16 @@ public:
   void           removeGecoTcpServer(gecoTcpServer* srv);
   int            gecoServerExist(gecoTcpServer* srv);
 
+  void           linkNativeVar(const char* name, double* ptr);
+  void           unlinkNativeVar(const char* name);
+  double*        findNativeVar(const char* name);
+  unsigned long  getNativeVarsEpoch() {return nativeVarsEpoch;} /*!< Returns the number of changes of the native variables */
+
   gecoEvent*     getEvent()  {return event;}  /*!< Returns the gecoEvent of the geco event loop run by the gecoApp */
   Tcl_Interp*    getInterp() {return interp;} /*!< Returns the Tcl interpreter run by the gecoApp */
+  gecoRTLoop*    getRTLoop() {return rtLoop;} /*!< Returns the real-time thread of the geco process loop */
+  gecoSignalBus* getSignalBus() {return signalBus;} /*!< Returns the typed numeric signals of the gecoApp */
+  gecoTimerWheel* getTimerWheel() {return wheel;} /*!< Returns the multi-rate scheduler of the geco process loop */
 
   void run();
   void runCLI();
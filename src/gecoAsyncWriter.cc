@@ -0,0 +1,620 @@
+// ---------------------------------------------------------------
+//
+// Definition of the class gecoAsyncWriter
+//
+// (c) Rolf Wuthrich
+//     2026 Concordia University
+//
+// author:  agent
+// email:   agent@local
+// version: v1
+//
+// This software is copyright under the BSD license
+//
+// ---------------------------------------------------------------
+// history:
+// ---------------------------------------------------------------
+// Date       Modification                     Author
+// ---------------------------------------------------------------
+// 17.10.2026 Creation                         agent
+// 17.10.2026 Added rotation of the file       agent
+// 18.10.2026 Header written by the writer     agent
+//
+// ---------------------------------------------------------------
+
+#include <cstring>
+#include <cerrno>
+#include <cstdio>
+#include <vector>
+#include <tcl8.6/tcl.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/uio.h>
+#include <pthread.h>
+#include "gecoAsyncWriter.h"
+
+using namespace std;
+
+
+// ---------------------------------------------------------------
+//
+// Durability and overflow policies
+//
+
+const char* DurabilityStr[] = {"none", "flush", "sync", NULL};
+const char* OverflowStr[]   = {"drop", "block", NULL};
+
+static const size_t AsyncBatch   = 65536;   // pending bytes waking up the writer thread
+static const int    AsyncMaxWait = 10;      // max time (ms) the writer thread sleeps
+static const size_t GzipChunk    = 262144;  // bytes read at once by the gzip thread
+
+
+// ---------------------------------------------------------------
+//
+// Auxiliary functions
+//
+
+static long long monotonicTime()
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (long long)ts.tv_sec*1000000000LL + ts.tv_nsec;
+}
+
+
+// ---------------------------------------------------------------
+//
+// Writer thread
+//
+
+/**
+ * @brief Body of the writer thread of a gecoAsyncWriter
+ *
+ * Sleeps until a batch or a switch of file is pending or the next deadline of
+ * the durability policy, then drains the ring buffer to the file.
+*/
+
+void* geco_AsyncWriterThread(void* arg)
+{
+  gecoAsyncWriter* w=(gecoAsyncWriter *)arg;
+  long long period=(long long)((w->interval<1) ? 1 : w->interval)*1000000LL;
+  long long next=monotonicTime()+period;
+  bool      dirty=false;
+
+  while (true)
+    {
+      long long now=monotonicTime();
+      long long wake=now+AsyncMaxWait*1000000LL;
+      if ((w->durability!=Durability_none)&&(next<wake)) wake=next;
+
+      pthread_mutex_lock(&w->mutex);
+      if ((!w->stopRequest.load())&&(w->head.load()-w->tail.load()<w->batch)&&(wake>now)
+	  &&(w->switches.empty()))
+	{
+	  struct timespec ts;
+	  ts.tv_sec  = wake/1000000000LL;
+	  ts.tv_nsec = wake%1000000000LL;
+	  pthread_cond_timedwait(&w->cond, &w->mutex, &ts);
+	}
+      bool rotation=!w->switches.empty();
+      pthread_mutex_unlock(&w->mutex);
+
+      bool stop=w->stopRequest.load();
+      now=monotonicTime();
+      bool deadline=(w->durability!=Durability_none)&&(now>=next);
+      size_t pending=w->head.load(memory_order_acquire)-w->tail.load();
+
+      if ((pending>=w->batch)||(deadline)||(stop)||(rotation))
+	{
+	  if (pending>0) dirty=true;
+	  w->drain();
+	}
+
+      if (deadline)
+	{
+	  if ((w->durability==Durability_sync)&&(dirty)&&(w->error.load()==0))
+	    {
+	      if (fdatasync(w->fd)!=0) w->error.store(errno);
+	      w->syncs++;
+	    }
+	  dirty=false;
+	  next=now+period;
+	}
+
+      if ((stop)&&(w->head.load()==w->tail.load())) break;
+    }
+
+  if ((w->durability==Durability_sync)&&(dirty)&&(w->error.load()==0))
+    {
+      if (fdatasync(w->fd)!=0) w->error.store(errno);
+      w->syncs++;
+    }
+  return NULL;
+}
+
+
+// ---------------------------------------------------------------
+//
+// Gzip thread
+//
+
+struct gecoGzipJob
+{
+  gecoAsyncWriter* writer;
+  string           file;
+};
+
+
+/**
+ * @brief Body of a thread compressing a file closed by a rotation
+ *
+ * Writes file.gz (through file.gz.tmp) with the zlib of Tcl and removes the
+ * file once done. In case of error, the file is kept.
+*/
+
+void* geco_GzipThread(void* arg)
+{
+  gecoGzipJob*     job=(gecoGzipJob *)arg;
+  gecoAsyncWriter* w=job->writer;
+  string           gz=job->file+".gz";
+  string           tmp=gz+".tmp";
+  int              err=0;
+
+  FILE* in=fopen(job->file.c_str(), "rb");
+  FILE* out=(in) ? fopen(tmp.c_str(), "wb") : NULL;
+  Tcl_ZlibStream zs=NULL;
+  if ((!in)||(!out)||(Tcl_ZlibStreamInit(NULL, TCL_ZLIB_STREAM_DEFLATE, TCL_ZLIB_FORMAT_GZIP,
+					 6, NULL, &zs)!=TCL_OK))
+    err=(errno!=0) ? errno : EIO;
+
+  if (err==0)
+    {
+      vector<unsigned char> buf(GzipChunk);
+      Tcl_Obj* data=Tcl_NewObj();
+      Tcl_IncrRefCount(data);
+      bool eof=false;
+      while ((!eof)&&(err==0))
+	{
+	  size_t n=fread(&buf[0], 1, GzipChunk, in);
+	  eof=(n<GzipChunk);
+	  if ((eof)&&(ferror(in))) err=EIO;
+	  Tcl_Obj* chunk=Tcl_NewByteArrayObj(&buf[0], n);
+	  Tcl_IncrRefCount(chunk);
+	  if (Tcl_ZlibStreamPut(zs, chunk, (eof) ? TCL_ZLIB_FINALIZE : TCL_ZLIB_NO_FLUSH)!=TCL_OK) err=EIO;
+	  Tcl_DecrRefCount(chunk);
+	  while ((err==0)&&(Tcl_ZlibStreamGet(zs, data, -1)==TCL_OK))
+	    {
+	      int len;
+	      unsigned char* bytes=Tcl_GetByteArrayFromObj(data, &len);
+	      if (len==0) break;
+	      if (fwrite(bytes, 1, len, out)!=(size_t)len) err=errno;
+	      Tcl_SetByteArrayLength(data, 0);
+	    }
+	}
+      Tcl_DecrRefCount(data);
+    }
+
+  if (zs) Tcl_ZlibStreamClose(zs);
+  if (in) fclose(in);
+  if ((out)&&(fclose(out)!=0)&&(err==0)) err=errno;
+  if ((err==0)&&(rename(tmp.c_str(), gz.c_str())!=0)) err=errno;
+  if (err==0)
+    unlink(job->file.c_str());
+  else
+    {
+      unlink(tmp.c_str());
+      w->gzipError.store(err);
+    }
+
+  delete job;
+  Tcl_FinalizeThread();
+  w->gzipRunning--;
+  return NULL;
+}
+
+
+// ---------------------------------------------------------------
+//
+// class gecoAsyncWriter : file written by a background thread
+//
+
+
+/**
+ * @brief Constructor
+*/
+
+gecoAsyncWriter::gecoAsyncWriter() :
+  buffer(NULL),
+  capacity(0),
+  head(0),
+  tail(0),
+  batch(AsyncBatch),
+  fd(-1),
+  durability(Durability_flush),
+  interval(100),
+  overflow(Overflow_drop),
+  running(false),
+  stopRequest(false),
+  records(0),
+  dropped(0),
+  late(0),
+  bytes(0),
+  syncs(0),
+  maxFill(0),
+  error(0),
+  segments(0),
+  gzipRunning(0),
+  gzipError(0)
+{
+  pthread_condattr_t attr;
+  pthread_condattr_init(&attr);
+  pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+  pthread_cond_init(&cond, &attr);
+  pthread_condattr_destroy(&attr);
+  pthread_mutex_init(&mutex, NULL);
+}
+
+
+/**
+ * @brief Destructor
+ *
+ * Closes the file if open.
+*/
+
+gecoAsyncWriter::~gecoAsyncWriter()
+{
+  close();
+  struct timespec ts = {0, 1000000};
+  while (gzipRunning.load()>0) nanosleep(&ts, NULL);
+  pthread_cond_destroy(&cond);
+  pthread_mutex_destroy(&mutex);
+}
+
+
+/**
+ * @brief Opens (truncates) a file and starts the writer thread
+ * @param fileName name of the file
+ * @param bufferSize size of the ring buffer (bytes, rounded up to a power of 2)
+ * @param Durability durability policy (Durability_none, Durability_flush or Durability_sync)
+ * @param Interval interval of the durability policy (ms)
+ * @param Overflow overflow policy (Overflow_drop or Overflow_block)
+ * @param header data written at the start of the file (not counted as a record)
+ * @param headerLen length of header
+ * \return 0 in case of success and an errno otherwise
+ *
+ * The counters are reset.
+*/
+
+int gecoAsyncWriter::open(const char* fileName, size_t bufferSize, int Durability, int Interval, int Overflow,
+			  const char* header, size_t headerLen)
+{
+  close();
+
+  capacity=4096;
+  while ((capacity<bufferSize)||(capacity<2*headerLen)) capacity*=2;
+  batch = (AsyncBatch<capacity/2) ? AsyncBatch : capacity/2;
+  durability=Durability;
+  interval=Interval;
+  overflow=Overflow;
+  head.store(0);
+  tail.store(0);
+  records.store(0);
+  dropped.store(0);
+  late.store(0);
+  bytes.store(0);
+  syncs.store(0);
+  maxFill.store(0);
+  error.store(0);
+  segments.store(0);
+  gzipError.store(0);
+  stopRequest.store(false);
+  switches.clear();
+
+  fd=::open(fileName, O_WRONLY|O_CREAT|O_TRUNC, 0644);
+  if (fd<0) return errno;
+  currentFile=fileName;
+
+  buffer=new char[capacity];
+  if (headerLen>0) memcpy(buffer, header, headerLen);
+  head.store(headerLen);
+  running.store(true);
+  int ret=pthread_create(&thread, NULL, geco_AsyncWriterThread, this);
+  if (ret!=0)
+    {
+      running.store(false);
+      ::close(fd);
+      fd=-1;
+      delete[] buffer;
+      buffer=NULL;
+      return ret;
+    }
+  return 0;
+}
+
+
+/**
+ * @brief Writes all pending records, stops the writer thread and closes the file
+ * \return 0 in case of success and the errno of the first write error otherwise
+*/
+
+int gecoAsyncWriter::close()
+{
+  if (!running.load()) return error.load();
+
+  pthread_mutex_lock(&mutex);
+  stopRequest.store(true);
+  pthread_cond_signal(&cond);
+  pthread_mutex_unlock(&mutex);
+  pthread_join(thread, NULL);
+  running.store(false);
+
+  if ((::close(fd)!=0)&&(error.load()==0)) error.store(errno);
+  fd=-1;
+  delete[] buffer;
+  buffer=NULL;
+  return error.load();
+}
+
+
+/**
+ * @brief Copies a record made of two parts into the ring buffer
+ * @param a first part of the record
+ * @param la length of a
+ * @param b second part of the record (or NULL)
+ * @param lb length of b
+ * @param header true for the trailer of a file (never dropped for lack of space, not counted)
+ * \return true if the record was accepted and false if it was dropped
+ *
+ * Must only be called by the producer thread.
+*/
+
+bool gecoAsyncWriter::push(const char* a, size_t la, const char* b, size_t lb, bool header)
+{
+  size_t len=la+lb;
+  if ((!running.load())||(len>capacity))
+    {
+      dropped++;
+      return false;
+    }
+
+  size_t h=head.load(memory_order_relaxed);
+  if (capacity-(h-tail.load(memory_order_acquire))<len)
+    {
+      if (((overflow==Overflow_drop)&&(!header))||(error.load()!=0))
+	{
+	  dropped++;
+	  return false;
+	}
+
+      // waits for the writer thread
+      if (!header) late++;
+      pthread_cond_signal(&cond);
+      struct timespec ts = {0, 20000};
+      while (capacity-(h-tail.load(memory_order_acquire))<len)
+	{
+	  if (error.load()!=0)
+	    {
+	      dropped++;
+	      return false;
+	    }
+	  nanosleep(&ts, NULL);
+	}
+    }
+
+  size_t pos=h & (capacity-1);
+  size_t n=(la<capacity-pos) ? la : capacity-pos;
+  memcpy(buffer+pos, a, n);
+  memcpy(buffer, a+n, la-n);
+  if (lb>0)
+    {
+      pos=(h+la) & (capacity-1);
+      n=(lb<capacity-pos) ? lb : capacity-pos;
+      memcpy(buffer+pos, b, n);
+      memcpy(buffer, b+n, lb-n);
+    }
+  head.store(h+len, memory_order_release);
+  if (!header) records++;
+
+  size_t fill=h+len-tail.load(memory_order_relaxed);
+  if (fill>maxFill.load(memory_order_relaxed)) maxFill.store(fill, memory_order_relaxed);
+  if ((fill>=batch)&&(fill-len<batch)) pthread_cond_signal(&cond);
+  return true;
+}
+
+
+/**
+ * @brief Switches to a new file at the next record
+ * @param fileName name of the new file (truncated)
+ * @param header data written at the start of the new file (not counted as a record)
+ * @param headerLen length of header
+ * @param gzip true to compress the previous file once closed
+ * \return false if the file is not open
+ *
+ * Must only be called by the producer thread, between two records. The writer
+ * thread closes the current file, opens the new one, writes its header and starts
+ * the compression. The header is carried by the switch, not by the ring buffer,
+ * so that the producer never waits for space.
+*/
+
+bool gecoAsyncWriter::rotate(const char* fileName, const char* header, size_t headerLen, bool gzip)
+{
+  if (!running.load()) return false;
+  gecoWriterSwitch s;
+  s.pos=head.load(memory_order_relaxed);
+  s.file=fileName;
+  s.gzip=gzip;
+  if (headerLen>0) s.header.assign(header, headerLen);
+  pthread_mutex_lock(&mutex);
+  switches.push_back(s);
+  pthread_cond_signal(&cond);
+  pthread_mutex_unlock(&mutex);
+  return true;
+}
+
+
+/**
+ * @brief (Re)writes a text file once the data queued so far are written
+ * @param fileName name of the file
+ * @param text content of the file
+ *
+ * The file is written by the writer thread through a temporary file renamed
+ * in place, so that readers never see a partial file.
+*/
+
+void gecoAsyncWriter::writeManifest(const char* fileName, const char* text)
+{
+  if (!running.load()) return;
+  gecoWriterSwitch s;
+  s.pos=head.load(memory_order_relaxed);
+  s.gzip=false;
+  s.manifest=fileName;
+  s.text=text;
+  pthread_mutex_lock(&mutex);
+  switches.push_back(s);
+  pthread_cond_signal(&cond);
+  pthread_mutex_unlock(&mutex);
+}
+
+
+/**
+ * @brief Applies a switch of file or of manifest
+ *
+ * Called by the writer thread once all data before the switch are written.
+*/
+
+void gecoAsyncWriter::applySwitch(gecoWriterSwitch& s)
+{
+  if (!s.file.empty())
+    {
+      if ((durability==Durability_sync)&&(error.load()==0))
+	{
+	  if (fdatasync(fd)!=0) error.store(errno);
+	  syncs++;
+	}
+      if ((::close(fd)!=0)&&(error.load()==0)) error.store(errno);
+      if ((s.gzip)&&(error.load()==0))
+	{
+	  gecoGzipJob* job=new gecoGzipJob;
+	  job->writer=this;
+	  job->file=currentFile;
+	  pthread_t      gz;
+	  pthread_attr_t attr;
+	  pthread_attr_init(&attr);
+	  pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+	  gzipRunning++;
+	  int ret=pthread_create(&gz, &attr, geco_GzipThread, job);
+	  pthread_attr_destroy(&attr);
+	  if (ret!=0)
+	    {
+	      gzipRunning--;
+	      gzipError.store(ret);
+	      delete job;
+	    }
+	}
+      fd=::open(s.file.c_str(), O_WRONLY|O_CREAT|O_TRUNC, 0644);
+      if ((fd<0)&&(error.load()==0)) error.store(errno);
+      currentFile=s.file;
+      segments++;
+
+      // header of the new file
+      size_t done=0;
+      while ((done<s.header.size())&&(error.load()==0))
+	{
+	  ssize_t w=::write(fd, s.header.data()+done, s.header.size()-done);
+	  if (w<0)
+	    {
+	      if (errno!=EINTR) error.store(errno);
+	      continue;
+	    }
+	  done+=w;
+	  bytes+=w;
+	}
+    }
+
+  if (!s.manifest.empty())
+    {
+      string tmp=s.manifest+".tmp";
+      FILE*  f=fopen(tmp.c_str(), "w");
+      if (f)
+	{
+	  fputs(s.text.c_str(), f);
+	  if (fclose(f)==0) rename(tmp.c_str(), s.manifest.c_str());
+	}
+    }
+}
+
+
+/**
+ * @brief Writes the bytes of the ring buffer between t and h to the file
+ *
+ * Called by the writer thread. After a write error, the bytes are discarded
+ * so that the producer never waits forever.
+*/
+
+void gecoAsyncWriter::writeRange(size_t& t, size_t h)
+{
+  while (t<h)
+    {
+      if (error.load()!=0)
+	{
+	  t=h;
+	  break;
+	}
+      size_t pos=t & (capacity-1);
+      size_t n=h-t;
+      struct iovec iov[2];
+      int niov=1;
+      iov[0].iov_base=buffer+pos;
+      iov[0].iov_len=(n<capacity-pos) ? n : capacity-pos;
+      if (iov[0].iov_len<n)
+	{
+	  iov[1].iov_base=buffer;
+	  iov[1].iov_len=n-iov[0].iov_len;
+	  niov=2;
+	}
+      ssize_t w=writev(fd, iov, niov);
+      if (w<0)
+	{
+	  if (errno==EINTR) continue;
+	  error.store(errno);
+	  continue;
+	}
+      t+=w;
+      bytes+=w;
+      tail.store(t, memory_order_release);
+    }
+  tail.store(t, memory_order_release);
+}
+
+
+/**
+ * @brief Writes all pending bytes of the ring buffer to the file
+ *
+ * Called by the writer thread. The pending switches are applied at their
+ * position in the data.
+*/
+
+void gecoAsyncWriter::drain()
+{
+  size_t h=head.load(memory_order_acquire);
+  size_t t=tail.load(memory_order_relaxed);
+
+  while (true)
+    {
+      gecoWriterSwitch s;
+      bool found=false;
+      pthread_mutex_lock(&mutex);
+      if ((!switches.empty())&&(switches.front().pos<=h))
+	{
+	  s=switches.front();
+	  switches.pop_front();
+	  found=true;
+	}
+      pthread_mutex_unlock(&mutex);
+      if (!found) break;
+      writeRange(t, s.pos);
+      applySwitch(s);
+    }
+  writeRange(t, h);
+}
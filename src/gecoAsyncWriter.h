@@ -0,0 +1,199 @@
+// This may look like C code, but it is really -*- C++ -*-
+// ----------------------------------------------------------------
+//
+// Header file for class gecoAsyncWriter
+//
+// (c) Rolf Wuthrich
+//     2026 Concordia University
+//
+// author:  agent
+// email:   agent@local
+// version: v1
+//
+// This software is copyright under the BSD license
+//
+// ---------------------------------------------------------------
+// history:
+// ---------------------------------------------------------------
+// Date       Modification                     Author
+// ---------------------------------------------------------------
+// 17.10.2026 Creation                         agent
+// 17.10.2026 Added rotation of the file       agent
+// 18.10.2026 Added writeTrailer               agent
+// 18.10.2026 Header carried by the switch     agent
+//
+// ---------------------------------------------------------------
+/*! \file */
+
+#ifndef gecoAsyncWriter_SEEN_
+#define gecoAsyncWriter_SEEN_
+
+#include <stddef.h>
+#include <pthread.h>
+#include <atomic>
+#include <deque>
+#include <string>
+
+using namespace std;
+
+
+// ------------------------------------------------------------------------
+//
+// Durability and overflow policies
+//
+
+const int
+  Durability_none  = 0,       // data written when a batch is full or on close
+  Durability_flush = 1,       // data written to the file every interval
+  Durability_sync  = 2;       // data written and fdatasync every interval
+
+const int
+  Overflow_drop    = 0,       // records not fitting in the buffer are dropped
+  Overflow_block   = 1;       // the producer waits until the record fits
+
+extern const char* DurabilityStr[];
+extern const char* OverflowStr[];
+
+
+void* geco_AsyncWriterThread(void* arg);
+void* geco_GzipThread(void* arg);
+
+
+// ------------------------------------------------------------------------
+//
+// Change of file or of manifest at a position of the data
+//
+
+struct gecoWriterSwitch
+{
+  size_t              pos;          // position in the data (total bytes)
+  string              file;         // new file (empty to keep the file)
+  bool                gzip;         // compresses the previous file
+  string              header;       // header of the new file
+  string              manifest;     // manifest file (empty for none)
+  string              text;         // content of the manifest
+};
+
+
+// -----------------------------------------------------------------------
+//
+// class gecoAsyncWriter : file written by a background thread
+//
+
+/**
+ * @brief File written by a background thread through a lock-free ring buffer
+ * \author agent
+ * \date 2026
+ *
+ * A gecoAsyncWriter hands records from a producer (typically the geco process
+ * loop) to a writer thread through a preallocated single-producer single-consumer
+ * ring buffer. The producer only copies the record into the buffer and never
+ * waits on the file system. The writer thread drains the buffer with large
+ * batched writes.
+ *
+ * The durability policy defines when the data reach the file:
+ *
+ * Policy  | Behaviour
+ * ------- | ------------------------------------------------------
+ * none    | data written once a batch is full and on close
+ * flush   | data written at least every interval (survives a crash of the process)
+ * sync    | data written and fdatasync at least every interval (survives a power loss)
+ *
+ * The overflow policy defines what happens when a record does not fit in the
+ * buffer because the file system is too slow:
+ *
+ * Policy  | Behaviour
+ * ------- | ------------------------------------------------------
+ * drop    | the record is dropped and counted
+ * block   | the producer waits until the record fits; the record is counted as late
+ *
+ * A record is never split in the buffer: it is either fully accepted or dropped.
+ * The counters are atomic and can be read by any thread.
+ *
+ * Rotation
+ * --------
+ * gecoAsyncWriter::rotate switches to a new file between two records, without
+ * stopping the producer: the switch is queued at the current position of the
+ * data and the writer thread closes the current file, opens the new one and
+ * continues with its header. The previous file can be compressed to gzip format
+ * (with the zlib of Tcl) by a further background thread, which replaces it by
+ * its .gz once done. gecoAsyncWriter::writeManifest (re)writes a small text
+ * file atomically (through a temporary file) from the writer thread as well.
+ */
+
+class gecoAsyncWriter
+{
+
+private:
+
+  char*               buffer;       // ring buffer
+  size_t              capacity;     // size of the ring buffer (power of 2)
+  atomic<size_t>      head;         // total bytes written by the producer
+  atomic<size_t>      tail;         // total bytes consumed by the writer thread
+  size_t              batch;        // pending bytes waking up the writer thread
+
+  int                 fd;           // file descriptor
+  int                 durability;   // durability policy
+  int                 interval;     // interval of the durability policy (ms)
+  int                 overflow;     // overflow policy
+
+  pthread_t           thread;
+  pthread_mutex_t     mutex;
+  pthread_cond_t      cond;
+  atomic<bool>        running;      // writer thread is running
+  atomic<bool>        stopRequest;  // asks the writer thread to stop
+
+  // statistics
+  atomic<long long>   records;      // accepted records
+  atomic<long long>   dropped;      // dropped records
+  atomic<long long>   late;         // records which had to wait for space
+  atomic<long long>   bytes;        // bytes written to the file
+  atomic<long long>   syncs;        // number of fdatasync
+  atomic<size_t>      maxFill;      // max fill of the ring buffer (bytes)
+  atomic<int>         error;        // errno of the first write error (0 if none)
+
+  // rotation
+  deque<gecoWriterSwitch> switches; // pending switches (protected by mutex)
+  string              currentFile;  // file being written (writer thread)
+  atomic<long long>   segments;     // files opened by rotation
+  atomic<int>         gzipRunning;  // running compressions
+  atomic<int>         gzipError;    // errno of the last failed compression (0 if none)
+
+  bool                push(const char* a, size_t la, const char* b, size_t lb, bool header=false);
+  void                drain();
+  void                writeRange(size_t& t, size_t h);
+  void                applySwitch(gecoWriterSwitch& s);
+
+  friend void*        geco_AsyncWriterThread(void* arg);
+  friend void*        geco_GzipThread(void* arg);
+
+public:
+
+  gecoAsyncWriter();
+  ~gecoAsyncWriter();
+
+  int          open(const char* fileName, size_t bufferSize, int Durability, int Interval, int Overflow,
+		    const char* header = NULL, size_t headerLen = 0);
+  int          close();
+  bool         isOpen() {return running.load();}   /*!< Returns true if the file is open */
+
+  bool         write(const char* data, size_t len) {return push(data, len, NULL, 0);}  /*!< Queues a record */
+  bool         writeLine(const char* data, size_t len) {return push(data, len, "\n", 1);}  /*!< Queues a record followed by a newline */
+  bool         writeTrailer(const char* data, size_t len) {return push(data, len, NULL, 0, true);}  /*!< Queues the trailer of the file (not counted as record) */
+  bool         rotate(const char* fileName, const char* header, size_t headerLen, bool gzip);
+  void         writeManifest(const char* fileName, const char* text);
+
+  long long    getRecords()  {return records.load();}  /*!< Returns the number of accepted records */
+  long long    getDropped()  {return dropped.load();}  /*!< Returns the number of dropped records */
+  long long    getLate()     {return late.load();}     /*!< Returns the number of records which had to wait for space */
+  long long    getBytes()    {return bytes.load();}    /*!< Returns the number of bytes written to the file */
+  long long    getSyncs()    {return syncs.load();}    /*!< Returns the number of fdatasync */
+  size_t       getMaxFill()  {return maxFill.load();}  /*!< Returns the max fill of the ring buffer (bytes) */
+  size_t       getCapacity() {return capacity;}        /*!< Returns the size of the ring buffer (bytes) */
+  int          getError()    {return error.load();}    /*!< Returns the errno of the first write error (0 if none) */
+  long long    getSegments() {return segments.load();} /*!< Returns the number of files opened by rotation */
+  int          getGzipRunning() {return gzipRunning.load();} /*!< Returns the number of running compressions */
+  int          getGzipError() {return gzipError.load();} /*!< Returns the errno of the last failed compression (0 if none) */
+};
+
+#endif /* gecoAsyncWriter_SEEN_ */
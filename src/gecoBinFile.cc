@@ -0,0 +1,1096 @@
+// ---------------------------------------------------------------
+//
+// Definition of the class gecoBinFile
+//
+// (c) Rolf Wuthrich
+//     2026 Concordia University
+//
+// author:  agent
+// email:   agent@local
+// version: v1
+//
+// This software is copyright under the BSD license
+//
+// ---------------------------------------------------------------
+// history:
+// ---------------------------------------------------------------
+// Date       Modification                     Author
+// ---------------------------------------------------------------
+// 17.10.2026 Creation                         agent
+// 17.10.2026 Header built into a buffer       agent
+// 17.10.2026 Added compressed encoding        agent
+// 17.10.2026 Added time-indexed queries       agent
+// 17.10.2026 Added getDouble                  agent
+// 18.10.2026 Bounded header length            agent
+// 18.10.2026 Block index kept in a trailer     agent
+//
+// ---------------------------------------------------------------
+
+#include <tcl.h>
+#include <cstring>
+#include <climits>
+#include <sys/types.h>
+#include "gecoBinFile.h"
+#include "gecoBlockCodec.h"
+#include "gecoTimeQuery.h"
+#include "gecoHelp.h"
+
+using namespace std;
+
+
+// ---------------------------------------------------------------
+//
+// Types of columns
+//
+
+const char* BinColTypeStr[] = {"timestamp", "double", "float", "int", "wide", NULL};
+const int   BinColSize[]    = {8, 8, 4, 4, 8};
+
+static const char BinMagic[] = "GECOBIN1";
+static const int  BinVersion = 2;     // version 1 for uncompressed files
+static const unsigned long BinMaxHeader = 1<<24;   // bound of the header length read from a file
+static const char BinIndexMagic[] = "GECOIDX1";
+static const unsigned long BinMaxIndex = 1<<26;    // bound of the trailer length read from a file
+static const int  BinChunk   = 4096;     // records read at once
+
+// returns the value of key in dict or NULL
+static Tcl_Obj* dictGet(Tcl_Obj* dict, const char* key)
+{
+  Tcl_Obj* val=NULL;
+  Tcl_Obj* k=Tcl_NewStringObj(key, -1);
+  Tcl_IncrRefCount(k);
+  Tcl_DictObjGet(NULL, dict, k, &val);
+  Tcl_DecrRefCount(k);
+  return val;
+}
+
+
+// -------------------------------------------------------------------------
+//
+// Tcl interface
+//
+
+// opens a binary data file and reads its header
+static FILE* openBinFile(Tcl_Interp* interp, const char* fileName, gecoBinFile* bin)
+{
+  FILE* file=fopen(fileName, "rb");
+  if (file==NULL)
+    {
+      Tcl_AppendResult(interp, "couldn't open \"", fileName, "\": ",
+		       Tcl_PosixError(interp), NULL);
+      return NULL;
+    }
+  if (bin->readHeader(interp, file)!=TCL_OK)
+    {
+      fclose(file);
+      return NULL;
+    }
+  return file;
+}
+
+// reads block k of a compressed file; returns false if its header doesn't match
+// the sparse time index or if the block doesn't fit before the next one
+static bool readBlock(FILE* file, gecoBinFile* bin, size_t k, vector<char>& block)
+{
+  vector<gecoBinBlock>& blocks=bin->getBlocks();
+  gecoBinBlock&         b=blocks[k];
+  off_t                 end;
+  if (k+1<blocks.size())
+    end=blocks[k+1].offset;
+  else if ((fseeko(file, 0, SEEK_END)!=0)||((end=ftello(file))<0))
+    return false;
+
+  block.resize(16);
+  if ((fseeko(file, b.offset, SEEK_SET)!=0)||(fread(&block[0], 1, 16, file)!=16))
+    return false;
+  size_t size=gecoBlockDecoder::getSize(&block[0]);
+  if ((size<16)||((off_t)size>end-b.offset)||
+      (b.records<1)||(b.records>BlockMaxRecords)||
+      (gecoBlockDecoder::getRecords(&block[0])!=b.records))
+    return false;
+  block.resize(size);
+  return (fread(&block[16], 1, size-16, file)==size-16);
+}
+
+// reads the records of a file in order; of a compressed file,
+// only the blocks holding the records read are decoded
+struct recordCursor
+{
+  FILE*         file;
+  gecoBinFile*  bin;
+  vector<char>  buf;        // records read or decoded
+  vector<char>  block;      // compressed block
+  size_t        next;       // next block to decode
+  long long     skip;       // records to skip in the next block decoded
+  const char*   cur;        // next record of a decoded block
+  long long     left;       // records of the decoded block not read yet
+  bool          corrupted;  // a block couldn't be decoded
+
+  recordCursor(FILE* File, gecoBinFile* Bin) :
+    file(File), bin(Bin), next(0), skip(0), cur(NULL), left(0), corrupted(false) {}
+
+  // positions the cursor on record first
+  void seek(long long first)
+  {
+    left=0;
+    if (bin->getEncoding()==Encoding_none)
+      {
+	fseeko(file, bin->getDataOffset()+(off_t)first*bin->getRecordSize(), SEEK_SET);
+	return;
+      }
+    vector<gecoBinBlock>& blocks=bin->getBlocks();
+    next=0;
+    while ((next<blocks.size())&&(first>=blocks[next].records))
+      first-=blocks[next++].records;
+    skip=first;
+  }
+
+  // reads at most max records; returns their number (0 at the end) and sets recs on the first
+  long long read(long long max, const char** recs)
+  {
+    int rs=bin->getRecordSize();
+    if (bin->getEncoding()==Encoding_none)
+      {
+	buf.resize((size_t)rs*BinChunk);
+	*recs=&buf[0];
+	return fread(&buf[0], rs, (max<BinChunk) ? max : BinChunk, file);
+      }
+
+    vector<gecoBinBlock>& blocks=bin->getBlocks();
+    if ((left==0)&&(next<blocks.size()))
+      {
+	gecoBinBlock& b=blocks[next];
+	buf.resize((size_t)BlockMaxRecords*rs);
+	if ((!readBlock(file, bin, next++, block))||
+	    (gecoBlockDecoder::decode(bin, &block[0], block.size(), &buf[0])!=b.records))
+	  {
+	    corrupted=true;
+	    next=blocks.size();
+	    return 0;
+	  }
+	cur=&buf[(size_t)skip*rs];
+	left=b.records-skip;
+	skip=0;
+      }
+    long long n=(left<max) ? left : max;
+    *recs=cur;
+    cur+=(size_t)n*rs;
+    left-=n;
+    return n;
+  }
+};
+
+// reads the optional arguments ?first? ?count? and positions the file on the first record
+static int seekRecords(Tcl_Interp* interp, recordCursor* cursor, gecoBinFile* bin,
+		       int objc, Tcl_Obj *const objv[], int i,
+		       long long* first, long long* count)
+{
+  Tcl_WideInt w;
+  *first=0;
+  *count=bin->getNbrRecords();
+  if (i<objc)
+    {
+      if (Tcl_GetWideIntFromObj(interp, objv[i], &w)!=TCL_OK) return TCL_ERROR;
+      *first = (w<0) ? 0 : w;
+    }
+  if (*first>bin->getNbrRecords()) *first=bin->getNbrRecords();
+  *count=bin->getNbrRecords()-*first;
+  if (i+1<objc)
+    {
+      if (Tcl_GetWideIntFromObj(interp, objv[i+1], &w)!=TCL_OK) return TCL_ERROR;
+      if ((w>=0)&&(w<*count)) *count=w;
+    }
+  cursor->seek(*first);
+  return TCL_OK;
+}
+
+// returns the timestamp of record r of an uncompressed file
+static long long readTimestamp(FILE* file, gecoBinFile* bin, long long r)
+{
+  char buf[8];
+  fseeko(file, bin->getDataOffset()+(off_t)r*bin->getRecordSize()+
+	 bin->getColumnOffset(bin->getTimestampColumn()), SEEK_SET);
+  if (fread(buf, 1, 8, file)!=8) return LLONG_MAX;
+  return (long long)gecoBinFile::getLE(buf, 8);
+}
+
+// returns the last record (uncompressed) or block (compressed) starting at or before t
+// (binary search over the records or over the sparse time index)
+static long long seekTime(FILE* file, gecoBinFile* bin, long long t)
+{
+  vector<gecoBinBlock>& blocks=bin->getBlocks();
+  long long lo=0;
+  long long hi=(bin->getEncoding()==Encoding_none) ? bin->getNbrRecords()-1 : (long long)blocks.size()-1;
+  while (lo<hi)
+    {
+      long long mid=lo+(hi-lo+1)/2;
+      long long tm=(bin->getEncoding()==Encoding_none) ? readTimestamp(file, bin, mid) : blocks[mid].time;
+      if (tm<=t)
+	lo=mid;
+      else
+	hi=mid-1;
+    }
+  return lo;
+}
+
+// returns the first record (uncompressed) or block (compressed) holding the n latest records
+static long long seekLatest(gecoBinFile* bin, long long n)
+{
+  if (bin->getEncoding()==Encoding_none)
+    return (bin->getNbrRecords()>n) ? bin->getNbrRecords()-n : 0;
+  vector<gecoBinBlock>& blocks=bin->getBlocks();
+  long long k=blocks.size();
+  while ((k>0)&&(n>0)) n-=blocks[--k].records;
+  return k;
+}
+
+// feeds a query with the records of a file, from record (uncompressed) or block (compressed) r on;
+// returns false if a block is corrupted
+static bool scanFile(FILE* file, gecoBinFile* bin, gecoTimeQuery* q, long long r)
+{
+  int          rs=bin->getRecordSize();
+  vector<char> buf;
+  if (bin->getEncoding()==Encoding_none)
+    {
+      buf.resize((size_t)rs*BinChunk);
+      long long left=bin->getNbrRecords()-r;
+      long long n;
+      fseeko(file, bin->getDataOffset()+(off_t)r*rs, SEEK_SET);
+      while ((left>0)&&((n=fread(&buf[0], rs, (left<BinChunk) ? left : BinChunk, file))>0))
+	{
+	  for (long long k=0; k<n; k++)
+	    if (!q->add(&buf[k*rs])) return true;
+	  left-=n;
+	}
+      return true;
+    }
+
+  vector<gecoBinBlock>& blocks=bin->getBlocks();
+  for (size_t k=r; k<blocks.size(); k++)
+    {
+      if (!readBlock(file, bin, k, buf)) return false;
+      if (!q->addBlock(&buf[0], buf.size())) return q->isDone();
+    }
+  return true;
+}
+
+int geco_BinFileCmd(ClientData clientData, Tcl_Interp *interp,
+		    int objc,Tcl_Obj *const objv[])
+{
+  Tcl_ResetResult(interp);
+
+  if (objc==1)
+    {
+      Tcl_WrongNumArgs(interp, 1, objv, "subcommand ?argument ...?");
+      return TCL_ERROR;
+    }
+
+  int index;
+  static CONST char* cmds[] = {"-help", "-info", "-read", "-column", "-totext",
+			       "-range", "-latest", NULL};
+  static CONST char* help[] = {"returns header and number of records",
+			       "returns records (file ?first? ?count?)",
+			       "returns a column (file column ?first? ?count?)",
+			       "converts to a text data file (file textFile)",
+			       "returns {t value} in a time range (file column tMin tMax ?maxPoints?)",
+			       "returns {t value} of the latest records (file column n)",
+			       NULL};
+  if (Tcl_GetIndexFromObj(interp, objv[1], cmds, "subcommand", '0', &index)!=TCL_OK)
+    return TCL_ERROR;
+
+  if (index==0)
+    {
+      if (objc!=2)
+	{
+	  Tcl_WrongNumArgs(interp, 2, objv, NULL);
+	  return TCL_ERROR;
+	}
+      gecoHelp(interp, "binfile", "reads binary data files", cmds, help);
+      return TCL_OK;
+    }
+
+  if (objc<3)
+    {
+      Tcl_WrongNumArgs(interp, 2, objv, "file ?argument ...?");
+      return TCL_ERROR;
+    }
+
+  gecoBinFile bin;
+  FILE* file=openBinFile(interp, Tcl_GetString(objv[2]), &bin);
+  if (file==NULL) return TCL_ERROR;
+
+  int        rs=bin.getRecordSize();
+  recordCursor cursor(file, &bin);
+  const char* buf;
+  long long  first, count, n;
+  int        col=0;
+  int        ret=TCL_OK;
+  Tcl_Obj*   list;
+  FILE*      txt;
+  char       str[TCL_DOUBLE_SPACE+8];
+  double     tMin, tMax;
+  Tcl_WideInt w=0;
+  gecoTimeQuery query(&bin);
+
+  switch (index)
+    {
+
+    case 1: // -info
+      if (objc!=3)
+	{
+	  Tcl_WrongNumArgs(interp, 2, objv, "file");
+	  ret=TCL_ERROR;
+	  break;
+	}
+      list=bin.headerDict();
+      Tcl_ListObjAppendElement(interp, list, Tcl_NewStringObj("records", -1));
+      Tcl_ListObjAppendElement(interp, list, Tcl_NewWideIntObj(bin.getNbrRecords()));
+      Tcl_SetObjResult(interp, list);
+      break;
+
+    case 2: // -read
+      if (objc>5)
+	{
+	  Tcl_WrongNumArgs(interp, 2, objv, "file ?first? ?count?");
+	  ret=TCL_ERROR;
+	  break;
+	}
+      if (seekRecords(interp, &cursor, &bin, objc, objv, 3, &first, &count)!=TCL_OK)
+	{
+	  ret=TCL_ERROR;
+	  break;
+	}
+      list=Tcl_NewListObj(0, NULL);
+      while ((count>0)&&((n=cursor.read(count, &buf))>0))
+	{
+	  for (long long r=0; r<n; r++)
+	    {
+	      Tcl_Obj* rec=Tcl_NewListObj(0, NULL);
+	      for (int k=0; k<bin.getNbrColumns(); k++)
+		Tcl_ListObjAppendElement(interp, rec, bin.getValue(buf+r*rs, k));
+	      Tcl_ListObjAppendElement(interp, list, rec);
+	    }
+	  count-=n;
+	}
+      Tcl_SetObjResult(interp, list);
+      break;
+
+    case 3: // -column
+      if ((objc<4)||(objc>6))
+	{
+	  Tcl_WrongNumArgs(interp, 2, objv, "file column ?first? ?count?");
+	  ret=TCL_ERROR;
+	  break;
+	}
+      for (col=0; col<bin.getNbrColumns(); col++)
+	if (strcmp(bin.getColumnName(col), Tcl_GetString(objv[3]))==0) break;
+      if (col==bin.getNbrColumns())
+	{
+	  Tcl_AppendResult(interp, "no column \"", Tcl_GetString(objv[3]), "\" in file", NULL);
+	  ret=TCL_ERROR;
+	  break;
+	}
+      if (seekRecords(interp, &cursor, &bin, objc, objv, 4, &first, &count)!=TCL_OK)
+	{
+	  ret=TCL_ERROR;
+	  break;
+	}
+      list=Tcl_NewListObj(0, NULL);
+      while ((count>0)&&((n=cursor.read(count, &buf))>0))
+	{
+	  for (long long r=0; r<n; r++)
+	    Tcl_ListObjAppendElement(interp, list, bin.getValue(buf+r*rs, col));
+	  count-=n;
+	}
+      Tcl_SetObjResult(interp, list);
+      break;
+
+    case 4: // -totext
+      if (objc!=4)
+	{
+	  Tcl_WrongNumArgs(interp, 2, objv, "file textFile");
+	  ret=TCL_ERROR;
+	  break;
+	}
+      txt=fopen(Tcl_GetString(objv[3]), "w");
+      if (txt==NULL)
+	{
+	  Tcl_AppendResult(interp, "couldn't open \"", Tcl_GetString(objv[3]), "\": ",
+			   Tcl_PosixError(interp), NULL);
+	  ret=TCL_ERROR;
+	  break;
+	}
+      if (bin.getHeader()[0]!='\0') fprintf(txt, "%s\n", bin.getHeader());
+      cursor.seek(0);
+      count=bin.getNbrRecords();
+      while ((count>0)&&((n=cursor.read(count, &buf))>0))
+	{
+	  for (long long r=0; r<n; r++)
+	    {
+	      for (int k=0; k<bin.getNbrColumns(); k++)
+		{
+		  bin.printValue(buf+r*rs, k, str);
+		  if (k>0) fputc(' ', txt);
+		  fputs(str, txt);
+		}
+	      fputc('\n', txt);
+	    }
+	  count-=n;
+	}
+      if (fclose(txt)!=0)
+	{
+	  Tcl_AppendResult(interp, "error writing \"", Tcl_GetString(objv[3]), "\": ",
+			   Tcl_PosixError(interp), NULL);
+	  ret=TCL_ERROR;
+	  break;
+	}
+      if (cursor.corrupted) break;
+      Tcl_SetObjResult(interp, Tcl_NewWideIntObj(bin.getNbrRecords()-count));
+      break;
+
+    case 5: // -range
+      if ((objc<6)||(objc>7))
+	{
+	  Tcl_WrongNumArgs(interp, 2, objv, "file column tMin tMax ?maxPoints?");
+	  ret=TCL_ERROR;
+	  break;
+	}
+      if ((query.setColumn(interp, Tcl_GetString(objv[3]))!=TCL_OK)||
+	  (Tcl_GetDoubleFromObj(interp, objv[4], &tMin)!=TCL_OK)||
+	  (Tcl_GetDoubleFromObj(interp, objv[5], &tMax)!=TCL_OK)||
+	  ((objc==7)&&(Tcl_GetWideIntFromObj(interp, objv[6], &w)!=TCL_OK)))
+	{
+	  ret=TCL_ERROR;
+	  break;
+	}
+      query.setRange(tMin, tMax);
+      if ((bin.getNbrRecords()>0)&&(!scanFile(file, &bin, &query, seekTime(file, &bin, query.getMin()))))
+	cursor.corrupted=true;
+      Tcl_SetObjResult(interp, query.result(w));
+      break;
+
+    case 6: // -latest
+      if (objc!=5)
+	{
+	  Tcl_WrongNumArgs(interp, 2, objv, "file column n");
+	  ret=TCL_ERROR;
+	  break;
+	}
+      if ((query.setColumn(interp, Tcl_GetString(objv[3]))!=TCL_OK)||
+	  (Tcl_GetWideIntFromObj(interp, objv[4], &w)!=TCL_OK))
+	{
+	  ret=TCL_ERROR;
+	  break;
+	}
+      if (w>0)
+	{
+	  query.setLatest(w);
+	  if (!scanFile(file, &bin, &query, seekLatest(&bin, w))) cursor.corrupted=true;
+	}
+      Tcl_SetObjResult(interp, query.result());
+      break;
+
+    }
+
+  if (cursor.corrupted)
+    {
+      Tcl_ResetResult(interp);
+      Tcl_AppendResult(interp, "corrupted block in geco binary data file", NULL);
+      ret=TCL_ERROR;
+    }
+  fclose(file);
+  return ret;
+}
+
+// -------------------------------------------------------------------------
+
+
+// ---------------------------------------------------------------
+//
+// class gecoBinFile : layout of a binary data file
+//
+
+
+/**
+ * @brief Constructor
+*/
+
+gecoBinFile::gecoBinFile() :
+  recordSize(0),
+  start(0),
+  date(0.0),
+  dataOffset(0),
+  nbrRecords(0),
+  encoding(Encoding_none),
+  tsColumn(0)
+{
+  header=Tcl_NewObj();
+  Tcl_IncrRefCount(header);
+}
+
+
+/**
+ * @brief Destructor
+*/
+
+gecoBinFile::~gecoBinFile()
+{
+  clear();
+  Tcl_DecrRefCount(header);
+}
+
+
+/**
+ * @brief Removes all columns
+*/
+
+void gecoBinFile::clear()
+{
+  for (int k=0; k<(int)colName.size(); k++) Tcl_DecrRefCount(colName[k]);
+  colName.clear();
+  colType.clear();
+  colOffset.clear();
+  recordSize=0;
+  tsColumn=0;
+}
+
+
+/**
+ * @brief Defines the columns of the records
+ * @param interp Tcl interpreter in which errors are reported
+ * @param decl Tcl list of columns, each of the form 'name' or '{name type}'
+ * \return TCL_OK if decl is valid and TCL_ERROR otherwise
+ *
+ * The type of a column defaults to double. If no column of type timestamp is
+ * declared, a column 'timestamp' is added in front of the others.
+*/
+
+int gecoBinFile::setColumns(Tcl_Interp* interp, const char* decl)
+{
+  int       n, m, type;
+  Tcl_Obj** elem;
+  Tcl_Obj** pair;
+  Tcl_Obj*  list=Tcl_NewStringObj(decl, -1);
+  Tcl_IncrRefCount(list);
+
+  clear();
+  if (Tcl_ListObjGetElements(interp, list, &n, &elem)!=TCL_OK)
+    {
+      Tcl_DecrRefCount(list);
+      return TCL_ERROR;
+    }
+
+  bool hasTimestamp=false;
+  for (int k=0; k<n; k++)
+    {
+      type=BinCol_double;
+      m=0;
+      if ((Tcl_ListObjGetElements(interp, elem[k], &m, &pair)==TCL_OK)&&((m<1)||(m>2)))
+	Tcl_AppendResult(interp, "column must be name or {name type}", NULL);
+      if ((m<1)||(m>2)||
+	  ((m==2)&&(Tcl_GetIndexFromObj(interp, pair[1], BinColTypeStr, "column type", 0, &type)!=TCL_OK)))
+	{
+	  clear();
+	  Tcl_DecrRefCount(list);
+	  return TCL_ERROR;
+	}
+      if (type==BinCol_timestamp) hasTimestamp=true;
+      colName.push_back(pair[0]);
+      Tcl_IncrRefCount(pair[0]);
+      colType.push_back(type);
+    }
+
+  if (!hasTimestamp)
+    {
+      Tcl_Obj* ts=Tcl_NewStringObj("timestamp", -1);
+      Tcl_IncrRefCount(ts);
+      colName.insert(colName.begin(), ts);
+      colType.insert(colType.begin(), BinCol_timestamp);
+    }
+
+  for (int k=(int)colType.size()-1; k>=0; k--)
+    if (colType[k]==BinCol_timestamp) tsColumn=k;
+  for (int k=0; k<(int)colType.size(); k++)
+    {
+      colOffset.push_back(recordSize);
+      recordSize+=BinColSize[colType[k]];
+    }
+
+  Tcl_DecrRefCount(list);
+  return TCL_OK;
+}
+
+
+/**
+ * @brief Returns the index of the column name or -1 if there is none
+*/
+
+int gecoBinFile::getColumnIndex(const char* name)
+{
+  for (int k=0; k<(int)colName.size(); k++)
+    if (strcmp(Tcl_GetString(colName[k]), name)==0) return k;
+  return -1;
+}
+
+
+/**
+ * @brief Returns the header dictionary (refcount 0)
+*/
+
+Tcl_Obj* gecoBinFile::headerDict()
+{
+  Tcl_Obj* cols=Tcl_NewListObj(0, NULL);
+  for (int k=0; k<(int)colType.size(); k++)
+    {
+      Tcl_Obj* c[2];
+      c[0]=colName[k];
+      c[1]=Tcl_NewStringObj(BinColTypeStr[colType[k]], -1);
+      Tcl_ListObjAppendElement(NULL, cols, Tcl_NewListObj(2, c));
+    }
+
+  Tcl_Obj* dict=Tcl_NewListObj(0, NULL);
+  Tcl_ListObjAppendElement(NULL, dict, Tcl_NewStringObj("version", -1));
+  Tcl_ListObjAppendElement(NULL, dict, Tcl_NewIntObj((encoding==Encoding_none) ? 1 : BinVersion));
+  Tcl_ListObjAppendElement(NULL, dict, Tcl_NewStringObj("recordSize", -1));
+  Tcl_ListObjAppendElement(NULL, dict, Tcl_NewIntObj(recordSize));
+  Tcl_ListObjAppendElement(NULL, dict, Tcl_NewStringObj("columns", -1));
+  Tcl_ListObjAppendElement(NULL, dict, cols);
+  Tcl_ListObjAppendElement(NULL, dict, Tcl_NewStringObj("start", -1));
+  Tcl_ListObjAppendElement(NULL, dict, Tcl_NewWideIntObj(start));
+  Tcl_ListObjAppendElement(NULL, dict, Tcl_NewStringObj("date", -1));
+  Tcl_ListObjAppendElement(NULL, dict, Tcl_NewDoubleObj(date));
+  Tcl_ListObjAppendElement(NULL, dict, Tcl_NewStringObj("header", -1));
+  Tcl_ListObjAppendElement(NULL, dict, header);
+  if (encoding!=Encoding_none)
+    {
+      Tcl_ListObjAppendElement(NULL, dict, Tcl_NewStringObj("encoding", -1));
+      Tcl_ListObjAppendElement(NULL, dict, Tcl_NewStringObj(EncodingStr[encoding], -1));
+    }
+  return dict;
+}
+
+
+/**
+ * @brief Builds the header of a binary data file
+ * @param out Tcl_DString to which the header is appended
+ * @param userHeader header of the gecoFileStream
+ * @param Start CLOCK_MONOTONIC at start of the recording (ns)
+ * @param Date Unix time at start of the recording (s)
+*/
+
+void gecoBinFile::buildHeader(Tcl_DString* out, const char* userHeader, long long Start, double Date)
+{
+  start=Start;
+  date=Date;
+  Tcl_DecrRefCount(header);
+  header=Tcl_NewStringObj(userHeader, -1);
+  Tcl_IncrRefCount(header);
+
+  Tcl_Obj* dict=headerDict();
+  Tcl_IncrRefCount(dict);
+  int len;
+  const char* str=Tcl_GetStringFromObj(dict, &len);
+  char buf[4];
+  putLE(buf, len, 4);
+  Tcl_DStringAppend(out, BinMagic, 8);
+  Tcl_DStringAppend(out, buf, 4);
+  Tcl_DStringAppend(out, str, len);
+  Tcl_DecrRefCount(dict);
+}
+
+
+/**
+ * @brief Reads the header of a binary data file
+ * @param interp Tcl interpreter in which errors are reported
+ * @param file file opened for reading
+ * \return TCL_OK if the header is valid and TCL_ERROR otherwise
+ *
+ * On success, the file is positioned on the first record and the number of
+ * complete records in the file is known.
+*/
+
+int gecoBinFile::readHeader(Tcl_Interp* interp, FILE* file)
+{
+  char buf[12];
+  if ((fread(buf, 1, 12, file)!=12)||(memcmp(buf, BinMagic, 8)!=0))
+    {
+      Tcl_AppendResult(interp, "not a geco binary data file", NULL);
+      return TCL_ERROR;
+    }
+  unsigned long len=getLE(buf+8, 4);
+  off_t here=ftello(file);
+  fseeko(file, 0, SEEK_END);
+  off_t end=ftello(file);
+  if ((len>BinMaxHeader)||((off_t)len>end-here))
+    {
+      Tcl_AppendResult(interp, "invalid header length in geco binary data file", NULL);
+      return TCL_ERROR;
+    }
+  fseeko(file, here, SEEK_SET);
+  Tcl_DString str;
+  Tcl_DStringInit(&str);
+  Tcl_DStringSetLength(&str, len);
+  if (fread(Tcl_DStringValue(&str), 1, len, file)!=len)
+    {
+      Tcl_DStringFree(&str);
+      Tcl_AppendResult(interp, "truncated header in geco binary data file", NULL);
+      return TCL_ERROR;
+    }
+  Tcl_Obj* dict=Tcl_NewStringObj(Tcl_DStringValue(&str), len);
+  Tcl_DStringFree(&str);
+  Tcl_IncrRefCount(dict);
+
+  Tcl_Obj*    val;
+  int         version=0, size=0;
+  encoding=Encoding_none;
+  Tcl_WideInt w=0;
+  int ret=TCL_ERROR;
+  if (((val=dictGet(dict, "version"))==NULL)||(Tcl_GetIntFromObj(NULL, val, &version)!=TCL_OK))
+    Tcl_AppendResult(interp, "invalid header in geco binary data file", NULL);
+  else if (version>BinVersion)
+    Tcl_AppendResult(interp, "unsupported version of geco binary data file", NULL);
+  else if (((val=dictGet(dict, "columns"))==NULL)||(setColumns(interp, Tcl_GetString(val))!=TCL_OK)||
+	   ((val=dictGet(dict, "recordSize"))==NULL)||(Tcl_GetIntFromObj(NULL, val, &size)!=TCL_OK)||
+	   (size!=recordSize))
+    Tcl_AppendResult(interp, (Tcl_GetCharLength(Tcl_GetObjResult(interp))>0) ? "\n" : "",
+		     "inconsistent header in geco binary data file", NULL);
+  else if (((val=dictGet(dict, "encoding"))!=NULL)&&
+	   (Tcl_GetIndexFromObj(NULL, val, EncodingStr, "encoding", 0, &encoding)!=TCL_OK))
+    Tcl_AppendResult(interp, "unsupported encoding of geco binary data file", NULL);
+  else
+    {
+      ret=TCL_OK;
+      if (((val=dictGet(dict, "start"))!=NULL)&&(Tcl_GetWideIntFromObj(NULL, val, &w)==TCL_OK))
+	start=w;
+      if ((val=dictGet(dict, "date"))!=NULL)
+	Tcl_GetDoubleFromObj(NULL, val, &date);
+      if ((val=dictGet(dict, "header"))!=NULL)
+	{
+	  Tcl_DecrRefCount(header);
+	  header=val;
+	  Tcl_IncrRefCount(header);
+	}
+    }
+  Tcl_DecrRefCount(dict);
+  if (ret!=TCL_OK) return TCL_ERROR;
+
+  dataOffset=12+len;
+  if (encoding==Encoding_none)
+    nbrRecords=(end-dataOffset)/recordSize;
+  else
+    {
+      // reads the sparse time index from the trailer or else from the headers
+      // of the complete blocks (e.g. file not closed after a crash)
+      if (readIndex(file, end))
+	{
+	  fseeko(file, dataOffset, SEEK_SET);
+	  return TCL_OK;
+	}
+      nbrRecords=0;
+      blocks.clear();
+      off_t pos=dataOffset;
+      char  head[16];
+      fseeko(file, pos, SEEK_SET);
+      while (fread(head, 1, 16, file)==16)
+	{
+	  size_t size=gecoBlockDecoder::getSize(head);
+	  if ((size<16)||(pos+(off_t)size>end)||
+	      (gecoBlockDecoder::getRecords(head)<1)||(gecoBlockDecoder::getRecords(head)>BlockMaxRecords))
+	    break;
+	  gecoBinBlock b;
+	  b.time=gecoBlockDecoder::getFirstTime(head);
+	  b.offset=pos;
+	  b.records=gecoBlockDecoder::getRecords(head);
+	  blocks.push_back(b);
+	  nbrRecords+=b.records;
+	  pos+=size;
+	  fseeko(file, pos, SEEK_SET);
+	}
+    }
+  fseeko(file, dataOffset, SEEK_SET);
+  return TCL_OK;
+}
+
+
+/**
+ * @brief Builds the trailer of a compressed file
+ * @param out Tcl_DString to which the trailer is appended
+ * @param Blocks sparse time index of the blocks of the file
+ *
+ * The trailer, appended once the last block of the file is written, holds the
+ * sparse time index so that gecoBinFile::readHeader doesn't have to read the
+ * header of every block:
+ *
+ * Bytes        | Content
+ * ------------ | ------------------------------------------------------
+ * 4            | size of the trailer in bytes (uint32)
+ * 4            | 0 (a block holds at least one record)
+ * 8            | number of blocks n (uint64)
+ * 20 per block | offset (int64), timestamp of the first record (int64, ns) and number of records (uint32)
+ * 4            | size of the trailer in bytes (uint32)
+ * 8            | magic string 'GECOIDX1'
+*/
+
+void gecoBinFile::buildIndex(Tcl_DString* out, const vector<gecoBinBlock>& Blocks)
+{
+  size_t n=Blocks.size();
+  size_t len=28+20*n;
+  int    pos=Tcl_DStringLength(out);
+  Tcl_DStringSetLength(out, pos+len);
+  char* p=Tcl_DStringValue(out)+pos;
+  putLE(p, len, 4);
+  putLE(p+4, 0, 4);
+  putLE(p+8, n, 8);
+  p+=16;
+  for (size_t k=0; k<n; k++, p+=20)
+    {
+      putLE(p, Blocks[k].offset, 8);
+      putLE(p+8, Blocks[k].time, 8);
+      putLE(p+16, Blocks[k].records, 4);
+    }
+  putLE(p, len, 4);
+  memcpy(p+4, BinIndexMagic, 8);
+}
+
+
+/**
+ * @brief Reads the sparse time index from the trailer of a compressed file
+ * @param file file opened for reading
+ * @param end size of the file
+ * \return true if the file ends with a consistent trailer
+*/
+
+bool gecoBinFile::readIndex(FILE* file, off_t end)
+{
+  char tail[12];
+  if ((end-dataOffset<28)||(fseeko(file, end-12, SEEK_SET)!=0)||
+      (fread(tail, 1, 12, file)!=12)||(memcmp(tail+4, BinIndexMagic, 8)!=0))
+    return false;
+  size_t len=getLE(tail, 4);
+  if ((len<28)||(len>BinMaxIndex)||((off_t)len>end-dataOffset)||((len-28)%20!=0))
+    return false;
+
+  vector<char> buf(len);
+  off_t trailer=end-len;
+  fseeko(file, trailer, SEEK_SET);
+  if ((fread(&buf[0], 1, len, file)!=len)||(getLE(&buf[0], 4)!=len)||(getLE(&buf[4], 4)!=0)||
+      (getLE(&buf[8], 8)!=(len-28)/20))
+    return false;
+
+  // the blocks follow each other from the data offset up to the trailer
+  vector<gecoBinBlock> index((len-28)/20);
+  long long total=0;
+  const char* p=&buf[16];
+  for (size_t k=0; k<index.size(); k++, p+=20)
+    {
+      index[k].offset =(long long)getLE(p, 8);
+      index[k].time   =(long long)getLE(p+8, 8);
+      index[k].records=(int)getLE(p+16, 4);
+      if ((index[k].offset<((k==0) ? dataOffset : index[k-1].offset+16))||
+	  ((k==0)&&(index[k].offset!=dataOffset))||
+	  (index[k].offset+16>trailer)||
+	  (index[k].records<1)||(index[k].records>BlockMaxRecords))
+	return false;
+      total+=index[k].records;
+    }
+
+  // checks the last block ends at the trailer
+  if (!index.empty())
+    {
+      char head[16];
+      fseeko(file, index.back().offset, SEEK_SET);
+      if ((fread(head, 1, 16, file)!=16)||
+	  (index.back().offset+(off_t)gecoBlockDecoder::getSize(head)!=trailer)||
+	  (gecoBlockDecoder::getRecords(head)!=index.back().records))
+	return false;
+    }
+  else if (trailer!=dataOffset)
+    return false;
+
+  blocks.swap(index);
+  nbrRecords=total;
+  return true;
+}
+
+
+/**
+ * @brief Stores a value in column k of a record
+ * @param rec start of the record
+ * @param k column
+ * @param v value, converted to the type of the column
+*/
+
+void gecoBinFile::putValue(char* rec, int k, double v)
+{
+  char* p=rec+colOffset[k];
+  union {double d; unsigned long long u;} d;
+  union {float f; unsigned int u;} f;
+  switch (colType[k])
+    {
+    case BinCol_double:
+      d.d=v;
+      putLE(p, d.u, 8);
+      break;
+    case BinCol_float:
+      f.f=(float)v;
+      putLE(p, f.u, 4);
+      break;
+    case BinCol_int:
+      putLE(p, (v==v) ? (unsigned int)(int)v : 0, 4);
+      break;
+    default:
+      putLE(p, (v==v) ? (unsigned long long)(long long)v : 0, 8);
+      break;
+    }
+}
+
+
+/**
+ * @brief Stores an integer value in column k of a record
+ * @param rec start of the record
+ * @param k column
+ * @param v value, converted to the type of the column
+*/
+
+void gecoBinFile::putWide(char* rec, int k, long long v)
+{
+  switch (colType[k])
+    {
+    case BinCol_timestamp:
+    case BinCol_wide:
+      putLE(rec+colOffset[k], (unsigned long long)v, 8);
+      break;
+    case BinCol_int:
+      putLE(rec+colOffset[k], (unsigned int)(int)v, 4);
+      break;
+    default:
+      putValue(rec, k, (double)v);
+      break;
+    }
+}
+
+
+/**
+ * @brief Returns the value of column k of a record (refcount 0)
+ * @param rec start of the record
+ * @param k column
+ *
+ * Timestamps are returned in seconds since the start of the recording.
+*/
+
+Tcl_Obj* gecoBinFile::getValue(const char* rec, int k)
+{
+  const char* p=rec+colOffset[k];
+  union {double d; unsigned long long u;} d;
+  union {float f; unsigned int u;} f;
+  switch (colType[k])
+    {
+    case BinCol_timestamp:
+      return Tcl_NewDoubleObj((long long)getLE(p, 8)/1e9);
+    case BinCol_double:
+      d.u=getLE(p, 8);
+      return Tcl_NewDoubleObj(d.d);
+    case BinCol_float:
+      f.u=getLE(p, 4);
+      return Tcl_NewDoubleObj(f.f);
+    case BinCol_int:
+      return Tcl_NewIntObj((int)getLE(p, 4));
+    default:
+      return Tcl_NewWideIntObj((long long)getLE(p, 8));
+    }
+}
+
+
+/**
+ * @brief Returns the value of column k of a record as a double
+ * @param rec start of the record
+ * @param k column
+ *
+ * Timestamps are returned in seconds since the start of the recording.
+*/
+
+double gecoBinFile::getDouble(const char* rec, int k)
+{
+  const char* p=rec+colOffset[k];
+  union {double d; unsigned long long u;} d;
+  union {float f; unsigned int u;} f;
+  switch (colType[k])
+    {
+    case BinCol_timestamp:
+      return (long long)getLE(p, 8)/1e9;
+    case BinCol_double:
+      d.u=getLE(p, 8);
+      return d.d;
+    case BinCol_float:
+      f.u=getLE(p, 4);
+      return f.f;
+    case BinCol_int:
+      return (int)getLE(p, 4);
+    default:
+      return (double)(long long)getLE(p, 8);
+    }
+}
+
+
+/**
+ * @brief Prints the value of column k of a record
+ * @param rec start of the record
+ * @param k column
+ * @param str buffer of at least TCL_DOUBLE_SPACE+8 characters
+ *
+ * The value is printed as Tcl would print it.
+*/
+
+void gecoBinFile::printValue(const char* rec, int k, char* str)
+{
+  const char* p=rec+colOffset[k];
+  union {double d; unsigned long long u;} d;
+  union {float f; unsigned int u;} f;
+  switch (colType[k])
+    {
+    case BinCol_timestamp:
+      Tcl_PrintDouble(NULL, (long long)getLE(p, 8)/1e9, str);
+      break;
+    case BinCol_double:
+      d.u=getLE(p, 8);
+      Tcl_PrintDouble(NULL, d.d, str);
+      break;
+    case BinCol_float:
+      f.u=getLE(p, 4);
+      Tcl_PrintDouble(NULL, f.f, str);
+      break;
+    case BinCol_int:
+      sprintf(str, "%d", (int)getLE(p, 4));
+      break;
+    default:
+      sprintf(str, "%lld", (long long)getLE(p, 8));
+      break;
+    }
+}
+
+
+/**
+ * @brief Stores the n lowest bytes of v in little-endian order
+*/
+
+void gecoBinFile::putLE(char* p, unsigned long long v, int n)
+{
+  for (int k=0; k<n; k++)
+    {
+      p[k]=(char)(v & 0xff);
+      v>>=8;
+    }
+}
+
+
+/**
+ * @brief Reads n bytes in little-endian order
+*/
+
+unsigned long long gecoBinFile::getLE(const char* p, int n)
+{
+  unsigned long long v=0;
+  for (int k=n-1; k>=0; k--)
+    v=(v<<8) | (unsigned char)p[k];
+  return v;
+}
@@ -0,0 +1,220 @@
+// This may look like C code, but it is really -*- C++ -*-
+// ----------------------------------------------------------------
+//
+// Header file for class gecoBinFile
+//
+// (c) Rolf Wuthrich
+//     2026 Concordia University
+//
+// author:  agent
+// email:   agent@local
+// version: v1
+//
+// This software is copyright under the BSD license
+//
+// ---------------------------------------------------------------
+// history:
+// ---------------------------------------------------------------
+// Date       Modification                     Author
+// ---------------------------------------------------------------
+// 17.10.2026 Creation                         agent
+// 17.10.2026 Added compressed encoding        agent
+// 17.10.2026 Added time-indexed queries       agent
+// 17.10.2026 Added getDouble                  agent
+// 18.10.2026 Block index kept in a trailer     agent
+//
+// ---------------------------------------------------------------
+/*! \file */
+
+#ifndef gecoBinFile_SEEN_
+#define gecoBinFile_SEEN_
+
+#include <tcl8.6/tcl.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/types.h>
+#include <vector>
+
+using namespace std;
+
+
+// -----------------------------------------------------------------------
+//
+// Tcl interface
+//
+
+/**
+ * @brief C++ implementation of the Tcl command 'binfile' reading binary data files
+ * @param clientData pointer to the gecoApp
+ * @param interp Tcl interpreter in which the Tcl command is executed
+ * @param objc number of arguments of the Tcl command
+ * @param objv arguments of the the Tcl command
+ * \return TCL_OK if the execution of the Tcl command is successful and TCL_ERROR otherwise
+ */
+
+int geco_BinFileCmd(ClientData clientData, Tcl_Interp *interp,
+		    int objc,Tcl_Obj *const objv[]);
+
+
+// ------------------------------------------------------------------------
+//
+// Types of columns
+//
+
+const int
+  BinCol_timestamp = 0,       // int64, ns since start of recording (CLOCK_MONOTONIC)
+  BinCol_double    = 1,       // IEEE 754 double
+  BinCol_float     = 2,       // IEEE 754 float
+  BinCol_int       = 3,       // int32
+  BinCol_wide      = 4;       // int64
+
+extern const char* BinColTypeStr[];
+extern const int   BinColSize[];
+
+
+// ------------------------------------------------------------------------
+//
+// Entry of the sparse time index of a compressed file
+//
+
+struct gecoBinBlock
+{
+  long long          time;         // timestamp of the first record (ns)
+  long long          offset;       // offset of the block in the file
+  int                records;      // number of records of the block
+};
+
+
+// -----------------------------------------------------------------------
+//
+// class gecoBinFile : layout of a binary data file
+//
+
+/**
+ * @brief Layout of the binary data files written by gecoFileStream
+ * \author agent
+ * \date 2026
+ *
+ * A binary data file starts with a self-describing header followed by
+ * fixed-width records, one per recording:
+ *
+ * Bytes        | Content
+ * ------------ | ------------------------------------------------------
+ * 8            | magic string 'GECOBIN1'
+ * 4            | length L of the header dictionary (uint32)
+ * L            | header dictionary (Tcl dict, see below)
+ * recordSize   | first record
+ * ...          | further records until the end of the file
+ *
+ * The header dictionary holds the keys 'version', 'recordSize', 'columns'
+ * (list of {name type}), 'start' (CLOCK_MONOTONIC at start of the recording, ns),
+ * 'date' (Unix time at start of the recording, s) and 'header' (the '-header' of
+ * the gecoFileStream).
+ *
+ * Within a record, the columns are packed in declaration order without padding.
+ * All numbers are little-endian, independently of the host. The column types are
+ *
+ * Type      | Size | Content
+ * --------- | ---- | ------------------------------------------------------
+ * timestamp | 8    | ns since the start of the recording (int64, CLOCK_MONOTONIC)
+ * double    | 8    | IEEE 754 double
+ * float     | 4    | IEEE 754 float
+ * int       | 4    | int32
+ * wide      | 8    | int64
+ *
+ * A record truncated at the end of the file (e.g. after a crash) is ignored.
+ *
+ * Compressed encoding
+ * -------------------
+ * If the header dictionary holds the key 'encoding' with value 'gorilla'
+ * (version 2), the records are compressed in blocks of up to 1024 records
+ * (see gecoBlockEncoder) following each other until the end of the file.
+ * A block truncated at the end of the file is ignored. The Tcl command 'binfile'
+ * decompresses such files transparently, decoding only the blocks it needs.
+ *
+ * The headers of the blocks, holding the timestamp of their first record, form
+ * a sparse time index of the file, read by gecoBinFile::readHeader. Once the file
+ * is closed, this index is appended as a trailer (see gecoBinFile::buildIndex)
+ * and read back at once. A file without trailer (e.g. after a crash) is indexed
+ * from the headers of its blocks.
+ *
+ * Associated Tcl command
+ * ----------------------
+ * The Tcl command 'binfile' reads binary data files
+ *
+ * Sub-command       | Short description
+ * ----------------- | ------------------
+ * -info             | returns the header dictionary and the number of records
+ * -read             | returns records (file ?first? ?count?)
+ * -column           | returns the values of a column (file column ?first? ?count?)
+ * -totext           | converts to a text data file (file textFile)
+ * -range            | returns {t value} of a column in a time range (file column tMin tMax ?maxPoints?)
+ * -latest           | returns {t value} of the latest records of a column (file column n)
+ *
+ * The timestamps are returned in seconds. '-range' and '-latest' read only the
+ * part of the file needed: the first record of the range is found by binary search,
+ * over the records of an uncompressed file or over the sparse time index of a
+ * compressed one. With 'maxPoints', the range is decimated to at most 'maxPoints'
+ * evenly spaced records (see gecoTimeQuery).
+ */
+
+class gecoBinFile
+{
+
+private:
+
+  vector<Tcl_Obj*>   colName;      // names of the columns
+  vector<int>        colType;      // types of the columns
+  vector<int>        colOffset;    // offsets of the columns within a record
+  int                recordSize;   // size of a record (bytes)
+  long long          start;        // CLOCK_MONOTONIC at start of recording (ns)
+  double             date;         // Unix time at start of recording (s)
+  Tcl_Obj*           header;       // user header
+  long               dataOffset;   // offset of the first record in the file
+  long long          nbrRecords;   // number of complete records in the file
+  int                encoding;     // Encoding_none or Encoding_gorilla
+  int                tsColumn;     // first timestamp column
+  vector<gecoBinBlock> blocks;     // sparse time index of a compressed file
+
+  void               clear();
+  bool               readIndex(FILE* file, off_t end);
+
+public:
+
+  gecoBinFile();
+  ~gecoBinFile();
+
+  int          setColumns(Tcl_Interp* interp, const char* decl);
+  int          getNbrColumns()        {return colType.size();}            /*!< Returns the number of columns */
+  const char*  getColumnName(int k)   {return Tcl_GetString(colName[k]);} /*!< Returns the name of column k */
+  Tcl_Obj*     getColumnNameObj(int k) {return colName[k];}               /*!< Returns the name of column k */
+  int          getColumnType(int k)   {return colType[k];}                /*!< Returns the type of column k */
+  int          getColumnOffset(int k) {return colOffset[k];}              /*!< Returns the offset of column k within a record */
+  int          getRecordSize()        {return recordSize;}                /*!< Returns the size of a record (bytes) */
+  long long    getNbrRecords()        {return nbrRecords;}                /*!< Returns the number of records (after readHeader) */
+  long long    getStart()             {return start;}                     /*!< Returns CLOCK_MONOTONIC at start of recording (ns) */
+  const char*  getHeader()            {return Tcl_GetString(header);}     /*!< Returns the user header */
+  int          getEncoding()          {return encoding;}                  /*!< Returns the encoding of the records */
+  void         setEncoding(int Encoding) {encoding=Encoding;}             /*!< Sets the encoding of the records */
+  long         getDataOffset()        {return dataOffset;}                /*!< Returns the offset of the first record (after readHeader) */
+  int          getTimestampColumn()   {return tsColumn;}                  /*!< Returns the first timestamp column */
+  long long    getTimestamp(const char* rec) {return (long long)getLE(rec+colOffset[tsColumn], 8);} /*!< Returns the timestamp of a record (ns) */
+  vector<gecoBinBlock>& getBlocks()   {return blocks;}                    /*!< Returns the sparse time index of a compressed file (after readHeader) */
+  int          getColumnIndex(const char* name);
+
+  void         buildHeader(Tcl_DString* out, const char* userHeader, long long Start, double Date);
+  int          readHeader(Tcl_Interp* interp, FILE* file);
+  Tcl_Obj*     headerDict();
+  static void  buildIndex(Tcl_DString* out, const vector<gecoBinBlock>& Blocks);
+
+  void         putValue(char* rec, int k, double v);
+  void         putWide(char* rec, int k, long long v);
+  Tcl_Obj*     getValue(const char* rec, int k);
+  double       getDouble(const char* rec, int k);
+  void         printValue(const char* rec, int k, char* str);
+
+  static void       putLE(char* p, unsigned long long v, int n);
+  static unsigned long long getLE(const char* p, int n);
+};
+
+#endif /* gecoBinFile_SEEN_ */
@@ -0,0 +1,156 @@
+// ---------------------------------------------------------------
+//
+// Definition of the class gecoBinRecord
+//
+// (c) Rolf Wuthrich
+//     2026 Concordia University
+//
+// author:  agent
+// email:   agent@local
+// version: v1
+//
+// This software is copyright under the BSD license
+//
+// ---------------------------------------------------------------
+// history:
+// ---------------------------------------------------------------
+// Date       Modification                     Author
+// ---------------------------------------------------------------
+// 17.10.2026 Creation                         agent
+//
+// ---------------------------------------------------------------
+
+#include <tcl.h>
+#include <cmath>
+#include <time.h>
+#include "gecoBinRecord.h"
+#include "gecoSignal.h"
+#include "gecoApp.h"
+
+using namespace std;
+
+
+// ---------------------------------------------------------------
+//
+// class gecoBinRecord : builds the records of a binary data file
+//
+
+
+/**
+ * @brief Constructor
+ * @param App gecoApp providing the variables
+ * @param Layout layout of the records
+*/
+
+gecoBinRecord::gecoBinRecord(gecoApp* App, gecoBinFile* Layout) :
+  app(App),
+  layout(Layout),
+  start(0)
+{
+}
+
+
+/**
+ * @brief Destructor
+*/
+
+gecoBinRecord::~gecoBinRecord()
+{
+  unbind();
+}
+
+
+/**
+ * @brief Returns the current time of CLOCK_MONOTONIC (ns)
+*/
+
+long long gecoBinRecord::monotonicTime()
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (long long)ts.tv_sec*1000000000LL+ts.tv_nsec;
+}
+
+
+/**
+ * @brief Binds the columns of the layout to their storage
+ * @param Start CLOCK_MONOTONIC at start of recording (ns)
+ *
+ * Must be called after the columns of the layout are set.
+*/
+
+void gecoBinRecord::bind(long long Start)
+{
+  unbind();
+  start=Start;
+  record.assign(layout->getRecordSize(), 0);
+  for (int k=0; k<layout->getNbrColumns(); k++)
+    {
+      gecoSignal* sig=NULL;
+      double*     ptr=NULL;
+      if (layout->getColumnType(k)!=BinCol_timestamp)
+	{
+	  if (app->getSignalBus()->find(layout->getColumnName(k)))
+	    sig=app->getSignalBus()->attach(layout->getColumnName(k), Signal_double);
+	  else
+	    ptr=app->findNativeVar(layout->getColumnName(k));
+	}
+      colSignal.push_back(sig);
+      colPtr.push_back(ptr);
+    }
+}
+
+
+/**
+ * @brief Detaches the columns from the signals
+*/
+
+void gecoBinRecord::unbind()
+{
+  for (int k=0; k<(int)colSignal.size(); k++)
+    app->getSignalBus()->detach(colSignal[k]);
+  colSignal.clear();
+  colPtr.clear();
+}
+
+
+/**
+ * @brief Fills a record with the current values of the columns
+ * @param interp Tcl interpreter holding the Tcl variables
+ * \return the record (valid until the next call)
+*/
+
+const char* gecoBinRecord::build(Tcl_Interp* interp)
+{
+  char* rec=&record[0];
+  for (int k=0; k<layout->getNbrColumns(); k++)
+    {
+      int type=layout->getColumnType(k);
+      if (type==BinCol_timestamp)
+	layout->putWide(rec, k, monotonicTime()-start);
+      else if (colSignal[k])
+	{
+	  if ((colSignal[k]->getType()!=Signal_double)&&((type==BinCol_int)||(type==BinCol_wide)))
+	    layout->putWide(rec, k, colSignal[k]->getInt());
+	  else
+	    layout->putValue(rec, k, colSignal[k]->getDouble());
+	}
+      else if (colPtr[k])
+	layout->putValue(rec, k, *colPtr[k]);
+      else
+	{
+	  Tcl_Obj*    obj=Tcl_ObjGetVar2(interp, layout->getColumnNameObj(k), NULL, TCL_GLOBAL_ONLY);
+	  Tcl_WideInt w;
+	  double      d=NAN;
+	  if ((obj)&&((type==BinCol_int)||(type==BinCol_wide))&&
+	      (Tcl_GetWideIntFromObj(NULL, obj, &w)==TCL_OK))
+	    layout->putWide(rec, k, w);
+	  else
+	    {
+	      if (obj) Tcl_GetDoubleFromObj(NULL, obj, &d);
+	      layout->putValue(rec, k, d);
+	    }
+	}
+    }
+  return rec;
+}
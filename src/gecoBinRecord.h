@@ -0,0 +1,83 @@
+// This may look like C code, but it is really -*- C++ -*-
+// ----------------------------------------------------------------
+//
+// Header file for class gecoBinRecord
+//
+// (c) Rolf Wuthrich
+//     2026 Concordia University
+//
+// author:  agent
+// email:   agent@local
+// version: v1
+//
+// This software is copyright under the BSD license
+//
+// ---------------------------------------------------------------
+// history:
+// ---------------------------------------------------------------
+// Date       Modification                     Author
+// ---------------------------------------------------------------
+// 17.10.2026 Creation                         agent
+//
+// ---------------------------------------------------------------
+/*! \file */
+
+#ifndef gecoBinRecord_SEEN_
+#define gecoBinRecord_SEEN_
+
+#include <tcl8.6/tcl.h>
+#include <vector>
+#include "gecoBinFile.h"
+
+class gecoApp;               // forward definition
+class gecoSignal;            // forward definition
+
+using namespace std;
+
+
+// -----------------------------------------------------------------------
+//
+// class gecoBinRecord : builds the records of a binary data file
+//
+
+/**
+ * @brief Builds the records of a binary data file from the variables of a gecoApp
+ * \author agent
+ * \date 2026
+ *
+ * A gecoBinRecord fills records with the layout of a gecoBinFile. Once bound,
+ * a column naming a signal of the gecoSignalBus is read from the signal, a column
+ * naming a native variable (like t) is read from its storage and the other
+ * columns are read from their Tcl variable without string conversion if they
+ * hold a number. A column of type timestamp holds the CLOCK_MONOTONIC time
+ * since the start of the recording.
+ *
+ * Used by gecoFileStream, gecoMemStream and gecoRingRecorder.
+ */
+
+class gecoBinRecord
+{
+
+private:
+
+  gecoApp*            app;
+  gecoBinFile*        layout;     // layout of the records
+  vector<gecoSignal*> colSignal;  // signal of each column (or NULL)
+  vector<double*>     colPtr;     // native variable of each column (or NULL)
+  vector<char>        record;     // record being built
+  long long           start;      // CLOCK_MONOTONIC at start of recording (ns)
+
+public:
+
+  gecoBinRecord(gecoApp* App, gecoBinFile* Layout);
+  ~gecoBinRecord();
+
+  void         bind(long long Start);
+  void         unbind();
+  const char*  build(Tcl_Interp* interp);
+  int          getSize() {return record.size();}   /*!< Returns the size of a record (bytes) */
+
+  static long long monotonicTime();
+};
+
+#endif /* gecoBinRecord_SEEN_ */
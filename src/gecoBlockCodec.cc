@@ -0,0 +1,459 @@
+// ---------------------------------------------------------------
+//
+// Definition of the classes gecoBlockEncoder and gecoBlockDecoder
+//
+// (c) Rolf Wuthrich
+//     2026 Concordia University
+//
+// author:  agent
+// email:   agent@local
+// version: v1
+//
+// This software is copyright under the BSD license
+//
+// ---------------------------------------------------------------
+// history:
+// ---------------------------------------------------------------
+// Date       Modification                     Author
+// ---------------------------------------------------------------
+// 17.10.2026 Creation                         agent
+//
+// ---------------------------------------------------------------
+
+#include <cstring>
+#include "gecoBlockCodec.h"
+
+using namespace std;
+
+
+// ---------------------------------------------------------------
+//
+// Encodings of the records
+//
+
+const char* EncodingStr[] = {"none", "gorilla", NULL};
+
+// Buckets of the delta of the delta of integer columns:
+//   '0'                 : 0
+//   '10'    + 7 bits    : [-64, 63]
+//   '110'   + 12 bits   : [-2048, 2047]
+//   '1110'  + 20 bits   : [-524288, 524287]
+//   '11110' + 32 bits   : 32 bit values
+//   '11111' + 64 bits   : all others
+// (values zigzag encoded)
+
+static const int DodBits[] = {7, 12, 20, 32, 64};
+static const int DodBuckets = 5;
+
+// XOR of floating point columns with the previous value:
+//   '0'                                       : same value
+//   '10' + meaningful bits                    : within the previous window
+//   '11' + 5 bits leading zeros + length - 1  : new window
+//          (6 bits for double, 5 for float) + meaningful bits
+
+static inline unsigned long long zigzag(unsigned long long d)
+{
+  return (d<<1) ^ (unsigned long long)((long long)d>>63);
+}
+
+static inline unsigned long long unzigzag(unsigned long long u)
+{
+  return (u>>1) ^ (0-(u & 1));
+}
+
+static inline bool isInteger(int type)
+{
+  return (type==BinCol_timestamp)||(type==BinCol_int)||(type==BinCol_wide);
+}
+
+// reads the value of column k of a record (int sign-extended)
+static inline unsigned long long readColumn(gecoBinFile* bin, const char* rec, int k)
+{
+  const char* p=rec+bin->getColumnOffset(k);
+  if (bin->getColumnType(k)==BinCol_int)
+    return (unsigned long long)(long long)(int)gecoBinFile::getLE(p, 4);
+  return gecoBinFile::getLE(p, BinColSize[bin->getColumnType(k)]);
+}
+
+
+// -------------------------------------------------------------------------
+//
+// Reader of a bit stream
+//
+
+struct gecoBitReader
+{
+  const unsigned char* p;
+  size_t               len;      // bytes
+  size_t               pos;      // bits read
+  bool                 error;    // read past the end
+
+  gecoBitReader(const char* P, size_t Len) :
+    p((const unsigned char *)P), len(Len), pos(0), error(false) {}
+
+  unsigned long long get(int n)
+  {
+    unsigned long long v=0;
+    while (n>0)
+      {
+	if (pos/8>=len)
+	  {
+	    error=true;
+	    return 0;
+	  }
+	int off=pos%8;
+	int take=(8-off<n) ? 8-off : n;
+	v=(v<<take) | ((p[pos/8]>>(8-off-take)) & ((1u<<take)-1));
+	pos+=take;
+	n-=take;
+      }
+    return v;
+  }
+};
+
+
+// ---------------------------------------------------------------
+//
+// struct gecoBitStream : stream of bits of a column
+//
+
+
+/**
+ * @brief Appends the n lowest bits of v, most significant first
+*/
+
+void gecoBitStream::put(unsigned long long v, int n)
+{
+  while (n>0)
+    {
+      int take=(8-fill<n) ? 8-fill : n;
+      cur|=((v>>(n-take)) & ((1u<<take)-1)) << (8-fill-take);
+      fill+=take;
+      n-=take;
+      if (fill==8)
+	{
+	  buf.push_back((unsigned char)cur);
+	  cur=0;
+	  fill=0;
+	}
+    }
+}
+
+
+// ---------------------------------------------------------------
+//
+// class gecoBlockEncoder : compresses records in blocks
+//
+
+
+/**
+ * @brief Constructor
+ * @param Bin layout of the records
+ *
+ * gecoBlockEncoder::setup must be called once the columns of Bin are defined.
+*/
+
+gecoBlockEncoder::gecoBlockEncoder(gecoBinFile* Bin) :
+  bin(Bin),
+  n(0),
+  maxRecords(BlockMaxRecords),
+  maxBytes(0),
+  bits(0),
+  maxRecordBits(0),
+  firstTime(0),
+  rawBytes(0),
+  encodedBytes(0)
+{
+}
+
+
+/**
+ * @brief Prepares the encoding of the columns of the gecoBinFile
+ * @param MaxRecords records per block at most
+ * @param MaxBytes size of a block at most (bytes)
+ *
+ * Discards the current block and resets the statistics.
+*/
+
+void gecoBlockEncoder::setup(int MaxRecords, size_t MaxBytes)
+{
+  int nc=bin->getNbrColumns();
+  streams.assign(nc, gecoBitStream());
+  prev.assign(nc, 0);
+  prevDelta.assign(nc, 0);
+  lead.assign(nc, -1);
+  trail.assign(nc, 0);
+  for (int k=0; k<nc; k++) streams[k].clear();
+
+  maxRecords=(MaxRecords<1) ? 1 : MaxRecords;
+  maxBytes=MaxBytes;
+  maxRecordBits=0;
+  for (int k=0; k<nc; k++)
+    switch (bin->getColumnType(k))
+      {
+      case BinCol_double: maxRecordBits+=2+5+6+64; break;
+      case BinCol_float:  maxRecordBits+=2+5+5+32; break;
+      default:            maxRecordBits+=5+64;     break;
+      }
+
+  n=0;
+  bits=0;
+  pending.clear();
+  pending.reserve((size_t)maxRecords*bin->getRecordSize());
+  rawBytes=0;
+  encodedBytes=0;
+}
+
+
+/**
+ * @brief Returns true if the next record may not fit in the block
+*/
+
+bool gecoBlockEncoder::isFull()
+{
+  if (n>=maxRecords) return true;
+  // each stream may end with a partial byte
+  return headerSize()+streams.size()+(bits+maxRecordBits+7)/8>maxBytes;
+}
+
+
+/**
+ * @brief Encodes the delta of the delta of an integer column
+ * @param k column
+ * @param d delta of the delta (two's complement)
+*/
+
+void gecoBlockEncoder::putDod(int k, unsigned long long d)
+{
+  unsigned long long u=zigzag(d);
+  if (u==0)
+    {
+      put(k, 0, 1);
+      return;
+    }
+  int b=0;
+  while ((b<DodBuckets-1)&&(u>>DodBits[b])) b++;
+  if (b<DodBuckets-1)
+    put(k, (1ull<<(b+2))-2, b+2);
+  else
+    put(k, (1ull<<DodBuckets)-1, DodBuckets);
+  put(k, u, DodBits[b]);
+}
+
+
+/**
+ * @brief Encodes the XOR of a floating point column with its previous value
+ * @param k column
+ * @param v bits of the value
+ * @param width 64 for double and 32 for float
+*/
+
+void gecoBlockEncoder::putXor(int k, unsigned long long v, int width)
+{
+  unsigned long long x=v^prev[k];
+  if (x==0)
+    {
+      put(k, 0, 1);
+      return;
+    }
+  int lz=(width==64) ? __builtin_clzll(x) : __builtin_clz((unsigned int)x);
+  int tz=__builtin_ctzll(x);
+  if (lz>31) lz=31;
+  if ((lead[k]>=0)&&(lz>=lead[k])&&(tz>=trail[k]))
+    {
+      put(k, 2, 2);
+      put(k, x>>trail[k], width-lead[k]-trail[k]);
+      return;
+    }
+  int len=width-lz-tz;
+  put(k, 3, 2);
+  put(k, lz, 5);
+  put(k, len-1, (width==64) ? 6 : 5);
+  put(k, x>>tz, len);
+  lead[k]=lz;
+  trail[k]=tz;
+}
+
+
+/**
+ * @brief Adds a record to the block
+ * @param rec the record (layout of the gecoBinFile)
+ *
+ * Once gecoBlockEncoder::isFull, the block must be closed with
+ * gecoBlockEncoder::finish before the next record is added.
+*/
+
+void gecoBlockEncoder::add(const char* rec)
+{
+  for (int k=0; k<(int)streams.size(); k++)
+    {
+      int type=bin->getColumnType(k);
+      int width=8*BinColSize[type];
+      unsigned long long v=readColumn(bin, rec, k);
+      if ((n==0)&&(k==bin->getTimestampColumn())) firstTime=(long long)v;
+      if (n==0)
+	{
+	  put(k, v, width);
+	  prevDelta[k]=0;
+	  lead[k]=-1;
+	}
+      else if (isInteger(type))
+	{
+	  unsigned long long delta=v-prev[k];
+	  putDod(k, delta-prevDelta[k]);
+	  prevDelta[k]=delta;
+	}
+      else
+	putXor(k, v, width);
+      prev[k]=v;
+    }
+  pending.insert(pending.end(), rec, rec+bin->getRecordSize());
+  n++;
+  rawBytes+=bin->getRecordSize();
+}
+
+
+/**
+ * @brief Closes the block
+ * @param len size of the block (bytes), 0 if the block holds no record
+ * \return the block, valid until the next call to gecoBlockEncoder::finish
+ *
+ * The next record starts a new block.
+*/
+
+const char* gecoBlockEncoder::finish(size_t& len)
+{
+  len=0;
+  if (n==0) return NULL;
+
+  len=headerSize();
+  for (size_t k=0; k<streams.size(); k++) len+=streams[k].getSize();
+  out.resize(len);
+
+  char* p=&out[0];
+  gecoBinFile::putLE(p, len, 4);
+  gecoBinFile::putLE(p+4, n, 4);
+  gecoBinFile::putLE(p+8, (unsigned long long)firstTime, 8);
+  p+=16;
+  for (size_t k=0; k<streams.size(); k++, p+=4)
+    gecoBinFile::putLE(p, streams[k].getSize(), 4);
+  for (size_t k=0; k<streams.size(); k++)
+    {
+      if (!streams[k].buf.empty())
+	memcpy(p, &streams[k].buf[0], streams[k].buf.size());
+      p+=streams[k].buf.size();
+      if (streams[k].fill>0) *p++=(char)streams[k].cur;
+      streams[k].clear();
+    }
+
+  n=0;
+  bits=0;
+  firstTime=0;
+  pending.clear();
+  encodedBytes+=len;
+  return &out[0];
+}
+
+
+// ---------------------------------------------------------------
+//
+// class gecoBlockDecoder : decompresses blocks of records
+//
+
+
+/**
+ * @brief Returns the size of a block (bytes) from its header
+*/
+
+size_t gecoBlockDecoder::getSize(const char* block)
+{
+  return gecoBinFile::getLE(block, 4);
+}
+
+
+/**
+ * @brief Returns the number of records of a block from its header
+*/
+
+int gecoBlockDecoder::getRecords(const char* block)
+{
+  return (int)gecoBinFile::getLE(block+4, 4);
+}
+
+
+/**
+ * @brief Returns the timestamp of the first record of a block (ns) from its header
+*/
+
+long long gecoBlockDecoder::getFirstTime(const char* block)
+{
+  return (long long)gecoBinFile::getLE(block+8, 8);
+}
+
+
+/**
+ * @brief Decodes a block
+ * @param bin layout of the records
+ * @param block the block
+ * @param len bytes available at block
+ * @param recs buffer for gecoBlockDecoder::getRecords records
+ * \return the number of records decoded or -1 if the block is corrupted
+*/
+
+int gecoBlockDecoder::decode(gecoBinFile* bin, const char* block, size_t len, char* recs)
+{
+  int    nc=bin->getNbrColumns();
+  int    rs=bin->getRecordSize();
+  size_t hs=16+4*(size_t)nc;
+  if ((len<hs)||(getSize(block)>len)) return -1;
+  int    n=getRecords(block);
+  size_t pos=hs;
+
+  for (int k=0; k<nc; k++)
+    {
+      size_t sl=gecoBinFile::getLE(block+16+4*k, 4);
+      if (pos+sl>getSize(block)) return -1;
+      gecoBitReader in(block+pos, sl);
+      pos+=sl;
+
+      int    type=bin->getColumnType(k);
+      int    size=BinColSize[type];
+      int    width=8*size;
+      int    lead=0, trail=0;
+      unsigned long long v=0, delta=0;
+      for (int r=0; r<n; r++)
+	{
+	  if (r==0)
+	    {
+	      v=in.get(width);
+	      if (type==BinCol_int) v=(unsigned long long)(long long)(int)v;
+	    }
+	  else if (isInteger(type))
+	    {
+	      unsigned long long u=0;
+	      if (in.get(1))
+		{
+		  int b=0;
+		  while ((b<DodBuckets-1)&&(in.get(1))) b++;
+		  u=in.get(DodBits[b]);
+		}
+	      delta+=unzigzag(u);
+	      v+=delta;
+	    }
+	  else if (in.get(1))
+	    {
+	      if (in.get(1))
+		{
+		  lead=(int)in.get(5);
+		  int l=(int)in.get((width==64) ? 6 : 5)+1;
+		  trail=width-lead-l;
+		  if (trail<0) return -1;
+		}
+	      v^=in.get(width-lead-trail)<<trail;
+	    }
+	  if (in.error) return -1;
+	  gecoBinFile::putLE(recs+(size_t)r*rs+bin->getColumnOffset(k), v, size);
+	}
+    }
+  return n;
+}
@@ -0,0 +1,168 @@
+// This may look like C code, but it is really -*- C++ -*-
+// ----------------------------------------------------------------
+//
+// Header file for classes gecoBlockEncoder and gecoBlockDecoder
+//
+// (c) Rolf Wuthrich
+//     2026 Concordia University
+//
+// author:  agent
+// email:   agent@local
+// version: v1
+//
+// This software is copyright under the BSD license
+//
+// ---------------------------------------------------------------
+// history:
+// ---------------------------------------------------------------
+// Date       Modification                     Author
+// ---------------------------------------------------------------
+// 17.10.2026 Creation                         agent
+//
+// ---------------------------------------------------------------
+/*! \file */
+
+#ifndef gecoBlockCodec_SEEN_
+#define gecoBlockCodec_SEEN_
+
+#include <stddef.h>
+#include <vector>
+#include "gecoBinFile.h"
+
+using namespace std;
+
+
+// ------------------------------------------------------------------------
+//
+// Encodings of the records
+//
+
+const int
+  Encoding_none    = 0,       // fixed-width records
+  Encoding_gorilla = 1;       // compressed blocks of records
+
+extern const char* EncodingStr[];
+
+const int BlockMaxRecords = 1024;   // records per block at most
+
+
+// -------------------------------------------------------------------------
+//
+// Stream of bits of a column
+//
+
+struct gecoBitStream
+{
+  vector<unsigned char> buf;        // complete bytes
+  unsigned int          cur;        // byte being filled
+  int                   fill;       // bits used in cur
+
+  void   clear() {buf.clear(); cur=0; fill=0;}
+  void   put(unsigned long long v, int n);
+  size_t getSize() {return buf.size()+((fill>0) ? 1 : 0);}
+};
+
+
+// -----------------------------------------------------------------------
+//
+// class gecoBlockEncoder : compresses records in blocks
+//
+
+/**
+ * @brief Compresses the records of a gecoBinFile in blocks
+ * \author agent
+ * \date 2026
+ *
+ * A gecoBlockEncoder compresses fixed-width records (see gecoBinFile) column
+ * by column, in the spirit of the Gorilla time series database:
+ *
+ * Type                   | Encoding
+ * ---------------------- | ------------------------------------------------------
+ * timestamp, int, wide   | delta of the delta with the previous value, in 1 to 69 bits
+ * double, float          | XOR with the previous value, only its meaningful bits
+ *
+ * Regularly sampled timestamps and slowly varying values therefore take a few
+ * bits per record. The encoding is lossless.
+ *
+ * The records are added one by one with gecoBlockEncoder::add, which costs a few
+ * bit operations per column. Once gecoBlockEncoder::isFull, the block is closed
+ * with gecoBlockEncoder::finish. Until then, the records of the block are available
+ * uncompressed with gecoBlockEncoder::getPending. Each block is decoded
+ * independently of the others:
+ *
+ * Bytes        | Content
+ * ------------ | ------------------------------------------------------
+ * 4            | size of the block in bytes (uint32)
+ * 4            | number of records n (uint32)
+ * 8            | timestamp of the first record (int64, ns)
+ * 4 per column | size of the bit stream of each column (uint32)
+ * ...          | bit streams of the columns, in declaration order
+ *
+ * All numbers are little-endian. The blocks are decoded with gecoBlockDecoder.
+ */
+
+class gecoBlockEncoder
+{
+
+private:
+
+  gecoBinFile*                bin;          // layout of the records
+  vector<gecoBitStream>       streams;      // one per column
+  vector<unsigned long long>  prev;         // previous value of each column
+  vector<unsigned long long>  prevDelta;    // previous delta (integer columns)
+  vector<int>                 lead, trail;  // previous XOR window (floating point columns)
+  vector<char>                out;          // last finished block
+  vector<char>                pending;      // records of the block (uncompressed)
+  int                         n;            // records in the block
+  int                         maxRecords;   // records per block at most
+  size_t                      maxBytes;     // size of a block at most
+  size_t                      bits;         // bits used by the block
+  size_t                      maxRecordBits; // bits used by a record at most
+  long long                   firstTime;    // timestamp of the first record
+
+  long long                   rawBytes;     // size of the records encoded
+  long long                   encodedBytes; // size of the blocks finished
+
+  void         put(int k, unsigned long long v, int nb) {streams[k].put(v, nb); bits+=nb;}
+  void         putDod(int k, unsigned long long v);
+  void         putXor(int k, unsigned long long v, int width);
+
+public:
+
+  gecoBlockEncoder(gecoBinFile* Bin);
+
+  void         setup(int MaxRecords, size_t MaxBytes);
+  void         add(const char* rec);
+  const char*  finish(size_t& len);
+  bool         isFull();
+  int          getRecords()   {return n;}              /*!< Returns the number of records in the block */
+  const char*  getPending()   {return (n>0) ? &pending[0] : NULL;} /*!< Returns the records of the block, uncompressed */
+  long long    getRawBytes()  {return rawBytes;}       /*!< Returns the size of the records encoded (bytes) */
+  long long    getEncodedBytes() {return encodedBytes;} /*!< Returns the size of the blocks finished (bytes) */
+  size_t       headerSize()   {return 16+4*streams.size();}  /*!< Returns the size of the header of a block */
+};
+
+
+// -----------------------------------------------------------------------
+//
+// class gecoBlockDecoder : decompresses blocks of records
+//
+
+/**
+ * @brief Decompresses the blocks written by gecoBlockEncoder
+ * \author agent
+ * \date 2026
+ */
+
+class gecoBlockDecoder
+{
+
+public:
+
+  static size_t     getSize(const char* block);
+  static int        getRecords(const char* block);
+  static long long  getFirstTime(const char* block);
+  static int        decode(gecoBinFile* bin, const char* block, size_t len, char* recs);
+};
+
+#endif /* gecoBlockCodec_SEEN_ */
@@ -19,11 +19,16 @@
 // ---------------------------------------------------------------
 // 25.10.2015 Creation                         R. Wuthrich
 // 08.12.2020 Added doxygen documentation      R. Wuthrich
+// 17.10.2026 Absolute deadline scheduler      agent
+// 17.10.2026 Added event queue statistics     agent
+// 17.10.2026 Added overrun policies           agent
 //
 // ---------------------------------------------------------------
 
 #include <tcl.h>
 #include <math.h>
+#include <time.h>
+#include <errno.h>
 #include <cstring>
 #include "gecoEvent.h"
 #include "gecoClock.h"
@@ -54,6 +59,10 @@ gecoClock::gecoClock(gecoApp* App) :
   holdOn = 0;
   holdDuration = 0.0;
   tick = 1;
+  period = 1000;
+  scheduler = Scheduler_relative;
+  overrunPolicy = Overrun_skip;
+  deadline = 0;
 
   // initialization of IO operation statistics
   min = 1e6;
@@ -62,9 +71,26 @@ gecoClock::gecoClock(gecoApp* App) :
   sqr_sum_dt = 0.0;
   n = 0;
 
+  // initialization of the phase error statistics
+  phase_sum = 0.0;
+  phase_sqr_sum = 0.0;
+  phase_max = 0.0;
+  nPhase = 0;
+
+  // initialization of the overrun accounting
+  overruns = 0;
+  missedTicks = 0;
+  for (int k=0; k<JitterBins; k++) jitterHist[k] = 0;
+
   // options
   addOption("-IOStat", "returns statistics on IO operations");
   addOption("-tick", &tick, "returns/sets clock tick (ms)");
+  addOption("-period", &period, "returns/sets clock period of absolute scheduler (us)");
+  addOption("-scheduler", "returns/sets the scheduler (relative or absolute)");
+  addOption("-overrunPolicy", "returns/sets the overrun policy (skip, catchup or stretch)");
+  addOption("-overruns", "returns the number of overruns");
+  addOption("-missedTicks", "returns the number of missed ticks");
+  addOption("-jitterHist", "returns the jitter histogram");
   addOption("-reset", "resets the clock");
 }
 
@@ -88,8 +114,111 @@ gecoClock::~gecoClock()
 int gecoClock::cmd(int &i, int objc,Tcl_Obj *const objv[])
 {
   // first executes the command options defined in gecoProcess
+  int j=i;
+  int oldTick=tick;
+  int oldPeriod=period;
   int index=gecoProcess::cmd(i,objc,objv);
 
+  // keeps tick and period consistent when one of them was set
+  if ((index==getOptionIndex("-tick"))&&(i==j+2))
+    {
+      if (tick<1)
+	{
+	  Tcl_AppendResult(interp, "tick must be a positive integer", NULL);
+	  tick = oldTick;
+	  return -1;
+	}
+      setTick(tick);
+    }
+
+  if ((index==getOptionIndex("-period"))&&(i==j+2))
+    {
+      if (period<1)
+	{
+	  Tcl_AppendResult(interp, "period must be a positive integer", NULL);
+	  period = oldPeriod;
+	  return -1;
+	}
+      setPeriod(period);
+    }
+
+  if (index==getOptionIndex("-scheduler"))
+    {
+      if ((i+1<=objc-1)&&(Tcl_StringMatch(Tcl_GetString(objv[i+1]), "-*")==0))
+	{
+	  if (strcmp(Tcl_GetString(objv[i+1]), "relative")==0)
+	    setScheduler(Scheduler_relative);
+	  else
+	    if (strcmp(Tcl_GetString(objv[i+1]), "absolute")==0)
+	      setScheduler(Scheduler_absolute);
+	    else
+	      {
+		Tcl_AppendResult(interp, "invalid scheduler \"",
+				 Tcl_GetString(objv[i+1]),
+				 "\": must be \"relative\" or \"absolute\"", NULL);
+		return -1;
+	      }
+	  i=i+2;
+	}
+      else
+	{
+	  Tcl_AppendResult(interp, SchedulerStr[scheduler], NULL);
+	  i++;
+	}
+    }
+
+  if (index==getOptionIndex("-overrunPolicy"))
+    {
+      if ((i+1<=objc-1)&&(Tcl_StringMatch(Tcl_GetString(objv[i+1]), "-*")==0))
+	{
+	  int k;
+	  for (k=0; k<3; k++)
+	    if (strcmp(Tcl_GetString(objv[i+1]), OverrunPolicyStr[k])==0) break;
+	  if (k==3)
+	    {
+	      Tcl_AppendResult(interp, "invalid overrun policy \"",
+			       Tcl_GetString(objv[i+1]),
+			       "\": must be \"skip\", \"catchup\" or \"stretch\"", NULL);
+	      return -1;
+	    }
+	  setOverrunPolicy(k);
+	  i=i+2;
+	}
+      else
+	{
+	  Tcl_AppendResult(interp, OverrunPolicyStr[overrunPolicy], NULL);
+	  i++;
+	}
+    }
+
+  if (index==getOptionIndex("-overruns"))
+    {
+      char str[30];
+      sprintf(str, "%ld", overruns);
+      Tcl_AppendResult(interp, str, NULL);
+      i++;
+    }
+
+  if (index==getOptionIndex("-missedTicks"))
+    {
+      char str[30];
+      sprintf(str, "%ld", missedTicks);
+      Tcl_AppendResult(interp, str, NULL);
+      i++;
+    }
+
+  if (index==getOptionIndex("-jitterHist"))
+    {
+      char str[30];
+      for (int k=0; k<JitterBins; k++)
+	{
+	  sprintf(str, "%ld", jitterHist[k]);
+	  Tcl_AppendElement(interp, JitterBinStr[k]);
+	  Tcl_AppendElement(interp, str);
+	}
+      i++;
+    }
+
   if (index==getOptionIndex("-reset"))
     {
      if (objc!=2)
@@ -183,6 +312,9 @@ Tcl_DString* gecoClock::info(const char* frontStr)
 {
   gecoProcess::info(frontStr);
   addInfo(frontStr, "Tick:\t", tick);  
+  addInfo(frontStr, "Period (us):\t", period);
+  addInfo(frontStr, "Scheduler:\t", SchedulerStr[scheduler]);
+  addInfo(frontStr, "Overrun policy:\t", OverrunPolicyStr[overrunPolicy]);
   return infoStr;
 }
 
@@ -199,6 +331,34 @@ void gecoClock::addStatReco(double dt)
   n++;
   sum_dt=sum_dt+dt;
   sqr_sum_dt=sqr_sum_dt+dt*dt;
+
+  // overrun accounting against the nominal period
+  double nominal = (scheduler==Scheduler_absolute) ? period*1e-6 : tick*1e-3;
+  long missed = (long)floor(dt/nominal+0.5)-1;
+  if (missed>0)
+    {
+      overruns++;
+      missedTicks=missedTicks+missed;
+    }
+
+  double jitter = fabs(dt-nominal);
+  int k = (jitter<1e-6) ? 0 : (int)floor(log10(jitter*1e6))+1;
+  if (k>=JitterBins) k=JitterBins-1;
+  jitterHist[k]++;
+}
+
+
+/**
+ * @brief adds an entry to the statistics about the phase error of the absolute scheduler
+ * @param phase delay (s) between the deadline and the effective start of the geco process loop
+*/
+
+void gecoClock::addPhaseReco(double phase)
+{
+  if (phase_max<phase) phase_max=phase;
+  nPhase++;
+  phase_sum=phase_sum+phase;
+  phase_sqr_sum=phase_sqr_sum+phase*phase;
 }
 
 
@@ -217,6 +377,18 @@ void gecoClock::reset()
   sqr_sum_dt = 0.0;
   n = 0;
 
+  phase_sum = 0.0;
+  phase_sqr_sum = 0.0;
+  phase_max = 0.0;
+  nPhase = 0;
+
+  overruns = 0;
+  missedTicks = 0;
+  for (int k=0; k<JitterBins; k++) jitterHist[k] = 0;
+
+  // restarts the deadlines of the absolute scheduler from now
+  deadline = 0;
+
   // record time origin
   gettimeofday(&activationTime, NULL);
 }
@@ -278,4 +450,159 @@ void gecoClock::iostat()
   Tcl_AppendResult(interp, "max      = ", NULL);
   Tcl_PrintDouble(interp, 1000.0*max/n*n, str);
   Tcl_AppendResult(interp, str, " ms\n", NULL);
+
+  Tcl_AppendResult(interp, "rate     = ", NULL);
+  Tcl_PrintDouble(interp, n/sum_dt, str);
+  Tcl_AppendResult(interp, str, " Hz\n", NULL);
+
+  gecoEventQueue* q = app->getEvent()->getQueue();
+  snprintf(str, 80, "Events: %ld posted, %ld dispatched, %ld rejected, %d queued\n",
+	  q->getPosted(), q->getDispatched(), q->getRejected(), q->depth());
+  Tcl_AppendResult(interp, str, NULL);
+  Tcl_AppendResult(interp, "event delay max = ", NULL);
+  Tcl_PrintDouble(interp, 1000.0*q->getMaxDelay(), str);
+  Tcl_AppendResult(interp, str, " ms\n", NULL);
+
+  snprintf(str, 80, "overruns = %ld (%ld missed ticks, policy %s)\n",
+	   overruns, missedTicks, OverrunPolicyStr[overrunPolicy]);
+  Tcl_AppendResult(interp, str, NULL);
+  Tcl_AppendResult(interp, "jitter   =", NULL);
+  for (int k=0; k<JitterBins; k++)
+    {
+      snprintf(str, 80, " %s:%ld", JitterBinStr[k], jitterHist[k]);
+      Tcl_AppendResult(interp, str, NULL);
+    }
+  Tcl_AppendResult(interp, "\n", NULL);
+
+  if (scheduler==Scheduler_relative) return;
+
+  sprintf(str, "Scheduler: absolute (period = %d us)\n", period);
+  Tcl_AppendResult(interp, str, NULL);
+  if (nPhase==0)
+    {
+      Tcl_AppendResult(interp, "no phase sample yet\n", NULL);
+      return;
+    }
+
+  double mean = phase_sum/nPhase;
+  Tcl_AppendResult(interp, "<phase>  = ", NULL);
+  Tcl_PrintDouble(interp, 1e6*mean, str);
+  Tcl_AppendResult(interp, str, " us\n", NULL);
+
+  Tcl_AppendResult(interp, "phase sd = ", NULL);
+  Tcl_PrintDouble(interp, 1e6*sqrt(fabs(phase_sqr_sum/nPhase-mean*mean)), str);
+  Tcl_AppendResult(interp, str, " us\n", NULL);
+
+  Tcl_AppendResult(interp, "phase max= ", NULL);
+  Tcl_PrintDouble(interp, 1e6*phase_max, str);
+  Tcl_AppendResult(interp, str, " us\n", NULL);
+}
+
+
+/**
+ * @brief sets the period of the absolute scheduler
+ * @param Period period (us) between two runs of the geco process loop
+ *
+ * The tick is set to the closest value in ms (at least 1 ms).
+*/
+
+void gecoClock::setPeriod(int Period)
+{
+  period = Period;
+  tick = (Period+500)/1000;
+  if (tick<1) tick = 1;
+  deadline = 0;
+}
+
+
+/**
+ * @brief sets the scheduler
+ * @param Scheduler Scheduler_relative or Scheduler_absolute
+*/
+
+void gecoClock::setScheduler(int Scheduler)
+{
+  scheduler = Scheduler;
+  deadline = 0;
+}
+
+
+/**
+ * @brief returns the current time of CLOCK_MONOTONIC
+ * \return time in ns
+*/
+
+long long gecoClock::monotonicTime()
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (long long)ts.tv_sec*1000000000LL+ts.tv_nsec;
+}
+
+
+/**
+ * @brief waits for the deadline of the absolute scheduler
+ *
+ * Called by geco_eventLoop() before running the geco process loop. Sleeps with
+ * clock_nanosleep() until the deadline and records the phase error.
+*/
+
+void gecoClock::waitDeadline()
+{
+  long long now = monotonicTime();
+  if (deadline==0) deadline = now;
+
+  if (now<deadline)
+    {
+      struct timespec ts;
+      ts.tv_sec  = deadline/1000000000LL;
+      ts.tv_nsec = deadline%1000000000LL;
+      while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL)==EINTR);
+      now = monotonicTime();
+    }
+
+  addPhaseReco((now-deadline)*1e-9);
+}
+
+
+/**
+ * @brief computes the delay to be used to re-arm the Tcl timer of geco_eventLoop()
+ * \return delay in ms
+ *
+ * With the relative scheduler returns the tick. With the absolute scheduler
+ * advances the deadline by one period (handling deadlines already missed
+ * according to the overrun policy) and returns the delay to wake up about 
+ * 1 ms before the deadline. The remaining
+ * time is waited for by gecoClock::waitDeadline.
+*/
+
+int gecoClock::nextTimerDelay()
+{
+  if (scheduler==Scheduler_relative) return tick;
+
+  long long now = monotonicTime();
+  long long p   = 1000LL*period;
+  if (deadline==0) deadline = now;
+  deadline = deadline+p;
+
+  // handles deadlines already missed according to the overrun policy
+  if (deadline<now)
+    {
+      long long missed = (now-deadline)/p+1;
+      switch (overrunPolicy)
+	{
+	case Overrun_catchup:
+	  if (missed>CatchupMax) deadline = deadline+(missed-CatchupMax)*p;
+	  break;
+	case Overrun_stretch:
+	  deadline = now+p;
+	  break;
+	default:
+	  deadline = deadline+missed*p;
+	}
+    }
+
+  long long delay = (deadline-now)/1000000LL-1;
+  if (delay<0) delay = 0;
+  return (int)delay;
 }
@@ -20,6 +20,9 @@
 // ---------------------------------------------------------------
 // 25.17.2015 Creation                         R. Wuthrich
 // 08.12.2020 Added doxygen documentation      R. Wuthrich
+// 17.10.2026 Absolute deadline scheduler      agent
+// 17.10.2026 Added event queue statistics     agent
+// 17.10.2026 Added overrun policies           agent
 //
 // ---------------------------------------------------------------
 
@@ -27,11 +30,50 @@
 #define gecoClock_SEEN_
 
 #include <tcl8.6/tcl.h>
+#include <time.h>
 #include "gecoProcess.h"
 
 using namespace std;
 
 
+// ---------------------------------------------------------------
+//
+// Scheduler types
+//
+
+const int
+  Scheduler_relative = 0,     // re-arms the loop tick ms after each run
+  Scheduler_absolute = 1;     // runs the loop on absolute CLOCK_MONOTONIC deadlines
+
+const char SchedulerStr[2][9] = {"relative", "absolute"};
+
+
+// ---------------------------------------------------------------
+//
+// Overrun policies
+//
+
+const int
+  Overrun_skip    = 0,        // skips the missed deadlines
+  Overrun_catchup = 1,        // runs the missed deadlines in a burst
+  Overrun_stretch = 2;        // restarts the deadlines from the late run
+
+const char OverrunPolicyStr[3][8] = {"skip", "catchup", "stretch"};
+
+const int CatchupMax = 100;   // max number of missed deadlines caught up in a burst
+
+
+// ---------------------------------------------------------------
+//
+// Jitter histogram
+//
+
+const int JitterBins = 8;     // decades of |dt - nominal period| from 1 us to 1 s
+
+const char JitterBinStr[JitterBins][9] = 
+  {"< 1us", "< 10us", "< 100us", "< 1ms", "< 10ms", "< 100ms", "< 1s", ">= 1s"};
+
+
 // ---------------------------------------------------------------
 //
 // class gecoClock : class responsible for updating time
@@ -54,8 +96,53 @@ using namespace std;
  * The tick value is used by geco_eventLoop() to register itself 
  * again continuously for a callback.
  *
+ * Scheduler
+ * ---------
+ * Two schedulers are available and can be selected with the subcommand
+ * '-scheduler':
+ *
+ * Scheduler  | Description
+ * ---------- | ---------------------------
+ * relative   | geco_eventLoop() re-arms itself tick ms after all processes have run (default)
+ * absolute   | geco_eventLoop() runs on absolute CLOCK_MONOTONIC deadlines spaced by period
+ *
+ * With the relative scheduler the processing time of each run of the geco
+ * process loop adds to the tick, such that the loop drifts. The absolute
+ * scheduler computes the deadline of the next run as the previous deadline
+ * plus the period (in micro-seconds, set with '-period'), independently of
+ * the time spent in the processes. The Tcl timer is armed to wake up slightly
+ * before the deadline and the remaining time is waited for with clock_nanosleep().
+ * Deadlines which were missed completely are skipped.
+ *
+ * Setting '-tick' sets the period to tick*1000 us; setting '-period' sets
+ * the tick to the closest value in ms (at least 1 ms).
+ *
+ * The achieved rate and the phase error (delay between the deadline and the
+ * effective start of the run of the geco process loop) are reported by '-IOStat'.
+ *
+ * Overruns
+ * --------
+ * A run of the geco process loop overruns when the time since the previous
+ * run is more than 1.5 times the nominal period (tick or period depending on 
+ * the scheduler). The number of overruns, the number of missed ticks and a 
+ * histogram (by decades) of the jitter |dt - nominal period| are reported by 
+ * '-IOStat' and by the subcommands '-overruns', '-missedTicks' and '-jitterHist'.
+ *
+ * What happens after an overrun with the absolute scheduler is set with the 
+ * subcommand '-overrunPolicy':
+ *
+ * Policy   | Description
+ * -------- | ---------------------------
+ * skip     | the missed deadlines are skipped; the loop stays on its deadline grid (default)
+ * catchup  | the missed deadlines are run in a burst (at most CatchupMax, the others are skipped)
+ * stretch  | the deadlines restart one period after the late run (the grid is shifted)
+ *
+ * The relative scheduler always behaves as 'stretch'.
+ *
  * The gecoClock class keeps as well statistics on the execution
- * of the geco process loop.
+ * of the geco process loop. '-IOStat' reports as well the counters of
+ * the gecoEventQueue (posted, dispatched and rejected event commands and
+ * the max delay between posting and dispatching an event command).
  *
  * Associated Tcl command
  * ----------------------
@@ -72,6 +159,12 @@ using namespace std;
  * ----------------- | ------------------
  * -IOStat           | returns statistics on IO operations
  * -tick             | returns/sets clock tick (ms)
+ * -period           | returns/sets clock period for the absolute scheduler (us)
+ * -scheduler        | returns/sets the scheduler (relative or absolute)
+ * -overrunPolicy    | returns/sets the overrun policy (skip, catchup or stretch)
+ * -overruns         | returns the number of overruns
+ * -missedTicks      | returns the number of missed ticks
+ * -jitterHist       | returns the jitter histogram
  * -reset            | resets the clock
  *
  */
@@ -96,10 +189,28 @@ private:
   double   sqr_sum_dt;
   int      n;
 
+  // entries for the absolute scheduler
+  long long deadline;           // next deadline [ns] on CLOCK_MONOTONIC (0 if not set)
+  double    phase_sum;
+  double    phase_sqr_sum;
+  double    phase_max;
+  int       nPhase;
+
+  // entries for overrun accounting
+  long      overruns;
+  long      missedTicks;
+  long      jitterHist[JitterBins];
+
+  static long long monotonicTime();
+
 protected:
 
   int      tick;                /*!< output update rate [ms] i.e. interval between 
                                      two calls of the geco eventLoop */
+  int      period;              /*!< period [us] between two runs of the geco eventLoop
+                                     with the absolute scheduler */
+  int      scheduler;           /*!< scheduler type (Scheduler_relative or Scheduler_absolute) */
+  int      overrunPolicy;       /*!< overrun policy of the absolute scheduler */
 
 public:
 
@@ -111,9 +222,21 @@ public:
   virtual Tcl_DString* info(const char* frontStr = "");
 
   void addStatReco(double dt);
+  void addPhaseReco(double phase);
   void reset();
-  void setTick(int Tick) {tick=Tick;}  /*!< sets the tick value */
+  void setTick(int Tick) {tick=Tick; period=1000*Tick; deadline=0;}  /*!< sets the tick value */
   int  getTick() {return tick;}        /*!< returns the tick value */
+  void setPeriod(int Period);
+  int  getPeriod() {return period;}    /*!< returns the period value (us) */
+  void setScheduler(int Scheduler);
+  int  getScheduler() {return scheduler;} /*!< returns the scheduler type */
+  void setOverrunPolicy(int Policy) {overrunPolicy=Policy;}  /*!< sets the overrun policy */
+  int  getOverrunPolicy() {return overrunPolicy;}            /*!< returns the overrun policy */
+  long getOverruns() {return overruns;}                      /*!< returns the number of overruns */
+  long getMissedTicks() {return missedTicks;}                /*!< returns the number of missed ticks */
+
+  void waitDeadline();
+  int  nextTimerDelay();
 
   void hold();
   void resume();
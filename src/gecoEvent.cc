@@ -19,15 +19,120 @@
 // ---------------------------------------------------------------
 // 17.10.2015 Creation                         R. Wuthrich
 // 05.12.2020 Added doxygen documentation      R. Wuthrich
+// 17.10.2026 Added lock-free event queue      agent
+// 17.10.2026 Time registered as native var    agent
 //
 // ---------------------------------------------------------------
 
+#include <time.h>
 #include "gecoEvent.h"
 #include "gecoApp.h"
 
 using namespace std;
 
 
+// -----------------------------------------------------------------------
+//
+// class gecoEventQueue : bounded lock-free queue of event commands
+//
+
+static double monotonicTime()
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec/1e9;
+}
+
+
+/**
+ * @brief Constructor
+*/
+
+gecoEventQueue::gecoEventQueue() :
+  enqPos(0),
+  deqPos(0),
+  posted(0),
+  rejected(0),
+  dispatched(0),
+  maxDelay(0.0)
+{
+  for (int i=0; i<EventQueueSize; i++)
+    cell[i].seq.store(i, memory_order_relaxed);
+}
+
+
+/**
+ * @brief Posts an event command
+ * @param Cmd event command to post
+ * @param EventGenerator gecoProcess which generated the command
+ * \return true in case of success and false if the queue is full
+ *
+ * Can be called from any thread.
+*/
+
+bool gecoEventQueue::post(int Cmd, gecoProcess* EventGenerator)
+{
+  Cell* c;
+  unsigned long pos = enqPos.load(memory_order_relaxed);
+  for (;;)
+    {
+      c = &cell[pos & (EventQueueSize-1)];
+      long diff = (long)c->seq.load(memory_order_acquire) - (long)pos;
+      if (diff==0)
+	{
+	  if (enqPos.compare_exchange_weak(pos, pos+1, memory_order_relaxed)) break;
+	}
+      else if (diff<0)
+	{
+	  rejected++;
+	  return false;
+	}
+      else
+	pos = enqPos.load(memory_order_relaxed);
+    }
+
+  c->ev.cmd       = Cmd;
+  c->ev.generator = EventGenerator;
+  c->ev.postTime  = monotonicTime();
+  c->seq.store(pos+1, memory_order_release);
+  posted++;
+  return true;
+}
+
+
+/**
+ * @brief Removes the oldest event command
+ * @param ev filled with the removed event command
+ * \return true if an event command was removed and false if the queue is empty
+ *
+ * Must only be called from the thread running the geco process loop.
+*/
+
+bool gecoEventQueue::pop(gecoQueuedEvent& ev)
+{
+  Cell* c = &cell[deqPos & (EventQueueSize-1)];
+  if (c->seq.load(memory_order_acquire)!=deqPos+1) return false;
+  ev = c->ev;
+  c->seq.store(deqPos+EventQueueSize, memory_order_release);
+  deqPos++;
+
+  dispatched++;
+  double delay = monotonicTime()-ev.postTime;
+  if (delay>maxDelay) maxDelay=delay;
+  return true;
+}
+
+
+/**
+ * @brief Returns the number of event commands waiting in the queue
+*/
+
+int gecoEventQueue::depth()
+{
+  return (int)(enqPos.load(memory_order_relaxed)-deqPos);
+}
+
+
 // -----------------------------------------------------------------------
 //
 // class gecoEvent : class for event manipulation and storing
@@ -48,11 +153,15 @@ gecoEvent::gecoEvent(gecoApp* App) :
     app(App),
     eventType(NoEvent), 
     generator(NULL),
+    EvCmd(NoCmd),
+    queued(false),
+    deferred(false),
     t(0.0),
     EventLoopStatus(0)
 {
   interp = App->getInterp();
   Tcl_LinkVar(interp, "t", (char *)&t, TCL_LINK_DOUBLE|TCL_LINK_READ_ONLY);
+  App->linkNativeVar("t", &t);
 }
 
 
@@ -63,6 +172,7 @@ gecoEvent::gecoEvent(gecoApp* App) :
 gecoEvent::~gecoEvent()
 {
   Tcl_UnlinkVar(interp, "t");
+  app->unlinkNativeVar("t");
 }
 
 
@@ -90,6 +200,7 @@ void gecoEvent::reset()
   eventType = NoEvent;
   generator = NULL;
   EvCmd = NoCmd;
+  queued = false;
 }
 
 
@@ -97,12 +208,67 @@ void gecoEvent::reset()
  * @brief Sets an event command
  * @param Cmd event command to set
  * @param EventGenerator gecoProcess which sets the command
+ *
+ * If the event carries a command loaded from the queue and not consumed yet,
+ * a different command is posted to the queue instead of overwriting it.
  */
 
 void gecoEvent::setCmdEvent(int Cmd, gecoProcess* EventGenerator)
+{
+  if ((deferred)||((queued)&&((Cmd!=EvCmd)||(EventGenerator!=generator))))
+    {
+      postCmdEvent(Cmd, EventGenerator);
+      return;
+    }
+  eventType = CmdEvent;
+  EvCmd = Cmd;
+  generator = EventGenerator;
+}
+
+
+/**
+ * @brief Loads an event command taken from the queue
+ * @param Cmd event command to load
+ * @param EventGenerator gecoProcess which generated the command
+ */
+
+void gecoEvent::loadCmdEvent(int Cmd, gecoProcess* EventGenerator)
 {
   eventType = CmdEvent;
   EvCmd = Cmd;
   generator = EventGenerator;
+  queued = true;
+}
+
+
+/**
+ * @brief Posts an event command to be dispatched by the geco process loop
+ * @param Cmd event command to post
+ * @param EventGenerator gecoProcess which generated the command
+ * \return true in case of success and false if the event queue is full
+ *
+ * Can be called from any thread.
+ */
+
+bool gecoEvent::postCmdEvent(int Cmd, gecoProcess* EventGenerator)
+{
+  return queue.post(Cmd, EventGenerator);
+}
+
+
+/**
+ * @brief Loads the next posted event command if the event is empty
+ * \return true if an event command was loaded
+ *
+ * Called by geco_eventLoop() at the start of each run of the geco process loop.
+ */
+
+bool gecoEvent::nextCmdEvent()
+{
+  if (EvCmd!=NoCmd) return false;
+  gecoQueuedEvent ev;
+  if (!queue.pop(ev)) return false;
+  loadCmdEvent(ev.cmd, ev.generator);
+  return true;
 }
 
@@ -20,6 +20,7 @@
 // ---------------------------------------------------------------
 // 17.10.2015 Creation                         R. Wuthrich
 // 05.12.2020 Added doxygen documentation      R. Wuthrich
+// 17.10.2026 Added lock-free event queue      agent
 //
 // ---------------------------------------------------------------
 
@@ -28,6 +29,7 @@
 
 #include <tcl8.6/tcl.h>
 #include <iostream>
+#include <atomic>
 
 using namespace std;
 
@@ -58,13 +60,79 @@ const int
 
 
 
+class gecoProcess; // forward definition
+class gecoApp;     // forward definition
+
+
 // -----------------------------------------------------------------------
 //
-// class gecoEvent : class for event manipulation and storing
+// class gecoEventQueue : bounded lock-free queue of event commands
 //
 
-class gecoProcess; // forward definition
-class gecoApp;     // forward definition
+const int EventQueueSize = 256;   // capacity of the gecoEventQueue (power of 2)
+
+/**
+ * @brief Event command waiting in the gecoEventQueue
+ */
+
+struct gecoQueuedEvent
+{
+  int           cmd;              /*!< event command */
+  gecoProcess*  generator;        /*!< gecoProcess which generated the event */
+  double        postTime;         /*!< CLOCK_MONOTONIC time (s) at which the event was posted */
+};
+
+/** 
+ * @brief Bounded lock-free multi-producer single-consumer queue of event commands
+ * \author agent
+ * \date 2026
+ *
+ * Any thread can post event commands with gecoEventQueue::post. Only the
+ * geco process loop removes them with gecoEventQueue::pop. Each cell carries
+ * a sequence number telling producers and consumer whose turn it is, so that
+ * no lock is needed. When the queue is full, gecoEventQueue::post fails and 
+ * the event command is rejected: it is never silently overwritten.
+ */
+
+class gecoEventQueue
+{
+private:
+
+  struct Cell
+  {
+    atomic<unsigned long> seq;
+    gecoQueuedEvent       ev;
+  };
+
+  Cell                   cell[EventQueueSize];
+  atomic<unsigned long>  enqPos;
+  unsigned long          deqPos;
+
+  // statistics
+  atomic<long>           posted;
+  atomic<long>           rejected;
+  long                   dispatched;
+  double                 maxDelay;
+
+public:
+
+  gecoEventQueue();
+
+  bool   post(int Cmd, gecoProcess* EventGenerator);
+  bool   pop(gecoQueuedEvent& ev);
+
+  long   getPosted()     {return posted.load();}    /*!< Returns the number of posted event commands */
+  long   getRejected()   {return rejected.load();}  /*!< Returns the number of rejected event commands */
+  long   getDispatched() {return dispatched;}       /*!< Returns the number of dispatched event commands */
+  double getMaxDelay()   {return maxDelay;}         /*!< Returns the max delay (s) between posting and dispatching */
+  int    depth();
+};
+
+
+// -----------------------------------------------------------------------
+//
+// class gecoEvent : class for event manipulation and storing
+//
 
 /** 
  * @brief Class for storing and manipulating geco events
@@ -107,6 +175,25 @@ class gecoApp;     // forward definition
  * CmdResume             | User issued the 'resume' command
  * CmdProcessTerminated  | A gecoProcess was terminated 
  * CmdProcedureActivated | A gecoProcess was activated
+ *
+ * Event queue
+ * -----------
+ * A gecoEvent holds a single event command which is passed along the geco 
+ * process loop during one run of geco_eventLoop(). Inside this run, the
+ * gecoProcess modify it with gecoEvent::setCmdEvent and gecoEvent::reset.
+ *
+ * Event commands coming from outside the geco process loop (Tcl commands 
+ * like 'start' or 'stop', the TCP server, other threads) must be posted with
+ * gecoEvent::postCmdEvent. They are stored in a gecoEventQueue and loaded one 
+ * by one, at the start of each run of geco_eventLoop(), with gecoEvent::nextCmdEvent.
+ * Event commands issued within a same tick are therefore dispatched on successive
+ * ticks instead of overwriting each other.
+ *
+ * A command loaded from the gecoEventQueue is never overwritten within the
+ * geco process loop: until a gecoProcess consumes it (gecoEvent::reset), a
+ * different command set with gecoEvent::setCmdEvent is posted to the queue
+ * instead. A posted CmdProcessTerminated is dispatched to the gecoProcess
+ * following its generator only, as if it had been set within the loop.
  */
 
 class gecoEvent
@@ -119,10 +206,14 @@ protected:
   int           eventType;
   gecoProcess*  generator;
   int           EvCmd;
+  bool          queued;        // EvCmd was loaded from the queue and not consumed
+  bool          deferred;      // commands set are posted to the queue
 
   int           EventLoopStatus;
   double        t;
 
+  gecoEventQueue queue;
+
 public:
 
   gecoEvent(gecoApp* App);
@@ -132,6 +223,11 @@ public:
   gecoProcess* eventGenerator();
   void     reset();
   void     setCmdEvent(int Cmd, gecoProcess* EventGenerator);
+  bool     postCmdEvent(int Cmd, gecoProcess* EventGenerator);
+  bool     nextCmdEvent();
+  void     loadCmdEvent(int Cmd, gecoProcess* EventGenerator);
+  void     deferCmdEvents(bool Deferred) {deferred=Deferred;}  /*!< Posts the commands set to the queue if true */
+  gecoEventQueue* getQueue() {return &queue;}  /*!< Returns the queue of posted event commands */
 
   void     setEventType(int type)          {eventType=type;}           /*!< Sets the type of the event */
   void     setEventLoopStatus(int status)  {EventLoopStatus=status;}   /*!< Sets the status of the event loop*/
@@ -0,0 +1,986 @@
+// ---------------------------------------------------------------
+//
+// Definition of the class gecoExpr
+//
+// (c) Rolf Wuthrich
+//     2026 Concordia University
+//
+// author:  agent
+// email:   agent@local
+// version: v1
+//
+// This software is copyright under the BSD license
+//
+// ---------------------------------------------------------------
+// history:
+// ---------------------------------------------------------------
+// Date       Modification                     Author
+// ---------------------------------------------------------------
+// 17.10.2026 Creation                         agent
+// 17.10.2026 Added evaluation as a double     agent
+//
+// ---------------------------------------------------------------
+
+#include <tcl.h>
+#include <cstring>
+#include <cstdlib>
+#include <cerrno>
+#include <cctype>
+#include <cmath>
+#include <climits>
+#include "gecoExpr.h"
+#include "gecoApp.h"
+
+using namespace std;
+
+
+// ---------------------------------------------------------------
+//
+// Operations and functions of the compiled program
+//
+
+enum
+  {
+    Op_const, Op_native, Op_var,
+    Op_neg, Op_pos, Op_not, Op_bitnot,
+    Op_pow, Op_mul, Op_div, Op_mod, Op_add, Op_sub, Op_shl, Op_shr,
+    Op_lt, Op_gt, Op_le, Op_ge, Op_eq, Op_ne,
+    Op_bitand, Op_bitxor, Op_bitor,
+    Op_and, Op_or, Op_bool, Op_jumpFalse, Op_jump, Op_func
+  };
+
+enum
+  {
+    F_abs, F_double, F_int, F_round, F_ceil, F_floor, F_sqrt, F_exp,
+    F_log, F_log10, F_sin, F_cos, F_tan, F_asin, F_acos, F_atan,
+    F_sinh, F_cosh, F_tanh, F_atan2, F_fmod, F_hypot, F_pow, F_min, F_max
+  };
+
+struct gecoExprFunc
+{
+  const char* name;
+  int         id;
+  int         minArgs;
+  int         maxArgs;
+};
+
+static const gecoExprFunc exprFuncs[] =
+  {
+    {"abs", F_abs, 1, 1},     {"double", F_double, 1, 1}, {"int", F_int, 1, 1},
+    {"wide", F_int, 1, 1},    {"entier", F_int, 1, 1},    {"round", F_round, 1, 1},
+    {"ceil", F_ceil, 1, 1},   {"floor", F_floor, 1, 1},   {"sqrt", F_sqrt, 1, 1},
+    {"exp", F_exp, 1, 1},     {"log", F_log, 1, 1},       {"log10", F_log10, 1, 1},
+    {"sin", F_sin, 1, 1},     {"cos", F_cos, 1, 1},       {"tan", F_tan, 1, 1},
+    {"asin", F_asin, 1, 1},   {"acos", F_acos, 1, 1},     {"atan", F_atan, 1, 1},
+    {"sinh", F_sinh, 1, 1},   {"cosh", F_cosh, 1, 1},     {"tanh", F_tanh, 1, 1},
+    {"atan2", F_atan2, 2, 2}, {"fmod", F_fmod, 2, 2},     {"hypot", F_hypot, 2, 2},
+    {"pow", F_pow, 2, 2},     {"min", F_min, 1, 64},      {"max", F_max, 1, 64},
+    {NULL, 0, 0, 0}
+  };
+
+// binary operators by level of precedence (lowest first, level 11 is '**')
+// longer operators must come before their prefixes
+
+struct gecoExprOperator
+{
+  const char* str;
+  int         op;
+};
+
+static const gecoExprOperator exprOperators[11][5] =
+  {
+    {{NULL, 0}},
+    {{"||", Op_or}, {NULL, 0}},
+    {{"&&", Op_and}, {NULL, 0}},
+    {{"|", Op_bitor}, {NULL, 0}},
+    {{"^", Op_bitxor}, {NULL, 0}},
+    {{"&", Op_bitand}, {NULL, 0}},
+    {{"==", Op_eq}, {"!=", Op_ne}, {NULL, 0}},
+    {{"<=", Op_le}, {">=", Op_ge}, {"<", Op_lt}, {">", Op_gt}, {NULL, 0}},
+    {{"<<", Op_shl}, {">>", Op_shr}, {NULL, 0}},
+    {{"+", Op_add}, {"-", Op_sub}, {NULL, 0}},
+    {{"*", Op_mul}, {"/", Op_div}, {"%", Op_mod}, {NULL, 0}}
+  };
+
+
+// ---------------------------------------------------------------
+//
+// Auxiliary functions
+//
+
+static inline double toDouble(const gecoExprValue& v)
+{
+  return (v.isInt) ? (double)v.i : v.d;
+}
+
+static inline bool isTrue(const gecoExprValue& v)
+{
+  return (v.isInt) ? (v.i!=0) : (v.d!=0.0);
+}
+
+static inline void setInt(gecoExprValue& v, long long i)
+{
+  v.isInt = true;
+  v.i = i;
+}
+
+static inline bool setDouble(gecoExprValue& v, double d)
+{
+  v.isInt = false;
+  v.d = d;
+  return !isnan(d);       // Tcl raises a domain error on NaN
+}
+
+
+/**
+ * @brief Reads a number from a Tcl_Obj like the Tcl 'expr' command
+ * \return false if the Tcl_Obj is not a number which can be handled natively
+ */
+
+static bool getNumber(Tcl_Obj* obj, gecoExprValue* v)
+{
+  static const Tcl_ObjType* doubleType = Tcl_GetObjType("double");
+  static const Tcl_ObjType* bignumType = Tcl_GetObjType("bignum");
+
+  Tcl_WideInt w;
+  double d;
+
+  if (obj->typePtr==doubleType)
+    {
+      Tcl_GetDoubleFromObj(NULL, obj, &d);
+      return setDouble(*v, d);
+    }
+  if ((obj->typePtr==bignumType)&&(bignumType!=NULL)) return false;
+  if (Tcl_GetWideIntFromObj(NULL, obj, &w)==TCL_OK)
+    {
+      setInt(*v, w);
+      return true;
+    }
+  if (Tcl_GetDoubleFromObj(NULL, obj, &d)!=TCL_OK) return false;
+  return setDouble(*v, d);
+}
+
+
+/**
+ * @brief Applies a binary operator
+ * \return false if the operation can't be done natively
+ */
+
+static bool binaryOp(int op, gecoExprValue& a, const gecoExprValue& b)
+{
+  bool ints = a.isInt && b.isInt;
+  long long r;
+
+  switch (op)
+    {
+    case Op_add:
+      if (!ints) return setDouble(a, toDouble(a)+toDouble(b));
+      if (__builtin_add_overflow(a.i, b.i, &r)) return false;
+      a.i = r;
+      return true;
+
+    case Op_sub:
+      if (!ints) return setDouble(a, toDouble(a)-toDouble(b));
+      if (__builtin_sub_overflow(a.i, b.i, &r)) return false;
+      a.i = r;
+      return true;
+
+    case Op_mul:
+      if (!ints) return setDouble(a, toDouble(a)*toDouble(b));
+      if (__builtin_mul_overflow(a.i, b.i, &r)) return false;
+      a.i = r;
+      return true;
+
+    case Op_div:
+      if (!ints) return setDouble(a, toDouble(a)/toDouble(b));
+      if ((b.i==0)||((a.i==LLONG_MIN)&&(b.i==-1))) return false;
+      r = a.i/b.i;
+      if ((a.i%b.i!=0)&&((a.i<0)!=(b.i<0))) r--;     // Tcl rounds towards -inf
+      a.i = r;
+      return true;
+
+    case Op_mod:
+      if ((!ints)||(b.i==0)) return false;
+      if (b.i==-1) {a.i = 0; return true;}
+      r = a.i%b.i;
+      if ((r!=0)&&((r<0)!=(b.i<0))) r += b.i;         // sign of the divisor
+      a.i = r;
+      return true;
+
+    case Op_pow:
+      if (!ints)
+	{
+	  if ((toDouble(a)==0.0)&&(toDouble(b)<0.0)) return false;
+	  return setDouble(a, pow(toDouble(a), toDouble(b)));
+	}
+      if (b.i<0)
+	{
+	  if (a.i==0) return false;
+	  if (a.i==1) return true;
+	  if (a.i==-1) {a.i = (b.i%2) ? -1 : 1; return true;}
+	  a.i = 0;
+	  return true;
+	}
+      r = 1;
+      {
+	long long base = a.i, e = b.i;
+	while (e>0)
+	  {
+	    if ((e&1)&&(__builtin_mul_overflow(r, base, &r))) return false;
+	    e >>= 1;
+	    if ((e>0)&&(__builtin_mul_overflow(base, base, &base))) return false;
+	  }
+      }
+      a.i = r;
+      return true;
+
+    case Op_shl:
+      if ((!ints)||(b.i<0)) return false;
+      if (a.i==0) return true;
+      if ((b.i>=63)||(a.i>(LLONG_MAX>>b.i))||(a.i<(LLONG_MIN>>b.i))) return false;
+      a.i = a.i*(1LL<<b.i);
+      return true;
+
+    case Op_shr:
+      if ((!ints)||(b.i<0)) return false;
+      a.i = (b.i>=63) ? ((a.i<0) ? -1 : 0) : (a.i>>b.i);
+      return true;
+
+    case Op_bitand:
+      if (!ints) return false;
+      a.i &= b.i;
+      return true;
+
+    case Op_bitxor:
+      if (!ints) return false;
+      a.i ^= b.i;
+      return true;
+
+    case Op_bitor:
+      if (!ints) return false;
+      a.i |= b.i;
+      return true;
+
+    case Op_lt:
+      setInt(a, (ints) ? (a.i<b.i) : (toDouble(a)<toDouble(b)));
+      return true;
+
+    case Op_gt:
+      setInt(a, (ints) ? (a.i>b.i) : (toDouble(a)>toDouble(b)));
+      return true;
+
+    case Op_le:
+      setInt(a, (ints) ? (a.i<=b.i) : (toDouble(a)<=toDouble(b)));
+      return true;
+
+    case Op_ge:
+      setInt(a, (ints) ? (a.i>=b.i) : (toDouble(a)>=toDouble(b)));
+      return true;
+
+    case Op_eq:
+      setInt(a, (ints) ? (a.i==b.i) : (toDouble(a)==toDouble(b)));
+      return true;
+
+    case Op_ne:
+      setInt(a, (ints) ? (a.i!=b.i) : (toDouble(a)!=toDouble(b)));
+      return true;
+    }
+
+  return false;
+}
+
+
+/**
+ * @brief Applies a math function to the n arguments in arg
+ * \return false if the function can't be evaluated natively
+ */
+
+static bool mathFunc(int id, int n, gecoExprValue* arg)
+{
+  gecoExprValue& a = arg[0];
+  double x = toDouble(a);
+  double y = (n>1) ? toDouble(arg[1]) : 0.0;
+
+  switch (id)
+    {
+    case F_abs:
+      if (!a.isInt) return setDouble(a, fabs(a.d));
+      if (a.i==LLONG_MIN) return false;
+      a.i = llabs(a.i);
+      return true;
+
+    case F_double: return setDouble(a, x);
+
+    case F_int:
+      if (a.isInt) return true;
+      if (fabs(a.d)>=9.2e18) return false;
+      setInt(a, (long long)a.d);
+      return true;
+
+    case F_round:
+      if (a.isInt) return true;
+      if (fabs(a.d)>=9.2e18) return false;
+      setInt(a, llround(a.d));
+      return true;
+
+    case F_ceil:  return setDouble(a, ceil(x));
+    case F_floor: return setDouble(a, floor(x));
+    case F_sqrt:  return setDouble(a, sqrt(x));
+    case F_exp:   return setDouble(a, exp(x));
+    case F_log:   return setDouble(a, log(x));
+    case F_log10: return setDouble(a, log10(x));
+    case F_sin:   return setDouble(a, sin(x));
+    case F_cos:   return setDouble(a, cos(x));
+    case F_tan:   return setDouble(a, tan(x));
+    case F_asin:  return setDouble(a, asin(x));
+    case F_acos:  return setDouble(a, acos(x));
+    case F_atan:  return setDouble(a, atan(x));
+    case F_sinh:  return setDouble(a, sinh(x));
+    case F_cosh:  return setDouble(a, cosh(x));
+    case F_tanh:  return setDouble(a, tanh(x));
+    case F_atan2: return setDouble(a, atan2(x, y));
+    case F_fmod:  return setDouble(a, fmod(x, y));
+    case F_hypot: return setDouble(a, hypot(x, y));
+    case F_pow:   return setDouble(a, pow(x, y));
+
+    case F_min:
+    case F_max:
+      for (int k=1; k<n; k++)
+	{
+	  gecoExprValue cmp = arg[k];
+	  binaryOp((id==F_min) ? Op_lt : Op_gt, cmp, a);
+	  if (cmp.i) a = arg[k];
+	}
+      return true;
+    }
+
+  return false;
+}
+
+
+// ---------------------------------------------------------------
+//
+// class gecoExpr : natively compiled Tcl expression
+//
+
+
+/**
+ * @brief Constructor
+ * @param App gecoApp providing the native variables
+ * @param Source Tcl_DString containing the expression
+ * @param Mode Expr_expression if Source is an expression, Expr_script if it is a Tcl script
+*/
+
+gecoExpr::gecoExpr(gecoApp* App, Tcl_DString* Source, int Mode) :
+  app(App),
+  source(Source),
+  mode(Mode),
+  compiled(false),
+  native(false),
+  epoch(0)
+{
+  tclCode = new gecoScript(Source);
+}
+
+
+/**
+ * @brief Destructor
+*/
+
+gecoExpr::~gecoExpr()
+{
+  clearCode();
+  delete tclCode;
+}
+
+
+/**
+ * @brief Discards the compiled expression
+ *
+ * Must be called whenever the source Tcl_DString is changed.
+*/
+
+void gecoExpr::invalidate()
+{
+  clearCode();
+  tclCode->invalidate();
+}
+
+
+/**
+ * @brief Returns true if the expression is evaluated natively
+ *
+ * Compiles the expression if needed.
+*/
+
+bool gecoExpr::isNative()
+{
+  if ((!compiled)||(epoch!=app->getNativeVarsEpoch())) compile();
+  return native;
+}
+
+
+/**
+ * @brief Evaluates the expression as a boolean
+ * @param interp Tcl interpreter used for the variables and the fallback
+ * @param b is set to the boolean value of the expression
+ * \return TCL_OK in case of success and TCL_ERROR otherwise
+*/
+
+int gecoExpr::exprBoolean(Tcl_Interp* interp, int* b)
+{
+  gecoExprValue v;
+  if ((isNative())&&(run(interp, &v)))
+    {
+      *b = isTrue(v);
+      return TCL_OK;
+    }
+  return tclCode->exprBoolean(interp, b);
+}
+
+
+/**
+ * @brief Evaluates the expression as a double
+ * @param interp Tcl interpreter used for the variables and the fallback
+ * @param d is set to the value of the expression
+ * \return TCL_OK in case of success and TCL_ERROR otherwise
+*/
+
+int gecoExpr::exprDouble(Tcl_Interp* interp, double* d)
+{
+  gecoExprValue v;
+  if ((isNative())&&(run(interp, &v)))
+    {
+      *d = (v.isInt) ? (double)v.i : v.d;
+      return TCL_OK;
+    }
+  Tcl_Obj* result;
+  if (tclCode->expr(interp, &result)!=TCL_OK) return TCL_ERROR;
+  int ret=Tcl_GetDoubleFromObj(interp, result, d);
+  Tcl_DecrRefCount(result);
+  return ret;
+}
+
+
+/**
+ * @brief Evaluates the expression and returns its result as a string
+ * @param interp Tcl interpreter used for the variables and the fallback
+ * @param len if not NULL, is set to the length of the result
+ * \return the result, or the error message of Tcl in case of error
+ *
+ * The returned string is only valid until the next evaluation. In Expr_script
+ * mode the result is the one of the script (e.g. 'STOP').
+*/
+
+const char* gecoExpr::evalString(Tcl_Interp* interp, int* len)
+{
+  gecoExprValue v;
+  if ((isNative())&&(run(interp, &v)))
+    {
+      if (v.isInt)
+	snprintf(strResult, sizeof(strResult), "%lld", v.i);
+      else
+	Tcl_PrintDouble(NULL, v.d, strResult);
+      if (len) *len = strlen(strResult);
+      return strResult;
+    }
+
+  if (mode==Expr_script)
+    tclCode->eval(interp);
+  else
+    {
+      Tcl_Obj* result;
+      if (tclCode->expr(interp, &result)==TCL_OK)
+	{
+	  Tcl_SetObjResult(interp, result);
+	  Tcl_DecrRefCount(result);
+	}
+    }
+  return Tcl_GetStringFromObj(Tcl_GetObjResult(interp), len);
+}
+
+
+// ---- compiler
+
+void gecoExpr::clearCode()
+{
+  for (unsigned int k=0; k<code.size(); k++)
+    {
+      if (code[k].part1) Tcl_DecrRefCount(code[k].part1);
+      if (code[k].part2) Tcl_DecrRefCount(code[k].part2);
+    }
+  code.clear();
+  compiled = false;
+  native = false;
+}
+
+
+/**
+ * @brief Compiles the expression
+ *
+ * Sets native to false if the expression can't be compiled natively.
+*/
+
+void gecoExpr::compile()
+{
+  clearCode();
+  compiled = true;
+  epoch = app->getNativeVarsEpoch();
+
+  pos = Tcl_DStringValue(source);
+  end = pos + Tcl_DStringLength(source);
+
+  // in script mode only 'expr {...}' is compiled
+  if (mode==Expr_script)
+    {
+      skipSpace();
+      if ((end-pos<5)||(strncmp(pos, "expr", 4)!=0)||(!isspace(pos[4]))) return;
+      pos += 4;
+      skipSpace();
+      if ((pos==end)||(*pos!='{')) return;
+      const char* body = ++pos;
+      int level = 1;
+      while ((pos<end)&&(level>0))
+	{
+	  if (*pos=='\\') return;
+	  if (*pos=='{') level++;
+	  if (*pos=='}') level--;
+	  pos++;
+	}
+      if (level>0) return;
+      const char* close = pos-1;
+      while ((pos<end)&&((isspace(*pos))||(*pos==';'))) pos++;
+      if (pos!=end) return;
+      pos = body;
+      end = close;
+    }
+
+  depth = 0;
+  maxDepth = 0;
+  bool ok = parseTernary();
+  skipSpace();
+  if ((!ok)||(pos!=end)||(depth!=1))
+    {
+      clearCode();
+      compiled = true;
+      return;
+    }
+
+  stack.resize(maxDepth);
+  native = true;
+}
+
+
+void gecoExpr::emit(int op, int arg)
+{
+  gecoExprInsn insn;
+  insn.op = op;
+  insn.arg = arg;
+  insn.val.isInt = true;
+  insn.val.i = 0;
+  insn.val.d = 0.0;
+  insn.ptr = NULL;
+  insn.part1 = NULL;
+  insn.part2 = NULL;
+  code.push_back(insn);
+}
+
+
+void gecoExpr::push(int n)
+{
+  depth += n;
+  if (depth>maxDepth) maxDepth = depth;
+}
+
+
+void gecoExpr::skipSpace()
+{
+  while ((pos<end)&&(isspace(*pos))) pos++;
+}
+
+
+bool gecoExpr::parseTernary()
+{
+  if (!parseBinary(1)) return false;
+  skipSpace();
+  if ((pos==end)||(*pos!='?')) return true;
+  pos++;
+
+  int jumpElse = code.size();
+  emit(Op_jumpFalse);
+  push(-1);
+  if (!parseTernary()) return false;
+  int jumpEnd = code.size();
+  emit(Op_jump);
+  push(-1);
+
+  skipSpace();
+  if ((pos==end)||(*pos!=':')) return false;
+  pos++;
+  code[jumpElse].arg = code.size();
+  if (!parseTernary()) return false;
+  code[jumpEnd].arg = code.size();
+  return true;
+}
+
+
+/**
+ * @brief Matches a binary operator of the given level of precedence
+ * \return the operation or -1 if there is none
+ */
+
+int gecoExpr::matchOperator(int level)
+{
+  skipSpace();
+  for (int k=0; exprOperators[level][k].str; k++)
+    {
+      const char* s = exprOperators[level][k].str;
+      int n = strlen(s);
+      if ((end-pos<n)||(strncmp(pos, s, n)!=0)) continue;
+      // '|' is not '||', '&' is not '&&', '*' is not '**', '<' is not '<<'...
+      if ((n==1)&&(strchr("|&*<>", s[0]))&&(pos+1<end)&&(pos[1]==s[0])) continue;
+      pos += n;
+      return exprOperators[level][k].op;
+    }
+  return -1;
+}
+
+
+bool gecoExpr::parseBinary(int level)
+{
+  if (level>10)
+    {
+      // '**' is right associative and binds less than the unary operators
+      if (!parseUnary()) return false;
+      skipSpace();
+      if ((end-pos>=2)&&(pos[0]=='*')&&(pos[1]=='*'))
+	{
+	  pos += 2;
+	  if (!parseBinary(11)) return false;
+	  emit(Op_pow);
+	  push(-1);
+	}
+      return true;
+    }
+
+  if (!parseBinary(level+1)) return false;
+  int op;
+  while ((op=matchOperator(level))!=-1)
+    {
+      if ((op==Op_and)||(op==Op_or))
+	{
+	  int jump = code.size();
+	  emit(op);
+	  push(-1);
+	  if (!parseBinary(level+1)) return false;
+	  emit(Op_bool);
+	  code[jump].arg = code.size();
+	}
+      else
+	{
+	  if (!parseBinary(level+1)) return false;
+	  emit(op);
+	  push(-1);
+	}
+    }
+  return true;
+}
+
+
+bool gecoExpr::parseUnary()
+{
+  skipSpace();
+  if (pos==end) return false;
+  int op = -1;
+  if (*pos=='-') op = Op_neg;
+  if (*pos=='+') op = Op_pos;
+  if (*pos=='!') op = Op_not;
+  if (*pos=='~') op = Op_bitnot;
+  if (op==-1) return parsePrimary();
+  pos++;
+  if (!parseUnary()) return false;
+  emit(op);
+  return true;
+}
+
+
+bool gecoExpr::parsePrimary()
+{
+  skipSpace();
+  if (pos==end) return false;
+
+  if (*pos=='(')
+    {
+      pos++;
+      if (!parseTernary()) return false;
+      skipSpace();
+      if ((pos==end)||(*pos!=')')) return false;
+      pos++;
+      return true;
+    }
+
+  if (*pos=='$') return parseVariable();
+  if ((isdigit(*pos))||((*pos=='.')&&(pos+1<end)&&(isdigit(pos[1])))) return parseNumber();
+  if ((isalpha(*pos))||(*pos=='_')) return parseFunction();
+
+  // strings, command substitution...
+  return false;
+}
+
+
+bool gecoExpr::parseNumber()
+{
+  gecoExprValue v;
+  char* e;
+
+  errno = 0;
+  if ((pos[0]=='0')&&(pos+1<end)&&((pos[1]=='x')||(pos[1]=='X')))
+    {
+      if ((pos+2==end)||(!isxdigit(pos[2]))) return false;
+      setInt(v, strtoll(pos+2, &e, 16));
+    }
+  else
+    {
+      // leading zeros are octal in Tcl 8.6
+      if ((pos[0]=='0')&&(pos+1<end)&&(isdigit(pos[1]))) return false;
+      const char* p = pos;
+      bool isFloat = false;
+      while ((p<end)&&(isdigit(*p))) p++;
+      if ((p<end)&&((*p=='.')||(*p=='e')||(*p=='E'))) isFloat = true;
+      if (isFloat)
+	setDouble(v, strtod(pos, &e));
+      else
+	setInt(v, strtoll(pos, &e, 10));
+    }
+
+  if ((errno==ERANGE)||(e>end)) return false;
+  pos = e;
+  if ((pos<end)&&((isalnum(*pos))||(*pos=='_')||(*pos=='.'))) return false;
+
+  emit(Op_const);
+  code.back().val = v;
+  push(1);
+  return true;
+}
+
+
+bool gecoExpr::parseVariable()
+{
+  pos++;
+  const char* name = pos;
+  int nameLen;
+
+  if ((pos<end)&&(*pos=='{'))
+    {
+      name = ++pos;
+      while ((pos<end)&&(*pos!='}')) pos++;
+      if (pos==end) return false;
+      nameLen = pos-name;
+      pos++;
+    }
+  else
+    {
+      while (pos<end)
+	{
+	  if ((isalnum(*pos))||(*pos=='_'))
+	    pos++;
+	  else if ((*pos==':')&&(pos+1<end)&&(pos[1]==':'))
+	    while ((pos<end)&&(*pos==':')) pos++;
+	  else
+	    break;
+	}
+      nameLen = pos-name;
+    }
+  if (nameLen==0) return false;
+
+  // array element with a literal index
+  Tcl_Obj* part2 = NULL;
+  if ((pos<end)&&(*pos=='('))
+    {
+      const char* index = ++pos;
+      while ((pos<end)&&(*pos!=')'))
+	{
+	  if ((*pos=='$')||(*pos=='[')||(*pos=='\\')||(*pos=='(')) return false;
+	  pos++;
+	}
+      if (pos==end) return false;
+      part2 = Tcl_NewStringObj(index, pos-index);
+      pos++;
+    }
+
+  Tcl_DString varName;
+  Tcl_DStringInit(&varName);
+  Tcl_DStringAppend(&varName, name, nameLen);
+
+  // binds the variable to its native storage if any
+  double* ptr = NULL;
+  if (part2==NULL)
+    {
+      const char* n = Tcl_DStringValue(&varName);
+      if (strncmp(n, "::", 2)==0) n += 2;
+      ptr = app->findNativeVar(n);
+    }
+
+  if (ptr)
+    {
+      emit(Op_native);
+      code.back().ptr = ptr;
+    }
+  else
+    {
+      emit(Op_var);
+      code.back().part1 = Tcl_NewStringObj(Tcl_DStringValue(&varName), -1);
+      Tcl_IncrRefCount(code.back().part1);
+      if (part2)
+	{
+	  code.back().part2 = part2;
+	  Tcl_IncrRefCount(part2);
+	}
+    }
+  Tcl_DStringFree(&varName);
+  push(1);
+  return true;
+}
+
+
+bool gecoExpr::parseFunction()
+{
+  const char* name = pos;
+  while ((pos<end)&&((isalnum(*pos))||(*pos=='_'))) pos++;
+  int nameLen = pos-name;
+
+  const gecoExprFunc* f = exprFuncs;
+  while ((f->name)&&((strlen(f->name)!=(size_t)nameLen)||(strncmp(f->name, name, nameLen)!=0))) f++;
+  if (f->name==NULL) return false;     // operators like 'eq', booleans...
+
+  skipSpace();
+  if ((pos==end)||(*pos!='(')) return false;
+  pos++;
+
+  int n = 0;
+  skipSpace();
+  if ((pos<end)&&(*pos==')'))
+    pos++;
+  else
+    while (true)
+      {
+	if (!parseTernary()) return false;
+	n++;
+	skipSpace();
+	if (pos==end) return false;
+	if (*pos==')') {pos++; break;}
+	if (*pos!=',') return false;
+	pos++;
+      }
+  if ((n<f->minArgs)||(n>f->maxArgs)) return false;
+
+  emit(Op_func, n);
+  code.back().val.i = f->id;
+  push(1-n);
+  return true;
+}
+
+
+// ---- evaluation
+
+/**
+ * @brief Runs the compiled program
+ * \return false if the expression can't be evaluated natively
+ */
+
+bool gecoExpr::run(Tcl_Interp* interp, gecoExprValue* v)
+{
+  gecoExprValue* s = stack.data();
+  int sp = 0;
+  int n = code.size();
+  int pc = 0;
+
+  while (pc<n)
+    {
+      const gecoExprInsn& insn = code[pc++];
+      switch (insn.op)
+	{
+	case Op_const:
+	  s[sp++] = insn.val;
+	  break;
+
+	case Op_native:
+	  if (!setDouble(s[sp++], *insn.ptr)) return false;
+	  break;
+
+	case Op_var:
+	  {
+	    Tcl_Obj* obj = Tcl_ObjGetVar2(interp, insn.part1, insn.part2, 0);
+	    if ((obj==NULL)||(!getNumber(obj, &s[sp]))) return false;
+	    sp++;
+	  }
+	  break;
+
+	case Op_neg:
+	  if (s[sp-1].isInt)
+	    {
+	      if (s[sp-1].i==LLONG_MIN) return false;
+	      s[sp-1].i = -s[sp-1].i;
+	    }
+	  else
+	    s[sp-1].d = -s[sp-1].d;
+	  break;
+
+	case Op_pos:
+	  break;
+
+	case Op_not:
+	  setInt(s[sp-1], !isTrue(s[sp-1]));
+	  break;
+
+	case Op_bitnot:
+	  if (!s[sp-1].isInt) return false;
+	  s[sp-1].i = ~s[sp-1].i;
+	  break;
+
+	case Op_and:
+	  sp--;
+	  if (!isTrue(s[sp]))
+	    {
+	      setInt(s[sp++], 0);
+	      pc = insn.arg;
+	    }
+	  break;
+
+	case Op_or:
+	  sp--;
+	  if (isTrue(s[sp]))
+	    {
+	      setInt(s[sp++], 1);
+	      pc = insn.arg;
+	    }
+	  break;
+
+	case Op_bool:
+	  setInt(s[sp-1], isTrue(s[sp-1]));
+	  break;
+
+	case Op_jumpFalse:
+	  sp--;
+	  if (!isTrue(s[sp])) pc = insn.arg;
+	  break;
+
+	case Op_jump:
+	  pc = insn.arg;
+	  break;
+
+	case Op_func:
+	  sp -= insn.arg;
+	  if (!mathFunc(insn.val.i, insn.arg, &s[sp])) return false;
+	  sp++;
+	  break;
+
+	default:
+	  sp--;
+	  if (!binaryOp(insn.op, s[sp-1], s[sp])) return false;
+	}
+    }
+
+  *v = s[0];
+  return true;
+}
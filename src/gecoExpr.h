@@ -0,0 +1,169 @@
+// This may look like C code, but it is really -*- C++ -*-
+// ----------------------------------------------------------------
+//
+// Header file for class gecoExpr
+//
+// (c) Rolf Wuthrich
+//     2026 Concordia University
+//
+// author:  agent
+// email:   agent@local
+// version: v1
+//
+// This software is copyright under the BSD license
+//
+// ---------------------------------------------------------------
+// history:
+// ---------------------------------------------------------------
+// Date       Modification                     Author
+// ---------------------------------------------------------------
+// 17.10.2026 Creation                         agent
+// 17.10.2026 Added evaluation as a double     agent
+//
+// ---------------------------------------------------------------
+/*! \file */
+
+#ifndef gecoExpr_SEEN_
+#define gecoExpr_SEEN_
+
+#include <tcl8.6/tcl.h>
+#include <vector>
+#include "gecoScript.h"
+
+using namespace std;
+
+class gecoApp;                // forward definition
+
+
+// ------------------------------------------------------------------------
+//
+// Modes of a gecoExpr
+//
+
+const int
+  Expr_expression = 0,        // source is a Tcl expression
+  Expr_script     = 1;        // source is a Tcl script
+
+
+// ------------------------------------------------------------------------
+//
+// Value and instruction of a compiled gecoExpr
+//
+
+/**
+ * @brief Numeric value handled by a compiled gecoExpr
+ */
+
+struct gecoExprValue
+{
+  bool       isInt;           /*!< true if the value is an integer */
+  long long  i;               /*!< value if integer */
+  double     d;               /*!< value if floating point */
+};
+
+/**
+ * @brief Instruction of a compiled gecoExpr
+ */
+
+struct gecoExprInsn
+{
+  int            op;          /*!< operation */
+  int            arg;         /*!< jump target or number of arguments */
+  gecoExprValue  val;         /*!< constant */
+  double*        ptr;         /*!< native storage of a variable */
+  Tcl_Obj*       part1;       /*!< name of a Tcl variable */
+  Tcl_Obj*       part2;       /*!< array index of a Tcl variable (or NULL) */
+};
+
+
+// -----------------------------------------------------------------------
+//
+// class gecoExpr : natively compiled Tcl expression
+//
+
+/**
+ * @brief Tcl expression compiled to native code, with fallback to Tcl
+ * \author agent
+ * \date 2026
+ *
+ * A gecoExpr compiles the numeric Tcl expression contained in a Tcl_DString
+ * (typically the variable of a subcommand like '-cut' or '-x') into a small
+ * stack program evaluated without the Tcl interpreter. In Expr_script mode,
+ * the source is a Tcl script and only a script of the form 'expr {...}' is
+ * compiled.
+ *
+ * The compiler handles integer and floating point numbers, variables ($name,
+ * ${name} and $name(index) with a literal index), the arithmetic, comparison,
+ * bitwise, logical and ternary operators and the usual math functions (abs,
+ * sqrt, sin, pow, min, max...). It follows the semantics of the Tcl 'expr'
+ * command (integer division, type of the result...).
+ *
+ * Variables are bound once, at compilation. A variable registered as native
+ * in the gecoApp (see gecoApp::linkNativeVar, e.g. the time $t) is read
+ * directly from its storage. The others are read with Tcl_ObjGetVar2 from a
+ * persistent name, without parsing their string representation if they hold
+ * a number.
+ *
+ * Anything the compiler can't handle (strings, command substitution, 'eq'...)
+ * is evaluated by Tcl with a gecoScript. The same happens for a single
+ * evaluation which fails natively (non numeric variable, integer overflow,
+ * division by zero...), so that Tcl returns the usual result or error.
+ *
+ * Like for gecoScript, the owner must call gecoExpr::invalidate whenever the
+ * Tcl_DString is changed. The gecoExpr is compiled at the next evaluation.
+ */
+
+class gecoExpr
+{
+
+private:
+
+  gecoApp*              app;
+  Tcl_DString*          source;       // source of the expression
+  int                   mode;         // Expr_expression or Expr_script
+  gecoScript*           tclCode;      // fallback evaluated by Tcl
+
+  bool                  compiled;     // true if compile() was called
+  bool                  native;       // true if the expression is compiled natively
+  unsigned long         epoch;        // epoch of the native variables of the gecoApp at compilation
+  vector<gecoExprInsn>  code;         // compiled program
+  vector<gecoExprValue> stack;        // evaluation stack
+  char                  strResult[TCL_DOUBLE_SPACE+8];
+
+  // parser
+  const char*           pos;          // current position in the source
+  const char*           end;          // end of the source
+  int                   depth;        // current depth of the stack
+  int                   maxDepth;     // max depth of the stack
+
+  void         compile();
+  void         clearCode();
+  void         emit(int op, int arg = 0);
+  void         push(int n);
+  bool         parseTernary();
+  bool         parseBinary(int level);
+  bool         parseUnary();
+  bool         parsePrimary();
+  bool         parseNumber();
+  bool         parseVariable();
+  bool         parseFunction();
+  int          matchOperator(int level);
+  void         skipSpace();
+
+  bool         run(Tcl_Interp* interp, gecoExprValue* v);
+
+public:
+
+  gecoExpr(gecoApp* App, Tcl_DString* Source, int Mode = Expr_expression);
+  ~gecoExpr();
+
+  void         invalidate();
+  bool         isNative();
+  bool         isEmpty() {return Tcl_DStringLength(source)==0;}  /*!< Returns true if the source is empty */
+
+  int          exprBoolean(Tcl_Interp* interp, int* b);
+  int          exprDouble(Tcl_Interp* interp, double* d);
+  const char*  evalString(Tcl_Interp* interp, int* len = NULL);
+};
+
+#endif /* gecoExpr_SEEN_ */
@@ -19,11 +19,23 @@
 // ---------------------------------------------------------------
 // 23.10.2015 Creation                         R. Wuthrich
 // 08.12.2020 Added doxygen documentation      R. Wuthrich
+// 17.10.2026 Cached bytecode of scripts       agent
+// 17.10.2026 Compiled cut filter              agent
+// 17.10.2026 Added binary format              agent
+// 17.10.2026 Added background writer          agent
+// 17.10.2026 Records built by gecoBinRecord   agent
+// 17.10.2026 Added compressed binary format   agent
+// 17.10.2026 Added rotation of the file       agent
+// 17.10.2026 Added native text encoding       agent
+// 18.10.2026 Counted queued records          agent
+// 18.10.2026 Block index written as trailer    agent
 //
 // ---------------------------------------------------------------
 
 #include <tcl.h>
 #include <cstring>
+#include <time.h>
+#include <cerrno>
 #include "gecoFileStream.h"
 #include "gecoApp.h"
 
@@ -53,12 +65,28 @@ int geco_FileStreamCmd(ClientData clientData, Tcl_Interp *interp,
 // class gecoFileStream: a class to stream data to a file
 //
 
+// returns the index of str in the NULL terminated table or -1
+static int tableIndex(const char* str, const char** table)
+{
+  for (int k=0; table[k]!=NULL; k++)
+    if (strcmp(str, table[k])==0) return k;
+  return -1;
+}
+
+
 /**
  * @brief Destructor
 */
 
 gecoFileStream::~gecoFileStream()
 {
+  delete writer;
+  delete encoder;
+  delete binRec;
+  delete textRec;
+  delete bin;
+  delete dataCode;
+  delete cutExpr;
   Tcl_DStringFree(fileName);
   Tcl_DStringFree(data);
   Tcl_DStringFree(dataStr);
@@ -67,6 +95,150 @@ gecoFileStream::~gecoFileStream()
   delete data;
   delete dataStr;
   delete cut;
+  Tcl_DStringFree(format);
+  Tcl_DStringFree(columns);
+  Tcl_DStringFree(precision);
+  Tcl_DStringFree(compress);
+  delete format;
+  delete columns;
+  delete precision;
+  delete compress;
+  Tcl_DStringFree(durability);
+  Tcl_DStringFree(overflow);
+  delete durability;
+  delete overflow;
+  Tcl_DStringFree(segHeader);
+  Tcl_DStringFree(segments);
+  delete segHeader;
+  delete segments;
+}
+
+
+/*!
+ * @copydoc gecoProcess::cmd 
+ *
+ * Compared to gecoProcess::cmd, gecoFileStream::cmd discards the cached
+ * data script and the compiled cut filter when they are changed and checks
+ * the settings of the binary format and of the background writer.
+ */
+
+int gecoFileStream::cmd(int &i, int objc,Tcl_Obj *const objv[])
+{
+  // first executes the command options defined in gecoProcess
+  int j=i;
+  int oldInterval=interval;
+  int oldBufferSize=bufferSize;
+  double oldRotateSize=rotateSize;
+  double oldRotateInterval=rotateInterval;
+  Tcl_DString oldColumns;
+  Tcl_DStringInit(&oldColumns);
+  Tcl_DStringAppend(&oldColumns, Tcl_DStringValue(columns), -1);
+  Tcl_DString oldPrecision;
+  Tcl_DStringInit(&oldPrecision);
+  Tcl_DStringAppend(&oldPrecision, Tcl_DStringValue(precision), -1);
+  Tcl_DString oldCompress;
+  Tcl_DStringInit(&oldCompress);
+  Tcl_DStringAppend(&oldCompress, Tcl_DStringValue(compress), -1);
+  Tcl_DString oldDurability;
+  Tcl_DStringInit(&oldDurability);
+  Tcl_DStringAppend(&oldDurability, Tcl_DStringValue(durability), -1);
+  Tcl_DString oldOverflow;
+  Tcl_DStringInit(&oldOverflow);
+  Tcl_DStringAppend(&oldOverflow, Tcl_DStringValue(overflow), -1);
+  int index=gecoProcess::cmd(i,objc,objv);
+
+  if ((index==getOptionIndex("-data"))&&(i==j+2)) dataCode->invalidate();
+  if ((index==getOptionIndex("-cut"))&&(i==j+2)) cutExpr->invalidate();
+
+  if ((index==getOptionIndex("-format"))&&(i==j+2)&&
+      (strcmp(Tcl_DStringValue(format),"text")!=0)&&(strcmp(Tcl_DStringValue(format),"binary")!=0))
+    {
+      Tcl_AppendResult(interp, "format must be text or binary", NULL);
+      Tcl_DStringFree(format);
+      Tcl_DStringAppend(format, (binary) ? "binary" : "text", -1);
+      index=-1;
+    }
+
+  if ((index==getOptionIndex("-columns"))&&(i==j+2))
+    {
+      gecoBinFile layout;
+      if (layout.setColumns(interp, Tcl_DStringValue(columns))!=TCL_OK)
+	{
+	  Tcl_DStringFree(columns);
+	  Tcl_DStringAppend(columns, Tcl_DStringValue(&oldColumns), -1);
+	  index=-1;
+	}
+    }
+
+  if ((index==getOptionIndex("-precision"))&&(i==j+2)&&
+      (textRec->setPrecision(interp, Tcl_DStringValue(precision))!=TCL_OK))
+    {
+      Tcl_DStringFree(precision);
+      Tcl_DStringAppend(precision, Tcl_DStringValue(&oldPrecision), -1);
+      index=-1;
+    }
+
+  if ((index==getOptionIndex("-compress"))&&(i==j+2)&&
+      (tableIndex(Tcl_DStringValue(compress), EncodingStr)<0))
+    {
+      Tcl_AppendResult(interp, "compress must be none or gorilla", NULL);
+      Tcl_DStringFree(compress);
+      Tcl_DStringAppend(compress, Tcl_DStringValue(&oldCompress), -1);
+      index=-1;
+    }
+
+  if ((index==getOptionIndex("-durability"))&&(i==j+2)&&
+      (tableIndex(Tcl_DStringValue(durability), DurabilityStr)<0))
+    {
+      Tcl_AppendResult(interp, "durability must be none, flush or sync", NULL);
+      Tcl_DStringFree(durability);
+      Tcl_DStringAppend(durability, Tcl_DStringValue(&oldDurability), -1);
+      index=-1;
+    }
+
+  if ((index==getOptionIndex("-overflow"))&&(i==j+2)&&
+      (tableIndex(Tcl_DStringValue(overflow), OverflowStr)<0))
+    {
+      Tcl_AppendResult(interp, "overflow must be drop or block", NULL);
+      Tcl_DStringFree(overflow);
+      Tcl_DStringAppend(overflow, Tcl_DStringValue(&oldOverflow), -1);
+      index=-1;
+    }
+
+  if ((index==getOptionIndex("-interval"))&&(i==j+2)&&(interval<1))
+    {
+      Tcl_AppendResult(interp, "interval must be a positive integer", NULL);
+      interval=oldInterval;
+      index=-1;
+    }
+
+  if ((index==getOptionIndex("-bufferSize"))&&(i==j+2)&&(bufferSize<4))
+    {
+      Tcl_AppendResult(interp, "buffer size must be at least 4 kB", NULL);
+      bufferSize=oldBufferSize;
+      index=-1;
+    }
+
+  if ((index==getOptionIndex("-rotateSize"))&&(i==j+2)&&(rotateSize<0.0))
+    {
+      Tcl_AppendResult(interp, "rotate size must be positive or 0", NULL);
+      rotateSize=oldRotateSize;
+      index=-1;
+    }
+
+  if ((index==getOptionIndex("-rotateInterval"))&&(i==j+2)&&(rotateInterval<0.0))
+    {
+      Tcl_AppendResult(interp, "rotate interval must be positive or 0", NULL);
+      rotateInterval=oldRotateInterval;
+      index=-1;
+    }
+
+  Tcl_DStringFree(&oldColumns);
+  Tcl_DStringFree(&oldPrecision);
+  Tcl_DStringFree(&oldCompress);
+  Tcl_DStringFree(&oldDurability);
+  Tcl_DStringFree(&oldOverflow);
+  return index;
 }
 
 
@@ -83,19 +255,39 @@ void gecoFileStream::handleEvent(gecoEvent* ev)
 
   // determines cut condition of set
   int b=1;
-  if (Tcl_DStringLength(cut)) Tcl_ExprBoolean(interp,Tcl_DStringValue(cut),&b);
+  if (!cutExpr->isEmpty()) cutExpr->exprBoolean(interp, &b);
 
   // If Active, records data
   if ((status==Active) && ((ev->getT()-saveTime)>=dtRecord) && (b))
     {
       saveTime=ev->getT();
-      Tcl_DStringFree(dataStr);
-      Tcl_DStringAppend(dataStr, "format \"", -1);
-      Tcl_DStringAppend(dataStr, Tcl_DStringValue(data), -1);
-      Tcl_DStringAppend(dataStr, "\"", -1);
-      Tcl_Eval(interp, Tcl_DStringValue(dataStr)); 
-      dataFile << Tcl_GetStringResult(interp) << "\n";
-      dataFile.flush();
+      if ((binary)&&(encoding==Encoding_none))
+	{
+	  checkRotation(saveTime, binRec->getSize());
+	  if (writer->write(binRec->build(interp), binRec->getSize()))
+	    addRecords(saveTime, saveTime, 1, binRec->getSize());
+	  return;
+	}
+      if (binary)
+	{
+	  if (encoder->getRecords()==0) blockTime=saveTime;
+	  encoder->add(binRec->build(interp));
+	  if ((encoder->isFull())||((blockAge>0.0)&&(saveTime-blockTime>=blockAge)))
+	    writeBlock();
+	  return;
+	}
+      int len;
+      if (nativeText)
+	{
+	  const char* line=textRec->build(interp, &len);
+	  checkRotation(saveTime, len);
+	  if (writer->write(line, len)) addRecords(saveTime, saveTime, 1, len);
+	  return;
+	}
+      dataCode->eval(interp);
+      const char* str=Tcl_GetStringFromObj(Tcl_GetObjResult(interp), &len);
+      checkRotation(saveTime, len+1);
+      if (writer->writeLine(str, len)) addRecords(saveTime, saveTime, 1, len+1);
       Tcl_ResetResult(interp);
     }
 }
@@ -115,6 +307,85 @@ Tcl_DString* gecoFileStream::info(const char* frontStr)
   addInfo(frontStr, "Header:               ", Tcl_DStringValue(header));  
   addInfo(frontStr, "Data to stream:       ", Tcl_DStringValue(data));  
   addInfo(frontStr, "Record interval (s):  ", dtRecord);  
+  addInfo(frontStr, "Format:               ", Tcl_DStringValue(format));
+  if (strcmp(Tcl_DStringValue(format),"binary")==0)
+    {
+      addInfo(frontStr, "Columns:              ", Tcl_DStringValue(columns));
+      addInfo(frontStr, "Compression:          ", Tcl_DStringValue(compress));
+    }
+  else if (Tcl_DStringLength(columns)>0)
+    {
+      addInfo(frontStr, "Columns:              ", Tcl_DStringValue(columns));
+      addInfo(frontStr, "Precision:            ", Tcl_DStringValue(precision));
+    }
+  char str[80];
+  if (strcmp(Tcl_DStringValue(durability), DurabilityStr[Durability_none])==0)
+    sprintf(str, "none (written when a batch is full)");
+  else
+    sprintf(str, "%s every %d ms", Tcl_DStringValue(durability), interval);
+  addInfo(frontStr, "Durability:           ", str);
+  addInfo(frontStr, "Overflow:             ", Tcl_DStringValue(overflow));
+
+  sprintf(str, "%d kB (max fill %ld kB)", bufferSize, (long)(writer->getMaxFill()/1024));
+  addInfo(frontStr, "Buffer size:          ", str);
+  if ((binary)&&(encoding!=Encoding_none))
+    {
+      // the writer handles blocks of records
+      sprintf(str, "%lld", encoder->getRawBytes()/bin->getRecordSize());
+      addInfo(frontStr, "Records compressed:   ", str);
+      if (encoder->getEncodedBytes()>0)
+	{
+	  sprintf(str, "%.1f", (double)(encoder->getRawBytes()-(long long)encoder->getRecords()*bin->getRecordSize())/
+		  encoder->getEncodedBytes());
+	  addInfo(frontStr, "Compression ratio:    ", str);
+	}
+      sprintf(str, "%lld", writer->getRecords());
+      addInfo(frontStr, "Blocks queued:        ", str);
+      sprintf(str, "%lld", writer->getDropped());
+      addInfo(frontStr, "Blocks dropped:       ", str);
+      sprintf(str, "%lld", writer->getLate());
+      addInfo(frontStr, "Blocks late:          ", str);
+    }
+  else
+    {
+      sprintf(str, "%lld", writer->getRecords());
+      addInfo(frontStr, "Records queued:       ", str);
+      sprintf(str, "%lld", writer->getDropped());
+      addInfo(frontStr, "Records dropped:      ", str);
+      sprintf(str, "%lld", writer->getLate());
+      addInfo(frontStr, "Records late:         ", str);
+    }
+  sprintf(str, "%lld", writer->getBytes());
+  addInfo(frontStr, "Bytes written:        ", str);
+  if (rotation)
+    {
+      Tcl_DString seg;
+      Tcl_DStringInit(&seg);
+      sprintf(str, "%d (", segment);
+      Tcl_DStringAppend(&seg, str, -1);
+      segmentName(&seg, segment);
+      Tcl_DStringAppend(&seg, ")", 1);
+      addInfo(frontStr, "Segment:              ", Tcl_DStringValue(&seg));
+      Tcl_DStringFree(&seg);
+      sprintf(str, "%g MB / %g s", rotateSize, rotateInterval);
+      addInfo(frontStr, "Rotation:             ", str);
+      if (rotateGzip)
+	{
+	  sprintf(str, "%d running", writer->getGzipRunning());
+	  addInfo(frontStr, "Gzip:                 ", str);
+	  if (writer->getGzipError()!=0)
+	    addInfo(frontStr, "Gzip error:           ", strerror(writer->getGzipError()));
+	}
+    }
+  if (writer->getSyncs()>0)
+    {
+      sprintf(str, "%lld", writer->getSyncs());
+      addInfo(frontStr, "Syncs:                ", str);
+    }
+  if (openError!=0)
+    addInfo(frontStr, "Error:                ", strerror(openError));
+  else if (writer->getError()!=0)
+    addInfo(frontStr, "Error:                ", strerror(writer->getError()));
   return infoStr;
 }
 
@@ -129,8 +400,183 @@ Tcl_DString* gecoFileStream::info(const char* frontStr)
 void gecoFileStream::terminate(gecoEvent* ev)
 {
   gecoProcess::terminate(ev);
-  dataFile.flush();
-  dataFile.close();
+  if (binary)
+    {
+      writeBlock();
+      writeIndex();
+      binRec->unbind();
+    }
+  if (nativeText) textRec->unbind();
+  if (rotation) writeManifest(true, false);
+  writer->close();
+}
+
+
+/**
+ * @brief Hands the current block of compressed records to the background writer
+*/
+
+void gecoFileStream::writeBlock()
+{
+  long long n=encoder->getRecords();
+  size_t len;
+  const char* block=encoder->finish(len);
+  if (len==0) return;
+  checkRotation(blockTime, len);
+  gecoBinBlock b;
+  b.time=gecoBlockDecoder::getFirstTime(block);
+  b.offset=segBytes;
+  b.records=n;
+  if (writer->write(block, len))
+    {
+      index.push_back(b);
+      addRecords(blockTime, saveTime, n, len);
+    }
+}
+
+
+/**
+ * @brief Hands the index of the blocks of compressed records as trailer to the background writer
+ *
+ * Called when the file or the segment is closed.
+*/
+
+void gecoFileStream::writeIndex()
+{
+  if ((!binary)||(encoding==Encoding_none)) return;
+  Tcl_DString str;
+  Tcl_DStringInit(&str);
+  gecoBinFile::buildIndex(&str, index);
+  if (writer->writeTrailer(Tcl_DStringValue(&str), Tcl_DStringLength(&str)))
+    segBytes+=Tcl_DStringLength(&str);
+  Tcl_DStringFree(&str);
+  index.clear();
+}
+
+
+/**
+ * @brief Appends to name the file name of a segment
+ * @param name Tcl_DString to which the name is appended
+ * @param k number of the segment (-1 for the manifest)
+ * @param ext extension replacing the one of the file (NULL to keep it)
+ *
+ * The segment k of 'dir/data.bin' is 'dir/data_000k.bin', its manifest
+ * 'dir/data.manifest'.
+*/
+
+void gecoFileStream::segmentName(Tcl_DString* name, int k, const char* ext)
+{
+  const char* file=Tcl_DStringValue(fileName);
+  const char* slash=strrchr(file, '/');
+  const char* dot=strrchr(file, '.');
+  if ((dot==NULL)||((slash!=NULL)&&(dot<slash))||(dot==file)||(dot==slash+1)) dot=file+strlen(file);
+  Tcl_DStringAppend(name, file, dot-file);
+  if (k>=0)
+    {
+      char str[16];
+      sprintf(str, "_%04d", k);
+      Tcl_DStringAppend(name, str, -1);
+    }
+  Tcl_DStringAppend(name, (ext) ? ext : dot, -1);
+}
+
+
+/**
+ * @brief Rotates the file if the current segment is full
+ * @param t time of the record about to be written
+ * @param len size of the record about to be written
+*/
+
+void gecoFileStream::checkRotation(double t, size_t len)
+{
+  if ((!rotation)||(segRecords==0)) return;
+  if (((rotateSize>0.0)&&(segBytes+(long long)len>rotateSize*1e6))||
+      ((rotateInterval>0.0)&&(t-segStart>=rotateInterval)))
+    rotate(t);
+}
+
+
+/**
+ * @brief Accounts records handed to the background writer
+ * @param first time of the first record
+ * @param last time of the last record
+ * @param n number of records
+ * @param len size of the records (bytes)
+*/
+
+void gecoFileStream::addRecords(double first, double last, long long n, size_t len)
+{
+  if (segRecords==0) segFirst=first;
+  segLast=last;
+  segRecords+=n;
+  segBytes+=len;
+}
+
+
+/**
+ * @brief Closes the current segment and starts the next one
+ * @param t time of the start of the next segment
+ *
+ * The switch is done by the writer thread, between the last record handed so
+ * far and the next one.
+*/
+
+void gecoFileStream::rotate(double t)
+{
+  writeIndex();
+  writeManifest(true, rotateGzip);
+  Tcl_DString name;
+  Tcl_DStringInit(&name);
+  segmentName(&name, ++segment);
+  writer->rotate(Tcl_DStringValue(&name), Tcl_DStringValue(segHeader), Tcl_DStringLength(segHeader),
+		 rotateGzip);
+  Tcl_DStringFree(&name);
+  segBytes=Tcl_DStringLength(segHeader);
+  segRecords=0;
+  segStart=t;
+  writeManifest(false, false);
+}
+
+
+/**
+ * @brief Hands the manifest of the segments to the background writer
+ * @param closed true if the current segment is closed
+ * @param gzip true if the current segment is compressed once closed
+ *
+ * Once closed, the line of the segment is kept in the manifest.
+*/
+
+void gecoFileStream::writeManifest(bool closed, bool gzip)
+{
+  Tcl_DString line, file;
+  Tcl_DStringInit(&line);
+  Tcl_DStringInit(&file);
+  segmentName(&file, segment);
+  const char* tail=strrchr(Tcl_DStringValue(&file), '/');
+  char str[200];
+  sprintf(str, " first %.6f last %.6f records %lld bytes %lld closed %d gzip %d\n",
+	  (segRecords>0) ? segFirst : segStart, (segRecords>0) ? segLast : segStart,
+	  segRecords, segBytes, (closed) ? 1 : 0, (gzip) ? 1 : 0);
+  Tcl_DStringAppendElement(&line, "file");
+  Tcl_DStringAppendElement(&line, (tail) ? tail+1 : Tcl_DStringValue(&file));
+  Tcl_DStringAppend(&line, str, -1);
+  if (closed) Tcl_DStringAppend(segments, Tcl_DStringValue(&line), -1);
+
+  Tcl_DStringFree(&file);
+  segmentName(&file, -1, ".manifest");
+  if (closed)
+    writer->writeManifest(Tcl_DStringValue(&file), Tcl_DStringValue(segments));
+  else
+    {
+      Tcl_DString text;
+      Tcl_DStringInit(&text);
+      Tcl_DStringAppend(&text, Tcl_DStringValue(segments), -1);
+      Tcl_DStringAppend(&text, Tcl_DStringValue(&line), -1);
+      writer->writeManifest(Tcl_DStringValue(&file), Tcl_DStringValue(&text));
+      Tcl_DStringFree(&text);
+    }
+  Tcl_DStringFree(&file);
+  Tcl_DStringFree(&line);
 }
 
 
@@ -138,20 +584,81 @@ void gecoFileStream::terminate(gecoEvent* ev)
  * @copydoc gecoProcess::activate
  *
  * In addition to gecoProcess::activate, gecoFileStream::activate 
- * opens for writing the file to stream to.
+ * opens for writing the file (or its first segment) to stream to and starts
+ * its background writer.
  */
 
 void gecoFileStream::activate(gecoEvent* ev)
 {
   gecoProcess::activate(ev);
-  dataFile.open(Tcl_DStringValue(fileName), ios::trunc);
-  
+  binary=(strcmp(Tcl_DStringValue(format),"binary")==0);
+  encoding=(binary) ? tableIndex(Tcl_DStringValue(compress), EncodingStr) : Encoding_none;
+  int dur=tableIndex(Tcl_DStringValue(durability), DurabilityStr);
+  blockAge=(dur==Durability_none) ? 0.0 : ((interval>1000) ? interval/1000.0 : 1.0);
+
   Tcl_DStringFree(dataStr);
   Tcl_DStringAppend(dataStr, "format \"", -1);
   Tcl_DStringAppend(dataStr, Tcl_DStringValue(header), -1);
   Tcl_DStringAppend(dataStr, "\"", -1);
   Tcl_Eval(interp, Tcl_DStringValue(dataStr)); 
-  dataFile << Tcl_GetStringResult(interp) << "\n";
+
+  // builds the header of the file
+  Tcl_DStringFree(dataStr);
+  if (binary)
+    {
+      struct timespec ts;
+      clock_gettime(CLOCK_REALTIME, &ts);
+      long long start=gecoBinRecord::monotonicTime();
+      bin->setColumns(interp, Tcl_DStringValue(columns));
+      bin->setEncoding(encoding);
+      encoder->setup(BlockMaxRecords, (size_t)bufferSize*1024/2);
+      index.clear();
+      bin->buildHeader(dataStr, Tcl_GetStringResult(interp), start, ts.tv_sec+ts.tv_nsec/1e9);
+      binRec->bind(start);
+    }
+  else
+    {
+      Tcl_DStringAppend(dataStr, Tcl_GetStringResult(interp), -1);
+      Tcl_DStringAppend(dataStr, "\n", 1);
+    }
+  Tcl_ResetResult(interp);
+
+  // the lines of the text format are built natively if columns are declared
+  nativeText=(!binary)&&(Tcl_DStringLength(columns)>0);
+  if (nativeText)
+    {
+      textRec->setColumns(interp, Tcl_DStringValue(columns));
+      textRec->setPrecision(interp, Tcl_DStringValue(precision));
+      textRec->bind(gecoBinRecord::monotonicTime());
+      Tcl_ResetResult(interp);
+    }
+
+  // the segments of a rotated file share the same header
+  rotation=(rotateSize>0.0)||(rotateInterval>0.0);
+  segment=0;
+  segBytes=Tcl_DStringLength(dataStr);
+  segRecords=0;
+  segStart=ev->getT();
+  Tcl_DStringFree(segments);
+  Tcl_DStringFree(segHeader);
+  Tcl_DString name;
+  Tcl_DStringInit(&name);
+  if (rotation)
+    {
+      Tcl_DStringAppend(segHeader, Tcl_DStringValue(dataStr), Tcl_DStringLength(dataStr));
+      segmentName(&name, 0);
+    }
+  else
+    Tcl_DStringAppend(&name, Tcl_DStringValue(fileName), -1);
+
+  openError=writer->open(Tcl_DStringValue(&name), (size_t)bufferSize*1024,
+			 dur, interval,
+			 tableIndex(Tcl_DStringValue(overflow), OverflowStr),
+			 Tcl_DStringValue(dataStr), Tcl_DStringLength(dataStr));
+  Tcl_DStringFree(&name);
+  Tcl_DStringFree(dataStr);
+  if (rotation) writeManifest(false, false);
   
   saveTime=ev->getT();
 }
+
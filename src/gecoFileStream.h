@@ -20,6 +20,14 @@
 // ---------------------------------------------------------------
 // 25.10.2015 Creation                         R. Wuthrich
 // 08.12.2020 Added doxygen documentation      R. Wuthrich
+// 17.10.2026 Added binary format              agent
+// 17.10.2026 Added background writer          agent
+// 17.10.2026 Records built by gecoBinRecord   agent
+// 17.10.2026 Added compressed binary format   agent
+// 17.10.2026 Added rotation of the file       agent
+// 17.10.2026 Added native text encoding       agent
+// 18.10.2026 Documented durability           agent
+// 18.10.2026 Block index written as trailer    agent
 //
 // ---------------------------------------------------------------
 /*! \file */
@@ -28,8 +36,14 @@
 #define gecoFileStream_SEEN_
 
 #include <tcl8.6/tcl.h>
-#include <fstream>
 #include "gecoProcess.h"
+#include "gecoScript.h"
+#include "gecoExpr.h"
+#include "gecoBinFile.h"
+#include "gecoBinRecord.h"
+#include "gecoTextRecord.h"
+#include "gecoAsyncWriter.h"
+#include "gecoBlockCodec.h"
 #include "gecoApp.h"
 
 using namespace std;
@@ -87,6 +101,111 @@ int geco_FileStreamCmd(ClientData clientData, Tcl_Interp *interp,
  * -data             | returns/sets data to stream to file
  * -cut              | returns/sets filter on data to be saved
  * -dtRecord         | returns/sets time interval between two recordings (s)
+ * -format           | returns/sets format of the file (text or binary)
+ * -columns          | returns/sets columns recorded (binary or native text format)
+ * -precision        | returns/sets decimals of columns in text format
+ * -compress         | returns/sets compression of the binary format (none or gorilla)
+ * -durability       | returns/sets durability policy (none, flush or sync)
+ * -interval         | returns/sets interval of the durability policy (ms)
+ * -overflow         | returns/sets overflow policy (drop or block)
+ * -bufferSize       | returns/sets size of the write buffer (kB)
+ * -rotateSize       | returns/sets size of a file before rotation (MB, 0 for none)
+ * -rotateInterval   | returns/sets time before rotation of a file (s, 0 for none)
+ * -rotateGzip       | returns/sets if rotated files are compressed with gzip
+ *
+ * Text format
+ * -----------
+ * In the text format (default), each recording evaluates '-data' with the Tcl
+ * 'format' command and writes the result as one line to the file.
+ *
+ * If '-columns' is set (see below), the lines are instead built natively by a
+ * gecoTextRecord, without evaluating any Tcl script, and '-data' is not used:
+ * the values of the columns are written separated by a blank, exactly as '-data'
+ * would print them ('-columns {t V {n int}}' writes the same lines as
+ * '-data {$t $V $n}'). No timestamp column is added in the text format.
+ * '-precision' is a dict {column decimals ...} printing the listed columns with
+ * a fixed number of decimals (as '%.nf'); the other doubles are printed with the
+ * shortest digits reading back to the same value.
+ *
+ * Binary format
+ * -------------
+ * In the binary format, the typed columns declared with '-columns' are written
+ * as fixed-width little-endian records behind a self-describing header (see
+ * gecoBinFile). '-columns' is a list of Tcl variables, each of the form 'name' or
+ * '{name type}' where type is one of double (default), float, int, wide or timestamp.
+ * A column 'timestamp' holding the CLOCK_MONOTONIC time since the start of the
+ * recording is added in front if none is declared. '-data' is not used.
+ *
+ * A column naming a signal of the gecoSignalBus or a native variable (like t)
+ * is read directly from its storage. Other Tcl variables are read without
+ * string conversion if they hold a number.
+ *
+ * The Tcl command 'binfile' reads the binary files and converts them to the
+ * text format.
+ *
+ * Compression
+ * -----------
+ * With '-compress gorilla', the records of the binary format are compressed in
+ * blocks of up to 1024 records (see gecoBlockEncoder): timestamps and integers
+ * are stored as delta of the delta with the previous value, floating point values
+ * as XOR with the previous value. Regularly sampled, slowly varying signals shrink
+ * several times. A block is handed to the background writer once full, or after
+ * '-interval' ms but at least 1 s unless '-durability' is none: the compression
+ * delays the records accordingly. The compression ratio is reported by '-info'.
+ * When the file (or a segment) is closed, the index of its blocks is appended as
+ * a trailer (see gecoBinFile::buildIndex). 'binfile' reads compressed files
+ * transparently.
+ *
+ * Background writer
+ * -----------------
+ * The geco process loop never writes to the file itself. The records are handed
+ * through a preallocated ring buffer of '-bufferSize' kB to a writer thread doing
+ * large batched writes (see gecoAsyncWriter). The durability policy defines when
+ * the records reach the file:
+ *
+ * '-durability' | Behaviour
+ * ------------- | ------------------------------------------------------
+ * none          | records written when a batch of 64 kB is full and on termination
+ * flush         | records written at least every '-interval' ms (default, 100 ms)
+ * sync          | records written and fdatasync at least every '-interval' ms
+ *
+ * With the default durability, a crash of the process loses up to the last
+ * '-interval' ms of records. '-info' reports the durability in effect.
+ *
+ * If the file system can't keep up and the buffer is full, the overflow policy
+ * '-overflow' either drops the record (drop, default) or makes the geco process
+ * loop wait for the writer thread (block). The dropped and late records are
+ * counted and reported by '-info', together with the records queued to the
+ * writer thread and the bytes it actually wrote to the file.
+ *
+ * Rotation
+ * --------
+ * For long sessions, the data can be split in segments with '-rotateSize' (MB)
+ * and/or '-rotateInterval' (s). The segments of '-file data.bin' are named
+ * data_0000.bin, data_0001.bin, ... Each segment starts with the header of the
+ * file and can be read on its own (binary segments share the same time origin).
+ * A segment is closed between two records (or blocks of compressed records), so
+ * that no record is lost at the handover. The writer thread closes the segment,
+ * opens the next one and, with '-rotateGzip 1', compresses the closed segment to
+ * data_000k.bin.gz in a further thread: the geco process loop never waits.
+ *
+ * The segments are listed in the manifest data.manifest, rewritten at each rotation,
+ * one Tcl dict per segment:
+ *
+ *     file data_0000.bin first 0.0 last 59.99 records 6000 bytes 288140 closed 1 gzip 0
+ *
+ * where first and last are the loop times (s) of the first and last records.
+ *
+ * The format, the columns and the settings of the writer are taken into account
+ * at the next activation.
+ *
+ * Example
+ * -------
+ * \code
+ * filestream -file data.bin -format binary -columns {t {V double} {n int}} -dtRecord 0
+ * ...
+ * binfile -totext data.bin data.txt
+ * \endcode
  */
 
 class gecoFileStream : public gecoProcess
@@ -94,16 +213,65 @@ class gecoFileStream : public gecoProcess
 private:
 
   Tcl_DString*   dataStr;
+  gecoScript*    dataCode;        // cached 'format' of data
+  gecoExpr*      cutExpr;         // compiled cut filter
   double         saveTime;
 
+  // binary format
+  bool                binary;     // true if the file is written in binary format
+  gecoBinFile*        bin;        // layout of the records
+  gecoBinRecord*      binRec;     // builds the records
+  gecoBlockEncoder*   encoder;    // compresses the records
+  int                 encoding;   // Encoding_none or Encoding_gorilla
+  double              blockTime;  // time of the first record of the block
+  double              blockAge;   // age of a block written (s, 0 for none)
+  vector<gecoBinBlock> index;     // blocks written to the current segment
+
+  void                writeBlock();
+  void                writeIndex();
+
+  // native text format
+  bool                nativeText; // true if the lines are built by textRec
+  gecoTextRecord*     textRec;    // builds the lines
+
+  // rotation
+  bool                rotation;   // true if the file is split in segments
+  int                 segment;    // current segment
+  long long           segBytes;   // bytes of the current segment
+  long long           segRecords; // records of the current segment
+  double              segStart;   // time of the start of the current segment
+  double              segFirst;   // time of the first record of the current segment
+  double              segLast;    // time of the last record of the current segment
+  Tcl_DString*        segHeader;  // header of the segments
+  Tcl_DString*        segments;   // manifest lines of the closed segments
+
+  void                segmentName(Tcl_DString* name, int k, const char* ext = NULL);
+  void                checkRotation(double t, size_t len);
+  void                addRecords(double first, double last, long long n, size_t len);
+  void                rotate(double t);
+  void                writeManifest(bool closed, bool gzip);
+
+  int                 openError;  // errno of the last opening of the file (0 if none)
+
 protected:
 
   Tcl_DString*   fileName;        // file name
   Tcl_DString*   header;          // header of data file
   Tcl_DString*   data;            // data to be streamed
   Tcl_DString*   cut;             // cut filter
-  ofstream       dataFile;
+  gecoAsyncWriter* writer;        // background writer of the file
   double         dtRecord;          
+  Tcl_DString*   format;          // text or binary
+  Tcl_DString*   columns;         // columns of the binary or native text format
+  Tcl_DString*   precision;       // decimals of columns in text format
+  Tcl_DString*   compress;        // compression of the binary format
+  Tcl_DString*   durability;      // durability policy of the writer
+  int            interval;        // interval of the durability policy (ms)
+  Tcl_DString*   overflow;        // overflow policy of the writer
+  int            bufferSize;      // size of the write buffer (kB)
+  double         rotateSize;      // size of a segment (MB, 0 for none)
+  double         rotateInterval;  // duration of a segment (s, 0 for none)
+  bool           rotateGzip;      // compresses the closed segments
 
 public:
 
@@ -111,7 +279,25 @@ public:
     gecoObj("Stream To File", "filestream", App),
     gecoProcess("Stream To File", "user", "filestream", App),
     saveTime(0.0),
-    dtRecord(0.1)
+    binary(false),
+    encoding(Encoding_none),
+    blockTime(0.0),
+    blockAge(0.0),
+    nativeText(false),
+    rotation(false),
+    segment(0),
+    segBytes(0),
+    segRecords(0),
+    segStart(0.0),
+    segFirst(0.0),
+    segLast(0.0),
+    openError(0),
+    dtRecord(0.1),
+    interval(100),
+    bufferSize(1024),
+    rotateSize(0.0),
+    rotateInterval(0.0),
+    rotateGzip(false)
   {
     activateOnStart=1;
     fileName = new Tcl_DString;
@@ -119,21 +305,60 @@ public:
     data     = new Tcl_DString;
     cut      = new Tcl_DString;
     dataStr  = new Tcl_DString;
+    format   = new Tcl_DString;
+    columns  = new Tcl_DString;
+    precision = new Tcl_DString;
+    compress = new Tcl_DString;
+    durability = new Tcl_DString;
+    overflow = new Tcl_DString;
+    segHeader = new Tcl_DString;
+    segments = new Tcl_DString;
     Tcl_DStringInit(fileName);
     Tcl_DStringInit(header);
     Tcl_DStringInit(data);
     Tcl_DStringInit(cut);
     Tcl_DStringInit(dataStr);
+    Tcl_DStringInit(format);
+    Tcl_DStringInit(columns);
+    Tcl_DStringInit(precision);
+    Tcl_DStringInit(compress);
+    Tcl_DStringInit(durability);
+    Tcl_DStringInit(overflow);
+    Tcl_DStringInit(segHeader);
+    Tcl_DStringInit(segments);
+    Tcl_DStringAppend(format, "text", -1);
+    Tcl_DStringAppend(compress, EncodingStr[Encoding_none], -1);
+    Tcl_DStringAppend(durability, DurabilityStr[Durability_flush], -1);
+    Tcl_DStringAppend(overflow, OverflowStr[Overflow_drop], -1);
+    bin      = new gecoBinFile;
+    binRec   = new gecoBinRecord(App, bin);
+    encoder  = new gecoBlockEncoder(bin);
+    textRec  = new gecoTextRecord(App);
+    writer   = new gecoAsyncWriter;
+    dataCode = new gecoScript(data, "format \"", "\"");
+    cutExpr  = new gecoExpr(App, cut);
 
     addOption("-file", fileName, "returns/sets file name to stream data to");
     addOption("-header", header, "returns/sets header of the file");
     addOption("-data", data, "returns/sets data to stream to file");
     addOption("-cut", cut, "returns/sets filter on data to be saved");
     addOption("-dtRecord", &dtRecord, "returns/sets time interval between two recordings (s)");
+    addOption("-format", format, "returns/sets format of the file (text or binary)");
+    addOption("-columns", columns, "returns/sets columns recorded (binary or native text format)");
+    addOption("-precision", precision, "returns/sets decimals of columns in text format");
+    addOption("-compress", compress, "returns/sets compression of the binary format (none or gorilla)");
+    addOption("-durability", durability, "returns/sets durability policy (none, flush or sync)");
+    addOption("-interval", &interval, "returns/sets interval of the durability policy (ms)");
+    addOption("-overflow", overflow, "returns/sets overflow policy (drop or block)");
+    addOption("-bufferSize", &bufferSize, "returns/sets size of the write buffer (kB)");
+    addOption("-rotateSize", &rotateSize, "returns/sets size of a file before rotation (MB, 0 for none)");
+    addOption("-rotateInterval", &rotateInterval, "returns/sets time before rotation of a file (s, 0 for none)");
+    addOption("-rotateGzip", &rotateGzip, "returns/sets if rotated files are compressed with gzip");
   }
 
   ~gecoFileStream();
 
+  virtual int  cmd(int &i,int objc,Tcl_Obj *const objv[]);
   virtual void handleEvent(gecoEvent* ev);
   virtual Tcl_DString* info(const char* frontStr = "");
 
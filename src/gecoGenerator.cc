@@ -19,11 +19,14 @@
 // ---------------------------------------------------------------
 // 01.02.2015 Creation                         R. Wuthrich
 // 03.12.2020 Added doxygen documentation      R. Wuthrich
+// 17.10.2026 Output written to signal bus     agent
 //
 // ---------------------------------------------------------------
 
 #include <tcl.h>
 #include "gecoGenerator.h"
+#include "gecoSignal.h"
+#include "gecoApp.h"
 
 using namespace std;
 
@@ -48,7 +51,8 @@ using namespace std;
 gecoGenerator::gecoGenerator(const char* procName, const char* procCmd, 
 			     gecoApp* App) :
   gecoObj(procName, procCmd, App),
-  gecoProcess(procName, "user", procCmd, App)
+  gecoProcess(procName, "user", procCmd, App),
+  output(NULL)
 {
   outputVar = new Tcl_DString;
   Tcl_DStringInit(outputVar);
@@ -62,17 +66,57 @@ gecoGenerator::gecoGenerator(const char* procName, const char* procCmd,
 
 gecoGenerator::~gecoGenerator()
 {
+  app->getSignalBus()->detach(output);
   Tcl_DStringFree(outputVar);
   delete outputVar;
 }
 
 
+/*!
+ * @copydoc gecoProcess::cmd 
+ *
+ * Compared to gecoProcess::cmd, gecoGenerator::cmd attaches the gecoGenerator
+ * to the signal of the gecoSignalBus named by '-outputVariable'.
+ */
+
+int gecoGenerator::cmd(int &i,int objc,Tcl_Obj *const objv[])
+{
+  // executes the command options defined in gecoProcess
+  int j=i;
+  Tcl_DString oldVar;
+  Tcl_DStringInit(&oldVar);
+  Tcl_DStringAppend(&oldVar, Tcl_DStringValue(outputVar), -1);
+  int index=gecoProcess::cmd(i,objc,objv);
+
+  if ((index==getOptionIndex("-outputVariable"))&&(i==j+2))
+    {
+      gecoSignal* sig=NULL;
+      if (Tcl_DStringLength(outputVar)!=0)
+	sig=app->getSignalBus()->attach(Tcl_DStringValue(outputVar), Signal_double);
+      if ((sig==NULL)&&(Tcl_DStringLength(outputVar)!=0))
+	{
+	  Tcl_DStringFree(outputVar);
+	  Tcl_DStringAppend(outputVar, Tcl_DStringValue(&oldVar), -1);
+	  index=-1;
+	}
+      else
+	{
+	  app->getSignalBus()->detach(output);
+	  output=sig;
+	}
+    }
+
+  Tcl_DStringFree(&oldVar);
+  return index;
+}
+
+
 /**
  * @copydoc gecoProcess::handleEvent
  *
  * In addition to gecoProcess::handleEvent, gecoGenerator::handleEvent implements
  * the call to gecoGenerator::signalFunction in order to compute the signal and copy
- * it's output to the associated Tcl variable.
+ * it's output to the associated signal of the gecoSignalBus.
  */
 
 void gecoGenerator::handleEvent(gecoEvent* ev)
@@ -82,9 +126,8 @@ void gecoGenerator::handleEvent(gecoEvent* ev)
   if (status!=Active) return;
 
   // calls the signalFunction method in order to compute the output
-  char str[80];
-  sprintf(str, "%f", signalFunction(ev->getT()));
-  Tcl_SetVar(interp, Tcl_DStringValue(outputVar), str, 0);
+  double y=signalFunction(ev->getT());
+  if (output) output->setDouble(y);
 }
 
 
@@ -20,6 +20,7 @@
 // ---------------------------------------------------------------
 // 01.02.2016 Creation                         R. Wuthrich
 // 03.12.2020 Added doxygen documentation      R. Wuthrich
+// 17.10.2026 Output written to signal bus     agent
 //
 // ---------------------------------------------------------------
 
@@ -30,6 +31,8 @@
 #include <stdio.h>
 #include "gecoProcess.h"
 
+class gecoSignal;            // forward definition
+
 using namespace std;
 
 
@@ -52,7 +55,7 @@ using namespace std;
  * implement the signal to be generated. This function is called
  * by gecoGenerator::handleEvent at each pass of the geco process loop.
  * The return value of gecoGenerator::signalFunction is then stored into a
- * Tcl variable which is associated to the gecoGenerator object.
+ * signal of the gecoSignalBus which is associated to the gecoGenerator object.
  *
  * Associated Tcl command
  * ----------------------
@@ -77,6 +80,11 @@ using namespace std;
  * in the gecoGenerator::handleEvent method using gecoGenerator::signalFunction, which
  * has to be implemented by the children of gecoGenerator.
  *
+ * The output is a double signal of the gecoSignalBus (see gecoSignal), mirrored
+ * to the Tcl variable. The other gecoProcess read the signal directly, without
+ * formatting or parsing strings; Tcl scripts read the mirrored value, at full
+ * precision.
+ *
  * Example
  * -------
  * To implement a child of gecoGenerator the method gecoGenerator::signalFunction must 
@@ -119,12 +127,14 @@ class gecoGenerator : public gecoProcess
 protected:
 
   Tcl_DString* outputVar;
+  gecoSignal*  output;        // signal of the gecoSignalBus named by outputVar
 
 public:
 
   gecoGenerator(const char* procName, const char* procCmd, gecoApp* App);
   ~gecoGenerator();
 
+  virtual int  cmd(int &i,int objc,Tcl_Obj *const objv[]);
   virtual void handleEvent(gecoEvent* ev);
   virtual Tcl_DString* info(const char* frontStr = "");
 
@@ -19,20 +19,24 @@
 // ---------------------------------------------------------------
 // 24.10.2015 Creation                         R. Wuthrich
 // 09.12.2020 Added doxygen documentation      R. Wuthrich
+// 17.10.2026 Cached bytecode of scripts       agent
+// 17.10.2026 Compiled coordinates             agent
+// 17.10.2026 Incremental plotting             agent
+// 17.10.2026 Min/max pyramid of the points    agent
+// 17.10.2026 Non-blocking plot pipe           agent
+// 17.10.2026 Several series per graph         agent
+// 18.10.2026 XY plots with decreasing x       agent
 //
 // ---------------------------------------------------------------
 
 #include <tcl.h>
 #include <cstring>
+#include <cmath>
 #include "gecoGraph.h"
-
-#include <stdlib.h>
-#include <unistd.h>
+#include "gecoTextRecord.h"
 
 using namespace std;
 
-#define TEMPLATE "/tmp/gecoGraphXXXXXX"    // Temporary file name template 
-
 
 // -------------------------------------------------------------------------
 //
@@ -72,12 +76,18 @@ gecoGraph::gecoGraph(gecoApp* App) :
     gecoObj("Graph","graph",App),
     gecoProcess("Graph","user","graph",App), 
     saveTime(0.0),
-    graphTime(0.0)
+    graphTime(0.0),
+    xMin(-HUGE_VAL),
+    xMax(HUGE_VAL),
+    resend(true),
+    plotChan(NULL),
+    updates(0),
+    skipped(0),
+    errors(0),
+    points(2000),
+    capacity(4096)
 {
   activateOnStart=1;
-  // open temporary file for graph data
-  strcpy(fname, TEMPLATE);
-  graphFile = mkstemp(fname); 
 
   // variable for recording and update
   dtRecord=0.1;
@@ -87,13 +97,19 @@ gecoGraph::gecoGraph(gecoApp* App) :
   xCoord     = new Tcl_DString;
   yCoord     = new Tcl_DString;
   plotStyle  = new Tcl_DString;
+  seriesList = new Tcl_DString;
   plotString = new Tcl_DString;
+  xRange     = new Tcl_DString;
   Tcl_DStringInit(xCoord);
   Tcl_DStringInit(yCoord);
   Tcl_DStringInit(plotStyle);
+  Tcl_DStringInit(seriesList);
   Tcl_DStringInit(plotString);
+  Tcl_DStringInit(xRange);
   Tcl_DStringAppend(xCoord, "$t", -1);
   Tcl_DStringAppend(plotStyle, "with lines notitle", -1);
+  xExpr = new gecoExpr(App, xCoord);
+  buildSeries();
 
   addOption("-stop", "stops to send data to the graph");
   addOption("-reset", "resets the graph");
@@ -102,8 +118,16 @@ gecoGraph::gecoGraph(gecoApp* App) :
   addOption("-dtUpdate", &dtUpdate,
 	    "returns/sets time interval between two graph updates (s)");
   addOption("-x", xCoord, "sets/returns the X-coordinate for plotting");
-  addOption("-y", yCoord, "sets/returns the Y-coordinate for plotting");
+  addOption("-y", yCoord, "sets/returns the Y-coordinate for plotting (deletes the points)");
   addOption("-style", plotStyle, "sets/returns the style for plotting");
+  addOption("-series", seriesList,
+	    "sets/returns several series to plot ({y ?style?} ...) (deletes the points)");
+  addOption("-points", &points, "returns/sets largest number of points plotted");
+  addOption("-xrange", xRange, "returns/sets range of x plotted (empty for all)");
+  addOption("-capacity", &capacity,
+	    "returns/sets number of buckets kept per level of the pyramid");
+  addOption("-envelope",
+	    "returns {x min max mean} of y over a range of x (xMin xMax ?maxBuckets?)");
 }
 
 
@@ -113,16 +137,20 @@ gecoGraph::gecoGraph(gecoApp* App) :
 
 gecoGraph::~gecoGraph()
 {
-  close(graphFile);
-  unlink(fname); 
+  delete xExpr;
+  deleteSeries();
   Tcl_DStringFree(xCoord);
   Tcl_DStringFree(yCoord);
   Tcl_DStringFree(plotStyle);
+  Tcl_DStringFree(seriesList);
   Tcl_DStringFree(plotString);
+  Tcl_DStringFree(xRange);
   delete xCoord;
   delete yCoord;
   delete plotStyle;
+  delete seriesList;
   delete plotString;
+  delete xRange;
 }
 
 
@@ -136,14 +164,127 @@ gecoGraph::~gecoGraph()
 int gecoGraph::cmd(int &i, int objc,Tcl_Obj *const objv[])
 {
   // first executes the command options defined in gecoProcess
+  int j=i;
+  int oldPoints=points;
+  int oldCapacity=capacity;
+  Tcl_DString oldRange, oldSeries;
+  Tcl_DStringInit(&oldRange);
+  Tcl_DStringAppend(&oldRange, Tcl_DStringValue(xRange), -1);
+  Tcl_DStringInit(&oldSeries);
+  Tcl_DStringAppend(&oldSeries, Tcl_DStringValue(seriesList), -1);
   int index=gecoProcess::cmd(i,objc,objv);
 
+  if ((index==getOptionIndex("-x"))&&(i==j+2)) xExpr->invalidate();
+
+  if ((index==getOptionIndex("-y"))&&(i==j+2)&&(Tcl_DStringLength(seriesList)==0))
+    buildSeries();
+
+  if ((index==getOptionIndex("-style"))&&(i==j+2)&&(Tcl_DStringLength(seriesList)==0))
+    {
+      Tcl_DStringFree(series[0].style);
+      Tcl_DStringAppend(series[0].style, Tcl_DStringValue(plotStyle), -1);
+    }
+
+  if ((index==getOptionIndex("-series"))&&(i==j+2))
+    {
+      int       n, m;
+      Tcl_Obj** elem;
+      Tcl_Obj** item;
+      bool      valid=true;
+      Tcl_Obj*  list=Tcl_NewStringObj(Tcl_DStringValue(seriesList), -1);
+      Tcl_IncrRefCount(list);
+      if (Tcl_ListObjGetElements(NULL, list, &n, &elem)!=TCL_OK)
+	valid=false;
+      for (int k=0; (valid)&&(k<n); k++)
+	if ((Tcl_ListObjGetElements(NULL, elem[k], &m, &item)!=TCL_OK)||
+	    (m<1)||(m>2)||(Tcl_GetCharLength(item[0])==0))
+	  valid=false;
+      Tcl_DecrRefCount(list);
+      if (valid)
+	buildSeries();
+      else
+	{
+	  Tcl_AppendResult(interp, "series must be a list of {y ?style?}", NULL);
+	  Tcl_DStringFree(seriesList);
+	  Tcl_DStringAppend(seriesList, Tcl_DStringValue(&oldSeries), -1);
+	  index=-1;
+	}
+    }
+  Tcl_DStringFree(&oldSeries);
+
+  if ((index==getOptionIndex("-points"))&&(i==j+2))
+    {
+      if (points<2)
+	{
+	  Tcl_AppendResult(interp, "points must be at least 2", NULL);
+	  points=oldPoints;
+	  index=-1;
+	}
+      resend=true;
+    }
+
+  if ((index==getOptionIndex("-capacity"))&&(i==j+2)&&(capacity<16))
+    {
+      Tcl_AppendResult(interp, "capacity must be at least 16", NULL);
+      capacity=oldCapacity;
+      index=-1;
+    }
+
+  if ((index==getOptionIndex("-xrange"))&&(i==j+2))
+    {
+      int       n;
+      Tcl_Obj** elem;
+      double    min=-HUGE_VAL, max=HUGE_VAL;
+      Tcl_Obj*  list=Tcl_NewStringObj(Tcl_DStringValue(xRange), -1);
+      Tcl_IncrRefCount(list);
+      if ((Tcl_ListObjGetElements(NULL, list, &n, &elem)!=TCL_OK)||
+	  ((n!=0)&&(n!=2))||
+	  ((n==2)&&((Tcl_GetDoubleFromObj(NULL, elem[0], &min)!=TCL_OK)||
+		    (Tcl_GetDoubleFromObj(NULL, elem[1], &max)!=TCL_OK)||(min>=max))))
+	{
+	  Tcl_AppendResult(interp, "xrange must be empty or {xMin xMax} with xMin<xMax", NULL);
+	  Tcl_DStringFree(xRange);
+	  Tcl_DStringAppend(xRange, Tcl_DStringValue(&oldRange), -1);
+	  index=-1;
+	}
+      else
+	{
+	  xMin=min;
+	  xMax=max;
+	  resend=true;
+	}
+      Tcl_DecrRefCount(list);
+    }
+  Tcl_DStringFree(&oldRange);
+
+  if (index==getOptionIndex("-envelope"))
+    {
+      double      min, max;
+      Tcl_WideInt w=points/2;
+      if ((i+2>=objc)||(objc>i+4))
+	{
+	  Tcl_WrongNumArgs(interp, i+1, objv, "xMin xMax ?maxBuckets?");
+	  return -1;
+	}
+      if ((Tcl_GetDoubleFromObj(interp, objv[i+1], &min)!=TCL_OK)||
+	  (Tcl_GetDoubleFromObj(interp, objv[i+2], &max)!=TCL_OK)||
+	  ((i+3<objc)&&(Tcl_GetWideIntFromObj(interp, objv[i+3], &w)!=TCL_OK)))
+	return -1;
+      if (Tcl_DStringLength(seriesList)==0)
+	Tcl_SetObjResult(interp, series[0].pyramid->query(min, max, (w<1) ? 1 : w));
+      else
+	{
+	  Tcl_Obj* list=Tcl_NewListObj(0, NULL);
+	  for (size_t k=0; k<series.size(); k++)
+	    Tcl_ListObjAppendElement(NULL, list, series[k].pyramid->query(min, max, (w<1) ? 1 : w));
+	  Tcl_SetObjResult(interp, list);
+	}
+      i=objc;
+    }
+
   if (index==getOptionIndex("-reset"))
     {
-      close(graphFile);
-      unlink(fname); 
-      strcpy(fname, TEMPLATE);
-      graphFile = mkstemp(fname); 
+      clearPoints();
       i++;
     }
 
@@ -158,12 +299,11 @@ int gecoGraph::cmd(int &i, int objc,Tcl_Obj *const objv[])
  * the sending of data to gnuplot.
  *
  * For this gecoGraph::handleEvent does at a frequency controlled
- * by dtRecord the calculation of the x- and y-coordinates using the
- * Tcl command 'expr' applied to the information stored in 'x' and 'y'
- * followed by storing it to the temporary file. 
+ * by dtRecord the calculation of the x-coordinate and of the y-coordinate
+ * of each series of a new point, kept in memory.
  *
  * With a frequency controlled by 'dtUpdate' gecoGraph::handleEvent
- * asks gnuplot to plot the content of the temporary file.
+ * sends the new points to gnuplot and asks it to plot them.
  */
 
 void gecoGraph::handleEvent(gecoEvent* ev)
@@ -175,41 +315,282 @@ void gecoGraph::handleEvent(gecoEvent* ev)
   if (ev->getT()-saveTime>=dtRecord)
 	{
 	  saveTime=ev->getT();
-	  Tcl_DStringFree(plotString);
-	  Tcl_DStringAppend(plotString, "expr {", -1);
-	  Tcl_DStringAppend(plotString, Tcl_DStringValue(xCoord), -1);
-	  Tcl_DStringAppend(plotString, "}", -1);
-	  Tcl_Eval(interp,Tcl_DStringValue(plotString));
-	  write(graphFile, Tcl_GetStringResult(interp),
-		          strlen(Tcl_GetStringResult(interp)));
-	  write(graphFile, "\t", 1);
-	  Tcl_DStringFree(plotString);
-	  Tcl_DStringAppend(plotString, "expr {", -1);
-	  Tcl_DStringAppend(plotString, Tcl_DStringValue(yCoord),-1);
-	  Tcl_DStringAppend(plotString, "}", -1);
-	  Tcl_Eval(interp,Tcl_DStringValue(plotString));
-	  write(graphFile,Tcl_GetStringResult(interp),
-		          strlen(Tcl_GetStringResult(interp)));
-	  write(graphFile, "\n", 1);
+	  double x, y;
+	  if (xExpr->exprDouble(interp, &x)!=TCL_OK)
+	    errors++;
+	  else
+	    for (size_t k=0; k<series.size(); k++)
+	      if (series[k].yExpr->exprDouble(interp, &y)==TCL_OK)
+		series[k].pyramid->add(x, y);
+	      else
+		errors++;
 	  Tcl_ResetResult(interp);
 	}
 
   if (ev->getT()-graphTime>=dtUpdate)
     {
       graphTime=ev->getT();
-      fsync(graphFile);
-      Tcl_DStringFree(plotString);
-      Tcl_DStringAppend(plotString, "plotGnuplot ", -1);
-      Tcl_DStringAppend(plotString, fname, -1);
-      Tcl_DStringAppend(plotString, " ", -1);
-      Tcl_DStringAppend(plotString, Tcl_DStringValue(plotStyle), -1);
-      Tcl_Eval(interp, Tcl_DStringValue(plotString));
+      update();
       Tcl_ResetResult(interp);
     }
 
 }
 
 
+/**
+ * @brief Adds a series to plot
+ * @param y the y-coordinate
+ * @param style the plot style
+ */
+
+void gecoGraph::addSeries(const char* y, const char* style)
+{
+  gecoGraphSeries s;
+  s.yCoord  = new Tcl_DString;
+  s.style   = new Tcl_DString;
+  Tcl_DStringInit(s.yCoord);
+  Tcl_DStringInit(s.style);
+  Tcl_DStringAppend(s.yCoord, y, -1);
+  Tcl_DStringAppend(s.style, style, -1);
+  s.yExpr   = new gecoExpr(app, s.yCoord);
+  s.pyramid = new gecoPyramid(capacity);
+  s.level=s.sentLevel=-1;
+  s.b0=s.b1=s.tailN=0;
+  s.sentB0=s.sentB1=s.sentTail=0;
+  series.push_back(s);
+}
+
+
+/**
+ * @brief Builds the series to plot from '-series' (or from '-y' and '-style')
+ *
+ * The points recorded are deleted.
+ */
+
+void gecoGraph::buildSeries()
+{
+  deleteSeries();
+  if (Tcl_DStringLength(seriesList)==0)
+    {
+      addSeries(Tcl_DStringValue(yCoord), Tcl_DStringValue(plotStyle));
+      resend=true;
+      return;
+    }
+
+  int       n, m;
+  Tcl_Obj** elem;
+  Tcl_Obj** item;
+  Tcl_Obj*  list=Tcl_NewStringObj(Tcl_DStringValue(seriesList), -1);
+  Tcl_IncrRefCount(list);
+  Tcl_ListObjGetElements(NULL, list, &n, &elem);
+  for (int k=0; k<n; k++)
+    {
+      Tcl_ListObjGetElements(NULL, elem[k], &m, &item);
+      if (m==2)
+	addSeries(Tcl_GetString(item[0]), Tcl_GetString(item[1]));
+      else
+	{
+	  // titled by its y-coordinate
+	  Tcl_DString style;
+	  Tcl_DStringInit(&style);
+	  Tcl_DStringAppend(&style, "with lines title \"", -1);
+	  for (const char* c=Tcl_GetString(item[0]); *c; c++)
+	    {
+	      if ((*c=='"')||(*c=='\\')) Tcl_DStringAppend(&style, "\\", 1);
+	      Tcl_DStringAppend(&style, c, 1);
+	    }
+	  Tcl_DStringAppend(&style, "\"", 1);
+	  addSeries(Tcl_GetString(item[0]), Tcl_DStringValue(&style));
+	  Tcl_DStringFree(&style);
+	}
+    }
+  Tcl_DecrRefCount(list);
+  resend=true;
+}
+
+
+/**
+ * @brief Deletes the series to plot
+ */
+
+void gecoGraph::deleteSeries()
+{
+  for (size_t k=0; k<series.size(); k++)
+    {
+      delete series[k].yExpr;
+      delete series[k].pyramid;
+      Tcl_DStringFree(series[k].yCoord);
+      Tcl_DStringFree(series[k].style);
+      delete series[k].yCoord;
+      delete series[k].style;
+    }
+  series.clear();
+}
+
+
+/**
+ * @brief Deletes all points of the graph
+ */
+
+void gecoGraph::clearPoints()
+{
+  for (size_t k=0; k<series.size(); k++)
+    {
+      series[k].pyramid->clear();
+      series[k].sentLevel=-1;
+    }
+  resend=true;
+}
+
+
+// appends the points drawing a bucket of the pyramid to a DString, each
+// point as "x y" between pre and post
+static void printBucket(Tcl_DString* str, const gecoPyramidBucket& b,
+			const char* pre, const char* post)
+{
+  char   buf[2*TCL_DOUBLE_SPACE+2];
+  double x[2], y[2];
+  int    n=((b.xMin==b.xMax)&&(b.yMin==b.yMax)) ? 1 : 2;
+  int    first=(b.xMin<=b.xMax) ? 0 : 1;
+  x[first]=b.xMin;
+  y[first]=b.yMin;
+  x[1-first]=b.xMax;
+  y[1-first]=b.yMax;
+  for (int k=0; k<n; k++)
+    {
+      int len=gecoTextRecord::printDouble(buf, x[k]);
+      buf[len++]=' ';
+      len+=gecoTextRecord::printDouble(buf+len, y[k]);
+      Tcl_DStringAppend(str, pre, -1);
+      Tcl_DStringAppend(str, buf, len);
+      Tcl_DStringAppend(str, post, -1);
+    }
+}
+
+
+/**
+ * @brief Returns the pipe to gnuplot (or NULL if it can't be opened)
+ *
+ * The pipe is the one of the Tcl procedures of plot.tcl (the global variable
+ * PlotPipe) and is opened if needed. It is made non-blocking, so that Tcl
+ * writes the queued commands in the background. The whole datablock must be
+ * sent again to a pipe opened again.
+ */
+
+Tcl_Channel gecoGraph::plotChannel()
+{
+  int         mode;
+  const char* name=Tcl_GetVar(interp, "PlotPipe", TCL_GLOBAL_ONLY);
+  Tcl_Channel chan=(name) ? Tcl_GetChannel(interp, name, &mode) : NULL;
+  if ((chan==NULL)||(Tcl_Flush(chan)!=TCL_OK))
+    {
+      Tcl_Eval(interp, "openPlotPipe");
+      name=Tcl_GetVar(interp, "PlotPipe", TCL_GLOBAL_ONLY);
+      chan=(name) ? Tcl_GetChannel(interp, name, &mode) : NULL;
+    }
+  if ((chan!=NULL)&&(chan!=plotChan))
+    {
+      Tcl_SetChannelOption(NULL, chan, "-blocking", "0");
+      Tcl_SetChannelOption(NULL, chan, "-buffering", "full");
+      resend=true;
+    }
+  plotChan=chan;
+  return chan;
+}
+
+
+/**
+ * @brief Sends the new points to gnuplot and plots the datablocks
+ *
+ * For each series, if the range is still plotted from the same level of the
+ * pyramid and no point is summarized in the tail, the new buckets are appended
+ * to its datablock, else the whole datablock is sent again. All series are
+ * drawn by a single plot command. The update is skipped if commands of a
+ * previous update are still queued.
+ */
+
+void gecoGraph::update()
+{
+  bool changed=resend, empty=true;
+  for (size_t k=0; k<series.size(); k++)
+    {
+      gecoGraphSeries& s=series[k];
+      s.level=s.pyramid->select(xMin, xMax, (points/2>0) ? points/2 : 1, s.b0, s.b1);
+      s.tailN=((s.level>=0)&&(s.pyramid->getTail(s.level, xMin, xMax, s.tail))) ? s.tail.n : 0;
+      if (s.level>=0) empty=false;
+      if ((s.level!=s.sentLevel)||(s.b0!=s.sentB0)||(s.b1!=s.sentB1)||(s.tailN!=s.sentTail))
+	changed=true;
+    }
+  if ((empty)||(!changed)) return;
+
+  // gnuplot still busy with a previous update
+  Tcl_Channel chan=plotChannel();
+  if (chan==NULL) return;
+  if (Tcl_OutputBuffered(chan)>0)
+    {
+      skipped++;
+      return;
+    }
+
+  Tcl_DString plot;
+  Tcl_DStringInit(&plot);
+  Tcl_DStringFree(plotString);
+  for (size_t k=0; k<series.size(); k++)
+    {
+      gecoGraphSeries& s=series[k];
+      if (s.level<0) continue;
+
+      // datablock $graphN or $graphN_k
+      char name[TCL_INTEGER_SPACE+2]="";
+      if (Tcl_DStringLength(seriesList)>0) sprintf(name, "_%d", (int)k+1);
+
+      if ((!resend)&&(s.level==s.sentLevel)&&(s.b0==s.sentB0)&&(s.b1>=s.sentB1)&&
+	  (s.tailN==0)&&(s.sentTail==0))
+	{
+	  if (s.b1>s.sentB1)
+	    {
+	      Tcl_DStringAppend(plotString, "set print $", -1);
+	      Tcl_DStringAppend(plotString, getTclCmd(), -1);
+	      Tcl_DStringAppend(plotString, name, -1);
+	      Tcl_DStringAppend(plotString, " append\n", -1);
+	      for (long long b=s.sentB1; b<s.b1; b++)
+		printBucket(plotString, s.pyramid->getBucket(s.level, b), "print \"", "\"\n");
+	      Tcl_DStringAppend(plotString, "unset print\n", -1);
+	    }
+	}
+      else
+	{
+	  Tcl_DStringAppend(plotString, "$", 1);
+	  Tcl_DStringAppend(plotString, getTclCmd(), -1);
+	  Tcl_DStringAppend(plotString, name, -1);
+	  Tcl_DStringAppend(plotString, " << EOD\n", -1);
+	  for (long long b=s.b0; b<s.b1; b++)
+	    printBucket(plotString, s.pyramid->getBucket(s.level, b), "", "\n");
+	  if (s.tailN>0) printBucket(plotString, s.tail, "", "\n");
+	  Tcl_DStringAppend(plotString, "EOD\n", -1);
+	}
+
+      Tcl_DStringAppend(&plot, (Tcl_DStringLength(&plot)==0) ? "plot $" : ", $", -1);
+      Tcl_DStringAppend(&plot, getTclCmd(), -1);
+      Tcl_DStringAppend(&plot, name, -1);
+      Tcl_DStringAppend(&plot, " ", 1);
+      Tcl_DStringAppend(&plot, Tcl_DStringValue(s.style), -1);
+      s.sentLevel=s.level;
+      s.sentB0=s.b0;
+      s.sentB1=s.b1;
+      s.sentTail=s.tailN;
+    }
+  Tcl_DStringAppend(plotString, Tcl_DStringValue(&plot), -1);
+  Tcl_DStringAppend(plotString, "\n", 1);
+  Tcl_DStringFree(&plot);
+
+  Tcl_Write(chan, Tcl_DStringValue(plotString), Tcl_DStringLength(plotString));
+  Tcl_Flush(chan);
+  resend=false;
+  updates++;
+}
+
+
 /**
  * @copydoc gecoProcess::info
  *
@@ -221,8 +602,39 @@ Tcl_DString* gecoGraph::info(const char* frontStr)
 {
   gecoProcess::info(frontStr);
   addInfo(frontStr, "X-coordinate: ", Tcl_DStringValue(xCoord));
-  addInfo(frontStr, "Y-coordinate: ", Tcl_DStringValue(yCoord));
-  addInfo(frontStr, "Plot style:   ", Tcl_DStringValue(plotStyle));
+  if (Tcl_DStringLength(seriesList)==0)
+    {
+      addInfo(frontStr, "Y-coordinate: ", Tcl_DStringValue(yCoord));
+      addInfo(frontStr, "Plot style:   ", Tcl_DStringValue(plotStyle));
+    }
+  addInfo(frontStr, "X-range:      ", Tcl_DStringValue(xRange));
+  char str[80];
+  for (size_t k=0; k<series.size(); k++)
+    {
+      gecoGraphSeries& s=series[k];
+      if (Tcl_DStringLength(seriesList)>0)
+	{
+	  sprintf(str, "Series %d:     ", (int)k+1);
+	  addInfo(frontStr, str, Tcl_DStringValue(s.yCoord));
+	}
+      sprintf(str, "%lld (%d levels%s)", s.pyramid->getSamples(), s.pyramid->getLevels(),
+	      (s.pyramid->isMonotonic()) ? "" : ", x decreasing");
+      addInfo(frontStr, "Points:       ", str);
+      if (s.sentLevel>=0)
+	{
+	  sprintf(str, "level %d (%lld buckets)", s.sentLevel, s.sentB1-s.sentB0+(s.sentTail>0));
+	  addInfo(frontStr, "Plotted:      ", str);
+	}
+    }
+  sprintf(str, "%lld", updates);
+  addInfo(frontStr, "Updates:      ", str);
+  sprintf(str, "%lld", skipped);
+  addInfo(frontStr, "Skipped:      ", str);
+  if (errors>0)
+    {
+      sprintf(str, "%lld", errors);
+      addInfo(frontStr, "Errors:       ", str);
+    }
   return infoStr;
 }
 
@@ -231,17 +643,18 @@ Tcl_DString* gecoGraph::info(const char* frontStr)
  * @copydoc gecoProcess::activate
  *
  * In addition to gecoProcess::activate, gecoGraph::activate 
- * creates and opens for writing a temporary file used to send data to gnuplot.
+ * deletes the points of the previous activation.
  */
 
 void gecoGraph::activate(gecoEvent* ev)
 {
   gecoProcess::activate(ev);
-
-  close(graphFile);
-  unlink(fname); 
-  strcpy(fname, TEMPLATE);
-  graphFile = mkstemp(fname); 
+  for (size_t k=0; k<series.size(); k++)
+    series[k].pyramid->setCapacity(capacity);
+  clearPoints();
+  updates=0;
+  skipped=0;
+  errors=0;
 
   saveTime=ev->getT();
   graphTime=ev->getT();
@@ -20,6 +20,11 @@
 // ---------------------------------------------------------------
 // 24.10.2015 Creation                         R. Wuthrich
 // 09.12.2020 Added doxygen documentation      R. Wuthrich
+// 17.10.2026 Incremental plotting             agent
+// 17.10.2026 Min/max pyramid of the points    agent
+// 17.10.2026 Non-blocking plot pipe           agent
+// 17.10.2026 Several series per graph         agent
+// 18.10.2026 XY plots with decreasing x       agent
 //
 // ---------------------------------------------------------------
 /*! \file */
@@ -29,9 +34,10 @@
 
 #include <tcl8.6/tcl.h>
 #include <stdio.h>
-#include <fstream>
-#include <limits.h>	      // for PATH_MAX 
+#include <vector>
 #include "gecoProcess.h"
+#include "gecoExpr.h"
+#include "gecoPyramid.h"
 
 using namespace std;
 
@@ -54,6 +60,28 @@ int geco_GraphCmd(ClientData clientData, Tcl_Interp *interp,
 		  int objc,Tcl_Obj *const objv[]);
 
 
+// -----------------------------------------------------------------------
+//
+// Series plotted by a gecoGraph
+//
+
+struct gecoGraphSeries
+{
+  Tcl_DString*       yCoord;       // y coordinate
+  Tcl_DString*       style;        // plot style
+  gecoExpr*          yExpr;        // compiled y coordinate
+  gecoPyramid*       pyramid;      // min/max/mean pyramid of the points
+  int                level;        // level of the pyramid to plot
+  long long          b0, b1;       // buckets of the level to plot
+  long long          tailN;        // points of the tail to plot
+  gecoPyramidBucket  tail;         // tail to plot
+  int                sentLevel;    // level of the pyramid in the datablock
+  long long          sentB0;       // first bucket of the level in the datablock
+  long long          sentB1;       // bucket following the last one in the datablock
+  long long          sentTail;     // points of the tail in the datablock
+};
+
+
 // -----------------------------------------------------------------------
 //
 // class gecoGraph : a class for plotting data
@@ -70,9 +98,9 @@ int geco_GraphCmd(ClientData clientData, Tcl_Interp *interp,
  * lives.
  *
  * To produce the graph, gecoGraph creates a pipe to gnuplot. Consequently
- * gnuplot must be installed on the system running geco and graphical
- * display must be possible. Data is exchanged via a temporary file in the
- * home folder of the user.
+ * gnuplot (version 5 or later) must be installed on the system running geco
+ * and graphical display must be possible. The data are sent through the pipe
+ * to a gnuplot datablock (see below).
  *
  * The geco_GraphCmd() is the C++ implementation for the Tcl command to
  * create gecoGraph objects. This Tcl command is already available in 
@@ -95,8 +123,13 @@ int geco_GraphCmd(ClientData clientData, Tcl_Interp *interp,
  * -dtRecord         | returns/sets time interval between two recordings (s)
  * -dtUpdate         | returns/sets time interval between two graph updates (s)
  * -x                | sets/returns the data for the X-coordinate for plotting
- * -y                | sets/returns the data for the Y-coordinate for plotting
+ * -y                | sets/returns the data for the Y-coordinate for plotting (deletes the points)
  * -style            | sets/returns the style for plotting
+ * -series           | sets/returns several series to plot ({y ?style?} ...) (deletes the points)
+ * -points           | returns/sets largest number of points plotted
+ * -xrange           | returns/sets range of x plotted (empty for all)
+ * -capacity         | returns/sets number of buckets kept per level of the pyramid
+ * -envelope         | returns {x min max mean} of y over a range of x (xMin xMax ?maxBuckets?)
  *
  * To choose the data to be plotted the '-x' and '-y' have to be used.
  * The user can pass any Tcl expression that can be evaluated by the Tcl command 'expr'
@@ -112,26 +145,96 @@ int geco_GraphCmd(ClientData clientData, Tcl_Interp *interp,
  * The subcommand '-style' can be used to set the plot-style of the graph
  * using the syntax from gnuplot (see man pages f gnuplot). 
  * The default value is 'with lines notitle'.
+ *
+ * Several series
+ * --------------
+ * A single gecoGraph can plot several series sharing the same x-coordinate
+ * with '-series', a list of {y ?style?}, which replaces '-y' and '-style'
+ * (an empty list plots '-y' again). For example
+ * \code
+ * graph -x {$t} -series {{$V1} {$V2 {with points title "V2"}}}
+ * \endcode
+ * The default style of a series is 'with lines title "y"'. At each recording
+ * x is evaluated once and each y once; the points of each series are kept in
+ * their own pyramid and sent in the datablock $graphN_k (k from 1), and all
+ * series are drawn by a single 'plot' command. Plotting many traces thus costs
+ * one gecoGraph, one evaluation of x and one refresh of gnuplot per update.
+ * With several series '-envelope' returns the list of the summaries of the series.
+ * Changing '-y' or '-series' deletes the points recorded.
+ *
+ * Min/max pyramid
+ * ---------------
+ * The points are kept in memory in a min/max/mean pyramid (see gecoPyramid):
+ * level k summarizes 2^k consecutive points by their smallest and largest y and
+ * the mean of y, each level keeping its latest '-capacity' buckets. A plot of
+ * the range '-xrange' (or of the whole run) uses the finest level holding the range in at most
+ * '-points'/2 buckets, each drawn by its smallest and largest y in the order
+ * they occurred: the number of points plotted is bounded whatever the duration
+ * of the run, and the spikes are preserved. The range can be changed while
+ * plotting, to zoom in or out. '-envelope' returns the same summary, including
+ * the mean, to other renderers.
+ *
+ * The range can only be searched as long as x doesn't decrease from a point to
+ * the next (like $t). Once x decreased, as in an XY plot (for example an I-V
+ * curve with '-x {$V} -y {$I}'), the points are plotted in the order they were
+ * recorded, decimated to at most '-points' points:
+ * '-xrange' and the range of '-envelope' are then ignored (the whole recording is
+ * returned) until the points are deleted, and '-info' reports the x as decreasing.
+ *
+ * Incremental plotting
+ * --------------------
+ * The points are sent to gnuplot in the datablock $graphN (N the number of the
+ * gecoGraph, see above for several series). As long as the range is plotted at full resolution, only the points
+ * recorded since the last update are appended to the datablock; otherwise the at
+ * most '-points' points are sent again. The cost of an update doesn't grow with
+ * the duration of the run, and the geco process loop never waits for a file to
+ * be synced. '-capacity' is taken into account at the next activation.
+ *
+ * Slow plotter
+ * ------------
+ * The pipe to gnuplot is non-blocking: the commands are queued by Tcl and written
+ * in the background by the event loop as gnuplot reads them, so that a gnuplot
+ * busy rendering never delays the geco process loop. As long as commands of a
+ * previous update are still queued, the updates are skipped: the next update
+ * sends the newest points only, as if the skipped ones were coalesced into it.
+ * The skipped updates are counted and reported by '-info'.
  */
 
 class gecoGraph : public gecoProcess
 {
 private:
 
-  char         fname[PATH_MAX]; // full file name of the temporary graph file
-  Tcl_DString* plotString;
+  Tcl_DString* plotString;      // commands sent to gnuplot
+  gecoExpr*    xExpr;           // compiled x coordinate
   double       saveTime;
   double       graphTime;
 
-protected:
+  vector<gecoGraphSeries> series; // series plotted
+  double       xMin, xMax;      // range of x plotted
+  bool         resend;          // the whole datablocks must be sent again
+  Tcl_Channel  plotChan;        // pipe to gnuplot (non-blocking)
+  long long    updates;         // updates sent to gnuplot
+  long long    skipped;         // updates skipped while gnuplot was busy
+  long long    errors;          // points not recorded (coordinate not a number)
+
+  void         addSeries(const char* y, const char* style);
+  void         buildSeries();
+  void         deleteSeries();
+  void         clearPoints();
+  Tcl_Channel  plotChannel();
+  void         update();
 
-  int          graphFile;
+protected:
 
   double       dtRecord;        // time interval between two recording
   double       dtUpdate;        // time interval between two graph update
   Tcl_DString* xCoord;          // x coordinate
   Tcl_DString* yCoord;          // y coordinate
   Tcl_DString* plotStyle;       // plot style
+  Tcl_DString* seriesList;      // several series ({y ?style?} ...)
+  int          points;          // largest number of points plotted
+  Tcl_DString* xRange;          // range of x plotted (empty for all)
+  int          capacity;        // buckets kept per level of the pyramid
 
 public:
 
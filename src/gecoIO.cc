@@ -27,6 +27,7 @@
 #include "gecoEvent.h"
 #include "gecoIO.h"
 #include "gecoIOModule.h"
+#include "gecoRTLoop.h"
 
 using namespace std;
 
@@ -66,7 +67,8 @@ int geco_IOCmd(ClientData clientData, Tcl_Interp *interp,
 gecoIO::gecoIO(gecoApp* App) :
   gecoObj("IO Operations", "io", App),
   gecoProcess("IO Operations", "user", "io", App),
-  firstGecoIOModule(NULL)
+  firstGecoIOModule(NULL),
+  rtFailedModule(NULL)
 {
   activateOnStart=1;
   addOption("-linkModule", "links an IO-module");
@@ -123,6 +125,12 @@ int gecoIO::cmd(int &i, int objc,Tcl_Obj *const objv[])
 	  Tcl_AppendResult(interp, str, NULL);
 	  return -1;
 	}
+      if ((realtime)&&(!iomodule->rtSafe()))
+	{
+	  Tcl_AppendResult(interp, "module \"", iomodule->getTclCmd(),
+			   "\" can't run on the real-time thread", NULL);
+	  return -1;
+	}
       if (addGecoIOModule(iomodule)==TCL_ERROR) return -1;
       i = objc;
     }
@@ -206,6 +214,14 @@ void gecoIO::handleEvent(gecoEvent* ev)
   // if not running nothing more to do
   if (ev->eventLoopStatus()==0) return;
 
+  // IO operations are done by the real-time thread
+  if (runsOnRTLoop())
+    {
+      gecoIOModule* failed=rtFailedModule.exchange(NULL);
+      if (failed) failed->IOerror();
+      return;
+    }
+
   // calls the IO module(s) 
   linkedGecoIOModules* b = firstGecoIOModule;
   while (b!=NULL)
@@ -220,6 +236,45 @@ void gecoIO::handleEvent(gecoEvent* ev)
 }
 
 
+/**
+ * @brief Returns true if all linked gecoIOModule are real-time safe
+ */
+
+bool gecoIO::realtimeCapable()
+{
+  linkedGecoIOModules* m=firstGecoIOModule;
+  while (m!=NULL)
+    {
+      if (!m->module->rtSafe()) return false;
+      m=m->nextModule;
+    }
+  return true;
+}
+
+
+/**
+ * @copydoc gecoProcess::handleRTEvent
+ *
+ * Calls each linked gecoIOModule and requests them to execute
+ * the defined IO operations. An IO error is reported by 
+ * gecoIO::handleEvent on the interpreter thread.
+ */
+
+void gecoIO::handleRTEvent(double t)
+{
+  linkedGecoIOModules* b = firstGecoIOModule;
+  while (b!=NULL)
+    {
+      if (b->module->doInstr()<0)
+	{
+	  rtFailedModule.store(b->module);
+	  return;
+	}
+      b=b->nextModule;
+    }
+}
+
+
 /**
  * @copydoc gecoProcess::info
  *
@@ -295,7 +350,9 @@ int gecoIO::addGecoIOModule(gecoIOModule* newModule)
   newM->module=newModule;
   newM->nextModule=NULL;
   newModule->setLinkedToGeco();
+  app->getRTLoop()->hold();
   if (m!=NULL) m->nextModule=newM; else firstGecoIOModule=newM;
+  app->getRTLoop()->release();
 
   return TCL_OK;
 }
@@ -332,10 +389,12 @@ int gecoIO::removeGecoIOModule(char* TclCmdOfModule)
     }
 	
   // removes the module
+  app->getRTLoop()->hold();
   if (prev==NULL)
     firstGecoIOModule = m->nextModule;
   else
     prev->nextModule = m->nextModule;
+  app->getRTLoop()->release();
   m->module->setUnlinkedToGeco();
   delete m;
   return TCL_OK;
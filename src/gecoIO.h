@@ -20,6 +20,7 @@
 // ---------------------------------------------------------------
 // 10.17.2015 Creation                         R. Wuthrich
 // 08.12.2020 Added doxygen documentation      R. Wuthrich
+// 17.10.2026 Added real-time thread support   agent
 //
 // ---------------------------------------------------------------
 /*! \file */
@@ -28,6 +29,7 @@
 #define gecoIO_SEEN_
 
 #include <tcl8.6/tcl.h>
+#include <atomic>
 #include "gecoProcess.h"
 #include "gecoIOModule.h"
 
@@ -95,6 +97,15 @@ struct linkedGecoIOModules {
  * -unlinkModule     | unlinks an IO-module
  * -listLinkModules  | list linked IO-modules
  * -update           | updates all IO operations
+ *
+ * Real-time thread
+ * ----------------
+ * A gecoIO whose linked gecoIOModule are all real-time safe (see
+ * gecoIOModule::rtSafe) can be moved with '-realtime on' to the real-time 
+ * thread (see gecoRTLoop). While the real-time thread runs, the IO operations
+ * are executed by gecoIO::handleRTEvent. An IO error on the real-time 
+ * thread is reported on the interpreter thread at the next run of the
+ * geco process loop.
  */
 
 class gecoIO : public gecoProcess
@@ -102,7 +113,8 @@ class gecoIO : public gecoProcess
 
 protected:
 
-  linkedGecoIOModules* firstGecoIOModule;
+  linkedGecoIOModules*  firstGecoIOModule;
+  atomic<gecoIOModule*> rtFailedModule;   // module which failed on the real-time thread
   
 public:
 
@@ -115,6 +127,9 @@ public:
 
   virtual void activate(gecoEvent* ev);
 
+  virtual bool realtimeCapable();
+  virtual void handleRTEvent(double t);
+
   int  addGecoIOModule(gecoIOModule* newModule);
   int  removeGecoIOModule(char* TclCmdOfModule);
   void listGecoIOModules(Tcl_DString* str);
@@ -21,12 +21,14 @@
 // 10.11.2020 General update                   R. Wuthrich
 // 30.01.2020 Added doxygen documentation      R. Wuthrich
 // 29.05.2021 Major revision                   R. Wuthrich
+// 18.10.2026 Error return of doInstr          agent
 // ---------------------------------------------------------------
 
 #include <tcl.h>
 #include <cstring>
 #include "gecoIOModule.h"
 #include "gecoApp.h"
+#include "gecoRTLoop.h"
 
 using namespace std;
 
@@ -239,6 +241,8 @@ Tcl_DString* gecoIOModule::info(const char* frontStr)
 int gecoIOModule::addInsn(IOModuleInsn* insn)
 {
   // adds the instruction
+  insn->next = NULL;
+  app->getRTLoop()->hold();
   IOModuleInsn* p = getFirstInsn();
   if (p)
     {
@@ -248,7 +252,7 @@ int gecoIOModule::addInsn(IOModuleInsn* insn)
     }
   else
     firstIOModuleInsn = insn;
-  insn->next = NULL;
+  app->getRTLoop()->release();
   
   return TCL_OK;
 }
@@ -261,21 +265,22 @@ int gecoIOModule::addInsn(IOModuleInsn* insn)
 
 void gecoIOModule::removeInsn(IOModuleInsn* insn)
 {
+  app->getRTLoop()->hold();
   if (insn==getFirstInsn())
+    firstIOModuleInsn = insn->getNext();
+  else
     {
-      firstIOModuleInsn = insn->getNext();
-      delete insn;
-      return;
-    }
-
-  IOModuleInsn* p = getFirstInsn();
-  while(p)
-    {
-      if (p->getNext()==insn) break;
-      p=p->getNext();
+      IOModuleInsn* p = getFirstInsn();
+      while(p)
+	{
+	  if (p->getNext()==insn) break;
+	  p=p->getNext();
+	}
+      p->next = insn->next;
     }
-  p->next = insn->next;
+  // deleted while held, as an instruction may update the data of its module
   delete insn;
+  app->getRTLoop()->release();
 }
 
 
@@ -295,7 +300,8 @@ void gecoIOModule::listInstr()
  *
  * Must be defined by child
  *
- * Must return the number of successful operations done
+ * Must return the number of successful operations done, or -1 if an IO error
+ * occurred (gecoIOModule::IOerror is then called by the caller)
 */
 
 int gecoIOModule::doInstr()
@@ -22,6 +22,8 @@
 // 10.11.2020 General update                   R. Wuthrich
 // 12.12.2020 Added doxygen documentation      R. Wuthrich
 // 29.05.2021 Major revision                   R. Wuthrich
+// 17.10.2026 Added real-time safe modules     agent
+// 17.10.2026 Documented signal bus            agent
 // ---------------------------------------------------------------
 
 #ifndef gecoIOModule_SEEN_
@@ -131,6 +133,17 @@ public:
  * In case of an output operation, the content of the Tcl variable 
  * will be written to the output by the gecoIOModule.
  *
+ * Real-time safe IO-modules
+ * -------------------------
+ * A gecoIOModule whose gecoIOModule::doInstr never calls the Tcl C API and
+ * keeps the data of its IOModuleInsn in aligned scalar variables linked 
+ * to the Tcl variables can be executed by the real-time thread (see gecoRTLoop).
+ * Such children must redefine gecoIOModule::rtSafe to return true.
+ *
+ * Children of gecoIOModule exchanging numeric values can attach to a signal of the
+ * gecoSignalBus (gecoSignalBus::attach) and read or write it directly, instead of
+ * formatting and parsing the string value of the Tcl variable.
+ *
  * Associated Tcl command
  * ----------------------
  * Every gecoIOModule is associated to a Tcl command. The associated Tcl command 
@@ -180,6 +193,7 @@ public:
   virtual int   doInstr();
   virtual int   update(const char* Tcl_Var);
   virtual void  IOerror();
+  virtual bool  rtSafe() {return false;}   // true if doInstr can run on the real-time thread
 
   IOModuleInsn* findLinkedTclVariable(const char* TclVar);
 
@@ -19,6 +19,9 @@
 // ---------------------------------------------------------------
 // 26.01.2021 Creation                         R. Wuthrich
 // 29.05.2021 Major revision                   R. Wuthrich
+// 17.10.2026 Cached bytecode of scripts       agent
+// 17.10.2026 Pipelined transactions           agent
+// 18.10.2026 Errors of pipelined transactions agent
 // ---------------------------------------------------------------
 
 #include "gecoIOSocket.h"
@@ -158,6 +161,10 @@ SocketInsn::SocketInsn(const char* Tcl_Var, const char* insn,
   
   PostProcScript = new Tcl_DString;
   Tcl_DStringInit(PostProcScript);
+
+  TclSocketCode = new gecoScript(TclSocketInstr);
+  PostProcCode  = new gecoScript(PostProcScript);
+  InstrCode     = new gecoScript(SocketInstr, "lindex ");
 }
 
 
@@ -166,6 +173,9 @@ SocketInsn::SocketInsn(const char* Tcl_Var, const char* insn,
 
 SocketInsn::~SocketInsn()
 {
+  delete TclSocketCode;
+  delete PostProcCode;
+  delete InstrCode;
   Tcl_DStringFree(SocketInstr);
   Tcl_DStringFree(TclSocketInstr);
   Tcl_DStringFree(PostProcScript);
@@ -187,43 +197,67 @@ SocketInsn::~SocketInsn()
 gecoIOSocket::gecoIOSocket(const char* modName, const char* moduleCmd, gecoApp* App) :
   gecoIOModule(modName, moduleCmd, App)
 {
-  handshake = false;
-  transDelay = 0;
-  
-  addOption("-handshake", &handshake, "sets (ON/OFF) if socket replies with a handshake or not");
-  addOption("-transmitDelay", &transDelay, "returns/sets transmission delay between sending/receiving data (ms)");
+  init();
   addOption("-linkTclVariable", "links a Tcl variable");
   addOption("-postProcessScript", "set/returns post processing script on Tcl variable");
   addOption("-query", "sends a query to the socket and returns the answers");
   addOption("-write", "writes a command to the socket");
   addOption("-getSocketID", "returns Tcl socket ID");
+  addOption("-pipeline", &pipeline, "sets (ON/OFF) if the instructions of a tick are sent in one transaction (no -transmitDelay)");
 }
 
 
 gecoIOSocket::gecoIOSocket(Tcl_Channel socket, const char* moduleCmd, gecoApp* App) :
   gecoIOModule("Tcl socket IO-module", moduleCmd, App)
 {
-  handshake = false;
-  transDelay = 0;
-  
-  addOption("-handshake", &handshake, "sets (ON/OFF) if socket replies with a handshake or not");
-  addOption("-transmitDelay", &transDelay, "returns/sets transmission delay between sending/receiving data (ms)");
+  init();
   addOption("-linkTclVariable", "links a numerical Tcl variable");
   addOption("-postProcessScript", "set/returns post processing script on numerical Tcl variable");
   addOption("-query", "sends a query to the socket and returns the answers");
   addOption("-write", "writes a command to the socket");
   addOption("-getSocketID", "returns Tcl socket ID");
+  addOption("-pipeline", &pipeline, "sets (ON/OFF) if the instructions of a tick are sent in one transaction (no -transmitDelay)");
   
   chanID = socket;
 }
 
 
+// ---- INIT : initializes the members common to both constructors
+//
+
+void gecoIOSocket::init()
+{
+  handshake = false;
+  transDelay = 0;
+  pipeline = false;
+  chanID = NULL;
+
+  errors = 0;
+
+  batch = new Tcl_DString;
+  Tcl_DStringInit(batch);
+  lastError = new Tcl_DString;
+  Tcl_DStringInit(lastError);
+  reply = Tcl_NewObj();
+  Tcl_IncrRefCount(reply);
+
+  addOption("-handshake", &handshake, "sets (ON/OFF) if socket replies with a handshake or not");
+  addOption("-transmitDelay", &transDelay,
+	    "returns/sets transmission delay between sending/receiving data (ms, not with -pipeline)");
+}
+
+
 // ---- DESTRUCTOR
 //
 
 gecoIOSocket::~gecoIOSocket()
 {
   if (chanID) Tcl_UnregisterChannel(interp, chanID);
+  Tcl_DStringFree(batch);
+  Tcl_DStringFree(lastError);
+  delete batch;
+  delete lastError;
+  Tcl_DecrRefCount(reply);
 }
 
 
@@ -237,7 +271,20 @@ gecoIOSocket::~gecoIOSocket()
 int gecoIOSocket::cmd(int &i, int objc,Tcl_Obj *const objv[])
 {
   // first executes the command options defined in gecoIOModule
-  int index=gecoIOModule::cmd(i, objc, objv);
+  int  j=i;
+  bool oldPipeline=pipeline;
+  int  oldDelay=transDelay;
+  int  index=gecoIOModule::cmd(i, objc, objv);
+
+  // the replies of a pipelined transaction are read without delay
+  if (((index==getOptionIndex("-pipeline"))||(index==getOptionIndex("-transmitDelay")))&&
+      (i==j+2)&&(pipeline)&&(transDelay!=0))
+    {
+      Tcl_AppendResult(interp, "-pipeline can't be used with a -transmitDelay", NULL);
+      pipeline=oldPipeline;
+      transDelay=oldDelay;
+      return -1;
+    }
 
   if (index==getOptionIndex("-getSocketID"))
     {
@@ -295,6 +342,7 @@ int gecoIOSocket::cmd(int &i, int objc,Tcl_Obj *const objv[])
 	{
 	  Tcl_DStringFree(p->PostProcScript);
 	  Tcl_DStringAppend(p->PostProcScript, Tcl_GetString(objv[i+2]), -1);
+	  p->PostProcCode->invalidate();
 	  i=i+3;
 	}
       else
@@ -363,23 +411,26 @@ void gecoIOSocket::listInstr()
 // ---- DOINSTR : executes the IO instruction list
 //
 //      returns number of successful instructions done
+//              -1 if a pipelined transaction failed
 //
 
 int gecoIOSocket::doInstr()
 {
+  if (pipeline) return transact(NULL);
+
   SocketInsn* p=getFirstInsn();
   int i=0;
   while (p)
     {
       i++;
-      Tcl_Eval(interp, Tcl_DStringValue(p->TclSocketInstr));
+      p->TclSocketCode->eval(interp);
       p=p->getNext();
     }
 
   p=getFirstInsn();
   while (p)
     {
-      Tcl_Eval(interp, Tcl_DStringValue(p->PostProcScript));
+      p->PostProcCode->eval(interp);
       Tcl_ResetResult(interp);
       p=p->getNext(); 
     }
@@ -398,15 +449,119 @@ int gecoIOSocket::update(const char* Tcl_Var)
 {
   SocketInsn* p = findLinkedTclVariable(Tcl_Var);
   if (p==NULL) return 0;
+  if (pipeline) return (transact(p)<0) ? -1 : 1;
 
-  Tcl_Eval(interp, Tcl_DStringValue(p->TclSocketInstr));
+  p->TclSocketCode->eval(interp);
   Tcl_Flush(chanID);
-  Tcl_Eval(interp, Tcl_DStringValue(p->PostProcScript));
+  p->PostProcCode->eval(interp);
   Tcl_ResetResult(interp);
   return 1;
 }
 
 
+/**
+ * @brief Executes IO instructions in a single pipelined transaction
+ * @param only the IO instruction to execute (NULL for all)
+ * \return number of instructions done (-1 if an error occurred)
+ *
+ * All instructions are written to the socket in one buffer and flushed once,
+ * then the replies are read in the same order with the Tcl channel API: the
+ * handshake (if any) of each instruction and the answer of each read
+ * instruction, stored in its Tcl variable. The socket thus waits once for the
+ * instrument per tick instead of once per instruction. As with 'puts', the
+ * instruction is a Tcl word, so that it may contain substitutions.
+ *
+ * If an instruction can't be evaluated nothing is written. If the socket
+ * fails or is closed before all replies are read, the Tcl variables of the
+ * replies not read are left unchanged and no post processing script is run.
+ * In both cases the error, naming the socket, is left in the result of the
+ * interpreter.
+ */
+
+int gecoIOSocket::transact(SocketInsn* only)
+{
+  const char* name=Tcl_GetChannelName(chanID);
+
+  // writes all instructions
+  Tcl_DStringFree(batch);
+  int n=0;
+  for (SocketInsn* p=(only) ? only : getFirstInsn(); p; p=(only) ? NULL : p->getNext())
+    {
+      if (p->InstrCode->eval(interp)!=TCL_OK)
+	{
+	  Tcl_Obj* msg=Tcl_GetObjResult(interp);
+	  Tcl_IncrRefCount(msg);
+	  Tcl_ResetResult(interp);
+	  Tcl_AppendResult(interp, "error in instruction \"", Tcl_DStringValue(p->SocketInstr),
+			   "\" of socket ", name, ": ", Tcl_GetString(msg), NULL);
+	  Tcl_DecrRefCount(msg);
+	  Tcl_DStringFree(batch);
+	  return -1;
+	}
+      Tcl_DStringAppend(batch, Tcl_GetStringResult(interp), -1);
+      Tcl_DStringAppend(batch, "\n", 1);
+      n++;
+    }
+  Tcl_ResetResult(interp);
+  if (n==0) return 0;
+  if ((Tcl_WriteChars(chanID, Tcl_DStringValue(batch), Tcl_DStringLength(batch))<0)||
+      (Tcl_Flush(chanID)!=TCL_OK))
+    {
+      Tcl_AppendResult(interp, "error writing to socket ", name, ": ",
+		       Tcl_PosixError(interp), NULL);
+      return -1;
+    }
+
+  // reads the replies in order
+  n=0;
+  for (SocketInsn* p=(only) ? only : getFirstInsn(); p; p=(only) ? NULL : p->getNext())
+    {
+      int lines=(handshake) ? 1 : 0;
+      if (p->getVarType()==TclVarRead) lines++;
+      for (int k=0; k<lines; k++)
+	{
+	  Tcl_SetObjLength(reply, 0);
+	  if (Tcl_GetsObj(chanID, reply)>=0) continue;
+	  if (Tcl_Eof(chanID))
+	    Tcl_AppendResult(interp, "socket ", name, " closed before replying to \"",
+			     Tcl_DStringValue(p->SocketInstr), "\"", NULL);
+	  else if (Tcl_InputBlocked(chanID))
+	    Tcl_AppendResult(interp, "no complete reply from socket ", name, " to \"",
+			     Tcl_DStringValue(p->SocketInstr), "\"", NULL);
+	  else
+	    Tcl_AppendResult(interp, "error reading from socket ", name, ": ",
+			     Tcl_PosixError(interp), NULL);
+	  return -1;
+	}
+      if (p->getVarType()==TclVarRead)
+	Tcl_SetVar2Ex(interp, Tcl_DStringValue(p->TclVar), NULL,
+		      Tcl_DuplicateObj(reply), TCL_GLOBAL_ONLY);
+      n++;
+    }
+
+  for (SocketInsn* p=(only) ? only : getFirstInsn(); p; p=(only) ? NULL : p->getNext())
+    {
+      p->PostProcCode->eval(interp);
+      Tcl_ResetResult(interp);
+    }
+  return n;
+}
+
+
+/**
+ * @copydoc gecoIOModule::IOerror
+ *
+ * Keeps the error left in the result of the interpreter, reported by '-info'.
+ */
+
+void gecoIOSocket::IOerror()
+{
+  errors++;
+  Tcl_DStringFree(lastError);
+  Tcl_DStringAppend(lastError, Tcl_GetStringResult(interp), -1);
+}
+
+
 /**
  * @brief Sends a query to the socket and reads answer
  * @param queryInsn query to be written to the socket
@@ -527,6 +682,17 @@ Tcl_DString* gecoIOSocket::info(const char* frontStr)
 
   Tcl_DStringAppend(infoStr, "\nTcl socket : ", -1);
   Tcl_DStringAppend(infoStr, Tcl_GetChannelName(chanID), -1);
+  Tcl_DStringAppend(infoStr, "\nPipelined  : ", -1);
+  Tcl_DStringAppend(infoStr, (pipeline) ? "on" : "off", -1);
+  if (errors>0)
+    {
+      char str[TCL_INTEGER_SPACE];
+      sprintf(str, "%lld", errors);
+      Tcl_DStringAppend(infoStr, "\nIO errors  : ", -1);
+      Tcl_DStringAppend(infoStr, str, -1);
+      Tcl_DStringAppend(infoStr, "\nLast error : ", -1);
+      Tcl_DStringAppend(infoStr, Tcl_DStringValue(lastError), -1);
+    }
   
   return infoStr;
 }
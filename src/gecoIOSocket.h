@@ -20,6 +20,8 @@
 // ---------------------------------------------------------------
 // 26.01.2021 Creation                         R. Wuthrich
 // 29.05.2021 Major revision                   R. Wuthrich
+// 17.10.2026 Pipelined transactions           agent
+// 18.10.2026 Errors of pipelined transactions agent
 // ---------------------------------------------------------------
 
 #ifndef gecoIOSocket_SEEN_
@@ -27,6 +29,7 @@
 
 #include <tcl8.6/tcl.h>
 #include "gecoIOModule.h"
+#include "gecoScript.h"
 
 using namespace std;
 
@@ -56,6 +59,9 @@ protected:
   Tcl_DString*   SocketInstr;      // Instruction to be sent to socket
   Tcl_DString*   TclSocketInstr;   // Tcl command to send instruction to the socket
   Tcl_DString*   PostProcScript;
+  gecoScript*    TclSocketCode;    // cached TclSocketInstr
+  gecoScript*    PostProcCode;     // cached PostProcScript
+  gecoScript*    InstrCode;        // cached value of SocketInstr (pipelined transactions)
 
 public:
 
@@ -78,6 +84,14 @@ private:
 
   bool           handshake;    // true if socket will reply with a handshake
   int            transDelay;   // delay in milliseconds between transmissions  
+  bool           pipeline;     // true if the instructions of a tick are pipelined
+  Tcl_DString*   batch;        // instructions of a pipelined transaction
+  Tcl_Obj*       reply;        // line read from the socket
+  long long      errors;       // IO errors
+  Tcl_DString*   lastError;    // last IO error
+
+  void           init();
+  int            transact(SocketInsn* only);
 
 protected:
 
@@ -95,6 +109,7 @@ public:
   virtual void  listInstr();
   virtual int   doInstr();
   virtual int   update(const char* Tcl_Var);
+  virtual void  IOerror();
   
   void          query(const char* queryInsn);
   void          write(const char* cmdTowrite);
@@ -19,12 +19,20 @@
 // ---------------------------------------------------------------
 // 31.10.2015 Creation                         R. Wuthrich
 // 08.12.2020 Added doxygen documentation      R. Wuthrich
+// 17.10.2026 Cached bytecode of scripts       agent
+// 17.10.2026 Compiled cut filter              agent
+// 17.10.2026 Arena storage of the data        agent
+// 17.10.2026 Saving in background             agent
+// 17.10.2026 Added typed and compressed data  agent
+// 17.10.2026 Added time-indexed queries       agent
+// 17.10.2026 Added native text encoding       agent
 //
 // ---------------------------------------------------------------
 
 #include <tcl.h>
-#include <fstream>
 #include <cstring>
+#include <cerrno>
+#include <time.h>
 #include "gecoMemStream.h"
 #include "gecoApp.h"
 
@@ -46,6 +54,55 @@ int geco_MemStreamCmd(ClientData clientData, Tcl_Interp *interp,
   return geco_CreateGecoProcessCmd(proc, objc, objv);
 }
 
+
+/**
+ * @brief Body of the thread writing a snapshot of a gecoMemStream to its file
+ * @param arg pointer to the gecoMemStream
+*/
+
+void* geco_MemStreamSaveThread(void* arg)
+{
+  gecoMemStream* ms=(gecoMemStream *)arg;
+  gecoArenaCursor c;
+  double      t;
+  const char* str;
+  size_t      len;
+  int         err=0;
+
+  ms->saveSnap->first(c);
+  while (ms->saveSnap->next(c, t, str, len))
+    {
+      if ((fwrite(str, 1, len, ms->saveFile)!=len)||
+	  ((ms->saveText)&&(fputc('\n', ms->saveFile)==EOF)))
+	{
+	  err=errno;
+	  break;
+	}
+      ms->savedRecords+=(ms->saveEncoding==Encoding_none) ? 1 : gecoBlockDecoder::getRecords(str);
+    }
+  if ((fclose(ms->saveFile)!=0)&&(err==0)) err=errno;
+  ms->saveFile=NULL;
+  ms->saveError=err;
+  ms->saveDone.store(true);
+  return NULL;
+}
+
+
+/**
+ * @brief Tcl timer handler checking if the save of a gecoMemStream is completed
+ * @param clientData pointer to the gecoMemStream
+*/
+
+void geco_MemStreamSavePoll(ClientData clientData)
+{
+  gecoMemStream* ms=(gecoMemStream *)clientData;
+  ms->saveTimer=NULL;
+  if (ms->saveDone.load())
+    ms->finishSave(true);
+  else
+    ms->saveTimer=Tcl_CreateTimerHandler(20, geco_MemStreamSavePoll, clientData);
+}
+
 // -------------------------------------------------------------------------
 
 
@@ -60,14 +117,34 @@ int geco_MemStreamCmd(ClientData clientData, Tcl_Interp *interp,
 
 gecoMemStream::~gecoMemStream()
 {
+  if (saving) finishSave(false);
+  Tcl_DStringFree(onSave);
+  Tcl_DStringFree(saveName);
+  delete onSave;
+  delete saveName;
+  delete dataCode;
+  delete cutExpr;
   Tcl_DStringFree(data);
   Tcl_DStringFree(cut);
-  Tcl_DStringFree(dataStr);
   delete data;
   delete cut;
-  delete dataStr;
-  resetData();
-  delete firstData;
+  Tcl_DStringFree(mode);
+  delete mode;
+  Tcl_DStringFree(columns);
+  Tcl_DStringFree(compress);
+  Tcl_DStringFree(binHeader);
+  Tcl_DStringFree(format);
+  Tcl_DStringFree(precision);
+  delete columns;
+  delete compress;
+  delete format;
+  delete precision;
+  delete binHeader;
+  delete encoder;
+  delete binRec;
+  delete textRec;
+  delete bin;
+  delete arena;
 }
 
 
@@ -75,14 +152,90 @@ gecoMemStream::~gecoMemStream()
  * @copydoc gecoProcess::cmd
  *
  * Compared to gecoProcess::cmd, gecoMemStream::cmd adds the processing of
- * the new subcommands of gecoMemStream.
+ * the new subcommands of gecoMemStream and checks the settings of the storage.
  */
 
 int gecoMemStream::cmd(int &i, int objc,Tcl_Obj *const objv[])
 {
   // first executes the command options defined in gecoProcess
+  int j=i;
+  int oldCapacity=capacity;
+  double oldWindow=window;
+  Tcl_DString oldColumns;
+  Tcl_DStringInit(&oldColumns);
+  Tcl_DStringAppend(&oldColumns, Tcl_DStringValue(columns), -1);
+  Tcl_DString oldPrecision;
+  Tcl_DStringInit(&oldPrecision);
+  Tcl_DStringAppend(&oldPrecision, Tcl_DStringValue(precision), -1);
   int index=gecoProcess::cmd(i,objc,objv);
 
+  if ((index==getOptionIndex("-data"))&&(i==j+2)) dataCode->invalidate();
+  if ((index==getOptionIndex("-cut"))&&(i==j+2)) cutExpr->invalidate();
+
+  if ((index==getOptionIndex("-mode"))&&(i==j+2)&&
+      (strcmp(Tcl_DStringValue(mode),ArenaModeStr[Arena_grow])!=0)&&
+      (strcmp(Tcl_DStringValue(mode),ArenaModeStr[Arena_ring])!=0))
+    {
+      Tcl_AppendResult(interp, "mode must be grow or ring", NULL);
+      Tcl_DStringFree(mode);
+      Tcl_DStringAppend(mode, ArenaModeStr[arena->getMode()], -1);
+      index=-1;
+    }
+
+  if ((index==getOptionIndex("-capacity"))&&(i==j+2)&&(capacity<8))
+    {
+      Tcl_AppendResult(interp, "capacity must be at least 8 kB", NULL);
+      capacity=oldCapacity;
+      index=-1;
+    }
+
+  if ((index==getOptionIndex("-window"))&&(i==j+2)&&(window<0.0))
+    {
+      Tcl_AppendResult(interp, "window must be positive or 0", NULL);
+      window=oldWindow;
+      index=-1;
+    }
+
+  if ((index==getOptionIndex("-columns"))&&(i==j+2)&&(Tcl_DStringLength(columns)>0))
+    {
+      gecoBinFile layout;
+      if (layout.setColumns(interp, Tcl_DStringValue(columns))!=TCL_OK)
+	{
+	  Tcl_DStringFree(columns);
+	  Tcl_DStringAppend(columns, Tcl_DStringValue(&oldColumns), -1);
+	  index=-1;
+	}
+    }
+  Tcl_DStringFree(&oldColumns);
+
+  if ((index==getOptionIndex("-format"))&&(i==j+2)&&
+      (strcmp(Tcl_DStringValue(format),"binary")!=0)&&(strcmp(Tcl_DStringValue(format),"text")!=0))
+    {
+      Tcl_AppendResult(interp, "format must be binary or text", NULL);
+      Tcl_DStringFree(format);
+      Tcl_DStringAppend(format, (nativeText) ? "text" : "binary", -1);
+      index=-1;
+    }
+
+  if ((index==getOptionIndex("-precision"))&&(i==j+2)&&
+      (textRec->setPrecision(interp, Tcl_DStringValue(precision))!=TCL_OK))
+    {
+      Tcl_DStringFree(precision);
+      Tcl_DStringAppend(precision, Tcl_DStringValue(&oldPrecision), -1);
+      index=-1;
+    }
+  Tcl_DStringFree(&oldPrecision);
+
+  if ((index==getOptionIndex("-compress"))&&(i==j+2)&&
+      (strcmp(Tcl_DStringValue(compress),EncodingStr[Encoding_none])!=0)&&
+      (strcmp(Tcl_DStringValue(compress),EncodingStr[Encoding_gorilla])!=0))
+    {
+      Tcl_AppendResult(interp, "compress must be none or gorilla", NULL);
+      Tcl_DStringFree(compress);
+      Tcl_DStringAppend(compress, EncodingStr[encoding], -1);
+      index=-1;
+    }
+
   if (index==getOptionIndex("-save"))
     {
       if (objc!=3)
@@ -112,6 +265,54 @@ int gecoMemStream::cmd(int &i, int objc,Tcl_Obj *const objv[])
       i=i+2;
     }
 
+  if ((index==getOptionIndex("-range"))||(index==getOptionIndex("-latest")))
+    {
+      bool         range=(index==getOptionIndex("-range"));
+      int          nargs=(range) ? 3 : 2;
+      int          iw=(range) ? i+4 : i+2;     // maxPoints or n
+      double       tMin=0.0, tMax=0.0;
+      Tcl_WideInt  w=0;
+      gecoTimeQuery query(bin);
+      if ((i+nargs>=objc)||(objc>i+nargs+((range) ? 2 : 1)))
+	{
+	  Tcl_WrongNumArgs(interp, i+1, objv, (range) ? "column tMin tMax ?maxPoints?" : "column n");
+	  return -1;
+	}
+      if (!binary)
+	{
+	  Tcl_AppendResult(interp, "no typed columns recorded in binary format (see -columns)", NULL);
+	  return -1;
+	}
+      if ((query.setColumn(interp, Tcl_GetString(objv[i+1]))!=TCL_OK)||
+	  ((range)&&(Tcl_GetDoubleFromObj(interp, objv[i+2], &tMin)!=TCL_OK))||
+	  ((range)&&(Tcl_GetDoubleFromObj(interp, objv[i+3], &tMax)!=TCL_OK))||
+	  ((iw<objc)&&(Tcl_GetWideIntFromObj(interp, objv[iw], &w)!=TCL_OK)))
+	return -1;
+      if (range)
+	{
+	  query.setRange(tMin, tMax);
+	  queryRange(&query);
+	  Tcl_SetObjResult(interp, query.result(w));
+	}
+      else
+	{
+	  queryLatest(&query, w);
+	  Tcl_SetObjResult(interp, query.result());
+	}
+      i=objc;
+    }
+
+  if (index==getOptionIndex("-waitSave"))
+    {
+      if (waitSave()!=0)
+	{
+	  Tcl_AppendResult(interp, "could not save file ", Tcl_DStringValue(saveName),
+			   ": ", strerror(saveError), NULL);
+	  return -1;
+	}
+      i++;
+    }
+
   return index;
 
 }
@@ -121,35 +322,67 @@ int gecoMemStream::cmd(int &i, int objc,Tcl_Obj *const objv[])
  * @copydoc gecoProcess::handleEvent
  *
  * In addition to gecoProcess::handleEvent, gecoMemStream::handleEvent implements
- * the streaming of the data to the memory.
+ * the streaming of the data to the memory and filtering with cut condition.
  */
 
 void gecoMemStream::handleEvent(gecoEvent* ev)
 {
   gecoProcess::handleEvent(ev);
 
+  // determines cut condition of set
+  int b=1;
+  if (!cutExpr->isEmpty()) cutExpr->exprBoolean(interp, &b);
+
   // If Active, records data
-  if ((status==Active)&&((ev->getT()-saveTime)>=dtRecord))
+  if ((status==Active)&&((ev->getT()-saveTime)>=dtRecord)&&(b))
     {
       saveTime=ev->getT();
-      Tcl_DStringFree(dataStr);
-      Tcl_DStringAppend(dataStr, "format \"", -1);
-      Tcl_DStringAppend(dataStr, Tcl_DStringValue(data), -1);
-      Tcl_DStringAppend(dataStr, "\"", -1);
-      Tcl_Eval(interp, Tcl_DStringValue(dataStr)); 
-      dataRec* rec;
-      rec = new dataRec;
-      rec->data = new Tcl_DString;
-      Tcl_DStringInit(rec->data);
-      Tcl_DStringAppend(rec->data, Tcl_GetStringResult(interp), -1);
-      rec->next=NULL;
-      lastData->next=rec;
-      lastData=rec;
+      if (binary)
+	{
+	  // typed records are stored with their timestamp
+	  const char* rec=binRec->build(interp);
+	  double ts=bin->getTimestamp(rec)/1e9;
+	  if (encoding==Encoding_none)
+	    arena->append(ts, rec, binRec->getSize());
+	  else
+	    {
+	      if (encoder->getRecords()==0) blockTime=ts;
+	      encoder->add(rec);
+	      if (encoder->isFull()) storeBlock();
+	    }
+	  if (window>0.0) arena->trim(ts-window);
+	  return;
+	}
+      int len;
+      if (nativeText)
+	{
+	  // the line is stored without its new line, as the text of data
+	  const char* line=textRec->build(interp, &len);
+	  arena->append(saveTime, line, len-1);
+	  if (window>0.0) arena->trim(saveTime-window);
+	  return;
+	}
+      dataCode->eval(interp);
+      const char* str=Tcl_GetStringFromObj(Tcl_GetObjResult(interp), &len);
+      arena->append(saveTime, str, len);
+      if (window>0.0) arena->trim(saveTime-window);
       Tcl_ResetResult(interp);
     }
 }
 
 
+/**
+ * @brief Stores the block of compressed records being filled
+*/
+
+void gecoMemStream::storeBlock()
+{
+  size_t len;
+  const char* block=encoder->finish(len);
+  if (len>0) arena->append(blockTime, block, len);
+}
+
+
 /**
  * @copydoc gecoProcess::info
  *
@@ -160,8 +393,73 @@ void gecoMemStream::handleEvent(gecoEvent* ev)
 Tcl_DString* gecoMemStream::info(const char* frontStr)
 {
   gecoProcess::info(frontStr);
-  addInfo(frontStr, "Data to stream:       ", Tcl_DStringValue(data));  
+  if (Tcl_DStringLength(columns)>0)
+    {
+      addInfo(frontStr, "Columns:              ", Tcl_DStringValue(columns));
+      addInfo(frontStr, "Format:               ", Tcl_DStringValue(format));
+      if (strcmp(Tcl_DStringValue(format),"text")==0)
+	addInfo(frontStr, "Precision:            ", Tcl_DStringValue(precision));
+      else
+	addInfo(frontStr, "Compression:          ", Tcl_DStringValue(compress));
+    }
+  else
+    addInfo(frontStr, "Data to stream:       ", Tcl_DStringValue(data));
   addInfo(frontStr, "Record interval (s):  ", dtRecord);  
+  addInfo(frontStr, "Mode:                 ", Tcl_DStringValue(mode));
+  addInfo(frontStr, "Capacity (kB):        ", capacity);
+  addInfo(frontStr, "Window (s):           ", window);
+  char str[80];
+  sprintf(str, "%ld kB (allocated %ld kB)", (long)(arena->getUsed()/1024),
+	  (long)(arena->getAllocated()/1024));
+  addInfo(frontStr, "Memory used:          ", str);
+  if ((binary)&&(encoding!=Encoding_none))
+    {
+      // the storage holds blocks of records
+      gecoArenaCursor c;
+      double      t;
+      const char* block;
+      size_t      len;
+      long long   n=encoder->getRecords();
+      arena->first(c);
+      while (arena->next(c, t, block, len)) n+=gecoBlockDecoder::getRecords(block);
+      sprintf(str, "%lld (%lld blocks)", n, arena->getRecords());
+      addInfo(frontStr, "Records stored:       ", str);
+      if (encoder->getEncodedBytes()>0)
+	{
+	  sprintf(str, "%.1f", (double)(encoder->getRawBytes()-(long long)encoder->getRecords()*bin->getRecordSize())/
+		  encoder->getEncodedBytes());
+	  addInfo(frontStr, "Compression ratio:    ", str);
+	}
+    }
+  else
+    {
+      sprintf(str, "%lld", arena->getRecords());
+      addInfo(frontStr, "Records stored:       ", str);
+    }
+  sprintf(str, "%lld", arena->getOverwritten());
+  addInfo(frontStr, "Records overwritten:  ", str);
+  if (arena->getDropped()>0)
+    {
+      sprintf(str, "%lld (larger than %ld bytes)", arena->getDropped(), (long)arena->getChunkSize());
+      addInfo(frontStr, "Records dropped:      ", str);
+    }
+  if (saving)
+    {
+      sprintf(str, "%lld of %lld records", savedRecords.load(), saveSnap->getRecords());
+      addInfo(frontStr, "Saving:               ", Tcl_DStringValue(saveName));
+      addInfo(frontStr, "Save progress:        ", str);
+    }
+  else if (Tcl_DStringLength(saveName)>0)
+    {
+      addInfo(frontStr, "Last save:            ", Tcl_DStringValue(saveName));
+      if (saveError)
+	addInfo(frontStr, "Save error:           ", strerror(saveError));
+      else
+	{
+	  sprintf(str, "%lld", savedRecords.load());
+	  addInfo(frontStr, "Records saved:        ", str);
+	}
+    }
   return infoStr;
 }
 
@@ -177,7 +475,38 @@ void gecoMemStream::activate(gecoEvent* ev)
 {
   gecoProcess::activate(ev);
   saveTime=ev->getT();
-  resetData();
+  int m=(strcmp(Tcl_DStringValue(mode),ArenaModeStr[Arena_ring])==0) ? Arena_ring : Arena_grow;
+  if ((arena->getCapacity()!=(size_t)capacity*1024)||(arena->getMode()!=m))
+    arena->setup((size_t)capacity*1024, m);
+  else
+    arena->clear();
+
+  // typed columns
+  nativeText=(Tcl_DStringLength(columns)>0)&&(strcmp(Tcl_DStringValue(format),"text")==0);
+  binary=(Tcl_DStringLength(columns)>0)&&(!nativeText);
+  encoding=Encoding_none;
+  Tcl_DStringFree(binHeader);
+  if (binary)
+    {
+      encoding=(strcmp(Tcl_DStringValue(compress),EncodingStr[Encoding_gorilla])==0) ?
+	Encoding_gorilla : Encoding_none;
+      struct timespec ts;
+      clock_gettime(CLOCK_REALTIME, &ts);
+      long long start=gecoBinRecord::monotonicTime();
+      bin->setColumns(interp, Tcl_DStringValue(columns));
+      bin->setEncoding(encoding);
+      bin->buildHeader(binHeader, "", start, ts.tv_sec+ts.tv_nsec/1e9);
+      binRec->bind(start);
+      // a block is stored as one record of a chunk
+      encoder->setup(BlockMaxRecords, arena->getChunkSize()-16);
+    }
+  if (nativeText)
+    {
+      textRec->setColumns(interp, Tcl_DStringValue(columns));
+      textRec->setPrecision(interp, Tcl_DStringValue(precision));
+      textRec->bind(gecoBinRecord::monotonicTime());
+      Tcl_ResetResult(interp);
+    }
 }
 
 
@@ -191,6 +520,12 @@ void gecoMemStream::activate(gecoEvent* ev)
 void gecoMemStream::terminate(gecoEvent* ev)
 {
   gecoProcess::terminate(ev);
+  if (binary)
+    {
+      storeBlock();
+      binRec->unbind();
+    }
+  if (nativeText) textRec->unbind();
 
   if (autoSave==false) return;
 
@@ -204,60 +539,193 @@ void gecoMemStream::terminate(gecoEvent* ev)
   Tcl_DStringAppend(fileName, getTclCmd(), -1);
   Tcl_DStringAppend(fileName, "_", -1);
   Tcl_DStringAppend(fileName, ID, -1);
-  Tcl_DStringAppend(fileName, ".txt", -1);
+  Tcl_DStringAppend(fileName, (binary) ? ".bin" : ".txt", -1);
   char str[80];
 
   if (saveData(fileName)==TCL_ERROR)
-    sprintf(str, "cons \"    ERROR : could not save %s\"",
-	    Tcl_DStringValue(fileName));
+    {
+      sprintf(str, "cons \"    ERROR : could not save %s\"",
+	      Tcl_DStringValue(fileName));
+      Tcl_Eval(interp, str);
+    }
   else
     if (verbose) 
-      sprintf(str, "cons \"    saved %s\"", Tcl_DStringValue(fileName));
+      {
+	sprintf(str, "cons \"    saving %s\"", Tcl_DStringValue(fileName));
+	Tcl_Eval(interp, str);
+      }
 
-  Tcl_Eval(interp, str);
   Tcl_DStringFree(fileName);
   delete fileName;
 }
 
 
 /**
- * @brief saves all recorded data
+ * @brief saves all recorded data in background
  * @param fileName name of the file to save to
- * \return TCL_ERROR if the saving fails otherwise TCL_OK
+ * \return TCL_ERROR if the file can't be opened otherwise TCL_OK
+ *
+ * The recorded data are frozen in a snapshot written to the file by a
+ * background thread. A running save is first waited for.
 */
 
 int gecoMemStream::saveData(Tcl_DString* fileName)
 {
-  ofstream dataFile;
-  dataFile.open(Tcl_DStringValue(fileName),ios::trunc);
-  if (dataFile.fail()) return TCL_ERROR;
-  dataRec* rec=firstData->next;
-  while(rec!=NULL)
+  if (saving) finishSave(true);
+  if (binary) storeBlock();
+
+  Tcl_DStringFree(saveName);
+  Tcl_DStringAppend(saveName, Tcl_DStringValue(fileName), -1);
+  savedRecords.store(0);
+  saveFile=fopen(Tcl_DStringValue(fileName), "w");
+  if (saveFile==NULL)
     {
-      dataFile << Tcl_DStringValue(rec->data) << "\n";
-      rec=rec->next;
+      saveError=errno;
+      return TCL_ERROR;
     }
-  dataFile.close();
+  setvbuf(saveFile, NULL, _IOFBF, 1<<20);
+  saveText=!binary;
+  saveEncoding=encoding;
+  if (binary) fwrite(Tcl_DStringValue(binHeader), 1, Tcl_DStringLength(binHeader), saveFile);
+
+  saveError=0;
+  saveDone.store(false);
+  saveSnap=arena->snapshot();
+  if (pthread_create(&saveThread, NULL, geco_MemStreamSaveThread, this)!=0)
+    {
+      // no thread available: saves in the foreground
+      geco_MemStreamSaveThread(this);
+      delete saveSnap;
+      saveSnap=NULL;
+      return (saveError==0) ? TCL_OK : TCL_ERROR;
+    }
+  saving=true;
+  saveTimer=Tcl_CreateTimerHandler(20, geco_MemStreamSavePoll, this);
   return TCL_OK;
 }
 
 
 /**
- * @brief deletes all recorded data except first one
- */
+ * @brief waits until the running save is completed
+ * \return 0 if the last save succeeded otherwise its errno
+*/
 
-void gecoMemStream::resetData()
+int gecoMemStream::waitSave()
 {
-  dataRec* it = firstData->next;
-  dataRec* next;
-  while (it!=NULL)
+  if (saving) finishSave(true);
+  return saveError;
+}
+
+
+/**
+ * @brief joins the save thread and releases the snapshot
+ * @param callback if true, the -onSave script is evaluated
+*/
+
+void gecoMemStream::finishSave(bool callback)
+{
+  if (saveTimer) Tcl_DeleteTimerHandler(saveTimer);
+  saveTimer=NULL;
+  pthread_join(saveThread, NULL);
+  saving=false;
+  delete saveSnap;
+  saveSnap=NULL;
+
+  if ((!callback)||(Tcl_DStringLength(onSave)==0)) return;
+
+  Tcl_DString script;
+  Tcl_DStringInit(&script);
+  Tcl_DStringAppend(&script, Tcl_DStringValue(onSave), -1);
+  Tcl_DStringAppendElement(&script, Tcl_DStringValue(saveName));
+  Tcl_DStringAppendElement(&script, (saveError==0) ? "ok" : strerror(saveError));
+  Tcl_InterpState state=Tcl_SaveInterpState(interp, TCL_OK);
+  if (Tcl_EvalEx(interp, Tcl_DStringValue(&script), -1, TCL_EVAL_GLOBAL)!=TCL_OK)
+    Tcl_BackgroundException(interp, TCL_ERROR);
+  Tcl_RestoreInterpState(interp, state);
+  Tcl_DStringFree(&script);
+}
+
+
+/**
+ * @brief feeds a query with the records stored from a cursor on
+ * @param q the query
+ * @param c cursor on the first record to feed
+ *
+ * The records of the block being filled are fed last.
+*/
+
+void gecoMemStream::scan(gecoTimeQuery* q, gecoArenaCursor& c)
+{
+  double      t;
+  const char* data;
+  size_t      len;
+  while (arena->next(c, t, data, len))
+    if (!((encoding==Encoding_none) ? q->add(data) : q->addBlock(data, len))) return;
+  for (int r=0; r<encoder->getRecords(); r++)
+    if (!q->add(encoder->getPending()+(size_t)r*bin->getRecordSize())) return;
+}
+
+
+/**
+ * @brief feeds a query with the records of its time range
+ * @param q the query
+ * \return TCL_OK
+ *
+ * The first record of the range is found by binary search over the chunks of
+ * the storage.
+*/
+
+int gecoMemStream::queryRange(gecoTimeQuery* q)
+{
+  gecoArenaCursor c;
+  arena->seek(c, q->getMin()/1e9);
+  scan(q, c);
+  return TCL_OK;
+}
+
+
+/**
+ * @brief feeds a query with the n latest records
+ * @param q the query
+ * @param n number of records
+ * \return TCL_OK
+ *
+ * The chunks of the storage holding the n latest records are found by counting
+ * the records of the chunks from the newest one.
+*/
+
+int gecoMemStream::queryLatest(gecoTimeQuery* q, long long n)
+{
+  if (n<=0) return TCL_OK;
+  q->setLatest(n);
+  n-=encoder->getRecords();
+
+  gecoArenaCursor c;
+  double      t;
+  const char* data;
+  size_t      len;
+  size_t      k=arena->getNbrChunks();
+  while ((k>0)&&(n>0))
     {
-      next = it->next;
-      Tcl_DStringFree(it->data);
-      delete it->data;
-      delete it;
-      it=next;
+      k--;
+      arena->firstOfChunk(c, k);
+      while ((arena->next(c, t, data, len))&&(c.chunk==k))
+	n-=(encoding==Encoding_none) ? 1 : gecoBlockDecoder::getRecords(data);
     }
-  firstData->next = NULL;
-  lastData = firstData;
+  arena->firstOfChunk(c, k);
+  scan(q, c);
+  return TCL_OK;
+}
+
+
+/**
+ * @brief deletes all recorded data
+ *
+ * The preallocated memory is kept for the next recording.
+ */
+
+void gecoMemStream::resetData()
+{
+  arena->clear();
+  if (binary) encoder->setup(BlockMaxRecords, arena->getChunkSize()-16);
 }
@@ -20,6 +20,11 @@
 // ---------------------------------------------------------------
 // 31.10.2015 Creation                         R. Wuthrich
 // 08.12.2020 Added doxygen documentation      R. Wuthrich
+// 17.10.2026 Arena storage of the data        agent
+// 17.10.2026 Saving in background             agent
+// 17.10.2026 Added typed and compressed data  agent
+// 17.10.2026 Added time-indexed queries       agent
+// 17.10.2026 Added native text encoding       agent
 //
 // ---------------------------------------------------------------
 /*! \file */
@@ -28,8 +33,19 @@
 #define gecoMemStream_SEEN_
 
 #include <tcl8.6/tcl.h>
+#include <stdio.h>
+#include <pthread.h>
+#include <atomic>
 #include "gecoProcess.h"
+#include "gecoScript.h"
+#include "gecoExpr.h"
 #include "gecoApp.h"
+#include "gecoRecordArena.h"
+#include "gecoBinFile.h"
+#include "gecoBinRecord.h"
+#include "gecoTextRecord.h"
+#include "gecoBlockCodec.h"
+#include "gecoTimeQuery.h"
 
 using namespace std;
 
@@ -51,16 +67,8 @@ using namespace std;
 int geco_MemStreamCmd(ClientData clientData, Tcl_Interp *interp, 
 		      int objc,Tcl_Obj *const objv[]);
 
-
-// -------------------------------------------------------------------------
-//
-// Structure for data
-
-struct dataRec
-{
-  Tcl_DString*   data;
-  dataRec*       next;
-};
+void* geco_MemStreamSaveThread(void* arg);
+void  geco_MemStreamSavePoll(ClientData clientData);
 
 
 // -----------------------------------------------------------------------
@@ -97,58 +105,226 @@ struct dataRec
  * -data             | returns/sets data to stream to file
  * -cut              | returns/sets filter on data to be saved
  * -autosave         | saves automatically recored data to disk when gecoMemStream is terminated
- * -save             | saves recored data to a file
+ * -save             | saves recored data to a file (in background)
+ * -waitSave         | waits until the running save is completed
+ * -onSave           | returns/sets script evaluated when a save is completed
+ * -capacity         | returns/sets memory preallocated for the data (kB)
+ * -mode             | returns/sets storage mode (grow or ring)
+ * -window           | returns/sets time span of data kept (s, 0 for no limit)
+ * -columns          | returns/sets typed columns recorded instead of data
+ * -format           | returns/sets format of typed columns (binary or text)
+ * -precision        | returns/sets decimals of columns in text format
+ * -compress         | returns/sets compression of typed columns (none or gorilla)
+ * -range            | returns {t value} of a column in a time range (column tMin tMax ?maxPoints?)
+ * -latest           | returns {t value} of the latest records of a column (column n)
+ *
+ * Storage of the data
+ * -------------------
+ * The recorded data are stored back to back in chunks of memory preallocated
+ * at activation (see gecoRecordArena). '-capacity' sets the preallocated memory.
+ * When it is full, the storage mode defines what happens:
+ *
+ * '-mode'   | Behaviour
+ * --------- | ------------------------------------------------------
+ * grow      | more memory is allocated (default, memory grows without bound)
+ * ring      | the oldest data are overwritten (memory never exceeds '-capacity')
+ *
+ * With a '-window' larger than 0, only the data of the last '-window' seconds
+ * are kept. The overwritten data are counted and reported by '-info'.
+ * A record must fit in a chunk ('-capacity'/16, between 4 and 64 kB); larger
+ * records are dropped and counted.
+ * The settings of the storage are taken into account at the next activation.
+ *
+ * Typed columns
+ * -------------
+ * With '-columns' (declared as for the binary format of gecoFileStream, see
+ * gecoBinRecord), fixed-width binary records are stored instead of the text of
+ * '-data'. They are saved as a binary data file read by the Tcl command 'binfile'
+ * ('-autosave' uses the extension .bin). With '-compress gorilla', the records are
+ * further compressed in blocks of up to 1024 records (see gecoBlockEncoder), each
+ * stored as one record of the storage: the memory holds several times more data.
+ * A block is limited to a chunk of the storage. The block being filled is stored
+ * when it is full, when the data are saved and on termination. The compression
+ * ratio is reported by '-info'. The columns are taken into account at the next
+ * activation.
+ *
+ * With '-format text', the typed columns are instead stored as lines of text built
+ * natively by a gecoTextRecord, without evaluating any Tcl script: the values are
+ * separated by a blank and printed exactly as '-data' would print them
+ * ('-columns {t V {n int}}' stores the same lines as '-data {$t $V $n}'). No
+ * timestamp column is added. '-precision' is a dict {column decimals ...} printing
+ * the listed columns with a fixed number of decimals (as '%.nf'). The lines are
+ * saved as with '-data' ('-autosave' uses the extension .txt) and can't be queried.
+ *
+ * Queries
+ * -------
+ * The typed columns recorded can be queried while recording, without saving:
+ * '-range' returns the records of a time range, decimated to at most 'maxPoints'
+ * evenly spaced records, and '-latest' the n latest records (see gecoTimeQuery).
+ * The times are in seconds since the start of the recording (the timestamp
+ * column), also used by '-window'. The first record of the range is found by
+ * binary search over the chunks of the storage (see gecoRecordArena::seek); only
+ * the records and blocks of the range are read and decompressed. The records of
+ * the block being filled are included.
+ *
+ * Saving of the data
+ * ------------------
+ * '-save' and '-autosave' freeze the recorded data in a snapshot sharing the
+ * memory of the storage (see gecoArenaSnapshot) and write it to the file from a
+ * background thread. The geco process loop is not blocked and the next recording
+ * can start immediately. Only the opening of the file is checked by '-save'.
+ *
+ * The progress of the save is reported by '-info'. Once the save is completed,
+ * the '-onSave' script is evaluated at global level with the file name and 'ok'
+ * or the error message appended. '-waitSave' waits for the completion and returns
+ * an error if the save failed. A new save waits for the running one.
+ *
+ * Example
+ * -------
+ * \code
+ * memstream -data {$t $V} -dtRecord 0 -mode ring -capacity 65536 -window 3600
+ * memstream -columns {t {V double}} -compress gorilla -dtRecord 0 -mode ring
+ * \endcode
  */
 
 class gecoMemStream : public gecoProcess
 {
 private:
 
-  Tcl_DString*           dataStr;
+  gecoScript*            dataCode;        // cached 'format' of data
+  gecoExpr*              cutExpr;         // compiled cut filter
   double                 saveTime;
   int                    autosaveCounter;
 
+  // typed columns
+  bool                   binary;          // true if typed columns are recorded
+  int                    encoding;        // Encoding_none or Encoding_gorilla
+  gecoBinFile*           bin;             // layout of the records
+  gecoBinRecord*         binRec;          // builds the records
+  gecoBlockEncoder*      encoder;         // compresses the records
+  Tcl_DString*           binHeader;       // header of the binary data file
+  double                 blockTime;       // time of the first record of the block
+
+  // native text format
+  bool                   nativeText;      // true if typed columns are stored as text
+  gecoTextRecord*        textRec;         // builds the lines
+
+  void                   storeBlock();
+  void                   scan(gecoTimeQuery* q, gecoArenaCursor& c);
+
+  // saving in background
+  pthread_t              saveThread;
+  bool                   saving;          // a save thread was started and not joined
+  atomic<bool>           saveDone;        // the save thread completed
+  atomic<long long>      savedRecords;    // records written by the save thread
+  gecoArenaSnapshot*     saveSnap;        // data being saved
+  FILE*                  saveFile;
+  bool                   saveText;        // the records are lines of text
+  int                    saveEncoding;    // encoding of the records saved
+  Tcl_DString*           saveName;        // file name of the last save
+  int                    saveError;       // errno of the last save (0 if none)
+  Tcl_TimerToken         saveTimer;
+
+  void                   finishSave(bool callback);
+
+  friend void* geco_MemStreamSaveThread(void* arg);
+  friend void  geco_MemStreamSavePoll(ClientData clientData);
+
 protected:
 
-  dataRec*       firstData;
-  dataRec*       lastData;
+  gecoRecordArena* arena;         // storage of the data
 
   bool           autoSave;
 
   Tcl_DString*   data;            // data to be recorder
   Tcl_DString*   cut;             // cut fiter
+  Tcl_DString*   onSave;          // script evaluated when a save is completed
 
   double         dtRecord;          
 
+  int            capacity;        // preallocated memory (kB)
+  Tcl_DString*   mode;            // grow or ring
+  double         window;          // time span of data kept (s)
+  Tcl_DString*   columns;         // typed columns recorded
+  Tcl_DString*   compress;        // compression of the typed columns
+  Tcl_DString*   format;          // format of the typed columns (binary or text)
+  Tcl_DString*   precision;       // decimals of columns in text format
+
 public:
 
   gecoMemStream(gecoApp* App) :
     gecoObj("Stream to memory", "memstream", App),
     gecoProcess("Stream to memory", "user", "memstream", App),
-    autosaveCounter(0),
     saveTime(0.0),
+    autosaveCounter(0),
+    binary(false),
+    encoding(Encoding_none),
+    blockTime(0.0),
+    nativeText(false),
+    saving(false),
+    saveDone(false),
+    savedRecords(0),
+    saveSnap(NULL),
+    saveFile(NULL),
+    saveText(true),
+    saveEncoding(Encoding_none),
+    saveError(0),
+    saveTimer(NULL),
     dtRecord(0.1),
-    autoSave(false)
+    autoSave(false),
+    capacity(1024),
+    window(0.0)
   {
     activateOnStart=1;
-    firstData=new dataRec;
-    firstData->data=NULL;
-    firstData->next=NULL;
-    lastData=firstData;
+    arena    = new gecoRecordArena;
 
     data     = new Tcl_DString;
     cut      = new Tcl_DString;
-    dataStr  = new Tcl_DString;
+    mode     = new Tcl_DString;
+    onSave   = new Tcl_DString;
+    saveName = new Tcl_DString;
+    columns  = new Tcl_DString;
+    compress = new Tcl_DString;
+    format   = new Tcl_DString;
+    precision = new Tcl_DString;
+    binHeader = new Tcl_DString;
     Tcl_DStringInit(data);
     Tcl_DStringInit(cut);
-    Tcl_DStringInit(dataStr);
+    Tcl_DStringInit(mode);
+    Tcl_DStringInit(onSave);
+    Tcl_DStringInit(saveName);
+    Tcl_DStringInit(columns);
+    Tcl_DStringInit(compress);
+    Tcl_DStringInit(format);
+    Tcl_DStringInit(precision);
+    Tcl_DStringInit(binHeader);
+    Tcl_DStringAppend(mode, ArenaModeStr[Arena_grow], -1);
+    Tcl_DStringAppend(compress, EncodingStr[Encoding_none], -1);
+    Tcl_DStringAppend(format, "binary", -1);
+    dataCode = new gecoScript(data, "format \"", "\"");
+    cutExpr  = new gecoExpr(App, cut);
+    bin      = new gecoBinFile;
+    binRec   = new gecoBinRecord(App, bin);
+    encoder  = new gecoBlockEncoder(bin);
+    textRec  = new gecoTextRecord(App);
 
     addOption("-dtRecord", &dtRecord,
 	      "returns/sets time interval between two recordings (s)");
     addOption("-cut", cut, "returns/sets filter on data to be recorded");
     addOption("-data", data, "returns/sets data to record");
     addOption("-autosave", &autoSave, "saves automatically recored data to disk");
-    addOption("-save", "saves recored data to a file");
+    addOption("-save", "saves recored data to a file (in background)");
+    addOption("-waitSave", "waits until the running save is completed");
+    addOption("-onSave", onSave, "returns/sets script evaluated when a save is completed");
+    addOption("-capacity", &capacity, "returns/sets memory preallocated for the data (kB)");
+    addOption("-mode", mode, "returns/sets storage mode (grow or ring)");
+    addOption("-window", &window, "returns/sets time span of data kept (s, 0 for no limit)");
+    addOption("-columns", columns, "returns/sets typed columns recorded instead of data");
+    addOption("-compress", compress, "returns/sets compression of typed columns (none or gorilla)");
+    addOption("-format", format, "returns/sets format of typed columns (binary or text)");
+    addOption("-precision", precision, "returns/sets decimals of columns in text format");
+    addOption("-range", "returns {t value} of a column in a time range (column tMin tMax ?maxPoints?)");
+    addOption("-latest", "returns {t value} of the latest records of a column (column n)");
   }
 
   ~gecoMemStream();
@@ -161,7 +337,10 @@ public:
   virtual void terminate(gecoEvent* ev);
 
   int          saveData(Tcl_DString* fileName);
+  int          waitSave();
   void         resetData();
+  int          queryRange(gecoTimeQuery* q);
+  int          queryLatest(gecoTimeQuery* q, long long n);
 };
 
 #endif /* gecoMemStream_SEEN_ */
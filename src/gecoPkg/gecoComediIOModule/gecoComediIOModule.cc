@@ -517,8 +517,10 @@ int gecoIOComedi::cmd(int &i,int objc,Tcl_Obj *const objv[])
 	return -1;
       }
 
-    // creates a new entry and links it
+    // creates a new entry and links it (a BoardInsn changes instr_list,
+    // used by the real-time thread)
     BoardInsn* isn;
+    app->getRTLoop()->hold();
     if (str[1]=='I')
       isn = new BoardInsn(Tcl_GetString(objv[i+1]),TclVarRead,n,this);
     else
@@ -526,8 +528,10 @@ int gecoIOComedi::cmd(int &i,int objc,Tcl_Obj *const objv[])
     if (addInsn(isn)==TCL_ERROR) 
       {
 	delete isn;
+	app->getRTLoop()->release();
 	return -1;
       }
+    app->getRTLoop()->release();
     i=i+3;
   }
 
@@ -19,6 +19,7 @@
 // Date       Modification                     Author
 // ---------------------------------------------------------------
 // 13.11.2015 Creation                         R. Wuthrich
+// 17.10.2026 Marked as real-time safe         agent
 // ---------------------------------------------------------------
 
 #ifndef GECOCOMEDIIOMODULE_SEEN_
@@ -161,6 +162,7 @@ public:
   int unlock() {return comedi_unlock(device,out_subdev);}
 
   virtual void IOerror();
+  virtual bool rtSafe() {return true;}   // doInstr only calls comedilib
   virtual Tcl_DString* info(const char* frontStr = "");
 
   BoardInsn* getFirstInsn() {return static_cast<BoardInsn*>(firstIOModuleInsn);}
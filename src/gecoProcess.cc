@@ -19,14 +19,21 @@
 // ---------------------------------------------------------------
 // 10.10.2015 Creation                         R. Wuthrich
 // 28.11.2020 Added doxygen documentation      R. Wuthrich
+// 17.10.2026 Added real-time thread support   agent
+// 17.10.2026 Added execution time statistics  agent
+// 17.10.2026 Added tick divider               agent
+// 17.10.2026 Loop index replaces nextGecoProc agent
 //
 // ---------------------------------------------------------------
 
 #include <cstring>
+#include <cmath>
 #include <sys/time.h>
 #include <tcl8.6/tcl.h>
 #include "gecoProcess.h"
 #include "gecoApp.h"
+#include "gecoRTLoop.h"
+#include "gecoTimerWheel.h"
 
 #include <iostream>
 
@@ -101,11 +108,14 @@ int geco_CreateGecoProcessCmd(gecoProcess* proc,
 gecoProcess::gecoProcess(const char* procName, const char* procOwner,
 		         const char* procCmd, gecoApp* App) : 
   gecoObj(procName,procCmd,App),
-  nextGecoProc(NULL),
   owner(procOwner),
   status(Waiting),
+  verbose(1),
   activateOnStart(0),
-  verbose(1)
+  activateNext(1),
+  realtime(0),
+  tickDivider(1),
+  loopIndex(-1)
 {
   activationTime.tv_sec = -1;
   activationTime.tv_usec = -1;
@@ -113,6 +123,7 @@ gecoProcess::gecoProcess(const char* procName, const char* procOwner,
   postProcessScript = new Tcl_DString;
   Tcl_DStringInit(preProcessScript);
   Tcl_DStringInit(postProcessScript);
+  resetExecStat();
 
   addOption("-verbose", &verbose, "turns on/off messaging to console");
   addOption("-activateOnStart", &activateOnStart,
@@ -120,6 +131,8 @@ gecoProcess::gecoProcess(const char* procName, const char* procOwner,
   addOption("-preProcess", preProcessScript, "returns/sets pre-process script");
   addOption("-postProcess", postProcessScript, "returns/sets post-process script");
   addOption("-status", "returns the process status");
+  addOption("-realtime", &realtime, "turns on/off execution on the real-time thread");
+  addOption("-tickDivider", &tickDivider, "returns/sets number of clock ticks between two runs");
 }
 
 
@@ -146,8 +159,39 @@ gecoProcess::~gecoProcess()
 int gecoProcess::cmd(int &i, int objc,Tcl_Obj *const objv[])
 {
   // first executes the command options defined in gecoObj
+  int j=i;
+  int oldTickDivider=tickDivider;
   int index=gecoObj::cmd(i, objc, objv);
 
+  if ((index==getOptionIndex("-tickDivider"))&&(i==j+2))
+    {
+      if (tickDivider<1)
+	{
+	  Tcl_AppendResult(interp, "tick divider must be a positive integer", NULL);
+	  tickDivider = oldTickDivider;
+	  return -1;
+	}
+      if ((tickDivider!=1)&&(strcmp(owner, "system")==0))
+	{
+	  Tcl_AppendResult(interp, "a system process runs at every tick", NULL);
+	  tickDivider = oldTickDivider;
+	  return -1;
+	}
+      app->getTimerWheel()->rebuild();
+    }
+
+  if ((index==getOptionIndex("-realtime"))&&(i==j+2))
+    {
+      if ((realtime)&&(!realtimeCapable()))
+	{
+	  Tcl_AppendResult(interp, "process \"", getID(),
+			   "\" can't run on the real-time thread", NULL);
+	  realtime = 0;
+	  return -1;
+	}
+      app->getRTLoop()->publish();
+    }
+
   if (index==getOptionIndex("-status"))
     {
       char str[10];
@@ -221,11 +265,7 @@ void gecoProcess::handleEvent(gecoEvent* ev)
 	ev->reset();
       }
 
-  if ((status==Active)&&(ev->cmd()==CmdStop)) 
-  {
-	  terminate(ev);
-	  ev->setCmdEvent(CmdStop, NULL);
-  }
+  if ((status==Active)&&(ev->cmd()==CmdStop)) terminate(ev);
 
   if ((status==Active)&&(ev->cmd()==CmdHold)) status = Hold;
   if ((status==Hold)&&(ev->cmd()==CmdResume)) status = Active;
@@ -239,6 +279,80 @@ void gecoProcess::handleEvent(gecoEvent* ev)
 }
 
 
+/**
+ * @brief Returns true if the real-time thread executes gecoProcess::handleRTEvent
+ *
+ * This is the case if the gecoProcess is in '-realtime' mode and the
+ * real-time thread of the gecoApp is running.
+ */
+
+bool gecoProcess::runsOnRTLoop()
+{
+  return (realtime)&&(app->getRTLoop()->isRunning());
+}
+
+
+/**
+ * @brief Adds an entry to the execution time statistics of handleEvent
+ * @param dt execution time (us) of gecoProcess::handleEvent
+*/
+
+void gecoProcess::addExecReco(double dt)
+{
+  if (exec_min>dt) exec_min=dt;
+  if (exec_max<dt) exec_max=dt;
+  nExec++;
+  exec_sum=exec_sum+dt;
+
+  // bucket k covers [2^e, 2^(e+1)) ns split in ExecHistSub linear sub-buckets
+  int e;
+  double m = frexp(1000.0*dt, &e);
+  int k = (e<1) ? 0 : (e-1)*ExecHistSub + (int)((2.0*m-1.0)*ExecHistSub);
+  if (k>=ExecHistBins) k=ExecHistBins-1;
+  execHist[k]++;
+}
+
+
+/**
+ * @brief Resets the execution time statistics of handleEvent
+*/
+
+void gecoProcess::resetExecStat()
+{
+  nExec = 0;
+  exec_sum = 0.0;
+  exec_min = 1e12;
+  exec_max = 0.0;
+  for (int k=0; k<ExecHistBins; k++) execHist[k]=0;
+}
+
+
+/**
+ * @brief Estimates a percentile of the execution time of handleEvent
+ * @param q percentile as a fraction (e.g. 0.99)
+ * \return upper bound (us) of the histogram bucket containing the percentile
+ *
+ * The estimate is within the width of a bucket (25% of its value) and 
+ * is clamped to the observed max execution time.
+*/
+
+double gecoProcess::execPercentile(double q)
+{
+  if (nExec==0) return 0.0;
+  long rank = (long)ceil(q*nExec);
+  long count = 0;
+  int k;
+  for (k=0; k<ExecHistBins-1; k++)
+    {
+      count += execHist[k];
+      if (count>=rank) break;
+    }
+  int e = k/ExecHistSub;
+  double upper = ldexp(1.0 + (double)(k%ExecHistSub+1)/ExecHistSub, e)/1000.0;
+  return (upper<exec_max) ? upper : exec_max;
+}
+
+
 /*! 
  * @copydoc gecoObj::info
  */
@@ -266,7 +380,9 @@ Tcl_DString* gecoProcess::info(const char* frontStr)
  *   gecoProcess lives the ID of the gecoProcess in the Tcl variable ID.
  * * Calls the Tcl postProcessScript of the gecoProcess
  * * Generates the Tk virtual event <<gecoProcessTerminated>>
- * * Sets the gecoEvent ev to CmdProcessTerminated
+ * * Sets the gecoEvent ev to CmdProcessTerminated (unless the gecoProcess
+ *   is stopped or gecoProcess::activateNext is false), so that the next
+ *   gecoProcess gets activated
  */
 
 void gecoProcess::terminate(gecoEvent* ev)
@@ -279,7 +395,8 @@ void gecoProcess::terminate(gecoEvent* ev)
   Tcl_SetVar(interp, "ID", objID, 0);
   Tcl_Eval(interp, Tcl_DStringValue(postProcessScript));
   Tcl_Eval(interp, "event generate . <<gecoProcessTerminated>>");
-  ev->setCmdEvent(CmdProcessTerminated, this);
+  if ((activateNext)&&(ev->cmd()!=CmdStop))
+    ev->setCmdEvent(CmdProcessTerminated, this);
 }
 
 
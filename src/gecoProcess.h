@@ -20,6 +20,10 @@
 // ---------------------------------------------------------------
 // 17.10.2015 Creation                         R. Wuthrich
 // 28.11.2020 Added doxygen documentation      R. Wuthrich
+// 17.10.2026 Added real-time thread support   agent
+// 17.10.2026 Added execution time statistics  agent
+// 17.10.2026 Added tick divider               agent
+// 17.10.2026 Loop index replaces nextGecoProc agent
 //
 // ---------------------------------------------------------------
 /*! \file */
@@ -50,6 +54,16 @@ const int
 const char StatusStr[4][11] = {"Waiting", "Active", "Hold", "Terminated"};
 
 
+// -----------------------------------------------------------------------
+//
+// Execution time histogram
+//
+
+const int
+  ExecHistSub  = 4,                       // linear sub-buckets per octave
+  ExecHistBins = 40*ExecHistSub;          // covers 1 ns up to 2^40 ns
+
+
 // -------------------------------------------------------------------------
 //
 // Tcl interface
@@ -196,6 +210,8 @@ int geco_CreateGecoProcessCmd(gecoProcess* proc, int objc,
  * -preprocess       | returns/sets pre-process script
  * -postprocess      | returns/sets post-process script  
  * -status           | returns the process status
+ * -realtime         | turns on/off execution on the real-time thread
+ * -tickDivider      | returns/sets number of clock ticks between two runs
  *
  * This Tcl command can be used to alter the gecoProcess, by for example
  * updating parameters (e.g the pre-pocess script).
@@ -211,6 +227,36 @@ int geco_CreateGecoProcessCmd(gecoProcess* proc, int objc,
  * process loop in case the user only invokes the '-help' subcommand.
  * See the example section for an illustration of how to use this function.
  *
+ * Tick divider
+ * ------------
+ * By default gecoProcess::handleEvent is called at every clock tick. With the
+ * '-tickDivider' subcommand a gecoProcess can be run only every N-th tick
+ * (see gecoTimerWheel). It is still called at every tick on which the gecoEvent 
+ * carries a command, so that it reacts immediately to 'start', 'stop', etc. 
+ * System processes (like the gecoClock) always run at every tick.
+ *
+ * Real-time thread
+ * ----------------
+ * A gecoProcess for which gecoProcess::realtimeCapable returns true can be
+ * moved with the '-realtime' subcommand to the real-time thread run by the
+ * gecoRTLoop of the gecoApp. While the real-time thread is running, the method
+ * gecoProcess::handleRTEvent is called by the real-time thread at each period
+ * as long as the gecoProcess is active. The life cycle of the gecoProcess is
+ * still handled by gecoProcess::handleEvent on the interpreter thread.
+ * gecoProcess::runsOnRTLoop tells a child if it should skip in
+ * gecoProcess::handleEvent the work done in gecoProcess::handleRTEvent.
+ *
+ * gecoProcess::handleRTEvent must never call the Tcl C API.
+ *
+ * Execution time statistics
+ * -------------------------
+ * geco_eventLoop() measures the time spent in gecoProcess::handleEvent and
+ * records it with gecoProcess::addExecReco. Each gecoProcess keeps the number
+ * of calls, the total, min and max execution time and a log-bucketed 
+ * histogram (4 linear sub-buckets per octave) from which the percentiles are 
+ * estimated with gecoProcess::execPercentile. The Tcl commands 'ps -stats' and 
+ * 'ps -resetStats' defined by gecoApp display and reset these statistics.
+ *
  * Example
  * -------
  * The following example code illustrated how a new gecoProcess can be created
@@ -348,11 +394,21 @@ protected:
   int          status;                  /*!< gecoProcess status */
   bool         verbose;                 /*!< gecoProcess verbose mode */
   bool         activateOnStart;         /*!< gecoProcess activate-on-start mode */
+  bool         activateNext;            /*!< activates the next gecoProcess when terminated */
+  bool         realtime;                /*!< gecoProcess runs on the real-time thread */
+  int          tickDivider;             /*!< number of clock ticks between two runs */
 
   Tcl_DString* preProcessScript;        /*!< gecoProcess Tcl preProcessScript */
   Tcl_DString* postProcessScript;       /*!< gecoProcess Tcl postProcessScript */
 
-  gecoProcess* nextGecoProc;            /*!< next gecoProcess in the geco process loop*/
+  int          loopIndex;               /*!< position in the geco process loop (-1 if not in the loop) */
+
+  // execution time statistics of handleEvent (us)
+  long         nExec;                   /*!< number of recorded calls of handleEvent */
+  double       exec_sum;                /*!< total execution time */
+  double       exec_min;                /*!< min execution time */
+  double       exec_max;                /*!< max execution time */
+  long         execHist[ExecHistBins];  /*!< log-bucketed histogram of execution time */
 
 public:
 
@@ -366,6 +422,19 @@ public:
 
   virtual void terminate(gecoEvent* ev);
   virtual void activate(gecoEvent* ev);
+
+  virtual bool realtimeCapable() {return false;}                   /*!< Returns true if handleRTEvent can run on the real-time thread */
+  virtual void handleRTEvent(double t) {}                          /*!< Called by the real-time thread with t the time (s) since its start */
+  bool         getRealtime() {return realtime;}                    /*!< Returns true if in '-realtime' mode */
+  bool         runsOnRTLoop();
+
+  void         addExecReco(double dt);
+  void         resetExecStat();
+  double       execPercentile(double q);
+  long         getNExec()   {return nExec;}                        /*!< Returns the number of recorded calls of handleEvent */
+  double       getExecSum() {return exec_sum;}                     /*!< Returns the total execution time (us) */
+  double       getExecMin() {return exec_min;}                     /*!< Returns the min execution time (us) */
+  double       getExecMax() {return exec_max;}                     /*!< Returns the max execution time (us) */
   double       timeSinceActivated();
   double       to() {return t_o;}                                  /*!< Returns t_o */
 
@@ -379,10 +448,10 @@ public:
   virtual void setStatus(int gecoProcessStatus) {status=gecoProcessStatus;} /*!< Sets the gecoProcess status */
   const char*  getStatusStr() {return StatusStr[status];}          /*!< Returns the gecoProcess status */
 
-  void         setNextGecoProcess(gecoProcess* NextGecoProc) 
-                       {nextGecoProc=NextGecoProc;}                /*!< Sets the next gecoProcess in the process loop*/
-  gecoProcess* getNextGecoProcess() {return nextGecoProc;}         /*!< Returns the next gecoProcess from the process loop */
+  void         setLoopIndex(int index) {loopIndex=index;}         /*!< Sets the position in the process loop (used by gecoApp) */
+  int          getLoopIndex() {return loopIndex;}                  /*!< Returns the position in the process loop */
   bool         getVerbose() {return verbose;}                      /*!< Returns value of verbose */
+  int          getTickDivider() {return tickDivider;}              /*!< Returns the tick divider */
 };
 
 #endif /* gecoProcess_SEEN_ */
@@ -0,0 +1,282 @@
+// ---------------------------------------------------------------
+//
+// Definition of the class gecoPyramid
+//
+// (c) Rolf Wuthrich
+//     2026 Concordia University
+//
+// author:  agent
+// email:   agent@local
+// version: v1
+//
+// This software is copyright under the BSD license
+//
+// ---------------------------------------------------------------
+// history:
+// ---------------------------------------------------------------
+// Date       Modification                     Author
+// ---------------------------------------------------------------
+// 17.10.2026 Creation                         agent
+// 18.10.2026 Decreasing x                     agent
+//
+// ---------------------------------------------------------------
+
+#include <tcl.h>
+#include <cmath>
+#include "gecoPyramid.h"
+
+using namespace std;
+
+
+// ---------------------------------------------------------------
+//
+// class gecoPyramid : min/max/mean pyramid of a plotted trace
+//
+
+
+const int PyramidMaxLevels = 48;     // a bucket of the top level holds 2^47 samples
+
+
+/**
+ * @brief Constructor
+ * @param Capacity number of buckets kept per level
+*/
+
+gecoPyramid::gecoPyramid(size_t Capacity) :
+  capacity(Capacity),
+  xPrev(0),
+  monotonic(true)
+{
+}
+
+
+/**
+ * @brief Sets the number of buckets kept per level and deletes all samples
+*/
+
+void gecoPyramid::setCapacity(size_t Capacity)
+{
+  capacity=Capacity;
+  clear();
+}
+
+
+/**
+ * @brief Deletes all samples
+*/
+
+void gecoPyramid::clear()
+{
+  levels.clear();
+  count.clear();
+  partial.clear();
+  children.clear();
+  monotonic=true;
+}
+
+
+/**
+ * @brief Merges bucket b, following bucket a, into a
+*/
+
+void gecoPyramid::merge(gecoPyramidBucket& a, const gecoPyramidBucket& b)
+{
+  a.xLast=b.xLast;
+  if (b.yMin<a.yMin)
+    {
+      a.yMin=b.yMin;
+      a.xMin=b.xMin;
+    }
+  if (b.yMax>a.yMax)
+    {
+      a.yMax=b.yMax;
+      a.xMax=b.xMax;
+    }
+  a.sum+=b.sum;
+  a.n+=b.n;
+}
+
+
+/**
+ * @brief Adds a sample
+ * @param x abscissa
+ * @param y ordinate
+ *
+ * Samples with a coordinate not a number are ignored. A sample with a smaller
+ * x than the previous one makes the pyramid not monotonic (see select).
+*/
+
+void gecoPyramid::add(double x, double y)
+{
+  if ((std::isnan(x))||(std::isnan(y))) return;
+  if ((getSamples()>0)&&(x<xPrev)) monotonic=false;
+  xPrev=x;
+  gecoPyramidBucket b={x, x, x, y, x, y, y, 1};
+  push(0, b);
+}
+
+
+/**
+ * @brief Stores a complete bucket in a level and merges it into the level above
+*/
+
+void gecoPyramid::push(int level, const gecoPyramidBucket& b)
+{
+  if ((int)levels.size()<=level)
+    {
+      levels.push_back(vector<gecoPyramidBucket>());
+      count.push_back(0);
+      partial.push_back(b);
+      children.push_back(0);
+    }
+
+  // ring of the level
+  vector<gecoPyramidBucket>& ring=levels[level];
+  if (ring.size()<capacity)
+    ring.push_back(b);
+  else
+    ring[count[level] % capacity]=b;
+  count[level]++;
+
+  if (level+1>=PyramidMaxLevels) return;
+  if ((int)levels.size()<=level+1)
+    {
+      levels.push_back(vector<gecoPyramidBucket>());
+      count.push_back(0);
+      partial.push_back(b);
+      children.push_back(0);
+    }
+  if (children[level+1]==0)
+    partial[level+1]=b;
+  else
+    merge(partial[level+1], b);
+  if (++children[level+1]==2)
+    {
+      // copied, as push may reallocate partial
+      gecoPyramidBucket full=partial[level+1];
+      children[level+1]=0;
+      push(level+1, full);
+    }
+}
+
+
+/**
+ * @brief Returns the first bucket of a level kept in the ring with xLast >= x
+ * (last true) or with xFirst > x (last false)
+*/
+
+long long gecoPyramid::lowerBound(int level, double x, bool last)
+{
+  long long lo=(count[level]>(long long)capacity) ? count[level]-capacity : 0;
+  long long hi=count[level];
+  while (lo<hi)
+    {
+      long long mid=lo+(hi-lo)/2;
+      const gecoPyramidBucket& b=getBucket(level, mid);
+      if ((last) ? (b.xLast<x) : (b.xFirst<=x))
+	lo=mid+1;
+      else
+	hi=mid;
+    }
+  return lo;
+}
+
+
+/**
+ * @brief Selects the finest level holding a range in at most maxBuckets buckets
+ * @param xMin start of the range
+ * @param xMax end of the range
+ * @param maxBuckets largest number of buckets
+ * @param b0 set to the first bucket of the range
+ * @param b1 set to the bucket following the last bucket of the range
+ * \return the level selected (-1 if there are no samples)
+ *
+ * A level holds the range if its ring was not overwritten since xMin. If no level
+ * holds the range in at most maxBuckets buckets, the top level is returned.
+ *
+ * If the pyramid is not monotonic, the range is ignored and the buckets of the
+ * finest level holding all the samples in at most maxBuckets buckets are returned.
+*/
+
+int gecoPyramid::select(double xMin, double xMax, long long maxBuckets, long long& b0, long long& b1)
+{
+  b0=b1=0;
+  for (int k=0; k<(int)levels.size(); k++)
+    {
+      long long first=(count[k]>(long long)capacity) ? count[k]-capacity : 0;
+      if (!monotonic)
+	{
+	  b0=first;
+	  b1=count[k];
+	  if ((first==0)&&(b1-b0<=maxBuckets)) return k;
+	  continue;
+	}
+      b0=lowerBound(k, xMin, true);
+      b1=lowerBound(k, xMax, false);
+      if (b1<b0) b1=b0;
+      bool held=(first==0)||(getBucket(k, first).xFirst<=xMin);
+      if ((held)&&(b1-b0<=maxBuckets)) return k;
+    }
+  return (int)levels.size()-1;
+}
+
+
+/**
+ * @brief Summarizes the samples not yet in a complete bucket of a level
+ * @param level the level
+ * @param xMin start of the range
+ * @param xMax end of the range
+ * @param tail set to the summary of the samples
+ * \return false if there are no such samples in the range
+ *
+ * If the pyramid is not monotonic, the range is ignored.
+*/
+
+bool gecoPyramid::getTail(int level, double xMin, double xMax, gecoPyramidBucket& tail)
+{
+  bool found=false;
+  for (int j=level; j>=1; j--)
+    if ((j<(int)levels.size())&&(children[j]>0))
+      {
+	if (!found)
+	  tail=partial[j];
+	else
+	  merge(tail, partial[j]);
+	found=true;
+      }
+  if (!monotonic) return found;
+  return (found)&&(tail.xFirst<=xMax)&&(tail.xLast>=xMin);
+}
+
+
+/**
+ * @brief Returns the summary of a range as a list of {x min max mean} (refcount 0)
+ * @param xMin start of the range
+ * @param xMax end of the range
+ * @param maxBuckets largest number of buckets returned (plus the tail)
+ *
+ * x is the middle of the samples summarized by a bucket (the mean of the x of its
+ * first and last samples). If the pyramid is not monotonic, the range is ignored.
+*/
+
+Tcl_Obj* gecoPyramid::query(double xMin, double xMax, long long maxBuckets)
+{
+  Tcl_Obj*  list=Tcl_NewListObj(0, NULL);
+  long long b0, b1;
+  int       level=select(xMin, xMax, maxBuckets, b0, b1);
+  if (level<0) return list;
+
+  gecoPyramidBucket tail;
+  bool hasTail=getTail(level, xMin, xMax, tail);
+  for (long long b=b0; b<b1+hasTail; b++)
+    {
+      const gecoPyramidBucket& p=(b<b1) ? getBucket(level, b) : tail;
+      Tcl_Obj* elem[4];
+      elem[0]=Tcl_NewDoubleObj((p.xFirst+p.xLast)/2);
+      elem[1]=Tcl_NewDoubleObj(p.yMin);
+      elem[2]=Tcl_NewDoubleObj(p.yMax);
+      elem[3]=Tcl_NewDoubleObj(p.sum/p.n);
+      Tcl_ListObjAppendElement(NULL, list, Tcl_NewListObj(4, elem));
+    }
+  return list;
+}
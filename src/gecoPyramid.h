@@ -0,0 +1,127 @@
+// This may look like C code, but it is really -*- C++ -*-
+// ----------------------------------------------------------------
+//
+// Header file for class gecoPyramid
+//
+// (c) Rolf Wuthrich
+//     2026 Concordia University
+//
+// author:  agent
+// email:   agent@local
+// version: v1
+//
+// This software is copyright under the BSD license
+//
+// ---------------------------------------------------------------
+// history:
+// ---------------------------------------------------------------
+// Date       Modification                     Author
+// ---------------------------------------------------------------
+// 17.10.2026 Creation                         agent
+// 18.10.2026 Decreasing x                     agent
+//
+// ---------------------------------------------------------------
+/*! \file */
+
+#ifndef gecoPyramid_SEEN_
+#define gecoPyramid_SEEN_
+
+#include <tcl8.6/tcl.h>
+#include <vector>
+
+using namespace std;
+
+
+// ------------------------------------------------------------------------
+//
+// Summary of consecutive samples
+//
+
+struct gecoPyramidBucket
+{
+  double             xFirst;       // x of the first sample
+  double             xLast;        // x of the last sample
+  double             xMin;         // x of the sample with the smallest y
+  double             yMin;         // smallest y
+  double             xMax;         // x of the sample with the largest y
+  double             yMax;         // largest y
+  double             sum;          // sum of y
+  long long          n;            // number of samples
+};
+
+
+// -----------------------------------------------------------------------
+//
+// class gecoPyramid : min/max/mean pyramid of a plotted trace
+//
+
+/**
+ * @brief Multi-resolution min/max/mean summary of a plotted trace
+ * \author agent
+ * \date 2026
+ *
+ * A gecoPyramid summarizes the samples (x,y) it is fed with, usually in increasing x,
+ * at several resolutions: a bucket of level k summarizes 2^k consecutive samples
+ * by the smallest and largest y (and where they occurred) and the mean of y.
+ * Level 0 holds the samples themselves. Each level keeps its latest 'capacity'
+ * buckets in a ring, so that the memory is bounded while the coarser levels
+ * cover the whole run:
+ *
+ *     gecoPyramid p(capacity);
+ *     p.add(x, y);                                   // for each sample
+ *     int level=p.select(xMin, xMax, maxBuckets, b0, b1);
+ *     for (long long b=b0; b<b1; b++) ... p.getBucket(level, b)
+ *     if (p.getTail(level, xMin, xMax, tail)) ...    // samples not yet in a bucket
+ *
+ * gecoPyramid::select returns the finest level holding the range in at most
+ * maxBuckets buckets, so that a plot of any time span has a bounded number of
+ * points. Drawing the smallest and largest y of each bucket preserves the spikes.
+ * The samples not yet summarized in a complete bucket of the level are returned
+ * by gecoPyramid::getTail.
+ *
+ * Once a sample has a smaller x than the previous one (as an XY plot, like an
+ * I-V curve), the buckets no longer cover ranges of x and can't be searched by x:
+ * gecoPyramid::select then ignores the range and returns the finest level holding
+ * all the samples kept in at most maxBuckets buckets, that is the samples decimated
+ * in the order they were added, and gecoPyramid::getTail returns the tail whatever
+ * its x. gecoPyramid::isMonotonic tells which case applies, until the pyramid is
+ * cleared.
+ *
+ * Used by gecoGraph.
+ */
+
+class gecoPyramid
+{
+
+private:
+
+  size_t                            capacity;  // buckets kept per level
+  vector< vector<gecoPyramidBucket> > levels;  // ring of buckets of each level
+  vector<long long>                 count;     // complete buckets of each level
+  vector<gecoPyramidBucket>         partial;   // bucket being filled at each level
+  vector<int>                       children;  // buckets of the level below in partial
+  double                            xPrev;     // x of the previous sample
+  bool                              monotonic; // x never decreased
+
+  void         push(int level, const gecoPyramidBucket& b);
+  long long    lowerBound(int level, double x, bool last);
+
+public:
+
+  gecoPyramid(size_t Capacity = 4096);
+
+  void         setCapacity(size_t Capacity);
+  void         clear();
+  void         add(double x, double y);
+  long long    getSamples()   {return (count.empty()) ? 0 : count[0];} /*!< Returns the number of samples added */
+  bool         isMonotonic()  {return monotonic;}                      /*!< Returns true if x never decreased */
+  int          getLevels()    {return levels.size();}                  /*!< Returns the number of levels */
+  int          select(double xMin, double xMax, long long maxBuckets, long long& b0, long long& b1);
+  const gecoPyramidBucket& getBucket(int level, long long b) {return levels[level][b % capacity];} /*!< Returns bucket b of a level */
+  bool         getTail(int level, double xMin, double xMax, gecoPyramidBucket& tail);
+  Tcl_Obj*     query(double xMin, double xMax, long long maxBuckets);
+
+  static void  merge(gecoPyramidBucket& a, const gecoPyramidBucket& b);
+};
+
+#endif /* gecoPyramid_SEEN_ */
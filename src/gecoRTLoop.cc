@@ -0,0 +1,463 @@
+// ---------------------------------------------------------------
+//
+// Definition of the class gecoRTLoop
+//
+// (c) Rolf Wuthrich
+//     2026 Concordia University
+//
+// author:  agent
+// email:   agent@local
+// version: v1
+//
+// This software is copyright under the BSD license
+//
+// ---------------------------------------------------------------
+// history:
+// ---------------------------------------------------------------
+// Date       Modification                     Author
+// ---------------------------------------------------------------
+// 17.10.2026 Creation                         agent
+//
+// ---------------------------------------------------------------
+
+#include <tcl.h>
+#include <cstring>
+#include <cerrno>
+#include <time.h>
+#include <sched.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include "gecoRTLoop.h"
+#include "gecoProcess.h"
+#include "gecoApp.h"
+
+using namespace std;
+
+
+// ---------------------------------------------------------------
+//
+// Auxiliary functions
+//
+
+static long long monotonicTime()
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (long long)ts.tv_sec*1000000000LL + ts.tv_nsec;
+}
+
+
+/**
+ * @brief Entry point of the real-time thread
+ * @param clientData a pointer to the instance of gecoRTLoop
+ */
+
+void* geco_RTThread(void* clientData)
+{
+  gecoRTLoop* rt = (gecoRTLoop *)clientData;
+  rt->run();
+  return NULL;
+}
+
+
+// ---------------------------------------------------------------
+//
+// class gecoRTLoop : real-time thread for the geco process loop
+//
+
+
+/**
+ * @brief Constructor
+ * @param App gecoApp in which the gecoRTLoop lives
+ *
+ * The constructor will create the Tcl command 'rtloop' via the call
+ * of the constructor of gecoObj. It further defines additional
+ * subcommands. The real-time thread is not started.
+*/
+
+gecoRTLoop::gecoRTLoop(gecoApp* App) :
+  gecoObj("Real-time loop", "rtloop", App, false),
+  running(false),
+  stopRequest(false),
+  procSet(NULL),
+  cycleSeq(0),
+  holds(0),
+  memoryLocked(false),
+  period(1000),
+  cpu(-1),
+  priority(0),
+  lockMemory(false)
+{
+  resetStat();
+
+  addOption("-period", &period, "returns/sets period (us) of the real-time thread");
+  addOption("-cpu", &cpu, "returns/sets CPU to which the thread is pinned (-1 = none)");
+  addOption("-priority", &priority, "returns/sets SCHED_FIFO priority (0 = SCHED_OTHER)");
+  addOption("-lockMemory", &lockMemory, "turns on/off locking of memory with mlockall");
+  addOption("-start", "starts the real-time thread");
+  addOption("-stop", "stops the real-time thread");
+  addOption("-running", "returns 1 if the real-time thread is running");
+  addOption("-stat", "returns statistics of the real-time thread");
+}
+
+
+/**
+ * @brief Destructor
+ *
+ * Stops the real-time thread if running.
+*/
+
+gecoRTLoop::~gecoRTLoop()
+{
+  stop();
+  deleteSet(procSet.exchange(NULL));
+}
+
+
+/*!
+ * @copydoc gecoObj::cmd
+ *
+ * Compared to gecoObj::cmd, gecoRTLoop::cmd adds the processing of
+ * the new subcommands of gecoRTLoop.
+ */
+
+int gecoRTLoop::cmd(int &i, int objc,Tcl_Obj *const objv[])
+{
+  // first executes the command options defined in gecoObj
+  int j=i;
+  int  oldPeriod=period;
+  int  oldCpu=cpu;
+  int  oldPriority=priority;
+  bool oldLockMemory=lockMemory;
+  int index=gecoObj::cmd(i,objc,objv);
+
+  // thread parameters can only be changed while the thread is stopped
+  if (((index==getOptionIndex("-period"))||(index==getOptionIndex("-cpu"))||
+       (index==getOptionIndex("-priority"))||(index==getOptionIndex("-lockMemory")))
+      &&(i==j+2))
+    {
+      const char* err=NULL;
+      if (isRunning())
+	err="can't change parameters while the real-time thread is running";
+      else if (period<1)
+	err="period must be a positive integer";
+      else if ((cpu<-1)||(cpu>=CPU_SETSIZE))
+	err="invalid CPU number";
+      else if ((priority<0)||(priority>sched_get_priority_max(SCHED_FIFO)))
+	err="invalid SCHED_FIFO priority";
+      if (err)
+	{
+	  Tcl_AppendResult(interp, err, NULL);
+	  period=oldPeriod;
+	  cpu=oldCpu;
+	  priority=oldPriority;
+	  lockMemory=oldLockMemory;
+	  return -1;
+	}
+    }
+
+  if (index==getOptionIndex("-start"))
+    {
+      if (start()==TCL_ERROR) return -1;
+      i++;
+    }
+
+  if (index==getOptionIndex("-stop"))
+    {
+      stop();
+      i++;
+    }
+
+  if (index==getOptionIndex("-running"))
+    {
+      Tcl_ResetResult(interp);
+      Tcl_AppendResult(interp, (isRunning()) ? "1" : "0", NULL);
+      i++;
+    }
+
+  if (index==getOptionIndex("-stat"))
+    {
+      char str[200];
+      long long n=cycles.load();
+      double meanLatency = (n>0) ? sumLatency.load()/1000.0/n : 0.0;
+      snprintf(str, 200, "cycles      = %lld\noverruns    = %lld\n"
+	       "<latency>   = %.1f us\nlatency max = %.1f us\nexec max    = %.1f us",
+	       n, overruns.load(), meanLatency,
+	       maxLatency.load()/1000.0, maxExec.load()/1000.0);
+      Tcl_ResetResult(interp);
+      Tcl_AppendResult(interp, str, NULL);
+      i++;
+    }
+
+  return index;
+}
+
+
+/*!
+ * @copydoc gecoObj::info
+ */
+
+Tcl_DString* gecoRTLoop::info(const char* frontStr)
+{
+  gecoObj::info(frontStr);
+  addInfo(frontStr, "Running:\t", (isRunning()) ? "yes" : "no");
+  addInfo(frontStr, "Period (us):\t", period);
+  addInfo(frontStr, "CPU:\t\t", cpu);
+  addInfo(frontStr, "Priority:\t", priority);
+  addInfo(frontStr, "Lock memory:\t", (lockMemory) ? "on" : "off");
+  return infoStr;
+}
+
+
+/**
+ * @brief Starts the real-time thread
+ * \return TCL_OK in case of success and TCL_ERROR otherwise
+ *
+ * In case of error, an error message is left in the Tcl interpreter
+ * run by the gecoApp in which the gecoRTLoop lives.
+ */
+
+int gecoRTLoop::start()
+{
+  if (isRunning())
+    {
+      Tcl_AppendResult(interp, "real-time thread is already running", NULL);
+      return TCL_ERROR;
+    }
+
+  if (lockMemory)
+    {
+      if (mlockall(MCL_CURRENT | MCL_FUTURE)!=0)
+	{
+	  Tcl_AppendResult(interp, "can't lock memory: ", strerror(errno), NULL);
+	  return TCL_ERROR;
+	}
+      memoryLocked = true;
+    }
+
+  pthread_attr_t attr;
+  pthread_attr_init(&attr);
+  if (priority>0)
+    {
+      struct sched_param param;
+      param.sched_priority = priority;
+      pthread_attr_setinheritsched(&attr, PTHREAD_EXPLICIT_SCHED);
+      pthread_attr_setschedpolicy(&attr, SCHED_FIFO);
+      pthread_attr_setschedparam(&attr, &param);
+    }
+  if (cpu>=0)
+    {
+      cpu_set_t cpus;
+      CPU_ZERO(&cpus);
+      CPU_SET(cpu, &cpus);
+      pthread_attr_setaffinity_np(&attr, sizeof(cpu_set_t), &cpus);
+    }
+
+  publish();
+  sync();
+  resetStat();
+  stopRequest.store(false);
+  int ret = pthread_create(&thread, &attr, geco_RTThread, this);
+  pthread_attr_destroy(&attr);
+
+  if (ret!=0)
+    {
+      if (memoryLocked) munlockall();
+      memoryLocked = false;
+      Tcl_AppendResult(interp, "can't start real-time thread: ", strerror(ret), NULL);
+      if (ret==EPERM)
+	Tcl_AppendResult(interp, " (SCHED_FIFO requires CAP_SYS_NICE)", NULL);
+      return TCL_ERROR;
+    }
+
+  running.store(true);
+  return TCL_OK;
+}
+
+
+/**
+ * @brief Stops the real-time thread
+ *
+ * Returns once the real-time thread has finished its current cycle.
+ */
+
+void gecoRTLoop::stop()
+{
+  if (!isRunning()) return;
+  stopRequest.store(true);
+  pthread_join(thread, NULL);
+  running.store(false);
+  if (memoryLocked) munlockall();
+  memoryLocked = false;
+}
+
+
+/**
+ * @brief Publishes the set of gecoProcess to be run by the real-time thread
+ *
+ * Must be called by the interpreter thread whenever the geco process loop
+ * or the '-realtime' mode of a gecoProcess changes. The previous set is
+ * deleted once the real-time thread no longer uses it.
+ */
+
+void gecoRTLoop::publish()
+{
+  gecoRTSet* old = procSet.exchange(buildSet());
+  quiesce();
+  deleteSet(old);
+}
+
+
+/**
+ * @brief Forwards the status of the gecoProcess to the real-time thread
+ *
+ * Called by geco_eventLoop() after each run of the geco process loop.
+ */
+
+void gecoRTLoop::sync()
+{
+  gecoRTSet* set = procSet.load();
+  if (set==NULL) return;
+  for (int k=0; k<set->n; k++)
+    set->entry[k].active.store(set->entry[k].proc->getStatus()==Active);
+}
+
+
+/**
+ * @brief Waits until the real-time thread has left its current cycle
+ *
+ * After return, the real-time thread no longer uses any gecoRTSet or
+ * gecoProcess which was unpublished before the call.
+ */
+
+void gecoRTLoop::quiesce()
+{
+  if (!isRunning()) return;
+  unsigned long seq = cycleSeq.load();
+  if ((seq & 1)==0) return;
+  struct timespec ts = {0, 10000};
+  while (cycleSeq.load()==seq) nanosleep(&ts, NULL);
+}
+
+
+/**
+ * @brief Stops the real-time thread from running the gecoProcess
+ *
+ * After return, the real-time thread skips its cycles until
+ * gecoRTLoop::release is called. Calls can be nested.
+ */
+
+void gecoRTLoop::hold()
+{
+  holds.fetch_add(1);
+  quiesce();
+}
+
+
+/**
+ * @brief Lets the real-time thread run the gecoProcess again
+ */
+
+void gecoRTLoop::release()
+{
+  holds.fetch_sub(1);
+}
+
+
+/**
+ * @brief Builds the set of gecoProcess in '-realtime' mode from the geco process loop
+ */
+
+gecoRTSet* gecoRTLoop::buildSet()
+{
+  gecoRTSet* set = new gecoRTSet;
+  set->n = 0;
+
+  for (int i=0; i<app->getNbrGecoProcesses(); i++)
+    if (app->getGecoProcess(i)->getRealtime()) set->n++;
+
+  set->entry = new gecoRTEntry[set->n];
+  int k = 0;
+  for (int i=0; i<app->getNbrGecoProcesses(); i++)
+    {
+      gecoProcess* p = app->getGecoProcess(i);
+      if (p->getRealtime())
+	{
+	  set->entry[k].proc = p;
+	  set->entry[k].active.store(p->getStatus()==Active);
+	  k++;
+	}
+    }
+
+  return set;
+}
+
+
+void gecoRTLoop::deleteSet(gecoRTSet* set)
+{
+  if (set==NULL) return;
+  delete[] set->entry;
+  delete set;
+}
+
+
+void gecoRTLoop::resetStat()
+{
+  cycles.store(0);
+  overruns.store(0);
+  maxLatency.store(0);
+  sumLatency.store(0);
+  maxExec.store(0);
+}
+
+
+/**
+ * @brief Body of the real-time thread
+ *
+ * Runs the active gecoProcess of the published gecoRTSet at absolute
+ * CLOCK_MONOTONIC deadlines spaced by period. Missed deadlines are
+ * counted as overruns and skipped. Never calls the Tcl C API.
+ */
+
+void gecoRTLoop::run()
+{
+  long long p = 1000LL*period;
+  long long t0 = monotonicTime();
+  long long deadline = t0;
+  struct timespec ts;
+
+  while (!stopRequest.load())
+    {
+      deadline += p;
+      ts.tv_sec  = deadline/1000000000LL;
+      ts.tv_nsec = deadline%1000000000LL;
+      while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL)==EINTR);
+
+      long long now = monotonicTime();
+      long long latency = now - deadline;
+      sumLatency.store(sumLatency.load() + latency);
+      if (latency>maxLatency.load()) maxLatency.store(latency);
+
+      // runs the active gecoProcess of the published set
+      // holds is checked inside the cycle, so that quiesce waits for it
+      cycleSeq.fetch_add(1);
+      gecoRTSet* set = (holds.load()==0) ? procSet.load() : NULL;
+      if (set!=NULL)
+	for (int k=0; k<set->n; k++)
+	  if (set->entry[k].active.load())
+	    set->entry[k].proc->handleRTEvent((now-t0)/1e9);
+      cycleSeq.fetch_add(1);
+
+      long long end = monotonicTime();
+      if (end-now>maxExec.load()) maxExec.store(end-now);
+      cycles.store(cycles.load()+1);
+
+      // skips missed deadlines
+      if (end>deadline+p)
+	{
+	  long long missed = (end-deadline)/p;
+	  overruns.store(overruns.load()+missed);
+	  deadline += missed*p;
+	}
+    }
+}
@@ -0,0 +1,203 @@
+// This may look like C code, but it is really -*- C++ -*-
+// ----------------------------------------------------------------
+//
+// Header file for class gecoRTLoop
+//
+// (c) Rolf Wuthrich
+//     2026 Concordia University
+//
+// author:  agent
+// email:   agent@local
+// version: v1
+//
+// This software is copyright under the BSD license
+//
+// ---------------------------------------------------------------
+// history:
+// ---------------------------------------------------------------
+// Date       Modification                     Author
+// ---------------------------------------------------------------
+// 17.10.2026 Creation                         agent
+//
+// ---------------------------------------------------------------
+/*! \file */
+
+#ifndef gecoRTLoop_SEEN_
+#define gecoRTLoop_SEEN_
+
+#include <tcl8.6/tcl.h>
+#include <pthread.h>
+#include <atomic>
+#include "gecoObj.h"
+
+using namespace std;
+
+class gecoProcess;            // forward definition
+
+
+// -----------------------------------------------------------------------
+//
+// Set of gecoProcess run by the real-time thread
+//
+
+/**
+ * @brief Entry of the set of gecoProcess run by the real-time thread
+ */
+
+struct gecoRTEntry
+{
+  gecoProcess*  proc;           /*!< gecoProcess run by the real-time thread */
+  atomic<bool>  active;         /*!< true if proc is in the Active status */
+};
+
+/**
+ * @brief Set of gecoProcess run by the real-time thread
+ *
+ * A gecoRTSet is built by the interpreter thread and published to the
+ * real-time thread with gecoRTLoop::publish. Once published, it is
+ * never modified apart from the active flags of its entries.
+ */
+
+struct gecoRTSet
+{
+  int           n;              /*!< number of entries */
+  gecoRTEntry*  entry;          /*!< entries in the order of the geco process loop */
+};
+
+
+// -----------------------------------------------------------------------
+//
+// class gecoRTLoop : real-time thread for the geco process loop
+//
+
+/**
+ * @brief Real-time thread running the timing-critical part of the geco process loop
+ * \author agent
+ * \date 2026
+ *
+ * The gecoRTLoop class runs a dedicated POSIX thread which executes, at absolute
+ * CLOCK_MONOTONIC deadlines, the gecoProcess of the geco process loop which were
+ * moved to the real-time thread with their '-realtime' subcommand. The thread can
+ * be pinned to a CPU, run under the SCHED_FIFO policy and the memory of the
+ * gecoApp can be locked with mlockall.
+ *
+ * The gecoRTLoop is created by the gecoApp during its construction. The Tcl
+ * command 'rtloop' allows to manipulate it.
+ *
+ * Division of work
+ * ----------------
+ * The Tcl interpreter is not thread safe. The real-time thread therefore never
+ * calls the Tcl C API. Only gecoProcess for which gecoProcess::realtimeCapable
+ * returns true (e.g. a gecoIO whose linked gecoIOModule are all real-time safe)
+ * can be moved to the real-time thread. There, gecoProcess::handleRTEvent is
+ * called once per period.
+ *
+ * The interpreter thread keeps running geco_eventLoop(). It handles the control
+ * commands, the life cycle of all gecoProcess (activation, termination, hold...)
+ * and all other gecoProcess like gecoGraph, gecoFileStream or gecoTrigger.
+ * A gecoProcess running on the real-time thread skips its IO operations in
+ * gecoProcess::handleEvent.
+ *
+ * Lock-free handoff
+ * -----------------
+ * The two threads never take a lock:
+ *  * the set of gecoProcess to run is published by the interpreter thread as
+ *    a gecoRTSet through an atomic pointer (gecoRTLoop::publish)
+ *  * the status of each gecoProcess is forwarded at each run of geco_eventLoop()
+ *    through an atomic flag (gecoRTLoop::sync)
+ *  * values are exchanged through the aligned scalar variables linked to Tcl
+ *    variables (Tcl_LinkVar) by the gecoIOModule
+ *  * statistics of the real-time thread are atomic counters
+ *
+ * Before a gecoRTSet or a gecoProcess is deleted, the interpreter thread waits
+ * with gecoRTLoop::quiesce that the real-time thread has left the cycle in
+ * which it might still use it.
+ *
+ * Lists walked by the real-time thread which are changed in place (the
+ * gecoIOModule linked to gecoIO and their IO instructions) are changed between
+ * gecoRTLoop::hold and gecoRTLoop::release: the real-time thread skips its
+ * cycles until released, so it never walks a list being changed.
+ *
+ * Associated Tcl command
+ * ----------------------
+ * The gecoRTLoop class extends the subcommands from gecoObj by the following subcommands
+ *
+ * Sub-command       | Short description
+ * ----------------- | ------------------
+ * -period           | returns/sets period (us) of the real-time thread
+ * -cpu              | returns/sets CPU to which the thread is pinned (-1 = none)
+ * -priority         | returns/sets SCHED_FIFO priority (0 = SCHED_OTHER)
+ * -lockMemory       | turns on/off locking of memory with mlockall
+ * -start            | starts the real-time thread
+ * -stop             | stops the real-time thread
+ * -running          | returns 1 if the real-time thread is running
+ * -stat             | returns statistics of the real-time thread
+ *
+ * Example
+ * -------
+ * \code
+ * rtloop -period 500 -cpu 3 -priority 80 -lockMemory on
+ * io -realtime on -linkModule comedi0
+ * rtloop -start
+ * \endcode
+ *
+ * The '-period', '-cpu', '-priority' and '-lockMemory' subcommands can only be
+ * changed while the real-time thread is stopped.
+ */
+
+class gecoRTLoop : public gecoObj
+{
+
+  friend void* geco_RTThread(void* clientData);
+
+private:
+
+  pthread_t             thread;
+  atomic<bool>          running;        // real-time thread is running
+  atomic<bool>          stopRequest;    // asks the real-time thread to stop
+  atomic<gecoRTSet*>    procSet;        // set of gecoProcess run by the thread
+  atomic<unsigned long> cycleSeq;       // odd while the thread is inside a cycle
+  atomic<int>           holds;          // the thread skips its cycles while not 0
+  bool                  memoryLocked;
+
+  // statistics of the real-time thread
+  atomic<long long>     cycles;         // number of cycles
+  atomic<long long>     overruns;       // number of missed deadlines
+  atomic<long long>     maxLatency;     // max wake-up latency (ns)
+  atomic<long long>     sumLatency;     // sum of wake-up latencies (ns)
+  atomic<long long>     maxExec;        // max execution time of a cycle (ns)
+
+  void         run();
+  gecoRTSet*   buildSet();
+  void         deleteSet(gecoRTSet* set);
+  void         resetStat();
+
+protected:
+
+  int          period;                  /*!< period (us) of the real-time thread */
+  int          cpu;                     /*!< CPU to which the thread is pinned (-1 = none) */
+  int          priority;                /*!< SCHED_FIFO priority (0 = SCHED_OTHER) */
+  bool         lockMemory;              /*!< locks memory with mlockall if true */
+
+public:
+
+  gecoRTLoop(gecoApp* App);
+  ~gecoRTLoop();
+
+  virtual int  cmd(int &i, int objc, Tcl_Obj *const objv[]);
+  virtual Tcl_DString* info(const char* frontStr = "");
+
+  int          start();
+  void         stop();
+  bool         isRunning() {return running.load();}    /*!< Returns true if the real-time thread runs */
+
+  void         publish();
+  void         sync();
+  void         quiesce();
+  void         hold();
+  void         release();
+
+  int          getPeriod() {return period;}            /*!< Returns the period (us) of the real-time thread */
+};
+
+#endif /* gecoRTLoop_SEEN_ */
@@ -0,0 +1,496 @@
+// ---------------------------------------------------------------
+//
+// Definition of the class gecoRecordArena
+//
+// (c) Rolf Wuthrich
+//     2026 Concordia University
+//
+// author:  agent
+// email:   agent@local
+// version: v1
+//
+// This software is copyright under the BSD license
+//
+// ---------------------------------------------------------------
+// history:
+// ---------------------------------------------------------------
+// Date       Modification                     Author
+// ---------------------------------------------------------------
+// 17.10.2026 Creation                         agent
+// 17.10.2026 Added copy-on-write snapshots    agent
+// 17.10.2026 Added seek by time               agent
+//
+// ---------------------------------------------------------------
+
+#include <cstring>
+#include <stdint.h>
+#include "gecoRecordArena.h"
+
+using namespace std;
+
+
+// ---------------------------------------------------------------
+//
+// Storage modes
+//
+
+const char* ArenaModeStr[] = {"grow", "ring", NULL};
+
+// Layout of a record within a chunk:
+//   double t | uint32 len | padding | len bytes | padding to 8 bytes
+
+static const size_t RecHeader    = 16;
+static const size_t MinChunkSize = 4096;
+static const size_t MaxChunkSize = 65536;
+
+static inline size_t recordSize(size_t len)
+{
+  return (RecHeader+len+7) & ~(size_t)7;
+}
+
+
+// ---------------------------------------------------------------
+//
+// Auxiliary functions
+//
+
+static gecoArenaChunk* newChunk(size_t size)
+{
+  gecoArenaChunk* c=new gecoArenaChunk;
+  c->data=new char[size];
+  c->refs.store(1);
+  return c;
+}
+
+static void unrefChunk(gecoArenaChunk* c)
+{
+  if (c->refs.fetch_sub(1)==1)
+    {
+      delete[] c->data;
+      delete c;
+    }
+}
+
+static const char* readRecord(const char* p, double& t, size_t& len)
+{
+  uint32_t l;
+  memcpy(&t, p, sizeof(double));
+  memcpy(&l, p+sizeof(double), sizeof(uint32_t));
+  len=l;
+  return p+RecHeader;
+}
+
+
+// ---------------------------------------------------------------
+//
+// class gecoArenaSnapshot : frozen view of the records of a gecoRecordArena
+//
+
+
+/**
+ * @brief Destructor
+ *
+ * Releases the shared chunks. Can be called by any thread.
+*/
+
+gecoArenaSnapshot::~gecoArenaSnapshot()
+{
+  for (size_t k=0; k<chunks.size(); k++) unrefChunk(chunks[k]);
+}
+
+
+/**
+ * @brief Places a cursor on the oldest record
+ * @param c the cursor
+*/
+
+void gecoArenaSnapshot::first(gecoArenaCursor& c)
+{
+  c.chunk=0;
+  c.pos=(chunks.empty()) ? 0 : begin[0];
+}
+
+
+/**
+ * @brief Reads the record at a cursor and advances the cursor
+ * @param c the cursor
+ * @param t time of the record
+ * @param data content of the record (valid as long as the snapshot exists)
+ * @param len length of data
+ * \return false if there are no more records
+*/
+
+bool gecoArenaSnapshot::next(gecoArenaCursor& c, double& t, const char*& data, size_t& len)
+{
+  while (c.chunk<chunks.size())
+    {
+      if (c.pos>=end[c.chunk])
+	{
+	  c.chunk++;
+	  if (c.chunk<chunks.size()) c.pos=begin[c.chunk];
+	  continue;
+	}
+      data=readRecord(chunks[c.chunk]->data+c.pos, t, len);
+      c.pos+=recordSize(len);
+      return true;
+    }
+  return false;
+}
+
+
+// ---------------------------------------------------------------
+//
+// class gecoRecordArena : chunked storage of time stamped records
+//
+
+
+/**
+ * @brief Constructor
+ *
+ * The arena holds no memory until gecoRecordArena::setup is called.
+*/
+
+gecoRecordArena::gecoRecordArena() :
+  firstChunk(0),
+  nbrChunks(0),
+  firstPos(0),
+  chunkSize(MinChunkSize),
+  capacity(0),
+  mode(Arena_grow),
+  records(0),
+  overwritten(0),
+  dropped(0)
+{
+}
+
+
+/**
+ * @brief Destructor
+*/
+
+gecoRecordArena::~gecoRecordArena()
+{
+  freePool();
+}
+
+
+/**
+ * @brief Frees all chunks
+*/
+
+void gecoRecordArena::freePool()
+{
+  for (size_t k=0; k<pool.size(); k++) unrefChunk(pool[k]);
+  pool.clear();
+  fill.clear();
+}
+
+
+/**
+ * @brief Preallocates the chunks and deletes all records
+ * @param Capacity memory to preallocate (bytes)
+ * @param Mode Arena_grow or Arena_ring
+ *
+ * The capacity is split in chunks of 4 to 64 kB. A record must fit
+ * in a chunk.
+*/
+
+void gecoRecordArena::setup(size_t Capacity, int Mode)
+{
+  freePool();
+  capacity=Capacity;
+  mode=Mode;
+
+  chunkSize=(capacity/16) & ~(size_t)7;
+  if (chunkSize<MinChunkSize) chunkSize=MinChunkSize;
+  if (chunkSize>MaxChunkSize) chunkSize=MaxChunkSize;
+  size_t n=capacity/chunkSize;
+  if (n<1) n=1;
+
+  pool.resize(n);
+  fill.assign(n, 0);
+  for (size_t k=0; k<n; k++) pool[k]=newChunk(chunkSize);
+  clear();
+}
+
+
+/**
+ * @brief Deletes all records
+ *
+ * Chunks allocated beyond the capacity in grow mode are freed.
+*/
+
+void gecoRecordArena::clear()
+{
+  size_t n=capacity/chunkSize;
+  if (n<1) n=1;
+  while (pool.size()>n)
+    {
+      unrefChunk(pool.back());
+      pool.pop_back();
+      fill.pop_back();
+    }
+  fill.assign(pool.size(), 0);
+  firstChunk=0;
+  nbrChunks=0;
+  firstPos=0;
+  records=0;
+  overwritten=0;
+  dropped=0;
+}
+
+
+/**
+ * @brief Appends a record
+ * @param t time of the record
+ * @param data content of the record
+ * @param len length of data
+ * \return true if the record was stored and false if it is larger than a chunk
+*/
+
+bool gecoRecordArena::append(double t, const char* data, size_t len)
+{
+  size_t need=recordSize(len);
+  if ((need>chunkSize)||(pool.empty()))
+    {
+      dropped++;
+      return false;
+    }
+
+  if (nbrChunks==0)
+    {
+      nbrChunks=1;
+      startChunk(0);
+      firstPos=0;
+    }
+
+  if (chunkFill(nbrChunks-1)+need>chunkSize)
+    {
+      if (nbrChunks==pool.size())
+	{
+	  if (mode==Arena_ring)
+	    releaseFirst();
+	  else
+	    {
+	      // inserts a new chunk just after the newest one
+	      pool.insert(pool.begin()+firstChunk, newChunk(chunkSize));
+	      fill.insert(fill.begin()+firstChunk, 0);
+	      firstChunk++;
+	    }
+	}
+      nbrChunks++;
+      startChunk(nbrChunks-1);
+    }
+
+  char*  p=chunk(nbrChunks-1)+chunkFill(nbrChunks-1);
+  uint32_t l=len;
+  memcpy(p, &t, sizeof(double));
+  memcpy(p+sizeof(double), &l, sizeof(uint32_t));
+  memcpy(p+RecHeader, data, len);
+  chunkFill(nbrChunks-1)+=need;
+  records++;
+  return true;
+}
+
+
+/**
+ * @brief Starts to fill a chunk from its beginning
+ * @param k the chunk (counted from the oldest one)
+ *
+ * A chunk still used by a snapshot is replaced by a new one.
+*/
+
+void gecoRecordArena::startChunk(size_t k)
+{
+  size_t idx=(firstChunk+k) % pool.size();
+  if (pool[idx]->refs.load()>1)
+    {
+      unrefChunk(pool[idx]);
+      pool[idx]=newChunk(chunkSize);
+    }
+  fill[idx]=0;
+}
+
+
+/**
+ * @brief Freezes the current records
+ * \return a gecoArenaSnapshot to be deleted by the caller
+ *
+ * No record is copied: the snapshot shares the chunks of the arena.
+*/
+
+gecoArenaSnapshot* gecoRecordArena::snapshot()
+{
+  gecoArenaSnapshot* snap=new gecoArenaSnapshot;
+  for (size_t k=0; k<nbrChunks; k++)
+    {
+      gecoArenaChunk* c=pool[(firstChunk+k) % pool.size()];
+      c->refs++;
+      snap->chunks.push_back(c);
+      snap->begin.push_back((k==0) ? firstPos : 0);
+      snap->end.push_back(chunkFill(k));
+    }
+  snap->records=records;
+  return snap;
+}
+
+
+/**
+ * @brief Releases the oldest chunk and counts its records as overwritten
+*/
+
+void gecoRecordArena::releaseFirst()
+{
+  if (nbrChunks==0) return;
+  size_t pos=firstPos;
+  while (pos<chunkFill(0))
+    {
+      uint32_t l;
+      memcpy(&l, chunk(0)+pos+sizeof(double), sizeof(uint32_t));
+      pos+=recordSize(l);
+      records--;
+      overwritten++;
+    }
+  chunkFill(0)=0;
+  firstChunk=(firstChunk+1) % pool.size();
+  nbrChunks--;
+  firstPos=0;
+}
+
+
+/**
+ * @brief Discards the records older than tMin
+ * @param tMin time of the oldest record to keep
+ *
+ * The records are assumed to be appended in increasing time.
+*/
+
+void gecoRecordArena::trim(double tMin)
+{
+  while (nbrChunks>0)
+    {
+      if (firstPos>=chunkFill(0))
+	{
+	  if (nbrChunks==1) break;
+	  releaseFirst();
+	  continue;
+	}
+      double   t;
+      uint32_t l;
+      memcpy(&t, chunk(0)+firstPos, sizeof(double));
+      if (t>=tMin) break;
+      memcpy(&l, chunk(0)+firstPos+sizeof(double), sizeof(uint32_t));
+      firstPos+=recordSize(l);
+      records--;
+      overwritten++;
+    }
+}
+
+
+/**
+ * @brief Places a cursor on the oldest record
+ * @param c the cursor
+*/
+
+void gecoRecordArena::first(gecoArenaCursor& c)
+{
+  c.chunk=0;
+  c.pos=firstPos;
+}
+
+
+/**
+ * @brief Places a cursor on the first record of a chunk
+ * @param c the cursor
+ * @param k the chunk (counted from the oldest one)
+*/
+
+void gecoRecordArena::firstOfChunk(gecoArenaCursor& c, size_t k)
+{
+  c.chunk=k;
+  c.pos=(k==0) ? firstPos : 0;
+}
+
+
+/**
+ * @brief Places a cursor on the last record with a time not later than t
+ * @param c the cursor
+ * @param t the time
+ *
+ * The cursor is placed on the oldest record if all records are later than t.
+ * The records are assumed to be appended in increasing time.
+*/
+
+void gecoRecordArena::seek(gecoArenaCursor& c, double t)
+{
+  first(c);
+  if (nbrChunks==0) return;
+
+  // binary search over the first record of the chunks (the oldest may be empty)
+  double tc;
+  size_t lo=(firstPos<chunkFill(0)) ? 0 : 1;
+  size_t hi=nbrChunks-1;
+  if (lo>hi) return;
+  while (lo<hi)
+    {
+      size_t mid=lo+(hi-lo+1)/2;
+      memcpy(&tc, chunk(mid), sizeof(double));
+      if (tc<=t)
+	lo=mid;
+      else
+	hi=mid-1;
+    }
+
+  // scan within the chunk
+  firstOfChunk(c, lo);
+  gecoArenaCursor last=c;
+  size_t len;
+  while (c.pos<chunkFill(lo))
+    {
+      memcpy(&tc, chunk(lo)+c.pos, sizeof(double));
+      if (tc>t) break;
+      last=c;
+      readRecord(chunk(lo)+c.pos, tc, len);
+      c.pos+=recordSize(len);
+    }
+  c=last;
+}
+
+
+/**
+ * @brief Reads the record at a cursor and advances the cursor
+ * @param c the cursor
+ * @param t time of the record
+ * @param data content of the record (valid until the arena is modified)
+ * @param len length of data
+ * \return false if there are no more records
+*/
+
+bool gecoRecordArena::next(gecoArenaCursor& c, double& t, const char*& data, size_t& len)
+{
+  while (c.chunk<nbrChunks)
+    {
+      if (c.pos>=chunkFill(c.chunk))
+	{
+	  c.chunk++;
+	  c.pos=0;
+	  continue;
+	}
+      data=readRecord(chunk(c.chunk)+c.pos, t, len);
+      c.pos+=recordSize(len);
+      return true;
+    }
+  return false;
+}
+
+
+/**
+ * @brief Returns the memory used by the records (bytes)
+*/
+
+size_t gecoRecordArena::getUsed()
+{
+  size_t used=0;
+  for (size_t k=0; k<nbrChunks; k++) used+=chunkFill(k);
+  return used-((nbrChunks>0) ? firstPos : 0);
+}
@@ -0,0 +1,204 @@
+// This may look like C code, but it is really -*- C++ -*-
+// ----------------------------------------------------------------
+//
+// Header file for class gecoRecordArena
+//
+// (c) Rolf Wuthrich
+//     2026 Concordia University
+//
+// author:  agent
+// email:   agent@local
+// version: v1
+//
+// This software is copyright under the BSD license
+//
+// ---------------------------------------------------------------
+// history:
+// ---------------------------------------------------------------
+// Date       Modification                     Author
+// ---------------------------------------------------------------
+// 17.10.2026 Creation                         agent
+// 17.10.2026 Added copy-on-write snapshots    agent
+// 17.10.2026 Added seek by time               agent
+//
+// ---------------------------------------------------------------
+/*! \file */
+
+#ifndef gecoRecordArena_SEEN_
+#define gecoRecordArena_SEEN_
+
+#include <stddef.h>
+#include <vector>
+#include <atomic>
+
+using namespace std;
+
+
+// ------------------------------------------------------------------------
+//
+// Storage modes
+//
+
+const int
+  Arena_grow = 0,       // new chunks are allocated when the arena is full
+  Arena_ring = 1;       // the oldest chunk is recycled when the arena is full
+
+extern const char* ArenaModeStr[];
+
+
+// -------------------------------------------------------------------------
+//
+// Cursor on the records of a gecoRecordArena
+//
+
+struct gecoArenaCursor
+{
+  size_t         chunk;       // chunk (counted from the oldest one)
+  size_t         pos;         // offset within the chunk
+};
+
+
+// -------------------------------------------------------------------------
+//
+// Chunk of memory shared between a gecoRecordArena and its snapshots
+//
+
+struct gecoArenaChunk
+{
+  char*          data;
+  atomic<int>    refs;        // number of owners (arena and snapshots)
+};
+
+
+// -----------------------------------------------------------------------
+//
+// class gecoArenaSnapshot : frozen view of the records of a gecoRecordArena
+//
+
+/**
+ * @brief Frozen view of the records of a gecoRecordArena
+ * \author agent
+ * \date 2026
+ *
+ * A gecoArenaSnapshot is created by gecoRecordArena::snapshot. It shares the
+ * chunks of the arena instead of copying them. The arena keeps appending records
+ * behind the frozen ones and allocates a new chunk instead of overwriting a chunk
+ * still used by a snapshot. A snapshot can therefore be read by another thread
+ * while the arena keeps recording.
+ */
+
+class gecoArenaSnapshot
+{
+
+private:
+
+  vector<gecoArenaChunk*>  chunks;   // shared chunks
+  vector<size_t>           begin;    // offset of the first record in each chunk
+  vector<size_t>           end;      // offset of the end of the records in each chunk
+  long long                records;  // number of records
+
+  friend class gecoRecordArena;
+
+public:
+
+  gecoArenaSnapshot() : records(0) {}
+  ~gecoArenaSnapshot();
+
+  void         first(gecoArenaCursor& c);
+  bool         next(gecoArenaCursor& c, double& t, const char*& data, size_t& len);
+  long long    getRecords() {return records;}   /*!< Returns the number of records */
+};
+
+
+// -----------------------------------------------------------------------
+//
+// class gecoRecordArena : chunked storage of time stamped records
+//
+
+/**
+ * @brief Chunked storage of time stamped records
+ * \author agent
+ * \date 2026
+ *
+ * A gecoRecordArena stores records (a time and a string of bytes) back to back
+ * in preallocated chunks of memory. Appending a record is a copy into the
+ * current chunk; no memory is allocated unless all chunks are full.
+ *
+ * When all chunks are full, the behaviour depends on the mode:
+ *
+ * Mode    | Behaviour
+ * ------- | ------------------------------------------------------
+ * grow    | a new chunk is allocated (memory grows without bound)
+ * ring    | the oldest chunk is recycled (its records are overwritten)
+ *
+ * In ring mode the memory used never exceeds the capacity. In both modes
+ * records older than a given time can be discarded with gecoRecordArena::trim,
+ * which returns their chunks to the pool.
+ *
+ * The records are read back in order with a gecoArenaCursor:
+ *
+ *     gecoArenaCursor c;
+ *     double t; const char* data; size_t len;
+ *     arena->first(c);
+ *     while (arena->next(c, t, data, len)) ...
+ *
+ * gecoRecordArena::snapshot freezes the current records in a gecoArenaSnapshot
+ * without copying them (copy-on-write of the chunks).
+ *
+ * As the records are appended in increasing time, the first record of each
+ * chunk forms a sparse time index: gecoRecordArena::seek places a cursor by
+ * binary search over the chunks followed by a scan within one chunk.
+ */
+
+class gecoRecordArena
+{
+
+private:
+
+  vector<gecoArenaChunk*> pool;   // chunks (circular, from firstChunk on)
+  vector<size_t>   fill;          // bytes used in each chunk
+  size_t           firstChunk;    // index in pool of the oldest chunk
+  size_t           nbrChunks;     // number of chunks holding records
+  size_t           firstPos;      // offset of the oldest record in the oldest chunk
+  size_t           chunkSize;     // size of a chunk (bytes)
+  size_t           capacity;      // preallocated memory (bytes)
+  int              mode;          // Arena_grow or Arena_ring
+
+  long long        records;       // records stored
+  long long        overwritten;   // records lost by recycling or trimming
+  long long        dropped;       // records larger than a chunk
+
+  char*            chunk(size_t k) {return pool[(firstChunk+k) % pool.size()]->data;}
+  size_t&          chunkFill(size_t k) {return fill[(firstChunk+k) % pool.size()];}
+  void             startChunk(size_t k);
+  void             releaseFirst();
+  void             freePool();
+
+public:
+
+  gecoRecordArena();
+  ~gecoRecordArena();
+
+  void         setup(size_t Capacity, int Mode);
+  bool         append(double t, const char* data, size_t len);
+  void         trim(double tMin);
+  void         clear();
+  gecoArenaSnapshot* snapshot();
+
+  void         first(gecoArenaCursor& c);
+  void         firstOfChunk(gecoArenaCursor& c, size_t k);
+  void         seek(gecoArenaCursor& c, double t);
+  bool         next(gecoArenaCursor& c, double& t, const char*& data, size_t& len);
+
+  size_t       getNbrChunks()   {return nbrChunks;}                /*!< Returns the number of chunks holding records */
+  int          getMode()        {return mode;}                     /*!< Returns the mode (Arena_grow or Arena_ring) */
+  size_t       getCapacity()    {return capacity;}                 /*!< Returns the preallocated memory (bytes) */
+  size_t       getChunkSize()   {return chunkSize;}                /*!< Returns the size of a chunk (bytes) */
+  size_t       getAllocated()   {return pool.size()*chunkSize;}    /*!< Returns the allocated memory (bytes) */
+  size_t       getUsed();
+  long long    getRecords()     {return records;}                  /*!< Returns the number of records stored */
+  long long    getOverwritten() {return overwritten;}              /*!< Returns the number of records lost by recycling or trimming */
+  long long    getDropped()     {return dropped;}                  /*!< Returns the number of records larger than a chunk */
+};
+
+#endif /* gecoRecordArena_SEEN_ */
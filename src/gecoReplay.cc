@@ -0,0 +1,657 @@
+// ---------------------------------------------------------------
+//
+// Definition of the class gecoReplay
+//
+// (c) Rolf Wuthrich
+//     2026 Concordia University
+//
+// author:  agent
+// email:   agent@local
+// version: v1
+//
+// This software is copyright under the BSD license
+//
+// ---------------------------------------------------------------
+// history:
+// ---------------------------------------------------------------
+// Date       Modification                     Author
+// ---------------------------------------------------------------
+// 17.10.2026 Creation                         agent
+// 18.10.2026 Stops at the trailer of the file  agent
+//
+// ---------------------------------------------------------------
+
+#include <tcl.h>
+#include <cstring>
+#include <cstdlib>
+#include <cmath>
+#include <cerrno>
+#include <sys/types.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "gecoReplay.h"
+#include "gecoBlockCodec.h"
+#include "gecoSignal.h"
+#include "gecoApp.h"
+
+using namespace std;
+
+
+// ---------------------------------------------------------------
+//
+// Read modes
+//
+
+const char* ReplayReadStr[] = {"mmap", "stream", NULL};
+
+static const size_t ReplayStreamBuffer = 1048576;   // buffer of a file read sequentially
+
+
+// -------------------------------------------------------------------------
+//
+// Tcl interface
+//
+
+// Command to create a new gecoReplay object
+//
+
+int geco_ReplayCmd(ClientData clientData, Tcl_Interp *interp,
+		   int objc,Tcl_Obj *const objv[])
+{
+  gecoReplay* proc = new gecoReplay((gecoApp *)clientData);
+  return geco_CreateGecoProcessCmd(proc, objc, objv);
+}
+
+
+// -------------------------------------------------------------------------
+//
+// class gecoReplay : plays back a recorded data file
+//
+
+// returns the index of str in the NULL terminated table or -1
+static int tableIndex(const char* str, const char** table)
+{
+  for (int k=0; table[k]!=NULL; k++)
+    if (strcmp(str, table[k])==0) return k;
+  return -1;
+}
+
+
+/**
+ * @brief Constructor
+ * @param App gecoApp in which the gecoReplay lives
+*/
+
+gecoReplay::gecoReplay(gecoApp* App) :
+  gecoObj("Replay", "replay", App),
+  gecoProcess("Replay", "user", "replay", App),
+  text(false),
+  timeCol(0),
+  fields(0),
+  firstField(0),
+  file(NULL),
+  map(NULL),
+  fileSize(0),
+  pos(0),
+  lineBuf(NULL),
+  lineSize(0),
+  blockRecords(0),
+  blockNext(0),
+  next(NULL),
+  anchorT(0.0),
+  anchorRec(0.0),
+  lastTime(0.0),
+  reanchor(true),
+  played(0),
+  skipped(0),
+  loops(0),
+  speed(1.0),
+  loop(false)
+{
+  activateOnStart=1;
+  fileName   = new Tcl_DString;
+  columns    = new Tcl_DString;
+  timeColumn = new Tcl_DString;
+  readMode   = new Tcl_DString;
+  error      = new Tcl_DString;
+  Tcl_DStringInit(fileName);
+  Tcl_DStringInit(columns);
+  Tcl_DStringInit(timeColumn);
+  Tcl_DStringInit(readMode);
+  Tcl_DStringInit(error);
+  Tcl_DStringAppend(readMode, ReplayReadStr[Replay_mmap], -1);
+  bin = new gecoBinFile;
+
+  addOption("-file", fileName, "returns/sets file name to replay");
+  addOption("-columns", columns, "returns/sets columns of a text file");
+  addOption("-timeColumn", timeColumn, "returns/sets column holding the time (s)");
+  addOption("-speed", &speed, "returns/sets replay speed (1 real time, 0 as fast as possible)");
+  addOption("-read", readMode, "returns/sets read mode (mmap or stream)");
+  addOption("-loop", &loop, "returns/sets if the file is replayed in a loop");
+}
+
+
+/**
+ * @brief Destructor
+*/
+
+gecoReplay::~gecoReplay()
+{
+  closeFile();
+  free(lineBuf);
+  delete bin;
+  Tcl_DStringFree(fileName);
+  Tcl_DStringFree(columns);
+  Tcl_DStringFree(timeColumn);
+  Tcl_DStringFree(readMode);
+  Tcl_DStringFree(error);
+  delete fileName;
+  delete columns;
+  delete timeColumn;
+  delete readMode;
+  delete error;
+}
+
+
+/*!
+ * @copydoc gecoProcess::cmd
+ *
+ * Compared to gecoProcess::cmd, gecoReplay::cmd checks the settings of the
+ * replay. A new speed is applied from the record replayed last on.
+ */
+
+int gecoReplay::cmd(int &i, int objc,Tcl_Obj *const objv[])
+{
+  // first executes the command options defined in gecoProcess
+  int j=i;
+  double oldSpeed=speed;
+  Tcl_DString oldColumns;
+  Tcl_DStringInit(&oldColumns);
+  Tcl_DStringAppend(&oldColumns, Tcl_DStringValue(columns), -1);
+  int index=gecoProcess::cmd(i,objc,objv);
+
+  if ((index==getOptionIndex("-columns"))&&(i==j+2))
+    {
+      gecoBinFile layout;
+      if (layout.setColumns(interp, Tcl_DStringValue(columns))!=TCL_OK)
+	{
+	  Tcl_DStringFree(columns);
+	  Tcl_DStringAppend(columns, Tcl_DStringValue(&oldColumns), -1);
+	  index=-1;
+	}
+    }
+
+  if ((index==getOptionIndex("-speed"))&&(i==j+2))
+    {
+      if (speed<0.0)
+	{
+	  Tcl_AppendResult(interp, "speed must be positive or 0", NULL);
+	  speed=oldSpeed;
+	  index=-1;
+	}
+      else
+	reanchor=true;
+    }
+
+  if ((index==getOptionIndex("-read"))&&(i==j+2)&&
+      (tableIndex(Tcl_DStringValue(readMode), ReplayReadStr)<0))
+    {
+      Tcl_AppendResult(interp, "read mode must be mmap or stream", NULL);
+      Tcl_DStringFree(readMode);
+      Tcl_DStringAppend(readMode, ReplayReadStr[Replay_mmap], -1);
+      index=-1;
+    }
+
+  Tcl_DStringFree(&oldColumns);
+  return index;
+}
+
+
+/**
+ * @copydoc gecoProcess::handleEvent
+ *
+ * In addition to gecoProcess::handleEvent, gecoReplay::handleEvent sets the
+ * variables to the last record due and terminates the gecoReplay at the end
+ * of the file.
+ */
+
+void gecoReplay::handleEvent(gecoEvent* ev)
+{
+  gecoProcess::handleEvent(ev);
+  if (status!=Active)
+    {
+      reanchor=true;
+      return;
+    }
+  if (reanchor)
+    {
+      anchorT=ev->getT();
+      anchorRec=lastTime;
+      reanchor=false;
+    }
+
+  if (speed<=0.0)
+    {
+      if (next)
+	{
+	  apply(next);
+	  lastTime=recTime(next);
+	  played++;
+	  next=fetch();
+	}
+    }
+  else
+    {
+      double      due=anchorRec+(ev->getT()-anchorT)*speed;
+      const char* rec=NULL;
+      while ((next)&&(recTime(next)<=due))
+	{
+	  if (rec) skipped++;
+	  memcpy(&cur[0], next, cur.size());
+	  rec=&cur[0];
+	  next=fetch();
+	}
+      if (rec)
+	{
+	  apply(rec);
+	  lastTime=recTime(rec);
+	  played++;
+	}
+    }
+
+  if (next==NULL)
+    {
+      if ((loop)&&(played>0))
+	{
+	  rewindFile();
+	  next=fetch();
+	}
+      if (next==NULL)
+	{
+	  terminate(ev);
+	  return;
+	}
+      loops++;
+      lastTime=recTime(next);
+      reanchor=true;
+    }
+}
+
+
+/**
+ * @copydoc gecoProcess::info
+ *
+ * In addition to gecoProcess::info, gecoReplay::info adds the information
+ * about the file replayed.
+ */
+
+Tcl_DString* gecoReplay::info(const char* frontStr)
+{
+  gecoProcess::info(frontStr);
+  addInfo(frontStr, "File:                 ", Tcl_DStringValue(fileName));
+  if ((file)||(map))
+    {
+      if (text)
+	addInfo(frontStr, "Format:               ", "text");
+      else
+	addInfo(frontStr, "Format:               ", (bin->getEncoding()==Encoding_none) ?
+		"binary" : "binary (gorilla)");
+    }
+  addInfo(frontStr, "Columns:              ", Tcl_DStringValue(columns));
+  addInfo(frontStr, "Time column:          ", Tcl_DStringValue(timeColumn));
+  addInfo(frontStr, "Speed:                ", speed);
+  addInfo(frontStr, "Read mode:            ", Tcl_DStringValue(readMode));
+  addInfo(frontStr, "Loop:                 ", (loop) ? "on" : "off");
+
+  Tcl_DString str;
+  Tcl_DStringInit(&str);
+  for (int k=0; k<(int)targets.size(); k++)
+    Tcl_DStringAppendElement(&str, bin->getColumnName(targets[k].col));
+  addInfo(frontStr, "Variables replayed:   ", Tcl_DStringValue(&str));
+  Tcl_DStringFree(&str);
+
+  char s[80];
+  sprintf(s, "%lld", played);
+  addInfo(frontStr, "Records replayed:     ", s);
+  sprintf(s, "%lld", skipped);
+  addInfo(frontStr, "Records skipped:      ", s);
+  if (loop)
+    {
+      sprintf(s, "%lld", loops);
+      addInfo(frontStr, "Loops:                ", s);
+    }
+  if ((fileSize>0)&&((file)||(map)))
+    {
+      sprintf(s, "%.1f %% of %lld kB", 100.0*pos/fileSize, (long long)(fileSize/1024));
+      addInfo(frontStr, "Position:             ", s);
+    }
+  if (Tcl_DStringLength(error)>0)
+    addInfo(frontStr, "Error:                ", Tcl_DStringValue(error));
+  return infoStr;
+}
+
+
+/**
+ * @copydoc gecoProcess::terminate
+ *
+ * In addition to gecoProcess::terminate, gecoReplay::terminate closes the
+ * file replayed.
+ */
+
+void gecoReplay::terminate(gecoEvent* ev)
+{
+  gecoProcess::terminate(ev);
+  closeFile();
+}
+
+
+/**
+ * @copydoc gecoProcess::activate
+ *
+ * In addition to gecoProcess::activate, gecoReplay::activate opens the file
+ * to replay and reads its first record. If the file can't be opened, the
+ * gecoReplay terminates at the next pass of the geco process loop.
+ */
+
+void gecoReplay::activate(gecoEvent* ev)
+{
+  gecoProcess::activate(ev);
+  played=0;
+  skipped=0;
+  loops=0;
+  Tcl_DStringFree(error);
+  Tcl_ResetResult(interp);
+  if (openFile()!=TCL_OK)
+    {
+      Tcl_DStringAppend(error, Tcl_GetStringResult(interp), -1);
+      Tcl_ResetResult(interp);
+      closeFile();
+      return;
+    }
+  next=fetch();
+  lastTime=(next) ? recTime(next) : 0.0;
+  reanchor=true;
+}
+
+
+/**
+ * @brief Opens the file, reads its layout and binds the columns to their variables
+ * \return TCL_OK in case of success and TCL_ERROR otherwise (error message left in the Tcl interpreter)
+*/
+
+int gecoReplay::openFile()
+{
+  closeFile();
+  const char* name=Tcl_DStringValue(fileName);
+  file=fopen(name, "rb");
+  if (file==NULL)
+    {
+      Tcl_AppendResult(interp, "couldn't open \"", name, "\": ", Tcl_PosixError(interp), NULL);
+      return TCL_ERROR;
+    }
+
+  // binary data files start with their magic string
+  char magic[8];
+  text=(fread(magic, 1, 8, file)!=8)||(memcmp(magic, "GECOBIN1", 8)!=0);
+  rewind(file);
+  int n=0;
+  if (text)
+    {
+      Tcl_Obj* list=Tcl_NewStringObj(Tcl_DStringValue(columns), -1);
+      Tcl_IncrRefCount(list);
+      Tcl_ListObjLength(NULL, list, &n);
+      Tcl_DecrRefCount(list);
+      if (n==0)
+	{
+	  Tcl_AppendResult(interp, "no columns declared for text file \"", name, "\"", NULL);
+	  return TCL_ERROR;
+	}
+      if (bin->setColumns(interp, Tcl_DStringValue(columns))!=TCL_OK) return TCL_ERROR;
+      bin->setEncoding(Encoding_none);
+    }
+  else if (bin->readHeader(interp, file)!=TCL_OK)
+    return TCL_ERROR;
+
+  // the values of a line fill the declared columns, after the timestamp added in front
+  fields=n;
+  firstField=(text) ? bin->getNbrColumns()-n : 0;
+  timeCol=bin->getTimestampColumn();
+  if ((text)&&(firstField>0)) timeCol=firstField;
+  if (Tcl_DStringLength(timeColumn)>0)
+    {
+      timeCol=bin->getColumnIndex(Tcl_DStringValue(timeColumn));
+      if ((timeCol<0)||((text)&&(timeCol<firstField)))
+	{
+	  Tcl_AppendResult(interp, "no column \"", Tcl_DStringValue(timeColumn), "\" in \"", name, "\"", NULL);
+	  return TCL_ERROR;
+	}
+    }
+
+  // maps the file or reads it through a large buffer
+  struct stat st;
+  fstat(fileno(file), &st);
+  fileSize=st.st_size;
+  pos=(text) ? 0 : bin->getDataOffset();
+  if ((tableIndex(Tcl_DStringValue(readMode), ReplayReadStr)==Replay_mmap)&&(fileSize>0))
+    {
+      void* m=mmap(NULL, fileSize, PROT_READ, MAP_PRIVATE, fileno(file), 0);
+      if (m==MAP_FAILED)
+	{
+	  Tcl_AppendResult(interp, "couldn't map \"", name, "\": ", Tcl_PosixError(interp), NULL);
+	  return TCL_ERROR;
+	}
+      map=(char *)m;
+      madvise(map, fileSize, MADV_SEQUENTIAL);
+      fclose(file);
+      file=NULL;
+    }
+  else
+    {
+      fclose(file);
+      file=fopen(name, "rb");
+      if (file==NULL)
+	{
+	  Tcl_AppendResult(interp, "couldn't open \"", name, "\": ", Tcl_PosixError(interp), NULL);
+	  return TCL_ERROR;
+	}
+      setvbuf(file, NULL, _IOFBF, ReplayStreamBuffer);
+      fseeko(file, pos, SEEK_SET);
+    }
+
+  int rs=bin->getRecordSize();
+  cur.assign(rs, 0);
+  textRec.assign(rs, 0);
+  if (bin->getEncoding()!=Encoding_none) blockRecs.resize((size_t)BlockMaxRecords*rs);
+  blockRecords=0;
+  blockNext=0;
+
+  // binds the columns to their variables
+  for (int k=0; k<bin->getNbrColumns(); k++)
+    {
+      const char* col=bin->getColumnName(k);
+      if ((k<firstField)||(bin->getColumnType(k)==BinCol_timestamp)||
+	  (strcmp(col, "-")==0)||(app->findNativeVar(col)))
+	continue;
+      gecoReplayTarget target;
+      target.col=k;
+      target.sig=(app->getSignalBus()->find(col)) ? app->getSignalBus()->attach(col, Signal_double) : NULL;
+      target.var=bin->getColumnNameObj(k);
+      targets.push_back(target);
+    }
+  return TCL_OK;
+}
+
+
+/**
+ * @brief Detaches the columns from their variables and closes the file
+*/
+
+void gecoReplay::closeFile()
+{
+  for (int k=0; k<(int)targets.size(); k++)
+    app->getSignalBus()->detach(targets[k].sig);
+  targets.clear();
+  if (map) munmap(map, fileSize);
+  map=NULL;
+  if (file) fclose(file);
+  file=NULL;
+  next=NULL;
+}
+
+
+/**
+ * @brief Positions the file back on its first record
+*/
+
+void gecoReplay::rewindFile()
+{
+  pos=(text) ? 0 : bin->getDataOffset();
+  if (file) fseeko(file, pos, SEEK_SET);
+  blockRecords=0;
+  blockNext=0;
+}
+
+
+/**
+ * @brief Reads n bytes from the file
+ * \return the bytes (valid until the next read) or NULL at the end of the file
+*/
+
+const char* gecoReplay::readBytes(size_t n)
+{
+  if (map)
+    {
+      if (pos+n>fileSize) return NULL;
+      const char* p=map+pos;
+      pos+=n;
+      return p;
+    }
+  if (file==NULL) return NULL;
+  buf.resize(n);
+  if (fread(&buf[0], 1, n, file)!=n) return NULL;
+  pos+=n;
+  return &buf[0];
+}
+
+
+/**
+ * @brief Reads the next line of a text file
+ * \return the line, NUL terminated (valid until the next read), or NULL at the end of the file
+*/
+
+const char* gecoReplay::readLine()
+{
+  if (map)
+    {
+      if (pos>=fileSize) return NULL;
+      const char* p=map+pos;
+      const char* e=(const char *)memchr(p, '\n', fileSize-pos);
+      size_t      len=(e) ? (size_t)(e-p) : fileSize-pos;
+      buf.assign(p, p+len);
+      buf.push_back(0);
+      pos+=len+1;
+      return &buf[0];
+    }
+  if (file==NULL) return NULL;
+  ssize_t len=getline(&lineBuf, &lineSize, file);
+  if (len<0) return NULL;
+  pos+=len;
+  return lineBuf;
+}
+
+
+/**
+ * @brief Reads the next record of the file
+ * \return the record (valid until the next read) or NULL at the end of the file
+ *
+ * A record or block truncated at the end of the file is ignored.
+*/
+
+const char* gecoReplay::fetch()
+{
+  if ((file==NULL)&&(map==NULL)) return NULL;
+  int rs=bin->getRecordSize();
+
+  if (text)
+    {
+      const char* line;
+      while ((line=readLine())!=NULL)
+	{
+	  char* s=(char *)line;
+	  int   f;
+	  for (f=0; f<fields; f++)
+	    {
+	      while ((*s==',')||(*s==';')) s++;
+	      char*  e;
+	      double v=strtod(s, &e);
+	      if (e==s) break;
+	      int k=firstField+f;
+	      int type=bin->getColumnType(k);
+	      if (type==BinCol_timestamp)
+		bin->putWide(&textRec[0], k, llround(v*1e9));
+	      else if ((type==BinCol_int)||(type==BinCol_wide))
+		{
+		  char*     ew;
+		  long long w=strtoll(s, &ew, 10);
+		  if (ew==e)
+		    bin->putWide(&textRec[0], k, w);
+		  else
+		    bin->putValue(&textRec[0], k, v);
+		}
+	      else
+		bin->putValue(&textRec[0], k, v);
+	      s=e;
+	    }
+	  if (f==fields) return &textRec[0];
+	}
+      return NULL;
+    }
+
+  if (bin->getEncoding()==Encoding_none) return readBytes(rs);
+
+  // compressed file: decodes the next block once its records are needed
+  while (blockNext>=blockRecords)
+    {
+      const char* head=readBytes(16);
+      if (head==NULL) return NULL;
+      size_t size=gecoBlockDecoder::getSize(head);
+      int    r=gecoBlockDecoder::getRecords(head);
+      // the trailer of the file (no record) ends the blocks
+      if ((size<16)||(r<1)||(r>BlockMaxRecords)) return NULL;
+      const char* block;
+      if (map)
+	{
+	  if (pos+size-16>fileSize) return NULL;
+	  block=head;
+	  pos+=size-16;
+	}
+      else
+	{
+	  buf.resize(size);
+	  if (fread(&buf[16], 1, size-16, file)!=size-16) return NULL;
+	  pos+=size-16;
+	  block=&buf[0];
+	}
+      if (gecoBlockDecoder::decode(bin, block, size, &blockRecs[0])!=r) return NULL;
+      blockRecords=r;
+      blockNext=0;
+    }
+  return &blockRecs[(size_t)(blockNext++)*rs];
+}
+
+
+/**
+ * @brief Sets the variables to the values of a record
+*/
+
+void gecoReplay::apply(const char* rec)
+{
+  for (int k=0; k<(int)targets.size(); k++)
+    {
+      gecoReplayTarget& target=targets[k];
+      if (target.sig)
+	target.sig->setDouble(bin->getDouble(rec, target.col));
+      else
+	Tcl_ObjSetVar2(interp, target.var, NULL, bin->getValue(rec, target.col), TCL_GLOBAL_ONLY);
+    }
+}
@@ -0,0 +1,237 @@
+// This may look like C code, but it is really -*- C++ -*-
+// ----------------------------------------------------------------
+//
+// Header file for class gecoReplay
+//
+// (c) Rolf Wuthrich
+//     2026 Concordia University
+//
+// author:  agent
+// email:   agent@local
+// version: v1
+//
+// This software is copyright under the BSD license
+//
+// ---------------------------------------------------------------
+// history:
+// ---------------------------------------------------------------
+// Date       Modification                     Author
+// ---------------------------------------------------------------
+// 17.10.2026 Creation                         agent
+//
+// ---------------------------------------------------------------
+/*! \file */
+
+#ifndef gecoReplay_SEEN_
+#define gecoReplay_SEEN_
+
+#include <tcl8.6/tcl.h>
+#include <stdio.h>
+#include <vector>
+#include "gecoProcess.h"
+#include "gecoBinFile.h"
+#include "gecoApp.h"
+
+class gecoSignal;            // forward definition
+
+using namespace std;
+
+
+// -----------------------------------------------------------------------
+//
+// Tcl interface
+//
+
+/**
+ * @brief C++ implementation of the Tcl command to create a gecoReplay object
+ * @param clientData pointer to the gecoApp in which the gecoReplay instance will live
+ * @param interp Tcl interpreter in which the Tcl command is executed
+ * @param objc number of arguments of the Tcl command
+ * @param objv arguments of the the Tcl command
+ * \return TCL_OK if the execution of the Tcl command is successful and TCL_ERROR otherwise
+ */
+
+int geco_ReplayCmd(ClientData clientData, Tcl_Interp *interp,
+		   int objc,Tcl_Obj *const objv[]);
+
+
+// ------------------------------------------------------------------------
+//
+// Read modes
+//
+
+const int
+  Replay_mmap   = 0,          // file mapped in memory
+  Replay_stream = 1;          // file read sequentially
+
+extern const char* ReplayReadStr[];
+
+
+// ------------------------------------------------------------------------
+//
+// Variable set by a column
+//
+
+struct gecoReplayTarget
+{
+  int                col;          // column of the record
+  gecoSignal*        sig;          // signal (or NULL)
+  Tcl_Obj*           var;          // name of the Tcl variable (if no signal)
+};
+
+
+// -----------------------------------------------------------------------
+//
+// class gecoReplay : plays back a recorded data file
+//
+
+/**
+ * @brief A gecoProcess playing back a data file recorded by gecoFileStream or gecoMemStream
+ * \author agent
+ * \date 2026
+ *
+ * The gecoReplay class allows to create a gecoProcess reading back, record by
+ * record, a data file recorded by a gecoFileStream or saved by a gecoMemStream
+ * and setting the variables of its columns, as the gecoIOModule would during
+ * the experiment. Triggers, graphs or controllers can so be tuned offline, and
+ * the replay serves as a load generator for the geco process loop without any
+ * hardware.
+ *
+ * The geco_ReplayCmd() is the C++ implementation for the Tcl command to
+ * create gecoReplay objects. This Tcl command is already available in
+ * the Tcl interpreter run by an instance of gecoApp under the name 'replay'.
+ *
+ * Associated Tcl command
+ * ----------------------
+ * Every gecoReplay is associated to a Tcl command. The associated Tcl command
+ * is created during the construction of an instance of gecoReplay by its
+ * parent class. The Tcl command is created in the Tcl interpreter
+ * run by the gecoApp in which gecoReplay lives.
+ *
+ * The gecoReplay class extends the subcommands from gecoObj and gecoProcess
+ * by the following subcommands
+ *
+ * Sub-command       | Short description
+ * ----------------- | ------------------
+ * -file             | returns/sets file name to replay
+ * -columns          | returns/sets columns of a text file
+ * -timeColumn       | returns/sets column holding the time (s)
+ * -speed            | returns/sets replay speed (1 real time, 0 as fast as possible)
+ * -read             | returns/sets read mode (mmap or stream)
+ * -loop             | returns/sets if the file is replayed in a loop
+ *
+ * Files
+ * -----
+ * Binary data files (see gecoBinFile), compressed or not, describe their columns
+ * in their header. The time of a record is its timestamp column.
+ *
+ * In a text data file, each line holds the values of a record separated by blanks.
+ * '-columns' names the values in order, declared as for the binary format of
+ * gecoFileStream ('name' or '{name type}'); a value named '-' is skipped. The
+ * time of a record is the first value, unless a column of type timestamp (s) is
+ * declared. Lines not holding enough numbers (like the header line of a
+ * gecoFileStream) are ignored.
+ *
+ * '-timeColumn' names another column holding the time (s) of the records.
+ *
+ * Variables
+ * ---------
+ * Each column (except the timestamps and the native variables like t) sets the
+ * variable of the same name: a signal of the gecoSignalBus if it exists at
+ * activation, the Tcl variable otherwise.
+ *
+ * Speed
+ * -----
+ * With a '-speed' larger than 0, the records are replayed at their recorded time,
+ * scaled by the speed (1 for real time, 2 for twice as fast). At each pass of the
+ * geco process loop, the variables are set to the last record due; the records
+ * due in between are skipped and counted. With '-speed 0', one record is replayed
+ * per pass of the geco process loop, as fast as possible. Changing the speed or
+ * holding the process does not make the replay jump.
+ *
+ * Once the end of the file is reached, the gecoReplay terminates, or restarts at
+ * the beginning of the file with '-loop on'.
+ *
+ * Reading
+ * -------
+ * The file is never loaded in memory: with '-read mmap' (default) it is mapped in
+ * memory and read in place, with '-read stream' it is read sequentially. A block
+ * of a compressed file is decompressed once its first record is due.
+ *
+ * The settings are taken into account at the next activation.
+ *
+ * Example
+ * -------
+ * \code
+ * replay -file run.bin -speed 1
+ * trigger -condition {$V>2.5} ...
+ * \endcode
+ */
+
+class gecoReplay : public gecoProcess
+{
+private:
+
+  gecoBinFile*   bin;             // layout of the records
+  bool           text;            // true for a text file
+  int            timeCol;         // column holding the time
+  int            fields;          // values of a line of a text file
+  int            firstField;      // first column of the values of a line
+  vector<gecoReplayTarget> targets; // columns replayed
+
+  FILE*          file;            // file read sequentially (or NULL)
+  char*          map;             // file mapped in memory (or NULL)
+  size_t         fileSize;        // size of the file
+  size_t         pos;             // position in the file
+  vector<char>   buf;             // bytes read from the file
+  char*          lineBuf;         // line read from a text file
+  size_t         lineSize;
+  vector<char>   blockRecs;       // records of the current block
+  int            blockRecords;    // records in the current block
+  int            blockNext;       // next record of the current block
+
+  const char*    next;            // next record (or NULL at the end of the file)
+  vector<char>   cur;             // record replayed last
+  vector<char>   textRec;         // record built from a line
+  double         anchorT;         // time of the loop at which the replay was anchored
+  double         anchorRec;       // time of the record at which the replay was anchored
+  double         lastTime;        // time of the record replayed last
+  bool           reanchor;        // the replay must be anchored again
+
+  long long      played;          // records replayed
+  long long      skipped;         // records due but skipped
+  long long      loops;           // replays of the file
+  Tcl_DString*   error;           // error at the last activation
+
+  int            openFile();
+  void           closeFile();
+  void           rewindFile();
+  const char*    readBytes(size_t n);
+  const char*    readLine();
+  const char*    fetch();
+  double         recTime(const char* rec) {return bin->getDouble(rec, timeCol);} /*!< Returns the time of a record (s) */
+  void           apply(const char* rec);
+
+protected:
+
+  Tcl_DString*   fileName;        // file name
+  Tcl_DString*   columns;         // columns of a text file
+  Tcl_DString*   timeColumn;      // column holding the time
+  double         speed;           // replay speed (0 as fast as possible)
+  Tcl_DString*   readMode;        // mmap or stream
+  bool           loop;            // replays the file in a loop
+
+public:
+
+  gecoReplay(gecoApp* App);
+  ~gecoReplay();
+
+  virtual int  cmd(int &i,int objc,Tcl_Obj *const objv[]);
+  virtual void handleEvent(gecoEvent* ev);
+  virtual Tcl_DString* info(const char* frontStr = "");
+
+  virtual void terminate(gecoEvent* ev);
+  virtual void activate(gecoEvent* ev);
+};
+
+#endif /* gecoReplay_SEEN_ */
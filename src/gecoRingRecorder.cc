@@ -0,0 +1,718 @@
+// ---------------------------------------------------------------
+//
+// Definition of the class gecoRingRecorder
+//
+// (c) Rolf Wuthrich
+//     2026 Concordia University
+//
+// author:  agent
+// email:   agent@local
+// version: v1
+//
+// This software is copyright under the BSD license
+//
+// ---------------------------------------------------------------
+// history:
+// ---------------------------------------------------------------
+// Date       Modification                     Author
+// ---------------------------------------------------------------
+// 17.10.2026 Creation                         agent
+// 18.10.2026 Previous ring kept on activation  agent
+//
+// ---------------------------------------------------------------
+
+#include <tcl.h>
+#include <cstring>
+#include <cerrno>
+#include <cstdio>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "gecoRingRecorder.h"
+#include "gecoHelp.h"
+#include "gecoApp.h"
+
+using namespace std;
+
+
+// ---------------------------------------------------------------
+//
+// Layout of the ring file
+//
+
+static const char RingMagic[]     = "GECORNG1";
+static const int  RingVersion     = 1;
+static const int  RingFixedHeader = 64;     // offset of the header of the binary data file
+static const int  RingCommitted   = 32;     // offset of the committed index
+static const int  RingPage        = 4096;   // alignment of the first slot
+
+// checksum (FNV-1a) of a slot, h allows to chain several parts
+static unsigned int slotChecksum(const char* p, int len, unsigned int h=2166136261u)
+{
+  for (int k=0; k<len; k++)
+    {
+      h^=(unsigned char)p[k];
+      h*=16777619u;
+    }
+  return h;
+}
+
+// returns the current time of CLOCK_MONOTONIC in ns
+static long long monotonicTime()
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (long long)ts.tv_sec*1000000000LL+ts.tv_nsec;
+}
+
+
+// -------------------------------------------------------------------------
+//
+// Tcl interface
+//
+
+// Command to create a new gecoRingRecorder object
+//
+
+int geco_RingRecorderCmd(ClientData clientData, Tcl_Interp *interp,
+			 int objc,Tcl_Obj *const objv[])
+{
+  gecoRingRecorder* proc  = new gecoRingRecorder((gecoApp *)clientData);
+  return geco_CreateGecoProcessCmd(proc, objc, objv);
+}
+
+
+// Content of a ring file mapped in memory
+
+struct ringFile
+{
+  char*        map;
+  size_t       size;
+  size_t       slotOffset;
+  int          slotSize;
+  int          recordSize;
+  long long    nbrSlots;
+  long long    committed;
+  long long    first;         // first record of the valid window (counted from 1)
+  long long    last;          // last record of the valid window (0 if none)
+  gecoBinFile  bin;
+
+  ringFile() : map(NULL) {}
+
+  // returns the slot of record n or NULL if the slot doesn't hold a valid record n
+  const char* slot(long long n)
+  {
+    const char* p=map+slotOffset+(size_t)((n-1)%nbrSlots)*slotSize;
+    if ((long long)gecoBinFile::getLE(p, 8)!=n) return NULL;
+    if (gecoBinFile::getLE(p+8+recordSize, 4)!=slotChecksum(p, 8+recordSize)) return NULL;
+    return p;
+  }
+};
+
+// maps a ring file, reads its header and finds the valid window
+static int openRingFile(Tcl_Interp* interp, const char* fileName, ringFile* ring)
+{
+  int fd=open(fileName, O_RDONLY);
+  if (fd<0)
+    {
+      Tcl_AppendResult(interp, "couldn't open \"", fileName, "\": ",
+		       Tcl_PosixError(interp), NULL);
+      return TCL_ERROR;
+    }
+  struct stat st;
+  fstat(fd, &st);
+  ring->size=st.st_size;
+  ring->map=NULL;
+  if (ring->size>=(size_t)RingFixedHeader)
+    ring->map=(char *)mmap(NULL, ring->size, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if ((ring->map==NULL)||(ring->map==MAP_FAILED)||(memcmp(ring->map, RingMagic, 8)!=0))
+    {
+      if ((ring->map!=NULL)&&(ring->map!=MAP_FAILED)) munmap(ring->map, ring->size);
+      ring->map=NULL;
+      Tcl_AppendResult(interp, "not a geco ring file", NULL);
+      return TCL_ERROR;
+    }
+
+  const char* p=ring->map;
+  if ((int)gecoBinFile::getLE(p+8, 4)>RingVersion)
+    {
+      Tcl_AppendResult(interp, "unsupported version of geco ring file", NULL);
+      return TCL_ERROR;
+    }
+  ring->slotOffset = gecoBinFile::getLE(p+12, 4);
+  ring->slotSize   = gecoBinFile::getLE(p+16, 4);
+  ring->recordSize = gecoBinFile::getLE(p+20, 4);
+  ring->nbrSlots   = gecoBinFile::getLE(p+24, 8);
+  ring->committed  = gecoBinFile::getLE(p+RingCommitted, 8);
+  if ((ring->nbrSlots<1)||(ring->slotSize<12+ring->recordSize)||
+      (ring->slotOffset+(size_t)ring->nbrSlots*ring->slotSize>ring->size))
+    {
+      Tcl_AppendResult(interp, "inconsistent header in geco ring file", NULL);
+      return TCL_ERROR;
+    }
+
+  // header of the binary data file
+  FILE* file=fopen(fileName, "rb");
+  if (file==NULL)
+    {
+      Tcl_AppendResult(interp, "couldn't open \"", fileName, "\": ",
+		       Tcl_PosixError(interp), NULL);
+      return TCL_ERROR;
+    }
+  fseek(file, RingFixedHeader, SEEK_SET);
+  int ret=ring->bin.readHeader(interp, file);
+  fclose(file);
+  if (ret!=TCL_OK) return TCL_ERROR;
+  if (ring->bin.getRecordSize()!=ring->recordSize)
+    {
+      Tcl_AppendResult(interp, "inconsistent header in geco ring file", NULL);
+      return TCL_ERROR;
+    }
+
+  // the last valid record is the valid slot holding the highest index
+  ring->last=0;
+  for (long long k=0; k<ring->nbrSlots; k++)
+    {
+      long long n=gecoBinFile::getLE(ring->map+ring->slotOffset+(size_t)k*ring->slotSize, 8);
+      if ((n>ring->last)&&((n-1)%ring->nbrSlots==k)&&(ring->slot(n))) ring->last=n;
+    }
+
+  // the window goes back until an invalid (overwritten or torn) slot
+  ring->first=ring->last+1;
+  while ((ring->first>1)&&(ring->first>ring->last-ring->nbrSlots+1)&&(ring->slot(ring->first-1)))
+    ring->first--;
+  return TCL_OK;
+}
+
+int geco_RingFileCmd(ClientData clientData, Tcl_Interp *interp,
+		     int objc,Tcl_Obj *const objv[])
+{
+  Tcl_ResetResult(interp);
+
+  if (objc==1)
+    {
+      Tcl_WrongNumArgs(interp, 1, objv, "subcommand ?argument ...?");
+      return TCL_ERROR;
+    }
+
+  int index;
+  static CONST char* cmds[] = {"-help", "-info", "-dump", NULL};
+  static CONST char* help[] = {"returns header and valid window (file)",
+			       "writes valid window to a binary data file (file binFile)",
+			       NULL};
+  if (Tcl_GetIndexFromObj(interp, objv[1], cmds, "subcommand", '0', &index)!=TCL_OK)
+    return TCL_ERROR;
+
+  if (index==0)
+    {
+      if (objc!=2)
+	{
+	  Tcl_WrongNumArgs(interp, 2, objv, NULL);
+	  return TCL_ERROR;
+	}
+      gecoHelp(interp, "ringfile", "recovers ring files of ringrecorder", cmds, help);
+      return TCL_OK;
+    }
+
+  if ((index==1)&&(objc!=3))
+    {
+      Tcl_WrongNumArgs(interp, 2, objv, "file");
+      return TCL_ERROR;
+    }
+  if ((index==2)&&(objc!=4))
+    {
+      Tcl_WrongNumArgs(interp, 2, objv, "file binFile");
+      return TCL_ERROR;
+    }
+
+  ringFile ring;
+  if (openRingFile(interp, Tcl_GetString(objv[2]), &ring)!=TCL_OK)
+    {
+      if (ring.map) munmap(ring.map, ring.size);
+      return TCL_ERROR;
+    }
+
+  int      ret=TCL_OK;
+  Tcl_Obj* list;
+  FILE*    file;
+
+  switch (index)
+    {
+
+    case 1: // -info
+      list=ring.bin.headerDict();
+      Tcl_ListObjAppendElement(interp, list, Tcl_NewStringObj("slots", -1));
+      Tcl_ListObjAppendElement(interp, list, Tcl_NewWideIntObj(ring.nbrSlots));
+      Tcl_ListObjAppendElement(interp, list, Tcl_NewStringObj("committed", -1));
+      Tcl_ListObjAppendElement(interp, list, Tcl_NewWideIntObj(ring.committed));
+      Tcl_ListObjAppendElement(interp, list, Tcl_NewStringObj("first", -1));
+      Tcl_ListObjAppendElement(interp, list, Tcl_NewWideIntObj(ring.first));
+      Tcl_ListObjAppendElement(interp, list, Tcl_NewStringObj("last", -1));
+      Tcl_ListObjAppendElement(interp, list, Tcl_NewWideIntObj(ring.last));
+      Tcl_ListObjAppendElement(interp, list, Tcl_NewStringObj("records", -1));
+      Tcl_ListObjAppendElement(interp, list, Tcl_NewWideIntObj(ring.last-ring.first+1));
+      Tcl_SetObjResult(interp, list);
+      break;
+
+    case 2: // -dump
+      file=fopen(Tcl_GetString(objv[3]), "wb");
+      if (file==NULL)
+	{
+	  Tcl_AppendResult(interp, "couldn't open \"", Tcl_GetString(objv[3]), "\": ",
+			   Tcl_PosixError(interp), NULL);
+	  ret=TCL_ERROR;
+	  break;
+	}
+      {
+	// the header of the binary data file is copied as is
+	size_t    headerSize=12+gecoBinFile::getLE(ring.map+RingFixedHeader+8, 4);
+	bool      written=(fwrite(ring.map+RingFixedHeader, 1, headerSize, file)==headerSize);
+	long long records=0;
+	for (long long n=ring.first; (written)&&(n<=ring.last); n++)
+	  {
+	    const char* p=ring.slot(n);
+	    if (p==NULL) break;     // overwritten meanwhile by a running recorder
+	    written=(fwrite(p+8, 1, ring.recordSize, file)==(size_t)ring.recordSize);
+	    if (written) records++;
+	  }
+	int err=errno;
+	if ((fclose(file)!=0)||(!written))
+	  {
+	    if (!written) errno=err;
+	    Tcl_AppendResult(interp, "error writing \"", Tcl_GetString(objv[3]), "\": ",
+			     Tcl_PosixError(interp), NULL);
+	    ret=TCL_ERROR;
+	    break;
+	  }
+	Tcl_SetObjResult(interp, Tcl_NewWideIntObj(records));
+      }
+      break;
+
+    }
+
+  munmap(ring.map, ring.size);
+  return ret;
+}
+
+
+/**
+ * @brief Body of the thread flushing the ring file of a gecoRingRecorder to disk
+ * @param arg pointer to the gecoRingRecorder
+*/
+
+void* geco_RingSyncThread(void* arg)
+{
+  gecoRingRecorder* rr=(gecoRingRecorder *)arg;
+  long long period=(long long)rr->syncInterval*1000000LL;
+  long long next=monotonicTime()+period;
+
+  pthread_mutex_lock(&rr->syncMutex);
+  while (!rr->syncStop.load())
+    {
+      struct timespec ts;
+      ts.tv_sec  = next/1000000000LL;
+      ts.tv_nsec = next%1000000000LL;
+      pthread_cond_timedwait(&rr->syncCond, &rr->syncMutex, &ts);
+      if (rr->syncStop.load()) break;
+      if (monotonicTime()<next) continue;
+      pthread_mutex_unlock(&rr->syncMutex);
+      if ((msync(rr->map, rr->mapSize, MS_SYNC)!=0)&&(rr->syncError.load()==0))
+	rr->syncError.store(errno);
+      rr->syncs++;
+      pthread_mutex_lock(&rr->syncMutex);
+      next+=period;
+      if (next<monotonicTime()) next=monotonicTime()+period;
+    }
+  pthread_mutex_unlock(&rr->syncMutex);
+  return NULL;
+}
+
+// -------------------------------------------------------------------------
+
+
+// -------------------------------------------------------------------------
+//
+// class gecoRingRecorder : records data to a memory-mapped ring file
+//
+
+/**
+ * @brief Constructor
+ * @param App gecoApp in which the gecoRingRecorder lives
+*/
+
+gecoRingRecorder::gecoRingRecorder(gecoApp* App) :
+  gecoObj("Ring recorder", "ringrecorder", App),
+  gecoProcess("Ring recorder", "user", "ringrecorder", App),
+  saveTime(0.0),
+  fd(-1),
+  map(NULL),
+  mapSize(0),
+  slotOffset(0),
+  slotSize(0),
+  nbrSlots(0),
+  committed(0),
+  openError(0),
+  syncRunning(false),
+  syncStop(false),
+  syncs(0),
+  syncError(0),
+  dtRecord(0.1),
+  records(100000),
+  syncInterval(1000)
+{
+  activateOnStart=1;
+  fileName = new Tcl_DString;
+  header   = new Tcl_DString;
+  cut      = new Tcl_DString;
+  columns  = new Tcl_DString;
+  Tcl_DStringInit(fileName);
+  Tcl_DStringInit(header);
+  Tcl_DStringInit(cut);
+  Tcl_DStringInit(columns);
+  previousRing = new Tcl_DString;
+  Tcl_DStringInit(previousRing);
+  bin      = new gecoBinFile;
+  binRec   = new gecoBinRecord(App, bin);
+  cutExpr  = new gecoExpr(App, cut);
+
+  pthread_condattr_t attr;
+  pthread_condattr_init(&attr);
+  pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+  pthread_cond_init(&syncCond, &attr);
+  pthread_condattr_destroy(&attr);
+  pthread_mutex_init(&syncMutex, NULL);
+
+  addOption("-file", fileName, "returns/sets file name of the ring file");
+  addOption("-header", header, "returns/sets header of the file");
+  addOption("-columns", columns, "returns/sets columns recorded");
+  addOption("-cut", cut, "returns/sets filter on data to be recorded");
+  addOption("-dtRecord", &dtRecord, "returns/sets time interval between two recordings (s)");
+  addOption("-records", &records, "returns/sets number of records kept in the ring file");
+  addOption("-syncInterval", &syncInterval, "returns/sets interval between two syncs to disk (ms, 0 for none)");
+}
+
+
+/**
+ * @brief Destructor
+*/
+
+gecoRingRecorder::~gecoRingRecorder()
+{
+  closeFile();
+  pthread_cond_destroy(&syncCond);
+  pthread_mutex_destroy(&syncMutex);
+  delete binRec;
+  delete bin;
+  delete cutExpr;
+  Tcl_DStringFree(fileName);
+  Tcl_DStringFree(header);
+  Tcl_DStringFree(cut);
+  Tcl_DStringFree(columns);
+  Tcl_DStringFree(previousRing);
+  delete fileName;
+  delete header;
+  delete cut;
+  delete columns;
+  delete previousRing;
+}
+
+
+/*!
+ * @copydoc gecoProcess::cmd
+ *
+ * Compared to gecoProcess::cmd, gecoRingRecorder::cmd discards the compiled
+ * cut filter when it is changed and checks the settings of the ring file.
+ */
+
+int gecoRingRecorder::cmd(int &i, int objc,Tcl_Obj *const objv[])
+{
+  // first executes the command options defined in gecoProcess
+  int j=i;
+  int oldRecords=records;
+  int oldSyncInterval=syncInterval;
+  Tcl_DString oldColumns;
+  Tcl_DStringInit(&oldColumns);
+  Tcl_DStringAppend(&oldColumns, Tcl_DStringValue(columns), -1);
+  int index=gecoProcess::cmd(i,objc,objv);
+
+  if ((index==getOptionIndex("-cut"))&&(i==j+2)) cutExpr->invalidate();
+
+  if ((index==getOptionIndex("-columns"))&&(i==j+2))
+    {
+      gecoBinFile layout;
+      if (layout.setColumns(interp, Tcl_DStringValue(columns))!=TCL_OK)
+	{
+	  Tcl_DStringFree(columns);
+	  Tcl_DStringAppend(columns, Tcl_DStringValue(&oldColumns), -1);
+	  index=-1;
+	}
+    }
+
+  if ((index==getOptionIndex("-records"))&&(i==j+2)&&(records<1))
+    {
+      Tcl_AppendResult(interp, "number of records must be a positive integer", NULL);
+      records=oldRecords;
+      index=-1;
+    }
+
+  if ((index==getOptionIndex("-syncInterval"))&&(i==j+2)&&(syncInterval<0))
+    {
+      Tcl_AppendResult(interp, "sync interval must be positive or 0", NULL);
+      syncInterval=oldSyncInterval;
+      index=-1;
+    }
+
+  Tcl_DStringFree(&oldColumns);
+  return index;
+}
+
+
+/**
+ * @copydoc gecoProcess::handleEvent
+ *
+ * In addition to gecoProcess::handleEvent, gecoRingRecorder::handleEvent
+ * copies a record to the next slot of the ring file.
+ */
+
+void gecoRingRecorder::handleEvent(gecoEvent* ev)
+{
+  gecoProcess::handleEvent(ev);
+
+  // determines cut condition of set
+  int b=1;
+  if (!cutExpr->isEmpty()) cutExpr->exprBoolean(interp, &b);
+
+  if ((status!=Active)||((ev->getT()-saveTime)<dtRecord)||(!b)||(map==NULL)) return;
+  saveTime=ev->getT();
+
+  // record, checksum, then index of the slot and committed index
+  long long n=committed+1;
+  int       rs=bin->getRecordSize();
+  char*     p=map+slotOffset+(size_t)((n-1)%nbrSlots)*slotSize;
+  memcpy(p+8, binRec->build(interp), rs);
+  char idx[8];
+  gecoBinFile::putLE(idx, n, 8);
+  gecoBinFile::putLE(p+8+rs, slotChecksum(p+8, rs, slotChecksum(idx, 8)), 4);
+  atomic_thread_fence(memory_order_release);
+  memcpy(p, idx, 8);
+  atomic_thread_fence(memory_order_release);
+  gecoBinFile::putLE(map+RingCommitted, n, 8);
+  committed=n;
+}
+
+
+/**
+ * @copydoc gecoProcess::info
+ *
+ * In addition to gecoProcess::info, gecoRingRecorder::info adds the information
+ * about the ring file.
+ */
+
+Tcl_DString* gecoRingRecorder::info(const char* frontStr)
+{
+  gecoProcess::info(frontStr);
+  addInfo(frontStr, "File:                 ", Tcl_DStringValue(fileName));
+  addInfo(frontStr, "Header:               ", Tcl_DStringValue(header));
+  addInfo(frontStr, "Columns:              ", Tcl_DStringValue(columns));
+  addInfo(frontStr, "Record interval (s):  ", dtRecord);
+  addInfo(frontStr, "Records kept:         ", records);
+  addInfo(frontStr, "Sync interval (ms):   ", syncInterval);
+
+  char str[80];
+  sprintf(str, "%lld", committed);
+  addInfo(frontStr, "Records written:      ", str);
+  sprintf(str, "%lld", syncs.load());
+  addInfo(frontStr, "Syncs:                ", str);
+  if (map)
+    {
+      sprintf(str, "%ld kB (slot of %d bytes)", (long)(mapSize/1024), slotSize);
+      addInfo(frontStr, "File size:            ", str);
+    }
+  if (Tcl_DStringLength(previousRing)>0)
+    addInfo(frontStr, "Previous ring:        ", Tcl_DStringValue(previousRing));
+  if (openError!=0)
+    addInfo(frontStr, "Error:                ", strerror(openError));
+  else if (syncError.load()!=0)
+    addInfo(frontStr, "Error:                ", strerror(syncError.load()));
+  return infoStr;
+}
+
+
+/**
+ * @copydoc gecoProcess::terminate
+ *
+ * In addition to gecoProcess::terminate, gecoRingRecorder::terminate
+ * flushes and closes the ring file.
+ */
+
+void gecoRingRecorder::terminate(gecoEvent* ev)
+{
+  gecoProcess::terminate(ev);
+  closeFile();
+}
+
+
+/**
+ * @copydoc gecoProcess::activate
+ *
+ * In addition to gecoProcess::activate, gecoRingRecorder::activate
+ * creates the ring file, maps it in memory and starts the sync thread.
+ */
+
+void gecoRingRecorder::activate(gecoEvent* ev)
+{
+  gecoProcess::activate(ev);
+  closeFile();
+  saveTime=ev->getT();
+  committed=0;
+  syncs.store(0);
+  syncError.store(0);
+
+  Tcl_DString str;
+  Tcl_DStringInit(&str);
+  Tcl_DStringAppend(&str, "format \"", -1);
+  Tcl_DStringAppend(&str, Tcl_DStringValue(header), -1);
+  Tcl_DStringAppend(&str, "\"", -1);
+  Tcl_Eval(interp, Tcl_DStringValue(&str));
+  Tcl_DStringFree(&str);
+
+  // header of the binary data file
+  struct timespec ts;
+  clock_gettime(CLOCK_REALTIME, &ts);
+  long long start=gecoBinRecord::monotonicTime();
+  bin->setColumns(interp, Tcl_DStringValue(columns));
+  bin->buildHeader(&str, Tcl_GetStringResult(interp), start, ts.tv_sec+ts.tv_nsec/1e9);
+  Tcl_ResetResult(interp);
+
+  int rs=bin->getRecordSize();
+  slotSize=(8+rs+4+7) & ~7;
+  slotOffset=((RingFixedHeader+Tcl_DStringLength(&str)+RingPage-1)/RingPage)*RingPage;
+  nbrSlots=records;
+  mapSize=slotOffset+(size_t)nbrSlots*slotSize;
+
+  openError=keepPreviousRing();
+  if (openError!=0)
+    {
+      Tcl_DStringFree(&str);
+      return;
+    }
+  fd=open(Tcl_DStringValue(fileName), O_RDWR|O_CREAT|O_TRUNC, 0644);
+  if (fd<0) openError=errno;
+  else openError=posix_fallocate(fd, 0, mapSize);
+  if (openError!=0)
+    {
+      Tcl_DStringFree(&str);
+      closeFile();
+      return;
+    }
+  map=(char *)mmap(NULL, mapSize, PROT_READ|PROT_WRITE, MAP_SHARED, fd, 0);
+  if (map==MAP_FAILED)
+    {
+      openError=errno;
+      map=NULL;
+      Tcl_DStringFree(&str);
+      closeFile();
+      return;
+    }
+  openError=0;
+
+  // fixed header
+  memcpy(map, RingMagic, 8);
+  gecoBinFile::putLE(map+8,  RingVersion, 4);
+  gecoBinFile::putLE(map+12, slotOffset, 4);
+  gecoBinFile::putLE(map+16, slotSize, 4);
+  gecoBinFile::putLE(map+20, rs, 4);
+  gecoBinFile::putLE(map+24, nbrSlots, 8);
+  gecoBinFile::putLE(map+RingCommitted, 0, 8);
+  memcpy(map+RingFixedHeader, Tcl_DStringValue(&str), Tcl_DStringLength(&str));
+  Tcl_DStringFree(&str);
+  msync(map, slotOffset, MS_SYNC);
+
+  binRec->bind(start);
+
+  if (syncInterval>0)
+    {
+      syncStop.store(false);
+      syncRunning=(pthread_create(&syncThread, NULL, geco_RingSyncThread, this)==0);
+    }
+}
+
+
+/**
+ * @brief Renames the ring file if it holds valid records
+ * \return 0 in case of success and the errno of the failing rename otherwise
+ *
+ * The ring file is renamed by appending the first free suffix .1, .2, ...
+ * to its name. Other files are left to be overwritten.
+*/
+
+int gecoRingRecorder::keepPreviousRing()
+{
+  Tcl_DStringFree(previousRing);
+  ringFile ring;
+  int ret=openRingFile(interp, Tcl_DStringValue(fileName), &ring);
+  Tcl_ResetResult(interp);
+  if (ret!=TCL_OK)
+    {
+      if (ring.map) munmap(ring.map, ring.size);
+      return 0;
+    }
+  munmap(ring.map, ring.size);
+  if (ring.last==0) return 0;
+
+  Tcl_DString name;
+  Tcl_DStringInit(&name);
+  char suffix[30];
+  struct stat st;
+  for (int k=1; ; k++)
+    {
+      Tcl_DStringFree(&name);
+      Tcl_DStringAppend(&name, Tcl_DStringValue(fileName), -1);
+      sprintf(suffix, ".%d", k);
+      Tcl_DStringAppend(&name, suffix, -1);
+      if (stat(Tcl_DStringValue(&name), &st)!=0) break;
+    }
+  ret=0;
+  if (rename(Tcl_DStringValue(fileName), Tcl_DStringValue(&name))!=0)
+    ret=errno;
+  else
+    {
+      Tcl_DStringFree(previousRing);
+      Tcl_DStringAppend(previousRing, Tcl_DStringValue(&name), -1);
+      if (verbose)
+	Tcl_VarEval(interp, "cons \"    previous ring file kept as ",
+		    Tcl_DStringValue(&name), "\"", NULL);
+    }
+  Tcl_DStringFree(&name);
+  return ret;
+}
+
+
+/**
+ * @brief Stops the sync thread, flushes and closes the ring file
+*/
+
+void gecoRingRecorder::closeFile()
+{
+  binRec->unbind();
+  if (syncRunning)
+    {
+      pthread_mutex_lock(&syncMutex);
+      syncStop.store(true);
+      pthread_cond_signal(&syncCond);
+      pthread_mutex_unlock(&syncMutex);
+      pthread_join(syncThread, NULL);
+      syncRunning=false;
+    }
+  if (map)
+    {
+      if (syncInterval>0) msync(map, mapSize, MS_SYNC);
+      munmap(map, mapSize);
+      map=NULL;
+    }
+  if (fd>=0) close(fd);
+  fd=-1;
+}
@@ -0,0 +1,225 @@
+// This may look like C code, but it is really -*- C++ -*-
+// ----------------------------------------------------------------
+//
+// Header file for class gecoRingRecorder
+//
+// (c) Rolf Wuthrich
+//     2026 Concordia University
+//
+// author:  agent
+// email:   agent@local
+// version: v1
+//
+// This software is copyright under the BSD license
+//
+// ---------------------------------------------------------------
+// history:
+// ---------------------------------------------------------------
+// Date       Modification                     Author
+// ---------------------------------------------------------------
+// 17.10.2026 Creation                         agent
+// 18.10.2026 Previous ring kept on activation  agent
+//
+// ---------------------------------------------------------------
+/*! \file */
+
+#ifndef gecoRingRecorder_SEEN_
+#define gecoRingRecorder_SEEN_
+
+#include <tcl8.6/tcl.h>
+#include <pthread.h>
+#include <atomic>
+#include "gecoProcess.h"
+#include "gecoExpr.h"
+#include "gecoBinFile.h"
+#include "gecoBinRecord.h"
+#include "gecoApp.h"
+
+using namespace std;
+
+
+// -----------------------------------------------------------------------
+//
+// Tcl interface
+//
+
+/**
+ * @brief C++ implementation of the Tcl command to create a gecoRingRecorder object
+ * @param clientData pointer to the gecoApp in which the gecoRingRecorder instance will live
+ * @param interp Tcl interpreter in which the Tcl command is executed
+ * @param objc number of arguments of the Tcl command
+ * @param objv arguments of the the Tcl command
+ * \return TCL_OK if the execution of the Tcl command is successful and TCL_ERROR otherwise
+ */
+
+int geco_RingRecorderCmd(ClientData clientData, Tcl_Interp *interp,
+			 int objc,Tcl_Obj *const objv[]);
+
+/**
+ * @brief C++ implementation of the Tcl command 'ringfile' recovering ring files
+ * @param clientData pointer to the gecoApp
+ * @param interp Tcl interpreter in which the Tcl command is executed
+ * @param objc number of arguments of the Tcl command
+ * @param objv arguments of the the Tcl command
+ * \return TCL_OK if the execution of the Tcl command is successful and TCL_ERROR otherwise
+ */
+
+int geco_RingFileCmd(ClientData clientData, Tcl_Interp *interp,
+		     int objc,Tcl_Obj *const objv[]);
+
+void* geco_RingSyncThread(void* arg);
+
+
+// -----------------------------------------------------------------------
+//
+// class gecoRingRecorder : records data to a memory-mapped ring file
+//
+
+/**
+ * @brief A gecoProcess recording data to a crash-safe memory-mapped ring file
+ * \author agent
+ * \date 2026
+ *
+ * The gecoRingRecorder class allows to create a gecoProcess recording typed
+ * columns (as the binary format of gecoFileStream) to a file of fixed size mapped
+ * in memory. The file is organised as a ring of '-records' slots: once full, the
+ * oldest record is overwritten. Recording a record is a copy to memory, without
+ * system call. The operating system writes the memory to the file, also if the
+ * geco application crashes.
+ *
+ * The geco_RingRecorderCmd() is the C++ implementation for the Tcl command to
+ * create gecoRingRecorder objects. This Tcl command is already available in
+ * the Tcl interpreter run by an instance of gecoApp under the name 'ringrecorder'.
+ *
+ * Associated Tcl command
+ * ----------------------
+ * Every gecoRingRecorder is associated to a Tcl command. The associated Tcl command
+ * is created during the construction of an instance of gecoRingRecorder by its
+ * parent class. The Tcl command is created in the Tcl interpreter
+ * run by the gecoApp in which gecoRingRecorder lives.
+ *
+ * The gecoRingRecorder class extends the subcommands from gecoObj and gecoProcess
+ * by the following subcommands
+ *
+ * Sub-command       | Short description
+ * ----------------- | ------------------
+ * -file             | returns/sets file name of the ring file
+ * -header           | returns/sets header of the file
+ * -columns          | returns/sets columns recorded
+ * -cut              | returns/sets filter on data to be recorded
+ * -dtRecord         | returns/sets time interval between two recordings (s)
+ * -records          | returns/sets number of records kept in the ring file
+ * -syncInterval     | returns/sets interval between two syncs to disk (ms, 0 for none)
+ *
+ * '-columns' is declared as for the binary format of gecoFileStream (see gecoBinRecord).
+ * The settings are taken into account at the next activation, which creates the file anew.
+ * If the file is a ring file still holding valid records (e.g. after a crash of the geco
+ * application with '-activateOnStart on'), it is first renamed by appending the first
+ * free suffix .1, .2, ... to its name. '-info' reports the name under which it was kept.
+ * If it can't be renamed, the ring recorder doesn't record and '-info' reports the error.
+ *
+ * The space of the ring file is allocated on activation (posix_fallocate), so that a full
+ * disk is reported by '-info' instead of failing when the records are written.
+ *
+ * Layout of the ring file
+ * -----------------------
+ * Bytes        | Content
+ * ------------ | ------------------------------------------------------
+ * 8            | magic string 'GECORNG1'
+ * 4            | version (uint32)
+ * 4            | offset of the first slot (uint32)
+ * 4            | size of a slot (uint32)
+ * 4            | size of a record (uint32)
+ * 8            | number of slots (uint64)
+ * 8            | committed index: number of records written (uint64)
+ * 24           | reserved
+ * ...          | header of a binary data file (see gecoBinFile)
+ * ...          | slots, from the offset of the first slot on
+ *
+ * Record n (counted from 1) is stored in slot (n-1) modulo the number of slots.
+ * A slot holds the index n (uint64), the record and a checksum (uint32) of both.
+ * The index of a slot and the committed index are updated after the record: a
+ * crash loses at most the record being written. With a '-syncInterval' larger than 0,
+ * a background thread flushes the file to disk (msync) at this interval, so that
+ * also a power loss loses at most the records of the last interval.
+ *
+ * Recovery
+ * --------
+ * The Tcl command 'ringfile' extracts the valid window of records of a ring file
+ *
+ * Sub-command       | Short description
+ * ----------------- | ------------------
+ * -info             | returns the header dictionary and the valid window (file)
+ * -dump             | writes the valid window to a binary data file (file binFile)
+ *
+ * '-dump' returns the number of records written, fewer than the valid window if
+ * a running recorder overwrote some of them meanwhile. The dumped file is read
+ * with the Tcl command 'binfile'.
+ *
+ * Example
+ * -------
+ * \code
+ * ringrecorder -file run.ring -columns {t {V double} {n int}} -dtRecord 0 -records 1000000
+ * ...
+ * ringfile -dump run.ring run.bin
+ * binfile -totext run.bin run.txt
+ * \endcode
+ */
+
+class gecoRingRecorder : public gecoProcess
+{
+private:
+
+  gecoExpr*      cutExpr;         // compiled cut filter
+  double         saveTime;
+
+  gecoBinFile*   bin;             // layout of the records
+  gecoBinRecord* binRec;          // builds the records
+  int            fd;              // file descriptor of the ring file
+  char*          map;             // ring file mapped in memory
+  size_t         mapSize;         // size of the mapping
+  size_t         slotOffset;      // offset of the first slot
+  int            slotSize;        // size of a slot
+  long long      nbrSlots;        // number of slots
+  long long      committed;       // number of records written
+  int            openError;       // errno of the last opening of the file (0 if none)
+  Tcl_DString*   previousRing;    // name under which the previous ring file was kept
+
+  // sync thread
+  pthread_t        syncThread;
+  pthread_mutex_t  syncMutex;
+  pthread_cond_t   syncCond;
+  bool             syncRunning;
+  atomic<bool>     syncStop;
+  atomic<long long> syncs;        // number of msync
+  atomic<int>      syncError;     // errno of the first failing msync (0 if none)
+
+  void           closeFile();
+  int            keepPreviousRing();
+
+  friend void*   geco_RingSyncThread(void* arg);
+
+protected:
+
+  Tcl_DString*   fileName;        // file name
+  Tcl_DString*   header;          // header of data file
+  Tcl_DString*   cut;             // cut filter
+  Tcl_DString*   columns;         // columns recorded
+  double         dtRecord;
+  int            records;         // number of records kept
+  int            syncInterval;    // interval between two msync (ms)
+
+public:
+
+  gecoRingRecorder(gecoApp* App);
+  ~gecoRingRecorder();
+
+  virtual int  cmd(int &i,int objc,Tcl_Obj *const objv[]);
+  virtual void handleEvent(gecoEvent* ev);
+  virtual Tcl_DString* info(const char* frontStr = "");
+
+  virtual void terminate(gecoEvent* ev);
+  virtual void activate(gecoEvent* ev);
+};
+
+#endif /* gecoRingRecorder_SEEN_ */
@@ -0,0 +1,132 @@
+// ---------------------------------------------------------------
+//
+// Definition of the class gecoScript
+//
+// (c) Rolf Wuthrich
+//     2026 Concordia University
+//
+// author:  agent
+// email:   agent@local
+// version: v1
+//
+// This software is copyright under the BSD license
+//
+// ---------------------------------------------------------------
+// history:
+// ---------------------------------------------------------------
+// Date       Modification                     Author
+// ---------------------------------------------------------------
+// 17.10.2026 Creation                         agent
+//
+// ---------------------------------------------------------------
+
+#include <tcl.h>
+#include "gecoScript.h"
+
+using namespace std;
+
+
+// ---------------------------------------------------------------
+//
+// class gecoScript : Tcl script with cached bytecode
+//
+
+
+/**
+ * @brief Constructor
+ * @param Source Tcl_DString containing the script
+ * @param Prefix string prepended to Source
+ * @param Suffix string appended to Source
+ *
+ * Prefix and Suffix must be string literals (they are not copied).
+*/
+
+gecoScript::gecoScript(Tcl_DString* Source, const char* Prefix, const char* Suffix) :
+  source(Source),
+  prefix(Prefix),
+  suffix(Suffix),
+  script(NULL)
+{
+}
+
+
+/**
+ * @brief Destructor
+*/
+
+gecoScript::~gecoScript()
+{
+  invalidate();
+}
+
+
+/**
+ * @brief Discards the cached Tcl_Obj
+ *
+ * Must be called whenever the source Tcl_DString is changed.
+*/
+
+void gecoScript::invalidate()
+{
+  if (script) Tcl_DecrRefCount(script);
+  script = NULL;
+}
+
+
+/**
+ * @brief Returns the cached Tcl_Obj, rebuilding it if needed
+*/
+
+Tcl_Obj* gecoScript::getObj()
+{
+  if (script==NULL)
+    {
+      script = Tcl_NewStringObj(prefix, -1);
+      Tcl_AppendToObj(script, Tcl_DStringValue(source), Tcl_DStringLength(source));
+      Tcl_AppendToObj(script, suffix, -1);
+      Tcl_IncrRefCount(script);
+    }
+  return script;
+}
+
+
+/**
+ * @brief Evaluates the script
+ * @param interp Tcl interpreter in which the script is evaluated
+ * \return the completion code of Tcl_EvalObjEx
+ *
+ * The result of the script is left in the Tcl interpreter.
+*/
+
+int gecoScript::eval(Tcl_Interp* interp)
+{
+  return Tcl_EvalObjEx(interp, getObj(), 0);
+}
+
+
+/**
+ * @brief Evaluates the script as a Tcl expression
+ * @param interp Tcl interpreter in which the expression is evaluated
+ * @param result is set to the result of the expression (refcount incremented)
+ * \return TCL_OK in case of success and TCL_ERROR otherwise
+ *
+ * The caller must call Tcl_DecrRefCount on result in case of success.
+*/
+
+int gecoScript::expr(Tcl_Interp* interp, Tcl_Obj** result)
+{
+  return Tcl_ExprObj(interp, getObj(), result);
+}
+
+
+/**
+ * @brief Evaluates the script as a boolean Tcl expression
+ * @param interp Tcl interpreter in which the expression is evaluated
+ * @param b is set to the boolean value of the expression
+ * \return TCL_OK in case of success and TCL_ERROR otherwise
+*/
+
+int gecoScript::exprBoolean(Tcl_Interp* interp, int* b)
+{
+  return Tcl_ExprBooleanObj(interp, getObj(), b);
+}
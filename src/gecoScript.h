@@ -0,0 +1,89 @@
+// This may look like C code, but it is really -*- C++ -*-
+// ----------------------------------------------------------------
+//
+// Header file for class gecoScript
+//
+// (c) Rolf Wuthrich
+//     2026 Concordia University
+//
+// author:  agent
+// email:   agent@local
+// version: v1
+//
+// This software is copyright under the BSD license
+//
+// ---------------------------------------------------------------
+// history:
+// ---------------------------------------------------------------
+// Date       Modification                     Author
+// ---------------------------------------------------------------
+// 17.10.2026 Creation                         agent
+//
+// ---------------------------------------------------------------
+/*! \file */
+
+#ifndef gecoScript_SEEN_
+#define gecoScript_SEEN_
+
+#include <tcl8.6/tcl.h>
+
+using namespace std;
+
+
+// -----------------------------------------------------------------------
+//
+// class gecoScript : Tcl script with cached bytecode
+//
+
+/**
+ * @brief Tcl script or expression evaluated repeatedly in the geco process loop
+ * \author agent
+ * \date 2026
+ *
+ * A gecoScript keeps a persistent Tcl_Obj built from a Tcl_DString (typically
+ * the variable of a subcommand defined with gecoObj::addOption), optionally
+ * wrapped between a prefix and a suffix (e.g. 'format "' and '"').
+ *
+ * The Tcl_Obj is evaluated with Tcl_EvalObjEx or Tcl_ExprObj so that Tcl
+ * compiles it once and reuses the bytecode at every further evaluation.
+ *
+ * The gecoScript does not monitor its Tcl_DString. The owner must call
+ * gecoScript::invalidate whenever the Tcl_DString is changed (usually in its
+ * cmd method when the corresponding subcommand sets a new value). The Tcl_Obj
+ * is rebuilt at the next evaluation.
+ *
+ * Example
+ * -------
+ * \code
+ * userScript = new gecoScript(userScriptStr);
+ * ...
+ * userScript->eval(interp);
+ * \endcode
+ */
+
+class gecoScript
+{
+
+private:
+
+  Tcl_DString*   source;        // source of the script
+  const char*    prefix;        // string prepended to source
+  const char*    suffix;        // string appended to source
+  Tcl_Obj*       script;        // cached Tcl_Obj (NULL if invalidated)
+
+public:
+
+  gecoScript(Tcl_DString* Source, const char* Prefix = "", const char* Suffix = "");
+  ~gecoScript();
+
+  void      invalidate();
+  Tcl_Obj*  getObj();
+
+  int       eval(Tcl_Interp* interp);
+  int       expr(Tcl_Interp* interp, Tcl_Obj** result);
+  int       exprBoolean(Tcl_Interp* interp, int* b);
+
+  bool      isEmpty() {return Tcl_DStringLength(source)==0;}  /*!< Returns true if the source is empty */
+};
+
+#endif /* gecoScript_SEEN_ */
@@ -19,12 +19,14 @@
 // ---------------------------------------------------------------
 // 06.11.2020 Creation                         R. Wuthrich
 // 08.12.2020 Added doxygen documentation      R. Wuthrich
+// 17.10.2026 Output written to signal bus     agent
 //
 // ---------------------------------------------------------------
 
 #include <tcl.h>
 #include <cstring>
 #include "gecoSensor.h"
+#include "gecoSignal.h"
 #include "gecoApp.h"
 
 using namespace std;
@@ -49,7 +51,8 @@ using namespace std;
 
 gecoSensor::gecoSensor(const char* sensorName, const char* sensorCmd, gecoApp* App) :
   gecoObj(sensorName, sensorCmd, App),
-  gecoProcess(sensorName, "user", sensorCmd, App)
+  gecoProcess(sensorName, "user", sensorCmd, App),
+  output(NULL)
 {
   TclVar = new Tcl_DString;
   Tcl_DStringInit(TclVar);
@@ -64,6 +67,7 @@ gecoSensor::gecoSensor(const char* sensorName, const char* sensorCmd, gecoApp* A
 
 gecoSensor::~gecoSensor()
 {
+  app->getSignalBus()->detach(output);
   Tcl_DStringFree(TclVar);
   delete TclVar;
 }
@@ -73,14 +77,38 @@ gecoSensor::~gecoSensor()
  * @copydoc gecoProcess::cmd 
  *
  * Compared to gecoProcess::cmd, gecoSensor::cmd adds the processing of
- * the new subcommands of gecoSensor.
+ * the new subcommands of gecoSensor. It attaches the gecoSensor to the
+ * signal of the gecoSignalBus named by '-TclVariable'.
  */
 
 int gecoSensor::cmd(int &i,int objc,Tcl_Obj *const objv[])
 {
   // executes the command options defined in gecoProcess
+  int j=i;
+  Tcl_DString oldVar;
+  Tcl_DStringInit(&oldVar);
+  Tcl_DStringAppend(&oldVar, Tcl_DStringValue(TclVar), -1);
   int index=gecoProcess::cmd(i,objc,objv);
 
+  if ((index==getOptionIndex("-TclVariable"))&&(i==j+2))
+    {
+      gecoSignal* sig=NULL;
+      if (Tcl_DStringLength(TclVar)!=0)
+	sig=app->getSignalBus()->attach(Tcl_DStringValue(TclVar), Signal_double);
+      if ((sig==NULL)&&(Tcl_DStringLength(TclVar)!=0))
+	{
+	  Tcl_DStringFree(TclVar);
+	  Tcl_DStringAppend(TclVar, Tcl_DStringValue(&oldVar), -1);
+	  index=-1;
+	}
+      else
+	{
+	  app->getSignalBus()->detach(output);
+	  output=sig;
+	}
+    }
+
+  Tcl_DStringFree(&oldVar);
   return index;
 }
 
@@ -90,7 +118,7 @@ int gecoSensor::cmd(int &i,int objc,Tcl_Obj *const objv[])
  *
  * In addition to gecoProcess::handleEvent, gecoSensor::handleEvent implements
  * the call to gecoSensor::readSensor in order to read the sensor signal and copy
- * it's output to the associated Tcl variable.
+ * it's output to the associated signal of the gecoSignalBus.
  */
 
 void gecoSensor::handleEvent(gecoEvent* ev)
@@ -99,10 +127,9 @@ void gecoSensor::handleEvent(gecoEvent* ev)
 
   if (status!=Active) return;
 
-  // calls the sensor read procedure and fills the Tcl variable
-  char str[80];
-  sprintf(str,"%f", readSensor());
-  Tcl_SetVar(interp, Tcl_DStringValue(TclVar), str, 0);
+  // calls the sensor read procedure and fills the signal
+  double y=readSensor();
+  if (output) output->setDouble(y);
 }
 
 
@@ -20,6 +20,7 @@
 // ---------------------------------------------------------------
 // 06.11.2020 Creation                         R. Wuthrich
 // 08.12.2020 Added doxygen documentation      R. Wuthrich
+// 17.10.2026 Output written to signal bus     agent
 //
 // ---------------------------------------------------------------
 
@@ -30,6 +31,8 @@
 #include "gecoProcess.h"
 #include "gecoEvent.h"
 
+class gecoSignal;            // forward definition
+
 using namespace std;
 
 
@@ -53,7 +56,7 @@ using namespace std;
  * implement the sensor signal reading. This function is called
  * by gecoSensor::handleEvent at each pass of the geco process loop.
  * The return value of gecoSensor::readSensor is then stored into a
- * Tcl variable which is associated to the gecoSensor object.
+ * signal of the gecoSignalBus which is associated to the gecoSensor object.
  *
  * Associated Tcl command
  * ----------------------
@@ -77,6 +80,11 @@ using namespace std;
  * subcommand '-TclVariable'. The gecoSensor updates this variable
  * in the gecoSensor::handleEvent method using the gecoSensor::readSensor method,
  * which has to be implemented by the children of gecoSensor.
+ *
+ * The reading is a double signal of the gecoSignalBus (see gecoSignal), mirrored
+ * to the Tcl variable. The other gecoProcess read the signal directly, without
+ * formatting or parsing strings; Tcl scripts read the mirrored value, at full
+ * precision.
  */
 
 class gecoSensor : public gecoProcess
@@ -85,6 +93,7 @@ class gecoSensor : public gecoProcess
 protected:
 
   Tcl_DString*   TclVar;             // Linked Tcl variable
+  gecoSignal*    output;             // signal of the gecoSignalBus named by TclVar
 
 public:
 
@@ -0,0 +1,480 @@
+// ---------------------------------------------------------------
+//
+// Definition of the classes gecoSignal and gecoSignalBus
+//
+// (c) Rolf Wuthrich
+//     2026 Concordia University
+//
+// author:  agent
+// email:   agent@local
+// version: v1
+//
+// This software is copyright under the BSD license
+//
+// ---------------------------------------------------------------
+// history:
+// ---------------------------------------------------------------
+// Date       Modification                     Author
+// ---------------------------------------------------------------
+// 17.10.2026 Creation                         agent
+// 18.10.2026 Mirrored to plain Tcl variables  agent
+// 18.10.2026 Mirrored at full precision       agent
+//
+// ---------------------------------------------------------------
+
+#include <tcl.h>
+#include <cstdio>
+#include <cstring>
+#include "gecoSignal.h"
+#include "gecoApp.h"
+
+using namespace std;
+
+
+// ---------------------------------------------------------------
+//
+// Types of signals
+//
+
+const char* SignalTypeStr[] = {"double", "int", "bool", NULL};
+
+static const int SignalTraceFlags = TCL_GLOBAL_ONLY|TCL_TRACE_READS|TCL_TRACE_WRITES|TCL_TRACE_UNSETS;
+
+
+// ---------------------------------------------------------------
+//
+// class gecoSignal : typed numeric signal
+//
+
+
+/**
+ * @brief Constructor
+ * @param Name name of the signal
+ * @param Type type of the signal (Signal_double, Signal_int or Signal_bool)
+*/
+
+gecoSignal::gecoSignal(const char* Name, int Type) :
+  type(Type),
+  dValue(0.0),
+  iValue(0),
+  users(0),
+  declared(false),
+  dirty(false),
+  stale(false),
+  mirroring(false)
+{
+  name = new Tcl_DString;
+  Tcl_DStringInit(name);
+  Tcl_DStringAppend(name, Name, -1);
+}
+
+
+/**
+ * @brief Destructor
+*/
+
+gecoSignal::~gecoSignal()
+{
+  Tcl_DStringFree(name);
+  delete name;
+}
+
+
+/**
+ * @brief Sets the signal to v
+ * @param v new value of the signal
+ *
+ * The value is converted to the type of the signal.
+*/
+
+void gecoSignal::setDouble(double v)
+{
+  switch (type)
+    {
+    case Signal_double:
+      dValue = v;
+      break;
+    case Signal_int:
+      iValue = (int)v;
+      break;
+    case Signal_bool:
+      iValue = (v!=0.0) ? 1 : 0;
+      break;
+    }
+  dirty = true;
+  stale = true;
+}
+
+
+/**
+ * @brief Sets the signal to v
+ * @param v new value of the signal
+ *
+ * The value is converted to the type of the signal.
+*/
+
+void gecoSignal::setInt(int v)
+{
+  switch (type)
+    {
+    case Signal_double:
+      dValue = v;
+      break;
+    case Signal_int:
+      iValue = v;
+      break;
+    case Signal_bool:
+      iValue = (v!=0) ? 1 : 0;
+      break;
+    }
+  dirty = true;
+  stale = true;
+}
+
+
+/**
+ * @brief Sets the Tcl variable of the signal to its value
+ * @param interp Tcl interpreter in which the Tcl variable lives
+ *
+ * The value is set as a number object, so that doubles keep their full
+ * precision when read as a string. Fires the write traces of the Tcl
+ * variable, except when called from a trace of the Tcl variable.
+*/
+
+void gecoSignal::mirror(Tcl_Interp* interp)
+{
+  Tcl_Obj* value;
+  if (type==Signal_double)
+    value = Tcl_NewDoubleObj(dValue);
+  else
+    value = Tcl_NewIntObj(iValue);
+  stale = false;
+  mirroring = true;
+  Tcl_SetVar2Ex(interp, getName(), NULL, value, TCL_GLOBAL_ONLY);
+  mirroring = false;
+}
+
+
+/**
+ * @brief Trace procedure of the Tcl variable of a signal
+ *
+ * A read updates the Tcl variable if the signal changed since it was last mirrored.
+ * A write of a value convertible to the type of the signal updates the signal.
+ * An unset removes the Tcl variable but keeps the trace, like for any other variable
+ * the next write creates it again.
+*/
+
+char* gecoSignal::traceProc(ClientData clientData, Tcl_Interp* interp,
+			    const char* name1, const char* name2, int flags)
+{
+  gecoSignal* sig = (gecoSignal *)clientData;
+
+  if (flags & TCL_TRACE_READS)
+    {
+      if (sig->stale) sig->mirror(interp);
+      return NULL;
+    }
+
+  if (flags & TCL_TRACE_WRITES)
+    {
+      if (sig->mirroring) return NULL;
+      Tcl_Obj* obj=Tcl_GetVar2Ex(interp, sig->getName(), NULL, TCL_GLOBAL_ONLY);
+      if (obj==NULL) return NULL;
+      double d;
+      int    b;
+      switch (sig->type)
+	{
+	case Signal_double:
+	  if (Tcl_GetDoubleFromObj(NULL, obj, &d)==TCL_OK) sig->dValue=d;
+	  break;
+	case Signal_int:
+	  if (Tcl_GetIntFromObj(NULL, obj, &b)==TCL_OK) sig->iValue=b;
+	  break;
+	case Signal_bool:
+	  if (Tcl_GetBooleanFromObj(NULL, obj, &b)==TCL_OK) sig->iValue=b;
+	  break;
+	}
+      sig->dirty=false;
+      sig->stale=false;
+      return NULL;
+    }
+
+  if ((flags & TCL_TRACE_DESTROYED) && !(flags & TCL_INTERP_DESTROYED))
+    Tcl_TraceVar(interp, sig->getName(), SignalTraceFlags, gecoSignal::traceProc, sig);
+  return NULL;
+}
+
+
+// ---------------------------------------------------------------
+//
+// class gecoSignalBus : store of the typed numeric signals
+//
+
+
+/**
+ * @brief Constructor
+ * @param App gecoApp in which the gecoSignalBus lives
+ *
+ * The constructor creates the Tcl command 'signals' via the call of
+ * the constructor of gecoObj.
+*/
+
+gecoSignalBus::gecoSignalBus(gecoApp* App) :
+  gecoObj("Signal bus", "signals", App, false)
+{
+  Tcl_InitHashTable(&signalByName, TCL_STRING_KEYS);
+
+  addOption("-list", "lists all signals");
+  addOption("-create", "creates a signal (name ?double|int|bool?)");
+  addOption("-remove", "removes a signal created with -create");
+}
+
+
+/**
+ * @brief Destructor
+ *
+ * Detaches and deletes all remaining signals.
+*/
+
+gecoSignalBus::~gecoSignalBus()
+{
+  while (!signals.empty()) remove(signals.back());
+  Tcl_DeleteHashTable(&signalByName);
+}
+
+
+/*!
+ * @copydoc gecoObj::cmd
+ *
+ * Compared to gecoObj::cmd, gecoSignalBus::cmd adds the processing of
+ * the new subcommands of gecoSignalBus.
+ */
+
+int gecoSignalBus::cmd(int &i, int objc,Tcl_Obj *const objv[])
+{
+  // first executes the command options defined in gecoObj
+  int index=gecoObj::cmd(i,objc,objv);
+
+  if (index==getOptionIndex("-list"))
+    {
+      Tcl_Obj* list=Tcl_NewListObj(0, NULL);
+      for (int k=0; k<(int)signals.size(); k++)
+	{
+	  gecoSignal* sig=signals[k];
+	  Tcl_Obj* item=Tcl_NewListObj(0, NULL);
+	  Tcl_ListObjAppendElement(interp, item, Tcl_NewStringObj(sig->getName(), -1));
+	  Tcl_ListObjAppendElement(interp, item, Tcl_NewStringObj(SignalTypeStr[sig->getType()], -1));
+	  if (sig->getType()==Signal_double)
+	    Tcl_ListObjAppendElement(interp, item, Tcl_NewDoubleObj(sig->getDouble()));
+	  else
+	    Tcl_ListObjAppendElement(interp, item, Tcl_NewIntObj(sig->getInt()));
+	  Tcl_ListObjAppendElement(interp, item, Tcl_NewIntObj(sig->getUsers()));
+	  Tcl_ListObjAppendElement(interp, list, item);
+	}
+      Tcl_SetObjResult(interp, list);
+      i++;
+    }
+
+  if (index==getOptionIndex("-create"))
+    {
+      if (i+1>=objc)
+	{
+	  Tcl_WrongNumArgs(interp, i+1, objv, "name ?double|int|bool?");
+	  return -1;
+	}
+      int type=Signal_double;
+      int n=2;
+      if ((i+2<objc)&&(Tcl_GetString(objv[i+2])[0]!='-'))
+	{
+	  if (Tcl_GetIndexFromObj(interp, objv[i+2], SignalTypeStr, "type", 0, &type)!=TCL_OK)
+	    return -1;
+	  n=3;
+	}
+      const char* sigName=Tcl_GetString(objv[i+1]);
+      gecoSignal* sig=find(sigName);
+      if ((sig!=NULL)&&(sig->declared))
+	{
+	  Tcl_AppendResult(interp, "signal ", sigName, " already exists", NULL);
+	  return -1;
+	}
+      if ((sig!=NULL)&&(sig->getType()!=type))
+	{
+	  Tcl_AppendResult(interp, "signal ", sigName, " already exists with type ",
+			   SignalTypeStr[sig->getType()], NULL);
+	  return -1;
+	}
+      sig=attach(sigName, type);
+      if (sig==NULL) return -1;
+      sig->declared=true;
+      i=i+n;
+    }
+
+  if (index==getOptionIndex("-remove"))
+    {
+      if (i+1>=objc)
+	{
+	  Tcl_WrongNumArgs(interp, i+1, objv, "name");
+	  return -1;
+	}
+      const char* sigName=Tcl_GetString(objv[i+1]);
+      gecoSignal* sig=find(sigName);
+      if ((sig==NULL)||(!sig->declared))
+	{
+	  Tcl_AppendResult(interp, "no signal ", sigName, " created with -create", NULL);
+	  return -1;
+	}
+      sig->declared=false;
+      detach(sig);
+      i=i+2;
+    }
+
+  return index;
+}
+
+
+/**
+ * @brief Attaches a user to a signal
+ * @param name name of the signal
+ * @param type type of the signal if it has to be created
+ * \return the gecoSignal or NULL in case of error (error message left in the Tcl interpreter)
+ *
+ * If the signal does not exist, it is created with the requested type and mirrored
+ * to the Tcl variable of the same name. If this Tcl variable already exists and holds
+ * a value of the requested type, the signal is initialized with it. If it does not
+ * exist, it is created with the value of the signal.
+ *
+ * If the signal exists, it is returned with its own type, whatever the requested type.
+ *
+ * Every call to gecoSignalBus::attach must be balanced by a call to gecoSignalBus::detach.
+*/
+
+gecoSignal* gecoSignalBus::attach(const char* name, int type)
+{
+  gecoSignal* sig=find(name);
+  if (sig!=NULL)
+    {
+      sig->users++;
+      return sig;
+    }
+
+  // a native variable not belonging to the gecoSignalBus (e.g. the time t) can't become a signal
+  if (app->findNativeVar(name))
+    {
+      Tcl_AppendResult(interp, "can't use ", name, " as signal: variable is reserved", NULL);
+      return NULL;
+    }
+
+  sig=new gecoSignal(name, type);
+
+  // initializes the signal with the current value of the Tcl variable
+  Tcl_Obj* obj=Tcl_GetVar2Ex(interp, name, NULL, TCL_GLOBAL_ONLY);
+  if (obj)
+    {
+      double d;
+      int    b;
+      switch (type)
+	{
+	case Signal_double:
+	  if (Tcl_GetDoubleFromObj(NULL, obj, &d)==TCL_OK) sig->dValue=d;
+	  break;
+	case Signal_int:
+	  if (Tcl_GetIntFromObj(NULL, obj, &b)==TCL_OK) sig->iValue=b;
+	  break;
+	case Signal_bool:
+	  if (Tcl_GetBooleanFromObj(NULL, obj, &b)==TCL_OK) sig->iValue=b;
+	  break;
+	}
+    }
+
+  if ((obj==NULL)&&(Tcl_SetVar(interp, name, (type==Signal_double) ? "0.000000" : "0",
+			   TCL_GLOBAL_ONLY|TCL_LEAVE_ERR_MSG)==NULL))
+    {
+      delete sig;
+      return NULL;
+    }
+  if (Tcl_TraceVar(interp, name, SignalTraceFlags, gecoSignal::traceProc, sig)!=TCL_OK)
+    {
+      delete sig;
+      return NULL;
+    }
+  if (type==Signal_double) app->linkNativeVar(name, &sig->dValue);
+
+  int isNew;
+  Tcl_SetHashValue(Tcl_CreateHashEntry(&signalByName, name, &isNew), sig);
+  signals.push_back(sig);
+  sig->users=1;
+  return sig;
+}
+
+
+/**
+ * @brief Detaches a user from a signal
+ * @param sig the gecoSignal (can be NULL)
+ *
+ * When its last user detached, the signal is detached from its Tcl variable
+ * and deleted. The Tcl variable keeps the last value of the signal.
+*/
+
+void gecoSignalBus::detach(gecoSignal* sig)
+{
+  if (sig==NULL) return;
+  sig->users--;
+  if (sig->users>0) return;
+  remove(sig);
+}
+
+
+/**
+ * @brief Detaches a signal from its Tcl variable and deletes it
+ * @param sig the gecoSignal
+*/
+
+void gecoSignalBus::remove(gecoSignal* sig)
+{
+  if (sig->stale) sig->mirror(interp);
+  Tcl_UntraceVar(interp, sig->getName(), SignalTraceFlags, gecoSignal::traceProc, sig);
+  if (sig->getType()==Signal_double) app->unlinkNativeVar(sig->getName());
+
+  Tcl_HashEntry* entry=Tcl_FindHashEntry(&signalByName, sig->getName());
+  if (entry) Tcl_DeleteHashEntry(entry);
+  for (int k=0; k<(int)signals.size(); k++)
+    if (signals[k]==sig)
+      {
+	signals.erase(signals.begin()+k);
+	break;
+      }
+  delete sig;
+}
+
+
+/**
+ * @brief Finds a signal
+ * @param name name of the signal
+ * \return the gecoSignal or NULL if no signal with this name exists
+*/
+
+gecoSignal* gecoSignalBus::find(const char* name)
+{
+  Tcl_HashEntry* entry=Tcl_FindHashEntry(&signalByName, name);
+  if (entry==NULL) return NULL;
+  return (gecoSignal *)Tcl_GetHashValue(entry);
+}
+
+
+/**
+ * @brief Fires the write traces of the Tcl variables of the signals which changed
+ *
+ * Reading a signal from Tcl always returns its current value. Only the write traces
+ * (e.g. a Tk widget displaying the variable) need the Tcl variable to be set. The gecoApp
+ * calls this method once per pass of the geco process loop.
+*/
+
+void gecoSignalBus::flush()
+{
+  for (int k=0; k<(int)signals.size(); k++)
+    if (signals[k]->dirty)
+      {
+	signals[k]->dirty=false;
+	signals[k]->mirror(interp);
+      }
+}
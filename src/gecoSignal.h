@@ -0,0 +1,180 @@
+// This may look like C code, but it is really -*- C++ -*-
+// ----------------------------------------------------------------
+//
+// Header file for classes gecoSignal and gecoSignalBus
+//
+// (c) Rolf Wuthrich
+//     2026 Concordia University
+//
+// author:  agent
+// email:   agent@local
+// version: v1
+//
+// This software is copyright under the BSD license
+//
+// ---------------------------------------------------------------
+// history:
+// ---------------------------------------------------------------
+// Date       Modification                     Author
+// ---------------------------------------------------------------
+// 17.10.2026 Creation                         agent
+// 18.10.2026 Mirrored to plain Tcl variables  agent
+//
+// ---------------------------------------------------------------
+/*! \file */
+
+#ifndef gecoSignal_SEEN_
+#define gecoSignal_SEEN_
+
+#include <tcl8.6/tcl.h>
+#include <vector>
+#include "gecoObj.h"
+
+using namespace std;
+
+
+// ------------------------------------------------------------------------
+//
+// Types of signals
+//
+
+const int
+  Signal_double = 0,
+  Signal_int    = 1,
+  Signal_bool   = 2;
+
+extern const char* SignalTypeStr[];
+
+
+// -----------------------------------------------------------------------
+//
+// class gecoSignal : typed numeric signal
+//
+
+/**
+ * @brief Typed numeric signal of the gecoSignalBus
+ * \author agent
+ * \date 2026
+ *
+ * A gecoSignal holds a double, an int or a bool. It is mirrored to the
+ * ordinary Tcl variable of the same name, so that Tcl scripts read and
+ * write the signal as before: the Tcl variable is updated from the signal
+ * when read, and a numeric value written to the Tcl variable updates the
+ * signal. A non-numeric value can still be written to the Tcl variable;
+ * it leaves the signal unchanged. The Tcl variable holds the value as a
+ * number, so that a double reads back at full precision.
+ *
+ * gecoProcess and gecoIOModule read and write the signal directly with the
+ * set and get methods, without formatting or parsing strings. The write
+ * traces of the Tcl variable (e.g. Tk widgets using the variable) are fired
+ * once per clock tick by gecoSignalBus::flush for the signals which changed.
+ *
+ * gecoSignal are created and deleted by the gecoSignalBus.
+ */
+
+class gecoSignal
+{
+
+  friend class gecoSignalBus;
+
+private:
+
+  Tcl_DString*  name;         // name of the signal and of the linked Tcl variable
+  int           type;         // Signal_double, Signal_int or Signal_bool
+  double        dValue;       // storage of a Signal_double
+  int           iValue;       // storage of a Signal_int or Signal_bool
+  int           users;        // number of users attached to the signal
+  bool          declared;     // true if declared with 'signals -create'
+  bool          dirty;        // true if changed since the last flush
+  bool          stale;        // true if changed since mirrored to the Tcl variable
+  bool          mirroring;    // true while the Tcl variable is set from the signal
+
+  gecoSignal(const char* Name, int Type);
+  ~gecoSignal();
+
+  void          mirror(Tcl_Interp* interp);
+  static char*  traceProc(ClientData clientData, Tcl_Interp* interp,
+			  const char* name1, const char* name2, int flags);
+
+public:
+
+  void          setDouble(double v);
+  void          setInt(int v);
+  void          setBool(bool v)  {setInt(v ? 1 : 0);}   /*!< Sets the signal to v */
+
+  double        getDouble() {return (type==Signal_double) ? dValue : iValue;}  /*!< Returns the signal as a double */
+  int           getInt()    {return (type==Signal_double) ? (int)dValue : iValue;}  /*!< Returns the signal as an int */
+  bool          getBool()   {return (type==Signal_double) ? (dValue!=0.0) : (iValue!=0);}  /*!< Returns the signal as a bool */
+
+  const char*   getName()   {return Tcl_DStringValue(name);}  /*!< Returns the name of the signal */
+  int           getType()   {return type;}                    /*!< Returns the type of the signal */
+  int           getUsers()  {return users;}                   /*!< Returns the number of users of the signal */
+};
+
+
+// -----------------------------------------------------------------------
+//
+// class gecoSignalBus : store of the typed numeric signals
+//
+
+/**
+ * @brief Store of the typed numeric signals exchanged between gecoProcess
+ * \author agent
+ * \date 2026
+ *
+ * The gecoSignalBus keeps the gecoSignal of a gecoApp, addressable by name.
+ * It is created by the gecoApp during its construction. The Tcl command
+ * 'signals' allows to manipulate it.
+ *
+ * A producer or consumer of a signal (e.g. a gecoGenerator for its
+ * '-outputVariable') attaches to it with gecoSignalBus::attach, which
+ * creates the signal if needed, and detaches from it with
+ * gecoSignalBus::detach once no longer needed. A signal is deleted when
+ * its last user detached. The Tcl variable then keeps its last value.
+ *
+ * The double signals are registered as native variables in the gecoApp
+ * (gecoApp::linkNativeVar), so that a gecoExpr reads them directly.
+ *
+ * Associated Tcl command
+ * ----------------------
+ * The gecoSignalBus class extends the subcommands from gecoObj by the following subcommands
+ *
+ * Sub-command       | Short description
+ * ----------------- | ------------------
+ * -list             | lists all signals
+ * -create           | creates a signal (name ?double|int|bool?)
+ * -remove           | removes a signal created with -create
+ *
+ * Example
+ * -------
+ * \code
+ * signals -create V double
+ * triangle -outputVariable V -Ulow 0 -Uhigh 5
+ * filestream -file data.txt -data {$t $V}
+ * \endcode
+ */
+
+class gecoSignalBus : public gecoObj
+{
+
+private:
+
+  Tcl_HashTable        signalByName;
+  vector<gecoSignal*>  signals;
+
+  void                 remove(gecoSignal* sig);
+
+public:
+
+  gecoSignalBus(gecoApp* App);
+  ~gecoSignalBus();
+
+  virtual int  cmd(int &i, int objc, Tcl_Obj *const objv[]);
+
+  gecoSignal*  attach(const char* name, int type);
+  void         detach(gecoSignal* sig);
+  gecoSignal*  find(const char* name);
+  void         flush();
+};
+
+#endif /* gecoSignal_SEEN_ */
@@ -0,0 +1,402 @@
+// ---------------------------------------------------------------
+//
+// Definition of the class gecoTextRecord
+//
+// (c) Rolf Wuthrich
+//     2026 Concordia University
+//
+// author:  agent
+// email:   agent@local
+// version: v1
+//
+// This software is copyright under the BSD license
+//
+// ---------------------------------------------------------------
+// history:
+// ---------------------------------------------------------------
+// Date       Modification                     Author
+// ---------------------------------------------------------------
+// 17.10.2026 Creation                         agent
+// 18.10.2026 Guarded int conversion           agent
+//
+// ---------------------------------------------------------------
+
+#include <tcl.h>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <charconv>
+#include "gecoTextRecord.h"
+#include "gecoBinRecord.h"
+#include "gecoSignal.h"
+#include "gecoApp.h"
+
+using namespace std;
+
+
+// ---------------------------------------------------------------
+//
+// class gecoTextRecord : builds the lines of a text data file
+//
+
+
+const int TextMaxDecimals = 17;     // largest number of fixed decimals
+const int TextMaxValue    = 400;    // largest size of a printed number
+
+
+/**
+ * @brief Constructor
+ * @param App gecoApp providing the variables
+*/
+
+gecoTextRecord::gecoTextRecord(gecoApp* App) :
+  app(App),
+  layout(new gecoBinFile),
+  first(0),
+  precDict(Tcl_NewDictObj()),
+  start(0)
+{
+  Tcl_IncrRefCount(precDict);
+}
+
+
+/**
+ * @brief Destructor
+*/
+
+gecoTextRecord::~gecoTextRecord()
+{
+  unbind();
+  Tcl_DecrRefCount(precDict);
+  delete layout;
+}
+
+
+/**
+ * @brief Sets the columns of a line
+ * @param interp Tcl interpreter in which errors are reported
+ * @param decl columns declared as for gecoBinFile::setColumns
+ * \return TCL_OK if the declaration is valid and TCL_ERROR otherwise
+*/
+
+int gecoTextRecord::setColumns(Tcl_Interp* interp, const char* decl)
+{
+  unbind();
+  if (layout->setColumns(interp, decl)!=TCL_OK) return TCL_ERROR;
+
+  // skips the timestamp column added by the layout
+  int      n=0;
+  Tcl_Obj* list=Tcl_NewStringObj(decl, -1);
+  Tcl_IncrRefCount(list);
+  Tcl_ListObjLength(NULL, list, &n);
+  Tcl_DecrRefCount(list);
+  first=layout->getNbrColumns()-n;
+  return TCL_OK;
+}
+
+
+/**
+ * @brief Sets a fixed number of decimals for some columns
+ * @param interp Tcl interpreter in which errors are reported
+ * @param dict dictionary {column decimals ...}
+ * \return TCL_OK if the dictionary is valid and TCL_ERROR otherwise
+ *
+ * The columns not listed are printed with the shortest string reading back
+ * to the same value. Names not declared as a column are ignored.
+*/
+
+int gecoTextRecord::setPrecision(Tcl_Interp* interp, const char* dict)
+{
+  Tcl_Obj*       obj=Tcl_NewStringObj(dict, -1);
+  Tcl_DictSearch search;
+  Tcl_Obj       *key, *val;
+  int            done, dec;
+  Tcl_IncrRefCount(obj);
+
+  if (Tcl_DictObjFirst(interp, obj, &search, &key, &val, &done)!=TCL_OK)
+    {
+      Tcl_DecrRefCount(obj);
+      return TCL_ERROR;
+    }
+  for (; !done; Tcl_DictObjNext(&search, &key, &val, &done))
+    if ((Tcl_GetIntFromObj(NULL, val, &dec)!=TCL_OK)||(dec<0)||(dec>TextMaxDecimals))
+      {
+	Tcl_DictObjDone(&search);
+	Tcl_AppendResult(interp, "decimals of column \"", Tcl_GetString(key),
+			 "\" must be an integer between 0 and 17", NULL);
+	Tcl_DecrRefCount(obj);
+	return TCL_ERROR;
+      }
+
+  Tcl_DecrRefCount(precDict);
+  precDict=obj;
+  return TCL_OK;
+}
+
+
+/**
+ * @brief Binds the columns to their storage
+ * @param Start CLOCK_MONOTONIC at start of recording (ns)
+ *
+ * Must be called after the columns are set.
+*/
+
+void gecoTextRecord::bind(long long Start)
+{
+  unbind();
+  start=Start;
+  for (int k=0; k<layout->getNbrColumns(); k++)
+    {
+      gecoSignal* sig=NULL;
+      double*     ptr=NULL;
+      Tcl_Obj*    val=NULL;
+      int         dec=-1;
+      if (layout->getColumnType(k)!=BinCol_timestamp)
+	{
+	  if (app->getSignalBus()->find(layout->getColumnName(k)))
+	    sig=app->getSignalBus()->attach(layout->getColumnName(k), Signal_double);
+	  else
+	    ptr=app->findNativeVar(layout->getColumnName(k));
+	}
+      if ((Tcl_DictObjGet(NULL, precDict, layout->getColumnNameObj(k), &val)==TCL_OK)&&(val))
+	Tcl_GetIntFromObj(NULL, val, &dec);
+      colSignal.push_back(sig);
+      colPtr.push_back(ptr);
+      precision.push_back(dec);
+    }
+}
+
+
+/**
+ * @brief Detaches the columns from the signals
+*/
+
+void gecoTextRecord::unbind()
+{
+  for (int k=0; k<(int)colSignal.size(); k++)
+    app->getSignalBus()->detach(colSignal[k]);
+  colSignal.clear();
+  colPtr.clear();
+  precision.clear();
+}
+
+
+/**
+ * @brief Makes room for n characters at position pos of the line
+*/
+
+char* gecoTextRecord::reserve(size_t pos, size_t n)
+{
+  if (line.size()<pos+n) line.resize(2*(pos+n));
+  return &line[pos];
+}
+
+
+/**
+ * @brief Builds a line with the current values of the columns
+ * @param interp Tcl interpreter holding the Tcl variables
+ * @param len set to the length of the line (with the trailing new line)
+ * \return the line (valid until the next call)
+*/
+
+const char* gecoTextRecord::build(Tcl_Interp* interp, int* len)
+{
+  size_t pos=0;
+  for (int k=first; k<layout->getNbrColumns(); k++)
+    {
+      int   type=layout->getColumnType(k);
+      bool  isInt=(type==BinCol_int)||(type==BinCol_wide);
+      char* p=reserve(pos, TextMaxValue+1);
+      if (k>first)
+	{
+	  *p++=' ';
+	  pos++;
+	}
+      if (type==BinCol_timestamp)
+	pos+=printDouble(p, (gecoBinRecord::monotonicTime()-start)/1e9);
+      else if (colSignal[k])
+	{
+	  if ((colSignal[k]->getType()!=Signal_double)&&(precision[k]<0))
+	    pos+=printWide(p, colSignal[k]->getInt());
+	  else if (isInt)
+	    pos+=printInt(p, colSignal[k]->getDouble(), type);
+	  else if (precision[k]>=0)
+	    pos+=printFixed(p, colSignal[k]->getDouble(), precision[k]);
+	  else
+	    pos+=printDouble(p, colSignal[k]->getDouble());
+	}
+      else if (colPtr[k])
+	{
+	  if (isInt)
+	    pos+=printInt(p, *colPtr[k], type);
+	  else if (precision[k]>=0)
+	    pos+=printFixed(p, *colPtr[k], precision[k]);
+	  else
+	    pos+=printDouble(p, *colPtr[k]);
+	}
+      else
+	{
+	  // a Tcl variable is printed as Tcl would, without building its
+	  // string representation when it holds a number
+	  Tcl_Obj*    obj=Tcl_ObjGetVar2(interp, layout->getColumnNameObj(k), NULL, TCL_GLOBAL_ONLY);
+	  Tcl_WideInt w;
+	  double      d;
+	  if (obj==NULL)
+	    pos+=printDouble(p, NAN);
+	  else if ((precision[k]>=0)&&(Tcl_GetDoubleFromObj(NULL, obj, &d)==TCL_OK))
+	    pos+=printFixed(p, d, precision[k]);
+	  else if ((obj->bytes==NULL)&&(Tcl_GetWideIntFromObj(NULL, obj, &w)==TCL_OK))
+	    pos+=printWide(p, w);
+	  else if ((obj->bytes==NULL)&&(Tcl_GetDoubleFromObj(NULL, obj, &d)==TCL_OK))
+	    pos+=printDouble(p, d);
+	  else
+	    {
+	      int         n;
+	      const char* str=Tcl_GetStringFromObj(obj, &n);
+	      memcpy(reserve(pos, n), str, n);
+	      pos+=n;
+	    }
+	}
+    }
+  *reserve(pos, 1)='\n';
+  *len=pos+1;
+  return &line[0];
+}
+
+
+/**
+ * @brief Prints a double as Tcl does (see Tcl_PrintDouble)
+ * @param str buffer of at least TCL_DOUBLE_SPACE characters
+ * @param v the value
+ * \return number of characters printed (str is not null terminated)
+ *
+ * The shortest digits reading back to v are printed in fixed notation
+ * (always with a decimal point) if the decimal exponent of v is between
+ * -5 and 16, else in exponential notation.
+*/
+
+int gecoTextRecord::printDouble(char* str, double v)
+{
+#ifdef __cpp_lib_to_chars
+  if (std::isnan(v))
+    {
+      // with its payload, if any
+      Tcl_PrintDouble(NULL, v, str);
+      return strlen(str);
+    }
+  if (std::isinf(v))
+    {
+      const char* s=(v<0) ? "-Inf" : "Inf";
+      memcpy(str, s, strlen(s));
+      return strlen(s);
+    }
+
+  // shortest digits d[0].d[1]...d[n-1] and decimal exponent e
+  char  buf[32];
+  char* end=to_chars(buf, buf+sizeof(buf)-1, fabs(v), chars_format::scientific).ptr;
+  *end='\0';
+  char  d[20];
+  int   n=0;
+  char* q=buf;
+  for (; (q<end)&&(*q!='e'); q++)
+    if (*q!='.') d[n++]=*q;
+  int e=atoi(q+1);
+
+  char* p=str;
+  if (signbit(v)) *p++='-';
+  if ((e<-4)||(e>16))
+    {
+      *p++=d[0];
+      if (n>1)
+	{
+	  *p++='.';
+	  memcpy(p, d+1, n-1);
+	  p+=n-1;
+	}
+      *p++='e';
+      *p++=(e<0) ? '-' : '+';
+      p=to_chars(p, p+4, abs(e)).ptr;
+    }
+  else if (e>=0)
+    {
+      for (int k=0; k<=e; k++) *p++=(k<n) ? d[k] : '0';
+      *p++='.';
+      if (n>e+1)
+	{
+	  memcpy(p, d+e+1, n-e-1);
+	  p+=n-e-1;
+	}
+      else
+	*p++='0';
+    }
+  else
+    {
+      *p++='0';
+      *p++='.';
+      for (int k=-1; k>e; k--) *p++='0';
+      memcpy(p, d, n);
+      p+=n;
+    }
+  return p-str;
+#else
+  Tcl_PrintDouble(NULL, v, str);
+  return strlen(str);
+#endif
+}
+
+
+/**
+ * @brief Prints a double with a fixed number of decimals (as format '%.nf')
+ * @param str buffer of at least 400 characters
+ * @param v the value
+ * @param decimals number of decimals
+ * \return number of characters printed (str is not null terminated)
+*/
+
+int gecoTextRecord::printFixed(char* str, double v, int decimals)
+{
+  if (!std::isfinite(v)) return printDouble(str, v);
+#ifdef __cpp_lib_to_chars
+  return to_chars(str, str+TextMaxValue, v, chars_format::fixed, decimals).ptr-str;
+#else
+  return sprintf(str, "%.*f", decimals, v);
+#endif
+}
+
+
+/**
+ * @brief Prints a double truncated to an integer column
+ * @param str buffer of at least 21 characters
+ * @param v the value
+ * @param type BinCol_int or BinCol_wide
+ * \return number of characters printed (str is not null terminated)
+ *
+ * A NaN or a value out of the range of the column has no integer and is
+ * printed as NaN, as a missing value.
+*/
+
+int gecoTextRecord::printInt(char* str, double v, int type)
+{
+  bool valid=(type==BinCol_int) ?
+    (v>-2147483649.0)&&(v<2147483648.0) :
+    (v>=-9223372036854775808.0)&&(v<9223372036854775808.0);
+  if (!valid) return printDouble(str, NAN);
+  return printWide(str, (long long)v);
+}
+
+
+/**
+ * @brief Prints an integer
+ * @param str buffer of at least 21 characters
+ * @param v the value
+ * \return number of characters printed (str is not null terminated)
+*/
+
+int gecoTextRecord::printWide(char* str, long long v)
+{
+#ifdef __cpp_lib_to_chars
+  return to_chars(str, str+24, v).ptr-str;
+#else
+  return sprintf(str, "%lld", v);
+#endif
+}
@@ -0,0 +1,108 @@
+// This may look like C code, but it is really -*- C++ -*-
+// ----------------------------------------------------------------
+//
+// Header file for class gecoTextRecord
+//
+// (c) Rolf Wuthrich
+//     2026 Concordia University
+//
+// author:  agent
+// email:   agent@local
+// version: v1
+//
+// This software is copyright under the BSD license
+//
+// ---------------------------------------------------------------
+// history:
+// ---------------------------------------------------------------
+// Date       Modification                     Author
+// ---------------------------------------------------------------
+// 17.10.2026 Creation                         agent
+// 18.10.2026 Guarded int conversion           agent
+//
+// ---------------------------------------------------------------
+/*! \file */
+
+#ifndef gecoTextRecord_SEEN_
+#define gecoTextRecord_SEEN_
+
+#include <tcl8.6/tcl.h>
+#include <vector>
+#include "gecoBinFile.h"
+
+class gecoApp;               // forward definition
+class gecoSignal;            // forward definition
+
+using namespace std;
+
+
+// -----------------------------------------------------------------------
+//
+// class gecoTextRecord : builds the lines of a text data file
+//
+
+/**
+ * @brief Builds the lines of a text data file from the variables of a gecoApp
+ * \author agent
+ * \date 2026
+ *
+ * A gecoTextRecord formats the values of declared columns (declared as for the
+ * binary format, see gecoBinFile) into a line of text, the values separated by
+ * a blank, without evaluating any Tcl script. The columns are read as by
+ * gecoBinRecord: from a signal of the gecoSignalBus, from a native variable
+ * (like t) or from a Tcl variable.
+ *
+ * The values are printed according to the type of their column:
+ *
+ * Type           | Printed as
+ * -------------- | ------------------------------------------------------
+ * double, float  | shortest string reading back to the same value, as Tcl prints it
+ * int, wide      | integer (NaN if the value is NaN or out of range of the column)
+ * timestamp      | s since the start of the recording, as a double
+ *
+ * The doubles are thus printed exactly as with the Tcl command 'format' and
+ * a line of '-columns {t V {n int}}' is identical to the one of '-data {$t $V $n}'.
+ * gecoTextRecord::setPrecision sets instead a fixed number of decimals for some
+ * columns (as the format '%.nf'). A Tcl variable holding no number is copied
+ * as is.
+ *
+ * Unlike gecoBinFile, no timestamp column is added to the declared columns.
+ *
+ * Used by gecoFileStream and gecoMemStream.
+ */
+
+class gecoTextRecord
+{
+
+private:
+
+  gecoApp*            app;
+  gecoBinFile*        layout;     // layout of the columns
+  int                 first;      // first declared column of the layout
+  Tcl_Obj*            precDict;   // decimals of the columns (dict)
+  vector<int>         precision;  // decimals of each column (-1 for shortest)
+  vector<gecoSignal*> colSignal;  // signal of each column (or NULL)
+  vector<double*>     colPtr;     // native variable of each column (or NULL)
+  vector<char>        line;       // line being built
+  long long           start;      // CLOCK_MONOTONIC at start of recording (ns)
+
+  char*        reserve(size_t pos, size_t n);
+
+public:
+
+  gecoTextRecord(gecoApp* App);
+  ~gecoTextRecord();
+
+  int          setColumns(Tcl_Interp* interp, const char* decl);
+  int          setPrecision(Tcl_Interp* interp, const char* dict);
+  void         bind(long long Start);
+  void         unbind();
+  const char*  build(Tcl_Interp* interp, int* len);
+
+  static int   printDouble(char* str, double v);
+  static int   printFixed(char* str, double v, int decimals);
+  static int   printInt(char* str, double v, int type);
+  static int   printWide(char* str, long long v);
+};
+
+#endif /* gecoTextRecord_SEEN_ */
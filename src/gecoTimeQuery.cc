@@ -0,0 +1,175 @@
+// ---------------------------------------------------------------
+//
+// Definition of the class gecoTimeQuery
+//
+// (c) Rolf Wuthrich
+//     2026 Concordia University
+//
+// author:  agent
+// email:   agent@local
+// version: v1
+//
+// This software is copyright under the BSD license
+//
+// ---------------------------------------------------------------
+// history:
+// ---------------------------------------------------------------
+// Date       Modification                     Author
+// ---------------------------------------------------------------
+// 17.10.2026 Creation                         agent
+//
+// ---------------------------------------------------------------
+
+#include <tcl.h>
+#include <cmath>
+#include <climits>
+#include "gecoTimeQuery.h"
+#include "gecoBlockCodec.h"
+
+using namespace std;
+
+
+// ---------------------------------------------------------------
+//
+// class gecoTimeQuery : query of a column over a time range
+//
+
+
+/**
+ * @brief Constructor
+ * @param Bin layout of the records
+ *
+ * The range defaults to all records.
+*/
+
+gecoTimeQuery::gecoTimeQuery(gecoBinFile* Bin) :
+  bin(Bin),
+  col(0),
+  tMin(LLONG_MIN),
+  tMax(LLONG_MAX),
+  latest(0),
+  done(false)
+{
+}
+
+
+/**
+ * @brief Sets the column queried
+ * @param interp Tcl interpreter in which errors are reported
+ * @param name name of the column
+ * \return TCL_OK if the column exists and TCL_ERROR otherwise
+*/
+
+int gecoTimeQuery::setColumn(Tcl_Interp* interp, const char* name)
+{
+  col=bin->getColumnIndex(name);
+  if (col>=0) return TCL_OK;
+  Tcl_AppendResult(interp, "no column \"", name, "\" in data", NULL);
+  col=0;
+  return TCL_ERROR;
+}
+
+
+/**
+ * @brief Sets the time range of the query
+ * @param TMin start of the range (s since the start of the recording)
+ * @param TMax end of the range (s since the start of the recording)
+*/
+
+void gecoTimeQuery::setRange(double TMin, double TMax)
+{
+  tMin=(TMin<-9e9) ? LLONG_MIN : llround(TMin*1e9);
+  tMax=(TMax>9e9) ? LLONG_MAX : llround(TMax*1e9);
+}
+
+
+/**
+ * @brief Keeps only the n latest records of the range
+*/
+
+void gecoTimeQuery::setLatest(long long n)
+{
+  latest=n;
+}
+
+
+/**
+ * @brief Adds a record
+ * @param rec the record
+ * \return false if the record is after the range (the query is done)
+*/
+
+bool gecoTimeQuery::add(const char* rec)
+{
+  long long t=bin->getTimestamp(rec);
+  if (t<tMin) return true;
+  if (t>tMax)
+    {
+      done=true;
+      return false;
+    }
+  int type=bin->getColumnType(col);
+  times.push_back(t);
+  values.push_back(gecoBinFile::getLE(rec+bin->getColumnOffset(col), BinColSize[type]));
+
+  // bounds the memory while only the latest records are kept
+  if ((latest>0)&&((long long)times.size()>=2*latest+1024))
+    {
+      times.erase(times.begin(), times.end()-latest);
+      values.erase(values.begin(), values.end()-latest);
+    }
+  return true;
+}
+
+
+/**
+ * @brief Adds the records of a compressed block (see gecoBlockEncoder)
+ * @param block the block
+ * @param len size of the block
+ * \return false if the block is corrupted or ends the query
+*/
+
+bool gecoTimeQuery::addBlock(const char* block, size_t len)
+{
+  int rs=bin->getRecordSize();
+  if ((len<16)||(gecoBlockDecoder::getRecords(block)<1)||
+      (gecoBlockDecoder::getRecords(block)>BlockMaxRecords))
+    return false;
+  blockBuf.resize((size_t)gecoBlockDecoder::getRecords(block)*rs);
+  int n=gecoBlockDecoder::decode(bin, block, len, &blockBuf[0]);
+  if (n<0) return false;
+  for (int r=0; r<n; r++)
+    if (!add(&blockBuf[(size_t)r*rs])) return false;
+  return true;
+}
+
+
+/**
+ * @brief Returns the records collected as a list of {t value} (refcount 0)
+ * @param maxPoints number of records returned at most (0 for all)
+ *
+ * If more records were collected, evenly spaced ones are returned.
+*/
+
+Tcl_Obj* gecoTimeQuery::result(long long maxPoints)
+{
+  size_t first=0;
+  if ((latest>0)&&((long long)times.size()>latest)) first=times.size()-latest;
+  size_t n=times.size()-first;
+  size_t m=((maxPoints>0)&&((long long)n>maxPoints)) ? (size_t)maxPoints : n;
+
+  vector<char> rec(bin->getRecordSize());
+  char*        p=&rec[0]+bin->getColumnOffset(col);
+  int          size=BinColSize[bin->getColumnType(col)];
+  Tcl_Obj*     list=Tcl_NewListObj(0, NULL);
+  for (size_t j=0; j<m; j++)
+    {
+      size_t   k=first+(size_t)((double)j*n/m);
+      Tcl_Obj* pair[2];
+      pair[0]=Tcl_NewDoubleObj(times[k]/1e9);
+      gecoBinFile::putLE(p, values[k], size);
+      pair[1]=bin->getValue(&rec[0], col);
+      Tcl_ListObjAppendElement(NULL, list, Tcl_NewListObj(2, pair));
+    }
+  return list;
+}
@@ -0,0 +1,92 @@
+// This may look like C code, but it is really -*- C++ -*-
+// ----------------------------------------------------------------
+//
+// Header file for class gecoTimeQuery
+//
+// (c) Rolf Wuthrich
+//     2026 Concordia University
+//
+// author:  agent
+// email:   agent@local
+// version: v1
+//
+// This software is copyright under the BSD license
+//
+// ---------------------------------------------------------------
+// history:
+// ---------------------------------------------------------------
+// Date       Modification                     Author
+// ---------------------------------------------------------------
+// 17.10.2026 Creation                         agent
+//
+// ---------------------------------------------------------------
+/*! \file */
+
+#ifndef gecoTimeQuery_SEEN_
+#define gecoTimeQuery_SEEN_
+
+#include <tcl8.6/tcl.h>
+#include <vector>
+#include "gecoBinFile.h"
+
+using namespace std;
+
+
+// -----------------------------------------------------------------------
+//
+// class gecoTimeQuery : query of a column over a time range
+//
+
+/**
+ * @brief Query of a column of binary records over a time range
+ * \author agent
+ * \date 2026
+ *
+ * A gecoTimeQuery collects the timestamp and the value of a column of the
+ * records (layout of a gecoBinFile) it is fed with, in increasing time:
+ *
+ *     gecoTimeQuery q(bin);
+ *     q.setColumn(interp, name);
+ *     q.setRange(tMin, tMax);
+ *     ... position on the last record before tMin (binary search)
+ *     while (!q.isDone() && ...) q.add(rec);
+ *     Tcl_SetObjResult(interp, q.result(maxPoints));
+ *
+ * Records before the range are skipped and the first record after the range
+ * ends the query. With gecoTimeQuery::setLatest, only the latest records are
+ * kept. The result is a list of {t value} with t in seconds since the start of
+ * the recording, decimated to at most maxPoints evenly spaced records.
+ *
+ * Used by the Tcl command 'binfile' and by gecoMemStream.
+ */
+
+class gecoTimeQuery
+{
+
+private:
+
+  gecoBinFile*               bin;       // layout of the records
+  int                        col;       // queried column
+  long long                  tMin;      // range of the query (ns)
+  long long                  tMax;
+  long long                  latest;    // number of latest records kept (0 for all)
+  bool                       done;      // a record after the range was met
+  vector<long long>          times;     // timestamps collected (ns)
+  vector<unsigned long long> values;    // values collected (raw bytes of the column)
+  vector<char>               blockBuf;  // records of a decoded block
+
+public:
+
+  gecoTimeQuery(gecoBinFile* Bin);
+
+  int          setColumn(Tcl_Interp* interp, const char* name);
+  void         setRange(double TMin, double TMax);
+  void         setLatest(long long n);
+  bool         add(const char* rec);
+  bool         addBlock(const char* block, size_t len);
+  bool         isDone()     {return done;}         /*!< Returns true if a record after the range was met */
+  long long    getMin()     {return tMin;}         /*!< Returns the start of the range (ns) */
+  Tcl_Obj*     result(long long maxPoints = 0);
+};
+
+#endif /* gecoTimeQuery_SEEN_ */
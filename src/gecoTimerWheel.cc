@@ -0,0 +1,130 @@
+// ---------------------------------------------------------------
+//
+// Definition of the class gecoTimerWheel
+//
+// (c) Rolf Wuthrich
+//     2026 Concordia University
+//
+// author:  agent
+// email:   agent@local
+// version: v1
+//
+// This software is copyright under the BSD license
+//
+// ---------------------------------------------------------------
+// history:
+// ---------------------------------------------------------------
+// Date       Modification                     Author
+// ---------------------------------------------------------------
+// 17.10.2026 Creation                         agent
+//
+// ---------------------------------------------------------------
+
+#include <algorithm>
+#include "gecoTimerWheel.h"
+#include "gecoProcess.h"
+#include "gecoApp.h"
+
+using namespace std;
+
+
+// ---------------------------------------------------------------
+//
+// class gecoTimerWheel : multi-rate scheduling of the geco process loop
+//
+
+
+/**
+ * @brief Constructor
+ * @param App gecoApp whose geco process loop is scheduled
+*/
+
+gecoTimerWheel::gecoTimerWheel(gecoApp* App) :
+  app(App),
+  tick(0)
+{
+}
+
+
+/**
+ * @brief Rebuilds the timer wheel from the geco process loop
+ *
+ * Each gecoProcess with a tick divider N larger than 1 is scheduled
+ * on the next tick multiple of N.
+*/
+
+void gecoTimerWheel::rebuild()
+{
+  everyTick.clear();
+  for (int k=0; k<WheelSize; k++) slot[k].clear();
+
+  for (int index=0; index<app->getNbrGecoProcesses(); index++)
+    {
+      gecoProcess* p = app->getGecoProcess(index);
+      gecoWheelEntry e;
+      e.proc    = p;
+      e.index   = index;
+      e.divider = p->getTickDivider();
+      if (e.divider<=1)
+	{
+	  e.due = tick+1;
+	  everyTick.push_back(e);
+	}
+      else
+	{
+	  e.due = (tick/e.divider+1)*e.divider;
+	  slot[e.due%WheelSize].push_back(e);
+	}
+    }
+}
+
+
+/**
+ * @brief Advances the timer wheel by one tick
+ * @param due is filled with the gecoProcess due on the new tick, in the order of the geco process loop
+ *
+ * The processes returned are rescheduled on their next due tick.
+*/
+
+void gecoTimerWheel::advance(vector<gecoProcess*>& due)
+{
+  tick++;
+  due.clear();
+
+  // collects the due entries of the current slot
+  dueEntries.clear();
+  vector<gecoWheelEntry>& s = slot[tick%WheelSize];
+  unsigned int k = 0;
+  while (k<s.size())
+    {
+      if (s[k].due==tick)
+	{
+	  dueEntries.push_back(s[k]);
+	  s[k] = s.back();
+	  s.pop_back();
+	}
+      else
+	k++;
+    }
+
+  // reschedules them
+  for (k=0; k<dueEntries.size(); k++)
+    {
+      gecoWheelEntry e = dueEntries[k];
+      e.due = tick+e.divider;
+      slot[e.due%WheelSize].push_back(e);
+    }
+
+  // merges them with the processes run at every tick in loop order
+  sort(dueEntries.begin(), dueEntries.end(),
+       [](const gecoWheelEntry& a, const gecoWheelEntry& b) {return a.index<b.index;});
+  unsigned int i = 0, j = 0;
+  while ((i<everyTick.size())||(j<dueEntries.size()))
+    {
+      if ((j==dueEntries.size())||
+	  ((i<everyTick.size())&&(everyTick[i].index<dueEntries[j].index)))
+	due.push_back(everyTick[i++].proc);
+      else
+	due.push_back(dueEntries[j++].proc);
+    }
+}
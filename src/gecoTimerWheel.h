@@ -0,0 +1,96 @@
+// This may look like C code, but it is really -*- C++ -*-
+// ----------------------------------------------------------------
+//
+// Header file for class gecoTimerWheel
+//
+// (c) Rolf Wuthrich
+//     2026 Concordia University
+//
+// author:  agent
+// email:   agent@local
+// version: v1
+//
+// This software is copyright under the BSD license
+//
+// ---------------------------------------------------------------
+// history:
+// ---------------------------------------------------------------
+// Date       Modification                     Author
+// ---------------------------------------------------------------
+// 17.10.2026 Creation                         agent
+//
+// ---------------------------------------------------------------
+/*! \file */
+
+#ifndef gecoTimerWheel_SEEN_
+#define gecoTimerWheel_SEEN_
+
+#include <vector>
+
+using namespace std;
+
+class gecoApp;                // forward definition
+class gecoProcess;            // forward definition
+
+const int WheelSize = 256;    // number of slots of the timer wheel
+
+
+/**
+ * @brief Entry of the gecoTimerWheel
+ */
+
+struct gecoWheelEntry
+{
+  gecoProcess*  proc;         /*!< scheduled gecoProcess */
+  int           index;        /*!< position of proc in the geco process loop */
+  int           divider;      /*!< number of ticks between two runs of proc */
+  long          due;          /*!< tick at which proc is due */
+};
+
+
+// -----------------------------------------------------------------------
+//
+// class gecoTimerWheel : multi-rate scheduling of the geco process loop
+//
+
+/**
+ * @brief Timer wheel for the multi-rate scheduling of the geco process loop
+ * \author agent
+ * \date 2026
+ *
+ * The gecoTimerWheel tells geco_eventLoop() which gecoProcess are due on the
+ * current clock tick. A gecoProcess with a tick divider of N (set with its
+ * '-tickDivider' subcommand) is due every N-th tick, on the ticks which are
+ * multiple of N.
+ *
+ * Processes with a tick divider of 1 are kept in a list visited at every tick.
+ * The others are kept in a hashed timer wheel of WheelSize slots, so that the
+ * cost of a tick only depends on the number of gecoProcess due on this tick
+ * (plus the processes of the slot with a divider larger than WheelSize).
+ *
+ * The gecoTimerWheel must be rebuilt with gecoTimerWheel::rebuild whenever the
+ * geco process loop or a tick divider changes. This is taken care of by gecoApp
+ * and gecoProcess.
+ */
+
+class gecoTimerWheel
+{
+
+private:
+
+  gecoApp*                app;
+  long                    tick;
+  vector<gecoWheelEntry>  everyTick;          // processes run at every tick
+  vector<gecoWheelEntry>  slot[WheelSize];    // processes with a divider > 1
+  vector<gecoWheelEntry>  dueEntries;         // needed as tmp variable
+
+public:
+
+  gecoTimerWheel(gecoApp* App);
+
+  void  rebuild();
+  void  advance(vector<gecoProcess*>& due);
+  long  getTick() {return tick;}              /*!< Returns the current tick */
+};
+
+#endif /* gecoTimerWheel_SEEN_ */
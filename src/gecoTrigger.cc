@@ -19,6 +19,8 @@
 // ---------------------------------------------------------------
 // 17.10.2015 Creation                         R. Wuthrich
 // 09.12.2020 Added doxygen documentation      R. Wuthrich
+// 17.10.2026 Cached bytecode of scripts       agent
+// 17.10.2026 Compiled trigger condition       agent
 //
 // ---------------------------------------------------------------
 
@@ -59,6 +61,8 @@ int geco_TriggerCmd(ClientData clientData, Tcl_Interp *interp,
 
 gecoTrigger::~gecoTrigger()
 {
+  delete triggerExpr;
+  delete actionCode;
   Tcl_DStringFree(triggerScript);
   Tcl_DStringFree(actionScript);
   delete triggerScript;
@@ -76,8 +80,13 @@ gecoTrigger::~gecoTrigger()
 int gecoTrigger::cmd(int &i, int objc,Tcl_Obj *const objv[])
 {
   // first executes the command options defined in gecoProcess
+  int j=i;
   int index=gecoProcess::cmd(i,objc,objv);
 
+  // discards the cached scripts if changed
+  if ((index==getOptionIndex("-triggerScript"))&&(i==j+2)) triggerExpr->invalidate();
+  if ((index==getOptionIndex("-action"))&&(i==j+2)) actionCode->invalidate();
+
   if (index==getOptionIndex("-always"))
     {
       trigger_type = Trigger_always;
@@ -109,6 +118,7 @@ void gecoTrigger::handleEvent(gecoEvent* ev)
       ((ev->cmd()==CmdStart)||(ev->cmd()==CmdProcessTerminated)))
     {
       activate(ev);
+      ev->reset();
       ev->setCmdEvent(CmdProcessTerminated, this);
     }
 
@@ -119,9 +129,8 @@ void gecoTrigger::handleEvent(gecoEvent* ev)
 
   if (status==Active)
     {
-      Tcl_Eval(interp,Tcl_DStringValue(triggerScript)); 
-      if ((strcmp(Tcl_GetStringResult(interp),"0")==0)||
-          (strcmp(Tcl_GetStringResult(interp),"STOP")==0))
+      const char* result = triggerExpr->evalString(interp);
+      if ((strcmp(result,"0")==0)||(strcmp(result,"STOP")==0))
 	{
 	  if (verbose==1)
 	    {
@@ -129,13 +138,8 @@ void gecoTrigger::handleEvent(gecoEvent* ev)
 	      sprintf(str, "cons \"  ==> trig%s released\"", objID); 
 	      Tcl_Eval(interp,str);
 	    }
-	  Tcl_Eval(interp, Tcl_DStringValue(actionScript));
-	  
-	  // saves event
-	  int evCmd = ev->cmd();
-	  gecoProcess* proc = ev->eventGenerator();
+	  actionCode->eval(interp);
 	  if (trigger_type==Trigger_single) terminate(ev);
-	  ev->setCmdEvent(evCmd, proc); // restores event
 	}
     }
 
@@ -175,6 +179,7 @@ void gecoTrigger::setTriggerScript(Tcl_DString* TriggerScript)
 {
   Tcl_DStringFree(triggerScript);
   Tcl_DStringAppend(triggerScript,Tcl_DStringValue(TriggerScript),-1);
+  triggerExpr->invalidate();
 }
 
 
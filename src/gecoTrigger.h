@@ -30,6 +30,8 @@
 #include <tcl8.6/tcl.h>
 #include <stdio.h>
 #include "gecoProcess.h"
+#include "gecoScript.h"
+#include "gecoExpr.h"
 
 using namespace std;
 
@@ -116,6 +118,8 @@ protected:
 
   Tcl_DString* triggerScript;
   Tcl_DString* actionScript;
+  gecoExpr*    triggerExpr;     /*!< compiled triggerScript */
+  gecoScript*  actionCode;      /*!< cached actionScript */
 
 public:
 
@@ -130,7 +134,10 @@ public:
     actionScript = new Tcl_DString;
     Tcl_DStringInit(actionScript);
     Tcl_DStringAppend(actionScript, "", -1);
+    triggerExpr = new gecoExpr(App, triggerScript, Expr_script);
+    actionCode  = new gecoScript(actionScript);
     verbose=0;
+    activateNext=0;   // the next process is activated with the trigger
     addOption("-triggerScript", triggerScript, "returns/sets trigger condition");
     addOption("-action", actionScript, "returns/sets action");
     addOption("-single", "trigger is removed after release");
@@ -19,6 +19,7 @@
 // ---------------------------------------------------------------
 // 23.10.2015 Creation                         R. Wuthrich
 // 09.12.2020 Added doxygen documentation      R. Wuthrich
+// 17.10.2026 Cached bytecode of scripts       agent
 //
 // ---------------------------------------------------------------
 
@@ -61,11 +62,31 @@ int geco_UProcCmd(ClientData clientData, Tcl_Interp *interp,
 
 gecoUProc::~gecoUProc()
 {
+  delete userCode;
   Tcl_DStringFree(userScript);
   delete userScript;
 }
 
 
+/*!
+ * @copydoc gecoProcess::cmd 
+ *
+ * Compared to gecoProcess::cmd, gecoUProc::cmd discards the cached
+ * user script when it is changed.
+ */
+
+int gecoUProc::cmd(int &i, int objc,Tcl_Obj *const objv[])
+{
+  // first executes the command options defined in gecoProcess
+  int j=i;
+  int index=gecoProcess::cmd(i,objc,objv);
+
+  if ((index==getOptionIndex("-userProcess"))&&(i==j+2)) userCode->invalidate();
+
+  return index;
+}
+
+
 /**
  * @copydoc gecoProcess::handleEvent
  *
@@ -78,7 +99,7 @@ void gecoUProc::handleEvent(gecoEvent* ev)
   gecoProcess::handleEvent(ev);
 
   // If the user process is Active, evaluates the user script.
-  if (status==Active) Tcl_Eval(interp,Tcl_DStringValue(userScript)); 
+  if (status==Active) userCode->eval(interp);
 
   // Necessary as otherwise the result of the UserScript would
   // remain in the interpreter
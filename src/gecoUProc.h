@@ -29,6 +29,7 @@
 #include <tcl8.6/tcl.h>
 #include <stdio.h>
 #include "gecoProcess.h"
+#include "gecoScript.h"
 #include "gecoApp.h"
 
 using namespace std;
@@ -93,6 +94,7 @@ class gecoUProc : public gecoProcess
 protected:
 
   Tcl_DString* userScript;
+  gecoScript*  userCode;        /*!< cached userScript */
 
 public:
 
@@ -102,11 +104,13 @@ public:
   {
     userScript = new Tcl_DString;
     Tcl_DStringInit(userScript);
+    userCode = new gecoScript(userScript);
     addOption("-userProcess", userScript, "returns/sets user process");
   }
 
   ~gecoUProc();
 
+  virtual int  cmd(int &i,int objc,Tcl_Obj *const objv[]);
   virtual void handleEvent(gecoEvent* ev);
   virtual Tcl_DString* info(const char* frontStr = "");
 };
@@ -16,10 +16,13 @@
 # Date       Section       Modification             Author
 # ---------------------------------------------------------------
 # 24.10.15   all           creation                 R. Wuthrich 
+# 17.10.26   all           non-blocking pipe        agent
 #                                                                  
 # ---------------------------------------------------------------
 
 global PlotPipe
+global PlotSkipped
+set PlotSkipped 0
 
 # ----------------------------------------------------------------------
 #
@@ -27,13 +30,18 @@ global PlotPipe
 #
 # usage : openPlotPipe
 #
+# The pipe is non-blocking: Tcl writes the commands in the background
+# as gnuplot reads them, so that a busy gnuplot never blocks geco.
+#
 # -----------------------------------------------------------------------
 
 proc openPlotPipe {} {
     global PlotPipe
     if [catch {open |gnuplot w} PlotPipe] {
 	puts stderr "Cannot open gnuplot: $PlotPipe"
+	return
     }
+    fconfigure $PlotPipe -blocking 0 -buffering full
 }
 
 
@@ -78,15 +86,23 @@ proc plotTerminal {type} {
 #
 # usage : plotGnuplot file
 #
+# The plot is skipped (and counted in PlotSkipped) if gnuplot did not
+# yet read the previous commands.
+#
 # -----------------------------------------------------------------------
 
 proc plotGnuplot {file {args ""}} {
-    global PlotPipe
+    global PlotPipe PlotSkipped
 
     if {[catch {flush $PlotPipe}] > 0} {
 	openPlotPipe
     }
 
+    if {[chan pending output $PlotPipe] > 0} {
+	incr PlotSkipped
+	return
+    }
+
     puts $PlotPipe "plot \"$file\" $args"
     flush $PlotPipe
 }
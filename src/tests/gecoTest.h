@@ -0,0 +1,50 @@
+// This may look like C code, but it is really -*- C++ -*-
+// ----------------------------------------------------------------
+//
+// Checks of the C++ tests of the geco library
+//
+// (c) Rolf Wuthrich
+//     2026 Concordia University
+//
+// author:  agent
+// email:   agent@local
+// version: v1
+//
+// This software is copyright under the BSD license
+//
+// ---------------------------------------------------------------
+// history:
+// ---------------------------------------------------------------
+// Date       Modification                     Author
+// ---------------------------------------------------------------
+// 18.10.2026 Creation                         agent
+//
+// ---------------------------------------------------------------
+
+#ifndef gecoTest_SEEN_
+#define gecoTest_SEEN_
+
+#include <cstdio>
+
+static int testChecks   = 0;
+static int testFailures = 0;
+
+// checks that a condition is true, printing it if it isn't
+#define check(name, cond)						\
+  do {									\
+    testChecks++;							\
+    if (!(cond))							\
+      {									\
+	testFailures++;							\
+	printf("FAILED: %s (%s, line %d)\n", (name), #cond, __LINE__);	\
+      }									\
+  } while (0)
+
+// prints the result of the checks and returns the exit status of the test
+static inline int testSummary()
+{
+  printf("%d checks, %d failed\n", testChecks, testFailures);
+  return (testFailures>0) ? 1 : 0;
+}
+
+#endif /* gecoTest_SEEN_ */
@@ -0,0 +1,89 @@
+# ---------------------------------------------------------------
+#
+# Checks of the Tcl test scripts of the geco library
+#
+# (c) Rolf Wuthrich
+#     2026 Concordia University
+#
+# author:  agent
+# email:   agent@local
+#
+# ---------------------------------------------------------------
+# history:
+# ---------------------------------------------------------------
+# Date       Section       Modification             Author
+# ---------------------------------------------------------------
+# 18.10.26   all           creation                 agent
+#
+# ---------------------------------------------------------------
+
+set testChecks   0
+set testFailures 0
+set testDir      [file join [pwd] tmp]
+file mkdir $testDir
+
+
+# ----------------------------------------------------------------------
+#
+# check - checks that an expression is true
+#
+# name : name of the check, printed if it fails
+# cond : expression evaluated in the caller
+#
+
+proc check {name cond} {
+    global testChecks testFailures
+    incr testChecks
+    if {![uplevel 1 [list expr $cond]]} {
+	incr testFailures
+	puts "FAILED: $name ($cond)"
+    }
+}
+
+
+# ----------------------------------------------------------------------
+#
+# checkError - checks that a script fails with a message matching a pattern
+#
+
+proc checkError {name script pattern} {
+    global testChecks testFailures
+    incr testChecks
+    if {![catch {uplevel 1 $script} msg]} {
+	incr testFailures
+	puts "FAILED: $name (no error)"
+    } elseif {![string match $pattern $msg]} {
+	incr testFailures
+	puts "FAILED: $name ($msg)"
+    }
+}
+
+
+# ----------------------------------------------------------------------
+#
+# runLoop - runs the geco process loop during ms milliseconds
+#
+# The loop runs at global level, where the scripts of the processes
+# are evaluated as in a geco application.
+#
+
+proc runLoop {ms} {
+    start
+    after $ms {set ::testRunning 0}
+    uplevel #0 {vwait ::testRunning}
+    stop
+    after 50 {set ::testRunning 0}
+    uplevel #0 {vwait ::testRunning}
+}
+
+
+# ----------------------------------------------------------------------
+#
+# testSummary - prints the result of the checks, an error if any failed
+#
+
+proc testSummary {} {
+    global testChecks testFailures
+    puts "$testChecks checks, $testFailures failed"
+    if {$testFailures>0} {error "$testFailures checks failed"}
+}
@@ -0,0 +1,53 @@
+// ---------------------------------------------------------------
+//
+// Runs a Tcl test script of the geco library in a gecoApp
+//
+// (c) Rolf Wuthrich
+//     2026 Concordia University
+//
+// author:  agent
+// email:   agent@local
+// version: v1
+//
+// This software is copyright under the BSD license
+//
+// ---------------------------------------------------------------
+// history:
+// ---------------------------------------------------------------
+// Date       Modification                     Author
+// ---------------------------------------------------------------
+// 18.10.2026 Creation                         agent
+//
+// ---------------------------------------------------------------
+
+#include <iostream>
+#include "geco.h"
+
+using namespace std;
+
+
+// usage: gecoTestApp script.tcl
+//
+// The script is evaluated after gecoTest.tcl, in the Tcl interpreter of
+// a gecoApp. Returns 0 if the script completes without a failed check.
+
+int main(int argc, char **argv)
+{
+  if (argc!=2)
+    {
+      cerr << "usage: gecoTestApp script.tcl\n";
+      return 2;
+    }
+
+  gecoApp*    app = new gecoApp(1, argv);
+  Tcl_Interp* interp = app->getInterp();
+
+  if ((Tcl_EvalFile(interp, "gecoTest.tcl")!=TCL_OK)||
+      (Tcl_EvalFile(interp, argv[1])!=TCL_OK)||
+      (Tcl_Eval(interp, "testSummary")!=TCL_OK))
+    {
+      cout << argv[1] << ": " << Tcl_GetVar(interp, "errorInfo", TCL_GLOBAL_ONLY) << "\n";
+      return 1;
+    }
+  return 0;
+}
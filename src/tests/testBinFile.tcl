@@ -0,0 +1,122 @@
+# ---------------------------------------------------------------
+#
+# Reading of compressed binary data files: index and time queries
+#
+# (c) Rolf Wuthrich
+#     2026 Concordia University
+#
+# author:  agent
+# email:   agent@local
+#
+# ---------------------------------------------------------------
+# history:
+# ---------------------------------------------------------------
+# Date       Section       Modification             Author
+# ---------------------------------------------------------------
+# 18.10.26   all           creation                 agent
+#
+# ---------------------------------------------------------------
+
+set raw [file join $testDir raw.bin]
+set gz  [file join $testDir gorilla.bin]
+set cut [file join $testDir cut.bin]
+file delete $raw $gz $cut
+
+# writes a file
+proc writeFile {file data} {
+    set f [open $file wb]
+    puts -nonewline $f $data
+    close $f
+}
+
+# records the same data uncompressed and compressed
+set V 0.0
+set n 0
+trigger -triggerScript {expr 0} -action {set V [expr {sin($n/50.0)}]; incr n} -always
+filestream -file $raw -format binary -columns {t V {n int}} -dtRecord 0 -durability none
+filestream -file $gz -format binary -columns {t V {n int}} -dtRecord 0 -durability none \
+    -compress gorilla
+runLoop 3000
+
+set N [dict get [binfile -info $gz] records]
+check "several blocks recorded" {$N>2*1024}
+check "same records" {[dict get [binfile -info $raw] records]==$N}
+check "same values" {[binfile -column $raw n] eq [binfile -column $gz n]}
+check "same doubles" {[binfile -column $raw V] eq [binfile -column $gz V]}
+set f [open $gz rb]
+seek $f -8 end
+check "index trailer" {[read $f 8] eq "GECOIDX1"}
+close $f
+
+# records across blocks
+set all [binfile -read $gz]
+check "all records read" {[llength $all]==$N}
+set ok 1
+for {set k 0} {$k<$N} {incr k} {
+    if {[lindex $all $k 3]!=$k+1} {set ok 0}
+}
+check "records in order" {$ok}
+foreach {first count} [list 0 1 1020 10 1024 1 2047 2 [expr {$N-3}] 10 $N 5] {
+    set recs [binfile -read $gz $first $count]
+    check "records $first $count" {$recs eq [lrange $all $first [expr {$first+$count-1}]]}
+}
+check "column across blocks" {[binfile -column $gz n 1000 50] eq [binfile -column $raw n 1000 50]}
+
+# without index trailer, the blocks are scanned
+set f [open $gz rb]
+set data [read $f]
+close $f
+binary scan [string range $data end-11 end-8] iu trailer
+writeFile $cut [string range $data 0 end-$trailer]
+check "records without index" {[dict get [binfile -info $cut] records]==$N}
+check "read without index" {[binfile -read $cut] eq $all}
+writeFile $cut [string range $data 0 end-1]X
+check "records with invalid index" {[dict get [binfile -info $cut] records]==$N}
+check "read with invalid index" {[binfile -read $cut 2000 100] eq [lrange $all 2000 2099]}
+
+# a corrupted block is reported, the others are read through the index
+binary scan [string range $data 8 11] iu headerLength
+set block [expr {12+$headerLength}]
+writeFile $cut [string replace $data $block [expr {$block+3}] [binary format iu 5]]
+check "records with corrupted block" {[dict get [binfile -info $cut] records]==$N}
+checkError "read corrupted block" {binfile -read $cut 0 2} "*corrupted block*"
+check "read after corrupted block" {[binfile -read $cut 1024 5] eq [lrange $all 1024 1028]}
+checkError "range over corrupted block" {binfile -range $cut n -1e10 1e10} "*corrupted block*"
+checkError "latest over corrupted block" {binfile -latest $cut n $N} "*corrupted block*"
+set expected {}
+foreach rec [lrange $all end-9 end] {lappend expected [list [lindex $rec 0] [lindex $rec 3]]}
+check "latest after corrupted block" {[binfile -latest $cut n 10] eq $expected}
+writeFile $cut [string replace $data [expr {$block+4}] [expr {$block+7}] [binary format iu 0x7fffffff]]
+checkError "read block with invalid records" {binfile -read $cut 0 2} "*corrupted block*"
+checkError "range over block with invalid records" {binfile -range $cut n -1e10 1e10} "*corrupted block*"
+
+# time queries of the records a to b, checked against the records read
+proc timeQuery {file recs a b} {
+    set tMin [expr {([lindex $recs [expr {$a-1}] 0]+[lindex $recs $a 0])/2}]
+    set tMax [expr {([lindex $recs $b 0]+[lindex $recs [expr {$b+1}] 0])/2}]
+    set expected {}
+    foreach rec [lrange $recs $a $b] {lappend expected [list [lindex $rec 0] [lindex $rec 3]]}
+    return [expr {[binfile -range $file n $tMin $tMax] eq $expected}]
+}
+foreach {a b} [list 1 1 10 1500 1023 1024 2000 [expr {$N-2}]] {
+    check "range $a $b" {[timeQuery $gz $all $a $b]}
+}
+set recs [binfile -read $raw]
+foreach {a b} [list 10 1500 2000 [expr {$N-2}]] {
+    check "range $a $b uncompressed" {[timeQuery $raw $recs $a $b]}
+}
+set last [lindex $all end 0]
+check "empty range" {[binfile -range $gz n [expr {$last+1}] [expr {$last+2}]] eq {}}
+check "whole range" {[llength [binfile -range $gz n -1e10 1e10]]==$N}
+set points [binfile -range $gz n -1e10 1e10 100]
+check "decimated range" {([llength $points]==100)&&([lindex $points 0 1]==1)}
+set expected {}
+foreach rec [lrange $all end-9 end] {lappend expected [list [lindex $rec 0] [lindex $rec 2]]}
+check "latest records" {[binfile -latest $gz V 10] eq $expected}
+set expected {}
+foreach rec [lrange $recs end-9 end] {lappend expected [list [lindex $rec 0] [lindex $rec 2]]}
+check "latest records uncompressed" {[binfile -latest $raw V 10] eq $expected}
+check "more latest records than recorded" {[llength [binfile -latest $gz n [expr {$N+10}]]]==$N}
+checkError "query of unknown column" {binfile -range $gz x 0 1} "no column \"x\" in data"
+
+file delete $raw $gz $cut
@@ -0,0 +1,182 @@
+// ---------------------------------------------------------------
+//
+// Round trip of records through gecoBlockEncoder and gecoBlockDecoder
+//
+// (c) Rolf Wuthrich
+//     2026 Concordia University
+//
+// author:  agent
+// email:   agent@local
+// version: v1
+//
+// This software is copyright under the BSD license
+//
+// ---------------------------------------------------------------
+// history:
+// ---------------------------------------------------------------
+// Date       Modification                     Author
+// ---------------------------------------------------------------
+// 18.10.2026 Creation                         agent
+//
+// ---------------------------------------------------------------
+
+#include <tcl.h>
+#include <cmath>
+#include <cfloat>
+#include <climits>
+#include <cstring>
+#include <random>
+#include <vector>
+#include "gecoBinFile.h"
+#include "gecoBlockCodec.h"
+#include "gecoTest.h"
+
+using namespace std;
+
+
+// columns of the records: timestamp, double, float, int, wide
+static const char* Columns = "{d double} {f float} {i int} {w wide}";
+
+
+// ---- records of a sequence, written bit for bit
+//
+
+struct sequence
+{
+  gecoBinFile*  bin;
+  vector<char>  recs;
+  int           n;
+
+  sequence(gecoBinFile* Bin) : bin(Bin), n(0) {}
+
+  void add(long long ts, double d, float f, int i, long long w)
+  {
+    union {double d; unsigned long long u;} dd;
+    union {float f; unsigned int u;} ff;
+    dd.d=d;
+    ff.f=f;
+    recs.resize((size_t)(n+1)*bin->getRecordSize());
+    char* rec=&recs[(size_t)n*bin->getRecordSize()];
+    gecoBinFile::putLE(rec+bin->getColumnOffset(0), (unsigned long long)ts, 8);
+    gecoBinFile::putLE(rec+bin->getColumnOffset(1), dd.u, 8);
+    gecoBinFile::putLE(rec+bin->getColumnOffset(2), ff.u, 4);
+    gecoBinFile::putLE(rec+bin->getColumnOffset(3), (unsigned int)i, 4);
+    gecoBinFile::putLE(rec+bin->getColumnOffset(4), (unsigned long long)w, 8);
+    n++;
+  }
+
+  const char* record(int k) {return &recs[(size_t)k*bin->getRecordSize()];}
+};
+
+
+// ---- encodes a sequence in blocks, decodes them and compares the records
+//
+//      returns the number of blocks (-1 if a block differs)
+//
+
+static int roundTrip(gecoBinFile* bin, sequence& seq, int maxRecords, size_t maxBytes)
+{
+  gecoBlockEncoder enc(bin);
+  enc.setup(maxRecords, maxBytes);
+  int          size=bin->getRecordSize();
+  int          blocks=0, first=0;
+  vector<char> out;
+  for (int k=0; k<=seq.n; k++)
+    {
+      if ((k==seq.n)||(enc.isFull()))
+	{
+	  size_t      len;
+	  int         n=enc.getRecords();
+	  const char* block=enc.finish(len);
+	  if (n==0) break;
+	  blocks++;
+	  if ((block==NULL)||(len>maxBytes)||
+	      (gecoBlockDecoder::getSize(block)!=len)||
+	      (gecoBlockDecoder::getRecords(block)!=n)||
+	      (gecoBlockDecoder::getFirstTime(block)!=seq.bin->getTimestamp(seq.record(first))))
+	    return -1;
+	  out.assign((size_t)n*size, 0);
+	  if (gecoBlockDecoder::decode(bin, block, len, &out[0])!=n) return -1;
+	  if (memcmp(&out[0], seq.record(first), (size_t)n*size)!=0) return -1;
+	  first+=n;
+	}
+      if (k<seq.n) enc.add(seq.record(k));
+    }
+  return (first==seq.n) ? blocks : -1;
+}
+
+
+int main(int argc, char **argv)
+{
+  Tcl_FindExecutable(argv[0]);
+  gecoBinFile bin;
+  check("columns", bin.setColumns(NULL, Columns)==TCL_OK);
+  check("timestamp column added", bin.getNbrColumns()==5);
+
+  // a single record
+  sequence one(&bin);
+  one.add(123456789, 1.5, 2.5f, -3, 4);
+  check("single record", roundTrip(&bin, one, BlockMaxRecords, 1<<20)==1);
+
+  // a full block of regularly sampled, slowly varying records
+  sequence full(&bin);
+  for (int k=0; k<BlockMaxRecords; k++)
+    full.add(1000000LL*k, sin(k*0.01), (float)cos(k*0.01), k/10, 1000000000000LL+k);
+  check("full block", roundTrip(&bin, full, BlockMaxRecords, 1<<20)==1);
+  check("next block", roundTrip(&bin, full, BlockMaxRecords-1, 1<<20)==2);
+
+  // values at the edges of their type
+  double doubles[] = {0.0, -0.0, NAN, -NAN, INFINITY, -INFINITY, DBL_MAX, -DBL_MAX,
+		      DBL_MIN, DBL_TRUE_MIN, -DBL_TRUE_MIN, 1.0, 1.0+DBL_EPSILON};
+  float  floats[]  = {0.0f, -0.0f, NAN, -NAN, INFINITY, -INFINITY, FLT_MAX, -FLT_MAX,
+		      FLT_MIN, FLT_TRUE_MIN, -FLT_TRUE_MIN, 1.0f, 1.0f+FLT_EPSILON};
+  int       ints[]  = {0, INT_MAX, INT_MIN, INT_MAX, -1, INT_MIN, 1};
+  long long wides[] = {0, LLONG_MAX, LLONG_MIN, LLONG_MAX, -1, LLONG_MIN, 1};
+  long long times[] = {0, LLONG_MAX, LLONG_MIN, 0, -1, 1000000000, 999999999};
+  union {double d; unsigned long long u;} payload;
+  payload.u=0x7ff0000000000001ULL;                // NaN with a payload
+
+  sequence edge(&bin);
+  for (int r=0; r<3; r++)
+    for (int k=0; k<13; k++)
+      edge.add(times[k%7], (k==12) ? payload.d : doubles[k], floats[(k+r)%13],
+	       ints[(k+r)%7], wides[(k+2*r)%7]);
+  check("edge values", roundTrip(&bin, edge, BlockMaxRecords, 1<<20)==1);
+  check("edge values, one record per block", roundTrip(&bin, edge, 1, 1<<20)==edge.n);
+
+  // random bits
+  mt19937_64 gen(1);
+  sequence noise(&bin);
+  for (int k=0; k<5000; k++)
+    {
+      union {double d; unsigned long long u;} d;
+      union {float f; unsigned int u;} f;
+      d.u=gen();
+      f.u=(unsigned int)gen();
+      noise.add((long long)gen(), d.d, f.f, (int)gen(), (long long)gen());
+    }
+  int blocks=roundTrip(&bin, noise, BlockMaxRecords, 1<<20);
+  check("random bits", blocks==5);
+
+  // blocks limited in size
+  blocks=roundTrip(&bin, noise, BlockMaxRecords, 4096);
+  check("blocks limited in size", blocks>5);
+  blocks=roundTrip(&bin, full, BlockMaxRecords, 512);
+  check("regular blocks limited in size", blocks>1);
+
+  // a truncated or corrupted block is rejected
+  gecoBlockEncoder enc(&bin);
+  enc.setup(BlockMaxRecords, 1<<20);
+  for (int k=0; k<100; k++) enc.add(noise.record(k));
+  size_t       len;
+  const char*  block=enc.finish(len);
+  vector<char> copy(block, block+len);
+  vector<char> out((size_t)100*bin.getRecordSize());
+  check("complete block", gecoBlockDecoder::decode(&bin, &copy[0], len, &out[0])==100);
+  check("truncated block", gecoBlockDecoder::decode(&bin, &copy[0], len-1, &out[0])==-1);
+  check("truncated header", gecoBlockDecoder::decode(&bin, &copy[0], 10, &out[0])==-1);
+  gecoBinFile::putLE(&copy[16], 1<<30, 4);       // size of the first bit stream
+  check("corrupted stream size", gecoBlockDecoder::decode(&bin, &copy[0], len, &out[0])==-1);
+
+  return testSummary();
+}
@@ -0,0 +1,198 @@
+// ---------------------------------------------------------------
+//
+// Selection and query of the buckets of a gecoPyramid
+//
+// (c) Rolf Wuthrich
+//     2026 Concordia University
+//
+// author:  agent
+// email:   agent@local
+// version: v1
+//
+// This software is copyright under the BSD license
+//
+// ---------------------------------------------------------------
+// history:
+// ---------------------------------------------------------------
+// Date       Modification                     Author
+// ---------------------------------------------------------------
+// 18.10.2026 Creation                         agent
+//
+// ---------------------------------------------------------------
+
+#include <tcl.h>
+#include <cmath>
+#include <random>
+#include <vector>
+#include "gecoPyramid.h"
+#include "gecoTest.h"
+
+using namespace std;
+
+
+// ---- summary of the buckets selected for a range
+//
+
+struct selection
+{
+  int               level;
+  long long         buckets;      // complete buckets selected
+  gecoPyramidBucket all;          // merge of the buckets and of the tail
+};
+
+static selection selectRange(gecoPyramid& p, double xMin, double xMax, long long maxBuckets)
+{
+  selection s;
+  long long b0, b1;
+  s.level=p.select(xMin, xMax, maxBuckets, b0, b1);
+  s.buckets=b1-b0;
+  s.all.n=0;
+  gecoPyramidBucket tail;
+  bool hasTail=p.getTail(s.level, xMin, xMax, tail);
+  for (long long b=b0; b<b1+hasTail; b++)
+    {
+      const gecoPyramidBucket& B=(b<b1) ? p.getBucket(s.level, b) : tail;
+      if (s.all.n==0)
+	s.all=B;
+      else
+	gecoPyramid::merge(s.all, B);
+    }
+  return s;
+}
+
+
+// ---- compares the summary of the buckets with the samples they cover
+//
+
+static bool sameSummary(const gecoPyramidBucket& b, const vector<double>& xs, const vector<double>& ys)
+{
+  double    yMin=HUGE_VAL, yMax=-HUGE_VAL, sum=0.0;
+  long long n=0;
+  for (size_t i=0; i<xs.size(); i++)
+    if ((xs[i]>=b.xFirst)&&(xs[i]<=b.xLast))
+      {
+	yMin=fmin(yMin, ys[i]);
+	yMax=fmax(yMax, ys[i]);
+	sum+=ys[i];
+	n++;
+      }
+  return (n==b.n)&&(yMin==b.yMin)&&(yMax==b.yMax)&&
+    (fabs(sum-b.sum)<=1e-9*(fabs(sum)+n));
+}
+
+
+int main(int argc, char **argv)
+{
+  Tcl_FindExecutable(argv[0]);
+
+  // an empty pyramid has nothing to plot
+  gecoPyramid empty(16);
+  long long b0, b1;
+  check("empty pyramid", empty.select(0.0, 1.0, 100, b0, b1)<0);
+  Tcl_Obj* list=empty.query(0.0, 1.0, 100);
+  int      len;
+  Tcl_IncrRefCount(list);
+  Tcl_ListObjLength(NULL, list, &len);
+  check("empty query", len==0);
+  Tcl_DecrRefCount(list);
+
+  // random ranges compared with the samples, spikes included
+  mt19937_64 gen(3);
+  normal_distribution<double> noise(0.0, 1.0);
+  int capacities[] = {16, 256, 4096};
+  long samples[]   = {1, 7, 1000, 123457};
+  int wrongCount=0, wrongSummary=0, wrongWhole=0, wrongSpikes=0;
+  for (int c=0; c<3; c++)
+    for (int s=0; s<4; s++)
+      {
+	long           N=samples[s];
+	gecoPyramid    p(capacities[c]);
+	vector<double> xs, ys;
+	for (long i=0; i<N; i++)
+	  {
+	    double y=noise(gen);
+	    if (i==N/3) y=1e3;
+	    if (i==2*N/3) y=-1e3;
+	    xs.push_back(i*0.001);
+	    ys.push_back(y);
+	    p.add(i*0.001, y);
+	  }
+
+	selection whole=selectRange(p, -HUGE_VAL, HUGE_VAL, 500);
+	if ((whole.all.n!=N)||(whole.all.xFirst!=xs[0])||(whole.all.xLast!=xs[N-1])) wrongWhole++;
+	if ((N>2)&&((whole.all.yMax!=1e3)||(whole.all.yMin!=-1e3))) wrongSpikes++;
+
+	for (int q=0; q<200; q++)
+	  {
+	    double xMin=xs[gen()%N], xMax=xs[gen()%N];
+	    if (xMin>xMax) swap(xMin, xMax);
+	    long long maxBuckets=2+gen()%500;
+	    selection sel=selectRange(p, xMin, xMax, maxBuckets);
+	    if ((sel.buckets>maxBuckets)&&(sel.level<p.getLevels()-1)) wrongCount++;
+	    if ((sel.all.n>0)&&(!sameSummary(sel.all, xs, ys))) wrongSummary++;
+	  }
+      }
+  check("bounded number of buckets", wrongCount==0);
+  check("buckets summarize their samples", wrongSummary==0);
+  check("whole range covers all samples", wrongWhole==0);
+  check("spikes preserved", wrongSpikes==0);
+
+  // the points of a query
+  gecoPyramid p(256);
+  for (long i=0; i<100000; i++) p.add(i*0.001, sin(i*0.001));
+  list=p.query(10.0, 20.0, 100);
+  Tcl_IncrRefCount(list);
+  Tcl_ListObjLength(NULL, list, &len);
+  check("points of a query", (len>0)&&(len<=101));
+  bool ordered=true, inRange=true;
+  double xPrev=-HUGE_VAL;
+  for (int k=0; k<len; k++)
+    {
+      Tcl_Obj* point;
+      double   x, yMin, yMax, yMean;
+      Tcl_ListObjIndex(NULL, list, k, &point);
+      Tcl_Obj* elem;
+      Tcl_ListObjIndex(NULL, point, 0, &elem);
+      Tcl_GetDoubleFromObj(NULL, elem, &x);
+      Tcl_ListObjIndex(NULL, point, 1, &elem);
+      Tcl_GetDoubleFromObj(NULL, elem, &yMin);
+      Tcl_ListObjIndex(NULL, point, 2, &elem);
+      Tcl_GetDoubleFromObj(NULL, elem, &yMax);
+      Tcl_ListObjIndex(NULL, point, 3, &elem);
+      Tcl_GetDoubleFromObj(NULL, elem, &yMean);
+      if (x<=xPrev) ordered=false;
+      if ((yMin>yMean)||(yMean>yMax)) inRange=false;
+      xPrev=x;
+    }
+  check("points in increasing x", ordered);
+  check("mean between min and max", inRange);
+  Tcl_DecrRefCount(list);
+
+  // with a decreasing x, all the samples are decimated in order
+  int wrongXY=0;
+  long sweeps[] = {5, 1000, 100001};
+  for (int s=0; s<3; s++)
+    {
+      long        N=sweeps[s];
+      gecoPyramid xy(256);
+      for (long i=0; i<N; i++)
+	{
+	  double v=(i<N/2) ? i : N-i;
+	  xy.add(v, v*v);
+	}
+      selection sel=selectRange(xy, 10.0, 20.0, 100);
+      if ((xy.isMonotonic())||(sel.all.n!=N)||(sel.buckets>100)) wrongXY++;
+    }
+  check("decreasing x", wrongXY==0);
+
+  // cleared, the pyramid is monotonic again
+  gecoPyramid xy(16);
+  xy.add(1.0, 1.0);
+  xy.add(0.0, 1.0);
+  xy.clear();
+  xy.add(0.0, 1.0);
+  xy.add(1.0, 1.0);
+  check("monotonic once cleared", xy.isMonotonic()&&(xy.getSamples()==2));
+
+  return testSummary();
+}
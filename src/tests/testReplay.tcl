@@ -0,0 +1,143 @@
+# ---------------------------------------------------------------
+#
+# Replay of recorded data files at their recorded time
+#
+# (c) Rolf Wuthrich
+#     2026 Concordia University
+#
+# author:  agent
+# email:   agent@local
+#
+# ---------------------------------------------------------------
+# history:
+# ---------------------------------------------------------------
+# Date       Section       Modification             Author
+# ---------------------------------------------------------------
+# 18.10.26   all           creation                 agent
+#
+# ---------------------------------------------------------------
+
+set raw [file join $testDir replay.bin]
+set gz  [file join $testDir replay-gorilla.bin]
+set txt [file join $testDir replay.txt]
+file delete $raw $gz $txt
+
+# records the same data in the three formats
+set V 0.0
+set n 0
+set rec [trigger -triggerScript {expr 0} -action {set V [expr {sin($n/50.0)}]; incr n} -always]
+set streams {}
+lappend streams [filestream -file $raw -format binary -columns {t V {n int}} \
+		     -dtRecord 0 -durability none]
+lappend streams [filestream -file $gz -format binary -columns {t V {n int}} \
+		     -dtRecord 0 -durability none -compress gorilla]
+lappend streams [filestream -file $txt -format text -columns {t V {n int}} \
+		     -dtRecord 0 -durability none]
+runLoop 1500
+remove trig$rec
+foreach id $streams {remove $id}
+
+set recs [binfile -read $gz]
+set N    [llength $recs]
+check "records recorded" {$N>1000}
+
+# times of the records of a file since its first record
+proc recordTimes {file} {
+    set recs [binfile -read $file]
+    set t0 [lindex $recs 0 0]
+    set times {}
+    foreach r $recs {lappend times [expr {[lindex $r 0]-$t0}]}
+    return $times
+}
+
+# replays a file and collects the values of t and n at each pass of the loop
+proc replayRun {ms args} {
+    global seen replayInfo
+    set seen {}
+    set id [replay {*}$args]
+    set trig [trigger -triggerScript {expr 0} -action {lappend seen [list $t $n]} -always]
+    set ::n 0
+    runLoop $ms
+    set replayInfo [replay$id -info]
+    remove replay$id
+    remove trig$trig
+    return $seen
+}
+
+# number of records of an information
+proc infoRecords {info name} {
+    regexp "$name:\\s+(\\d+)" $info -> count
+    return $count
+}
+
+# values of n replayed one record per pass: all records in order
+proc inOrder {seen N} {
+    set values {}
+    foreach s $seen {
+	if {([lindex $s 1]!=0)&&([lindex $values end] ne [lindex $s 1])} {
+	    lappend values [lindex $s 1]
+	}
+    }
+    set expected {}
+    for {set k 1} {$k<=$N} {incr k} {lappend expected $k}
+    return [expr {$values eq $expected}]
+}
+
+set ms [expr {2*$N+500}]
+foreach {name file opts} [list gorilla $gz {} raw $raw {} stream $gz {-read stream} \
+			      "stream raw" $raw {-read stream} \
+			      text $txt {-columns {t V {n int}}}] {
+    replayRun $ms -file $file -speed 0 {*}$opts
+    check "$name: all records replayed" {[inOrder $seen $N]}
+    check "$name: records counted" {[infoRecords $replayInfo "Records replayed"]==$N}
+    check "$name: no record skipped" {[infoRecords $replayInfo "Records skipped"]==0}
+}
+
+# at a speed larger than 0, the record replayed is the last one due
+proc lastDue {seen times speed} {
+    set tA {}
+    foreach s $seen {
+	lassign $s time k
+	if {$k==0} continue
+	if {$tA eq {}} {
+	    if {$k!=1} {return 0}
+	    set tA $time
+	}
+	set due [expr {($time-$tA)*$speed}]
+	if {[lindex $times [expr {$k-1}]]>$due+1e-9} {return 0}
+	if {($k<[llength $times])&&([lindex $times $k]<=$due-1e-9)} {return 0}
+    }
+    return 1
+}
+
+foreach {speed file} [list 1 $gz 2 $raw 0.5 $gz] {
+    set times [recordTimes $file]
+    set duration [lindex $times end]
+    set ms [expr {int(1000*$duration/$speed)+500}]
+    replayRun $ms -file $file -speed $speed
+    set played  [infoRecords $replayInfo "Records replayed"]
+    set skipped [infoRecords $replayInfo "Records skipped"]
+    check "speed $speed: last record due replayed" {[lastDue $seen $times $speed]}
+    check "speed $speed: end of file reached" {[lindex $seen end 1]==$N}
+    check "speed $speed: records replayed or skipped" {$played+$skipped==$N}
+}
+
+# the replay takes the recorded time
+set duration [lindex [recordTimes $gz] end]
+replayRun [expr {int(500*$duration)}] -file $gz -speed 1
+check "replay in real time" {([lindex $seen end 1]>1)&&([lindex $seen end 1]<$N)}
+
+# in a loop, the file is replayed again from its first record
+replayRun [expr {4*$N+500}] -file $gz -speed 0 -loop on
+set restarts 0
+set last 0
+foreach s $seen {
+    if {[lindex $s 1]<$last} {incr restarts}
+    set last [lindex $s 1]
+}
+check "replayed in a loop" {$restarts>=1}
+
+checkError "negative speed" {replay -speed -1} "*speed must be positive or 0*"
+checkError "invalid read mode" {replay -read all} "*read mode must be mmap or stream*"
+
+file delete $raw $gz $txt
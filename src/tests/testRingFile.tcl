@@ -0,0 +1,93 @@
+# ---------------------------------------------------------------
+#
+# Recovery of the records of a ring file (gecoRingRecorder, ringfile)
+#
+# (c) Rolf Wuthrich
+#     2026 Concordia University
+#
+# author:  agent
+# email:   agent@local
+#
+# ---------------------------------------------------------------
+# history:
+# ---------------------------------------------------------------
+# Date       Section       Modification             Author
+# ---------------------------------------------------------------
+# 18.10.26   all           creation                 agent
+#
+# ---------------------------------------------------------------
+
+set ring [file join $testDir test.ring]
+set bin  [file join $testDir ring.bin]
+file delete {*}[glob -nocomplain $ring*]
+
+# flips a byte of the record n of a ring file, as a torn write would
+proc tearRecord {file n} {
+    set f [open $file r+]
+    fconfigure $f -translation binary
+    binary scan [read $f 32] @12iu1iu1x4wu1 slotOffset slotSize slots
+    set pos [expr {$slotOffset+(($n-1)%$slots)*$slotSize+8}]
+    seek $f $pos
+    binary scan [read $f 1] cu byte
+    seek $f $pos
+    puts -nonewline $f [binary format c [expr {$byte^0xff}]]
+    close $f
+}
+
+# records more than the slots of the ring
+set V 1.5
+set n 7
+set r [ringrecorder -file $ring -columns {t V {n int}} -dtRecord 0 -records 64]
+runLoop 300
+
+set info [ringfile -info $ring]
+check "ring wrapped" {[dict get $info committed]>64}
+check "last record is the committed one" {[dict get $info last]==[dict get $info committed]}
+check "window holds all slots" {[dict get $info records]==64}
+check "window is contiguous" {[dict get $info first]==[dict get $info last]-63}
+
+# dumps the window
+check "records dumped" {[ringfile -dump $ring $bin]==64}
+check "records of dump" {[dict get [binfile -info $bin] records]==64}
+set recs [binfile -read $bin 0 64]
+set ok 1
+set prev -1
+foreach rec $recs {
+    lassign $rec ts time v k
+    if {($ts<=$prev)||($v!=1.5)||($k!=7)} {set ok 0}
+    set prev $ts
+}
+check "dumped records" {$ok && ([llength $recs]==64)}
+if {[file writable /dev/full]} {
+    checkError "dump to a full disk" {ringfile -dump $ring /dev/full} "error writing*"
+}
+
+# a torn newest record is dropped
+set last [dict get $info last]
+tearRecord $ring $last
+set info [ringfile -info $ring]
+check "torn last record dropped" {[dict get $info last]==$last-1}
+check "window after torn last record" {[dict get $info records]==63}
+
+# a torn record ends the window
+set first [dict get $info first]
+tearRecord $ring [expr {$first+10}]
+set info [ringfile -info $ring]
+check "window starts after torn record" {[dict get $info first]==$first+11}
+check "window after torn record" {[dict get $info records]==52}
+check "records dumped after torn record" {[ringfile -dump $ring $bin]==52}
+
+# not a ring file
+set f [open $bin a]
+close $f
+checkError "not a ring file" {ringfile -info $bin} "not a geco ring file"
+
+# the ring is kept on the next activation
+runLoop 100
+check "previous ring kept" {[file exists $ring.1]}
+set info [ringfile -info $ring.1]
+check "previous ring unchanged" {([dict get $info last]==$last-1)&&([dict get $info records]==52)}
+check "new ring" {[dict get [ringfile -info $ring] last]>0}
+check "previous ring reported" {[string match "*Previous ring:*$ring.1*" [ringrecorder$r -info]]}
+
+file delete {*}[glob -nocomplain $ring*] $bin